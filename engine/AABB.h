@@ -0,0 +1,231 @@
+/**
+ * @file	AABB.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Axis aligned bounding box
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Where a box lies relative to a volume.
+ */
+enum Containment
+{
+	/**
+	 * @brief Completely outside.
+	 */
+	CONTAINMENT_OUTSIDE,
+
+	/**
+	 * @brief Partly inside.
+	 */
+	CONTAINMENT_PARTIAL,
+
+	/**
+	 * @brief Completely inside.
+	 */
+	CONTAINMENT_INSIDE
+};
+
+/**
+ * @brief Axis aligned bounding box.
+ */
+struct AABB
+{
+	/**
+	 * @brief Minimum corner.
+	 */
+	glm::vec3 min{};
+
+	/**
+	 * @brief Maximum corner.
+	 */
+	glm::vec3 max{};
+
+	/**
+	 * @brief Creates a box from its center and half size.
+	 * @param center Center of the box.
+	 * @param extent Half size along each axis.
+	 * @return The box.
+	 */
+	static AABB fromCenter(glm::vec3 center, glm::vec3 extent)
+	{
+		return AABB{ center - extent, center + extent };
+	}
+
+	/**
+	 * @brief Creates the smallest box containing a set of points.
+	 * @param positions Packed xyz coordinates.
+	 * @param count Number of points, 0 gives an empty box at the origin.
+	 * @return The box.
+	 */
+	static AABB fromPoints(const float* positions, size_t count)
+	{
+		if (count == 0)
+		{
+			return AABB{};
+		}
+
+		AABB result{ glm::vec3{ positions[0], positions[1], positions[2] }, glm::vec3{ positions[0], positions[1], positions[2] } };
+
+		for (size_t i = 1; i < count; ++i)
+		{
+			glm::vec3 point{ positions[3 * i], positions[3 * i + 1], positions[3 * i + 2] };
+
+			result.min = glm::min(result.min, point);
+			result.max = glm::max(result.max, point);
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Checks whether two boxes overlap. Touching boxes do not overlap.
+	 * @param other The other box.
+	 * @return True if the boxes overlap.
+	 */
+	bool overlaps(const AABB& other) const
+	{
+		return min.x < other.max.x && max.x > other.min.x &&
+			min.y < other.max.y && max.y > other.min.y &&
+			min.z < other.max.z && max.z > other.min.z;
+	}
+
+	/**
+	 * @brief Checks whether another box is completely inside this box.
+	 * @param other The other box.
+	 * @return True if other is inside.
+	 */
+	bool contains(const AABB& other) const
+	{
+		return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+			other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+	}
+
+	/**
+	 * @brief Gets the smallest box containing both boxes.
+	 * @param other The other box.
+	 * @return The merged box.
+	 */
+	AABB merge(const AABB& other) const
+	{
+		return AABB{ glm::min(min, other.min), glm::max(max, other.max) };
+	}
+
+	/**
+	 * @brief Grows the box by margin in all directions.
+	 * @param margin Distance to grow by.
+	 * @return The grown box.
+	 */
+	AABB expand(float margin) const
+	{
+		return AABB{ min - glm::vec3{ margin }, max + glm::vec3{ margin } };
+	}
+
+	/**
+	 * @brief Gets the surface area of the box. Used as cost when building trees.
+	 * @return Surface area.
+	 */
+	float getSurfaceArea() const
+	{
+		glm::vec3 d = max - min;
+
+		return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+	/**
+	 * @brief Gets the center of the box.
+	 * @return Center.
+	 */
+	glm::vec3 getCenter() const
+	{
+		return (min + max) * 0.5f;
+	}
+
+	/**
+	 * @brief Gets the squared distance from a point to the box.
+	 * @param point The point.
+	 * @return Squared distance, 0 if the point is inside.
+	 */
+	float getDistanceSquared(glm::vec3 point) const
+	{
+		glm::vec3 d = glm::max(glm::max(min - point, point - max), glm::vec3{ 0.f });
+
+		return glm::dot(d, d);
+	}
+
+	/**
+	 * @brief Intersects a ray with the box using the slab test.
+	 * @param origin Origin of the ray.
+	 * @param invDirection One over the direction of the ray, per axis.
+	 * @param maxDistance Max distance along the ray.
+	 * @param distance Set to the distance where the ray enters the box, 0 if
+	 * the origin is inside.
+	 * @return True if the ray enters the box within maxDistance.
+	 */
+	bool intersectRay(glm::vec3 origin, glm::vec3 invDirection, float maxDistance, float& distance) const
+	{
+		glm::vec3 t1 = (min - origin) * invDirection;
+		glm::vec3 t2 = (max - origin) * invDirection;
+
+		glm::vec3 tNear = glm::min(t1, t2);
+		glm::vec3 tFar = glm::max(t1, t2);
+
+		float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.f));
+		float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+
+		distance = enter;
+
+		return enter <= exit;
+	}
+
+	/**
+	 * @brief Finds when a moving box first overlaps this box.
+	 * @param moving The moving box, at the start of the motion.
+	 * @param motion Distance the box moves.
+	 * @param time Set to the time of impact, from 0 at the start of the motion
+	 * to 1 at the end.
+	 * @return True if the boxes overlap during the motion.
+	 */
+	bool intersectSweep(const AABB& moving, glm::vec3 motion, float& time) const
+	{
+		// Grow this box by the moving one and follow its center through the slabs
+		glm::vec3 half = (moving.max - moving.min) * 0.5f;
+		glm::vec3 start = moving.getCenter();
+
+		AABB grown{ min - half, max + half };
+
+		float enter = 0.f;
+		float exit = 1.f;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			// Not moving along the axis, the boxes must already overlap on it.
+			// Dividing by zero here would give NaN for a start on the slab.
+			if (motion[axis] == 0.f)
+			{
+				if (start[axis] <= grown.min[axis] || start[axis] >= grown.max[axis])
+					return false;
+
+				continue;
+			}
+
+			float t1 = (grown.min[axis] - start[axis]) / motion[axis];
+			float t2 = (grown.max[axis] - start[axis]) / motion[axis];
+
+			enter = std::max(enter, std::min(t1, t2));
+			exit = std::min(exit, std::max(t1, t2));
+		}
+
+		time = enter;
+
+		// Boxes only touching do not overlap, like in overlaps
+		return enter < exit;
+	}
+};
@@ -0,0 +1,459 @@
+/**
+ * @file	AABBTreeBroadphase.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Broadphase based on a dynamic AABB tree
+ */
+
+#include "AABBTreeBroadphase.h"
+#include "CollisionComponent.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+constexpr size_t AABBTreeBroadphase::GRAIN_SIZE;
+
+AABBTreeBroadphase::AABBTreeBroadphase(EntityManager* entMan, EventManager* evMan) :
+	Broadphase(entMan, evMan)
+{
+	_evM->addSubscriber<EntityDestroyedEvent>(this);
+	_evM->addSubscriber<ComponentAssignedEvent<TransformComponent>>(this);
+	_evM->addSubscriber<ComponentAssignedEvent<CollisionComponent>>(this);
+}
+
+AABBTreeBroadphase::~AABBTreeBroadphase()
+{
+	_evM->removeSubscriber<EntityDestroyedEvent>(this);
+	_evM->removeSubscriber<ComponentAssignedEvent<TransformComponent>>(this);
+	_evM->removeSubscriber<ComponentAssignedEvent<CollisionComponent>>(this);
+}
+
+void AABBTreeBroadphase::findPairs(std::vector<CollisionPair>& pairs)
+{
+	removeDestroyed();
+	checkStatic();
+	classifyPending();
+	refit();
+	rebuildStatic();
+
+	size_t count = _entities.size();
+	size_t jobCount = JobSystem::getChunkCount(count, GRAIN_SIZE);
+
+	if (_jobPairs.size() < jobCount)
+	{
+		_jobPairs.resize(jobCount);
+	}
+
+	_jobTests.assign(jobCount, 0);
+	_jobSkipped.assign(jobCount, 0);
+
+	// The trees are only read from here on
+	JobSystem::get().parallelFor(count, GRAIN_SIZE, [this](size_t begin, size_t end)
+	{
+		size_t job = begin / GRAIN_SIZE;
+
+		std::vector<CollisionPair>& jobPairs = _jobPairs[job];
+		uint32_t tests = 0;
+		uint32_t skipped = 0;
+
+		jobPairs.clear();
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			EntityHandle ent = _entities[i];
+			int32_t proxy = _proxies[i];
+			uint32_t group = _proxyGroups[i];
+
+			const DynamicGroup& own = _dynamicGroups[group];
+			const AABB& box = own.boxes[proxy];
+
+			// Every pair is reported from its lower group, and within a group
+			// from its lower proxy only
+			for (size_t index = group; index < _dynamicGroups.size(); ++index)
+			{
+				const DynamicGroup& other = _dynamicGroups[index];
+
+				if (!CollisionComponent::canCollide(own.layer, own.mask, other.layer, other.mask))
+				{
+					++skipped;
+
+					continue;
+				}
+
+				bool sameGroup = index == group;
+
+				other.tree.query(own.tree.getFatAABB(proxy), [&](int32_t otherProxy)
+				{
+					if (sameGroup && otherProxy <= proxy)
+						return true;
+
+					++tests;
+
+					if (box.overlaps(other.boxes[otherProxy]))
+					{
+						jobPairs.push_back(CollisionPair(ent, other.tree.getEntity(otherProxy)));
+					}
+
+					return true;
+				});
+			}
+
+			for (const auto& staticGroup : _staticGroups)
+			{
+				if (!CollisionComponent::canCollide(own.layer, own.mask, staticGroup.layer, staticGroup.mask))
+				{
+					++skipped;
+
+					continue;
+				}
+
+				// Static boxes are tight, the query only reports actual overlaps
+				staticGroup.tree.query(box, [&](const StaticBVH::Item& item)
+				{
+					++tests;
+
+					jobPairs.push_back(CollisionPair(ent, item.ent));
+
+					return true;
+				});
+			}
+		}
+
+		_jobTests[job] = tests;
+		_jobSkipped[job] = skipped;
+	});
+
+	// Merge in job order so the result does not depend on the scheduling
+	_stats.pairTests = 0;
+	_stats.groupsSkipped = 0;
+
+	for (size_t job = 0; job < jobCount; ++job)
+	{
+		pairs.insert(pairs.end(), _jobPairs[job].begin(), _jobPairs[job].end());
+		_stats.pairTests += _jobTests[job];
+		_stats.groupsSkipped += _jobSkipped[job];
+	}
+
+	_stats.entityCount = static_cast<uint32_t>(_entities.size() + _staticEntities.size());
+}
+
+void AABBTreeBroadphase::pushEntity(EntityHandle ent)
+{
+	if (isTracked(ent))
+	{
+		throw Broadphase_error(std::string("Duplicate entity '").append(std::to_string(ent)).append("' in AABB tree"));
+	}
+
+	_pending.push_back(ent);
+}
+
+void AABBTreeBroadphase::handleEvent(const EntityDestroyedEvent& ev)
+{
+	_entToRemove.push_back(ev.entHandle);
+}
+
+void AABBTreeBroadphase::handleEvent(const ComponentAssignedEvent<TransformComponent>& ev)
+{
+	pushEntity(ev.entHandle);
+}
+
+void AABBTreeBroadphase::handleEvent(const ComponentAssignedEvent<CollisionComponent>& ev)
+{
+	// Entities with a transform and no collider were dropped, or are still
+	// pending when the collider comes in the same frame
+	if (_enM->hasComponent<TransformComponent>(ev.entHandle) && !isTracked(ev.entHandle))
+	{
+		_pending.push_back(ev.entHandle);
+	}
+}
+
+bool AABBTreeBroadphase::isTracked(EntityHandle ent) const
+{
+	return std::find(_pending.begin(), _pending.end(), ent) != _pending.end() ||
+		std::find(_entities.begin(), _entities.end(), ent) != _entities.end() ||
+		std::find(_staticEntities.begin(), _staticEntities.end(), ent) != _staticEntities.end();
+}
+
+void AABBTreeBroadphase::queryColliders(const AABB& box, const ColliderCallback& callback) const
+{
+	bool running = true;
+
+	for (const auto& group : _dynamicGroups)
+	{
+		if (!running)
+			return;
+
+		group.tree.query(box, [&](int32_t proxy)
+		{
+			running = callback(group.tree.getEntity(proxy), group.boxes[proxy], group.layer);
+
+			return running;
+		});
+	}
+
+	for (const auto& group : _staticGroups)
+	{
+		if (!running)
+			return;
+
+		group.tree.query(box, [&](const StaticBVH::Item& item)
+		{
+			running = callback(item.ent, item.aabb, group.layer);
+
+			return running;
+		});
+	}
+}
+
+void AABBTreeBroadphase::rayColliders(const Ray& ray, const RayCallback& callback) const
+{
+	// The dynamic trees are followed first, their hits shorten the static casts
+	float maxDistance = ray.maxDistance;
+
+	for (const auto& group : _dynamicGroups)
+	{
+		if (maxDistance < 0.f)
+			return;
+
+		group.tree.rayCast(ray.origin, ray.direction, maxDistance, [&](int32_t proxy)
+		{
+			maxDistance = callback(group.tree.getEntity(proxy), group.boxes[proxy], group.layer);
+
+			return maxDistance;
+		});
+	}
+
+	for (const auto& group : _staticGroups)
+	{
+		if (maxDistance < 0.f)
+			return;
+
+		group.tree.rayCast(ray.origin, ray.direction, maxDistance, [&](const StaticBVH::Item& item, float)
+		{
+			maxDistance = callback(item.ent, item.aabb, group.layer);
+
+			return maxDistance;
+		});
+	}
+}
+
+void AABBTreeBroadphase::removeDestroyed()
+{
+	if (_entToRemove.empty())
+		return;
+
+	std::sort(_entToRemove.begin(), _entToRemove.end());
+
+	auto isDestroyed = [this](EntityHandle ent)
+	{
+		return std::binary_search(_entToRemove.begin(), _entToRemove.end(), ent);
+	};
+
+	_pending.erase(std::remove_if(_pending.begin(), _pending.end(), isDestroyed), _pending.end());
+
+	size_t staticCount = _staticEntities.size();
+
+	_staticEntities.erase(std::remove_if(_staticEntities.begin(), _staticEntities.end(), isDestroyed), _staticEntities.end());
+
+	if (_staticEntities.size() != staticCount)
+	{
+		_staticDirty = true;
+	}
+
+	size_t kept = 0;
+
+	for (size_t i = 0; i < _entities.size(); ++i)
+	{
+		if (isDestroyed(_entities[i]))
+		{
+			if (_proxies[i] != DynamicAABBTree::NULL_NODE)
+			{
+				_dynamicGroups[_proxyGroups[i]].tree.destroyProxy(_proxies[i]);
+			}
+
+			continue;
+		}
+
+		_entities[kept] = _entities[i];
+		_proxies[kept] = _proxies[i];
+		_proxyGroups[kept] = _proxyGroups[i];
+		++kept;
+	}
+
+	_entities.resize(kept);
+	_proxies.resize(kept);
+	_proxyGroups.resize(kept);
+
+	_entToRemove.clear();
+}
+
+void AABBTreeBroadphase::checkStatic()
+{
+	// Only a bit test per entity, cheap enough to do every update
+	size_t kept = 0;
+
+	for (auto ent : _staticEntities)
+	{
+		if (!_enM->hasComponent<CollisionComponent>(ent) || !_enM->getComponent<CollisionComponent>(ent)->isStatic())
+		{
+			_pending.push_back(ent);
+
+			continue;
+		}
+
+		_staticEntities[kept++] = ent;
+	}
+
+	if (kept != _staticEntities.size())
+	{
+		_staticEntities.resize(kept);
+		_staticDirty = true;
+	}
+}
+
+void AABBTreeBroadphase::classifyPending()
+{
+	// Entities without a collider are dropped, assigning one brings them back
+	for (auto ent : _pending)
+	{
+		if (!_enM->hasComponent<CollisionComponent>(ent))
+		{
+			continue;
+		}
+
+		if (_enM->getComponent<CollisionComponent>(ent)->isStatic())
+		{
+			_staticEntities.push_back(ent);
+			_staticDirty = true;
+		}
+		else
+		{
+			_entities.push_back(ent);
+			_proxies.push_back(DynamicAABBTree::NULL_NODE);
+			_proxyGroups.push_back(0);
+		}
+	}
+
+	_pending.clear();
+}
+
+void AABBTreeBroadphase::refit()
+{
+	size_t kept = 0;
+
+	for (size_t i = 0; i < _entities.size(); ++i)
+	{
+		EntityHandle ent = _entities[i];
+		int32_t proxy = _proxies[i];
+
+		// Collider detached, wait for a new one
+		if (!_enM->hasComponent<CollisionComponent>(ent))
+		{
+			if (proxy != DynamicAABBTree::NULL_NODE)
+			{
+				_dynamicGroups[_proxyGroups[i]].tree.destroyProxy(proxy);
+			}
+
+			_pending.push_back(ent);
+
+			continue;
+		}
+
+		CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+
+		glm::vec3 position = _enM->getComponent<TransformComponent>(ent)->position;
+
+		AABB box = AABB::fromCenter(position, collider->getExtent());
+
+		if (collider->isFast())
+		{
+			_fastEntities.push_back(ent);
+		}
+
+		// Layers may change at runtime, the proxy then moves to the tree of the new group
+		uint32_t group = getDynamicGroup(collider->getLayer(), collider->getMask());
+
+		if (proxy != DynamicAABBTree::NULL_NODE && group != _proxyGroups[i])
+		{
+			_dynamicGroups[_proxyGroups[i]].tree.destroyProxy(proxy);
+			proxy = DynamicAABBTree::NULL_NODE;
+		}
+
+		DynamicGroup& dynamicGroup = _dynamicGroups[group];
+
+		if (proxy == DynamicAABBTree::NULL_NODE)
+		{
+			proxy = dynamicGroup.tree.createProxy(box, ent);
+		}
+		else
+		{
+			// Stretch the fat box along the movement since the last frame
+			glm::vec3 displacement = box.getCenter() - dynamicGroup.boxes[proxy].getCenter();
+
+			dynamicGroup.tree.moveProxy(proxy, box, displacement);
+		}
+
+		if (static_cast<size_t>(proxy) >= dynamicGroup.boxes.size())
+		{
+			dynamicGroup.boxes.resize(proxy + 1);
+		}
+
+		dynamicGroup.boxes[proxy] = box;
+
+		_entities[kept] = ent;
+		_proxies[kept] = proxy;
+		_proxyGroups[kept] = group;
+		++kept;
+	}
+
+	_entities.resize(kept);
+	_proxies.resize(kept);
+	_proxyGroups.resize(kept);
+}
+
+void AABBTreeBroadphase::rebuildStatic()
+{
+	if (!_staticDirty)
+		return;
+
+	// Ordered so the groups, and with them the pairs, come in a fixed order
+	std::map<std::pair<uint32_t, uint32_t>, std::vector<StaticBVH::Item>> groups;
+
+	for (auto ent : _staticEntities)
+	{
+		CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+
+		glm::vec3 position = _enM->getComponent<TransformComponent>(ent)->position;
+
+		auto key = std::make_pair(collider->getLayer(), collider->getMask());
+
+		groups[key].push_back(StaticBVH::Item{ AABB::fromCenter(position, collider->getExtent()), ent });
+	}
+
+	_staticGroups.clear();
+	_staticGroups.reserve(groups.size());
+
+	for (auto& it : groups)
+	{
+		_staticGroups.push_back(StaticGroup{ it.first.first, it.first.second, StaticBVH{} });
+		_staticGroups.back().tree.build(std::move(it.second));
+	}
+
+	_staticDirty = false;
+}
+
+uint32_t AABBTreeBroadphase::getDynamicGroup(uint32_t layer, uint32_t mask)
+{
+	// There are only a handful of groups, a scan beats a map
+	for (size_t i = 0; i < _dynamicGroups.size(); ++i)
+	{
+		if (_dynamicGroups[i].layer == layer && _dynamicGroups[i].mask == mask)
+			return static_cast<uint32_t>(i);
+	}
+
+	_dynamicGroups.push_back(DynamicGroup{ layer, mask, DynamicAABBTree{}, std::vector<AABB>{} });
+
+	return static_cast<uint32_t>(_dynamicGroups.size() - 1);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file	AABBTreeBroadphase.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Broadphase based on a dynamic AABB tree
+ */
+
+#pragma once
+
+#include "Broadphase.h"
+#include "DynamicAABBTree.h"
+#include "StaticBVH.h"
+#include "EntityManager.h"
+#include "TransformComponent.h"
+#include "CollisionComponent.h"
+#include "EntityDestroyedEvent.h"
+#include "ComponentAssignedEvent.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Broadphase keeping all colliders in a dynamic AABB tree.
+ *
+ * Unlike the quadtree and the grid this works in all three dimensions, so
+ * colliders separated vertically never make it into a pair.
+ *
+ * Static colliders are kept apart in a StaticBVH that is only rebuilt when
+ * static colliders come or go. They are never refitted and never tested
+ * against each other, only against the dynamic colliders.
+ *
+ * Static colliders are grouped by layer and mask with one StaticBVH per
+ * group, so a dynamic collider skips the groups it can not collide with
+ * without looking at a single box.
+ *
+ * Dynamic colliders are grouped the same way with one DynamicAABBTree per
+ * group. A collider only queries the trees of the groups it can collide
+ * with, so no pair is ever tested by layer.
+ */
+class AABBTreeBroadphase : public Broadphase, public Subscriber<EntityDestroyedEvent>, public Subscriber<ComponentAssignedEvent<TransformComponent>>, public Subscriber<ComponentAssignedEvent<CollisionComponent>>
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param entMan Pointer to the entity manager.
+	 * @param evMan Pointer to the event manager.
+	 */
+	AABBTreeBroadphase(EntityManager* entMan, EventManager* evMan);
+
+	/**
+	 * @brief Destructor
+	 */
+	~AABBTreeBroadphase();
+
+	/**
+	 * @brief Refits the tree and collects the colliding pairs.
+	 * @param pairs Vector to append the colliding pairs to.
+	 */
+	void findPairs(std::vector<CollisionPair>& pairs) override;
+
+	/**
+	 * @brief Starts tracking an entity.
+	 * @param ent Handle to entity.
+	 */
+	void pushEntity(EntityHandle ent) override;
+
+	/**
+	 * @brief Gets the name of the broadphase
+	 * @return "AABB tree"
+	 */
+	const char* getName() const override { return "AABB tree"; }
+
+	/**
+	 * @brief Destroyed entity handler
+	 * @param ev The recieved event to be handled
+	 */
+	void handleEvent(const EntityDestroyedEvent& ev) override;
+
+	/**
+	 * @brief TransformComponent assignment handler
+	 * @param ev The recieved event to be handled
+	 */
+	void handleEvent(const ComponentAssignedEvent<TransformComponent>& ev) override;
+
+	/**
+	 * @brief CollisionComponent assignment handler, picks up entities that
+	 * got their collider after they were dropped for having none
+	 * @param ev The recieved event to be handled
+	 */
+	void handleEvent(const ComponentAssignedEvent<CollisionComponent>& ev) override;
+
+	/**
+	 * @brief Forces a rebuild of the static trees on the next update, for
+	 * when static colliders have been moved or changed layers anyway.
+	 */
+	void invalidateStatic() { _staticDirty = true; }
+
+protected:
+	/**
+	 * @brief Calls callback with the colliders in all trees overlapping box.
+	 * @param box The box.
+	 * @param callback Callback.
+	 */
+	void queryColliders(const AABB& box, const ColliderCallback& callback) const override;
+
+	/**
+	 * @brief Follows the ray through all trees.
+	 * @param ray The ray.
+	 * @param callback Callback.
+	 */
+	void rayColliders(const Ray& ray, const RayCallback& callback) const override;
+
+private:
+
+	/**
+	 * @brief Drops destroyed entities from all lists.
+	 */
+	void removeDestroyed();
+
+	/**
+	 * @brief Moves static entities whose collider was detached or made
+	 * dynamic back to the pending list, and marks the static tree dirty.
+	 */
+	void checkStatic();
+
+	/**
+	 * @brief Sorts entities that got a collider into the static or dynamic
+	 * list. Entities without one, like cameras and lights, are dropped.
+	 */
+	void classifyPending();
+
+	/**
+	 * @brief Checks if an entity is pending or in either list.
+	 * @param ent Handle to entity.
+	 * @return True if the entity is tracked.
+	 */
+	bool isTracked(EntityHandle ent) const;
+
+	/**
+	 * @brief Moves the proxies of the dynamic colliders.
+	 */
+	void refit();
+
+	/**
+	 * @brief Rebuilds the static tree if static colliders have changed.
+	 */
+	void rebuildStatic();
+
+	/**
+	 * @brief Gets the group of dynamic colliders with the given layers and
+	 * mask, adding it if there is none.
+	 * @param layer Collision layers.
+	 * @param mask Collision mask.
+	 * @return Index of the group.
+	 */
+	uint32_t getDynamicGroup(uint32_t layer, uint32_t mask);
+
+	/**
+	 * @brief Number of colliders per job.
+	 */
+	static constexpr size_t GRAIN_SIZE{ 128 };
+
+	/**
+	 * @brief Dynamic colliders sharing layer and mask.
+	 */
+	struct DynamicGroup
+	{
+		/**
+		 * @brief Collision layers.
+		 */
+		uint32_t layer;
+
+		/**
+		 * @brief Collision mask.
+		 */
+		uint32_t mask;
+
+		/**
+		 * @brief Tree of the colliders.
+		 */
+		DynamicAABBTree tree;
+
+		/**
+		 * @brief Tight box of every proxy. Indexed by proxy.
+		 */
+		std::vector<AABB> boxes;
+	};
+
+	/**
+	 * @brief Static colliders sharing layer and mask.
+	 */
+	struct StaticGroup
+	{
+		/**
+		 * @brief Collision layers.
+		 */
+		uint32_t layer;
+
+		/**
+		 * @brief Collision mask.
+		 */
+		uint32_t mask;
+
+		/**
+		 * @brief Tree of the colliders.
+		 */
+		StaticBVH tree;
+	};
+
+	/**
+	 * @brief Dynamic colliders grouped by layer and mask, in the order the
+	 * groups first appeared.
+	 */
+	std::vector<DynamicGroup> _dynamicGroups{};
+
+	/**
+	 * @brief Static colliders grouped by layer and mask.
+	 */
+	std::vector<StaticGroup> _staticGroups{};
+
+	/**
+	 * @brief Whether the static tree has to be rebuilt.
+	 */
+	bool _staticDirty{ false };
+
+	/**
+	 * @brief Entities added since the last update.
+	 */
+	std::vector<EntityHandle> _pending{};
+
+	/**
+	 * @brief Entities with a dynamic collider.
+	 */
+	std::vector<EntityHandle> _entities{};
+
+	/**
+	 * @brief Proxy of every dynamic collider. Indexed like _entities.
+	 */
+	std::vector<int32_t> _proxies{};
+
+	/**
+	 * @brief Group of every dynamic collider. Indexed like _entities.
+	 */
+	std::vector<uint32_t> _proxyGroups{};
+
+	/**
+	 * @brief Entities with a static collider.
+	 */
+	std::vector<EntityHandle> _staticEntities{};
+
+	/**
+	 * @brief Entities destroyed since the last update.
+	 */
+	std::vector<EntityHandle> _entToRemove{};
+
+	/**
+	 * @brief Pair buffers of every job, merged in order once all jobs are done.
+	 */
+	std::vector<std::vector<CollisionPair>> _jobPairs{};
+
+	/**
+	 * @brief Overlap test counters of every job.
+	 */
+	std::vector<uint32_t> _jobTests{};
+
+	/**
+	 * @brief Counters of every job for the groups skipped by layer.
+	 */
+	std::vector<uint32_t> _jobSkipped{};
+};
@@ -1,6 +1,6 @@
 /**
  * @file	AssetManager.cpp
- * @Author	Kevin Kjelln
+ * @Author	Kevin Kjellén
  * @date	2017-05-21
  * @brief	AssetManager
  */
@@ -1,6 +1,6 @@
 /**
  * @file	AssetManager.h
- * @Author	Kevin Kjelln
+ * @Author	Kevin Kjellén
  * @date	2017-05-20
  * @brief	Asset Manager Interface
  */
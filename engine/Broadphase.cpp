@@ -0,0 +1,438 @@
+/**
+ * @file	Broadphase.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Common interface for the collision broadphase structures
+ */
+
+#include "Broadphase.h"
+#include "CollisionBeginEvent.h"
+#include "CollisionContactsEvent.h"
+#include "CollisionEndEvent.h"
+#include "CollisionStayEvent.h"
+#include "JobSystem.h"
+#include "Timer.h"
+#include "TransformComponent.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr float Broadphase::NEAREST_START_RADIUS;
+constexpr size_t Broadphase::QUERY_GRAIN_SIZE;
+
+Broadphase::Broadphase(EntityManager* entMan, EventManager* evMan) :
+	_enM{ entMan },
+	_evM{ evMan },
+	_narrowphase{ new Narrowphase(entMan) }
+{
+}
+
+Broadphase::~Broadphase()
+{
+	delete _narrowphase;
+}
+
+void Broadphase::update()
+{
+	_pairs.clear();
+	_fastEntities.clear();
+
+	Timer timer{};
+
+	findPairs(_pairs);
+
+	_stats.narrowRejected = _narrowphase->process(_pairs);
+
+	sweepFast(_pairs);
+
+	_stats.updateTime = timer.reset();
+
+	updateContacts();
+
+	const std::vector<CollisionContact>& contacts = _narrowphase->getContacts();
+
+	if (!contacts.empty())
+	{
+		_evM->postEvent(CollisionContactsEvent(contacts.data(), contacts.size()));
+	}
+}
+
+void Broadphase::updateContacts()
+{
+	++_generation;
+
+	_begun.clear();
+	_staying.clear();
+	_ended.clear();
+
+	// Pairs found twice in the same update only count once
+	for (auto& pair : _pairs)
+	{
+		auto result = _contacts.emplace(getKey(pair), Contact{ pair, _generation });
+
+		if (result.second)
+		{
+			_begun.push_back(pair);
+		}
+		else if (result.first->second.generation != _generation)
+		{
+			result.first->second.generation = _generation;
+			_staying.push_back(result.first->second.pair);
+		}
+	}
+
+	for (auto it = _contacts.begin(); it != _contacts.end();)
+	{
+		if (it->second.generation != _generation)
+		{
+			_ended.push_back(std::make_pair(it->first, it->second.pair));
+			it = _contacts.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// The map has no order, sort so the events come in the same order every run
+	std::sort(_ended.begin(), _ended.end(), [](const std::pair<uint64_t, CollisionPair>& a, const std::pair<uint64_t, CollisionPair>& b)
+	{
+		return a.first < b.first;
+	});
+
+	_stats.pairsFound = static_cast<uint32_t>(_contacts.size());
+	_stats.pairsBegun = static_cast<uint32_t>(_begun.size());
+	_stats.pairsEnded = static_cast<uint32_t>(_ended.size());
+
+	for (auto& ended : _ended)
+	{
+		_evM->postEvent(CollisionEndEvent(ended.second.first, ended.second.second));
+	}
+
+	for (auto& pair : _begun)
+	{
+		_evM->postEvent(CollisionBeginEvent(pair.first, pair.second));
+	}
+
+	if (_stayEvents && !_staying.empty())
+	{
+		_evM->postEvent(CollisionStayEvent(_staying.data(), _staying.size()));
+	}
+}
+
+void Broadphase::sweepFast(std::vector<CollisionPair>& pairs)
+{
+	_stats.sweptPairs = 0;
+	_nextSweepStarts.clear();
+
+	// Sorted so the pairs come in the same order every run
+	std::sort(_fastEntities.begin(), _fastEntities.end());
+
+	for (auto ent : _fastEntities)
+	{
+		CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+
+		TransformComponent* transform = _enM->getComponent<TransformComponent>(ent);
+
+		glm::vec3 end = transform->position;
+		glm::vec3 extent = collider->getExtent();
+
+		_nextSweepStarts[ent] = end;
+
+		auto it = _sweepStarts.find(ent);
+
+		if (it == _sweepStarts.end())
+			continue;
+
+		glm::vec3 start = it->second;
+		glm::vec3 motion = end - start;
+
+		// Moving less than its own size it can not skip past anything
+		if (glm::all(glm::lessThanEqual(glm::abs(motion), extent)))
+			continue;
+
+		AABB from = AABB::fromCenter(start, extent);
+		AABB to = AABB::fromCenter(end, extent);
+
+		// Only the first hit along the motion is reached
+		float firstTime = 2.f;
+
+		_sweepHits.clear();
+
+		// Other colliders are taken to be at their end positions
+		queryColliders(from.merge(to), [&](EntityHandle other, const AABB& box, uint32_t layer)
+		{
+			if (other == ent)
+				return true;
+
+			// A structure may still hold an entity whose collider was just detached
+			if (!_enM->hasComponent<CollisionComponent>(other))
+				return true;
+
+			if (!CollisionComponent::canCollide(collider->getLayer(), collider->getMask(), layer, _enM->getComponent<CollisionComponent>(other)->getMask()))
+				return true;
+
+			float time;
+
+			if (!box.intersectSweep(from, motion, time))
+				return true;
+
+			// Touching at the start, like after being stopped the last update,
+			// and moving away. Nothing is passed through.
+			if (time == 0.f && glm::dot(motion, box.getCenter() - start) <= 0.f)
+				return true;
+
+			firstTime = std::min(firstTime, time);
+
+			// Pairs overlapping at the end have already been found
+			if (!box.overlaps(to))
+			{
+				_sweepHits.push_back(std::make_pair(time, other));
+			}
+
+			return true;
+		});
+
+		bool stopped = false;
+
+		for (auto& hit : _sweepHits)
+		{
+			if (hit.first == firstTime)
+			{
+				pairs.push_back(CollisionPair(ent, hit.second));
+				++_stats.sweptPairs;
+				stopped = true;
+			}
+		}
+
+		// Stop the collider where it first touches what it would have passed
+		// through. If it first reaches a collider it overlaps at the end, the
+		// pair has contacts already and the collider is left where it is.
+		if (stopped)
+		{
+			glm::vec3 impact = start + motion * firstTime;
+
+			transform->position = impact;
+			_nextSweepStarts[ent] = impact;
+		}
+	}
+
+	std::swap(_sweepStarts, _nextSweepStarts);
+}
+
+uint64_t Broadphase::getKey(const CollisionPair& pair)
+{
+	uint64_t low = std::min(pair.first, pair.second);
+	uint64_t high = std::max(pair.first, pair.second);
+
+	return (low << 32) | high;
+}
+
+size_t Broadphase::queryAABB(const AABB& box, EntityHandle* out, size_t capacity, uint32_t mask) const
+{
+	size_t count = 0;
+
+	queryColliders(box, [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+	{
+		if ((layer & mask) && collider.overlaps(box))
+		{
+			if (count < capacity)
+			{
+				out[count] = ent;
+			}
+
+			++count;
+		}
+
+		return true;
+	});
+
+	return count;
+}
+
+size_t Broadphase::queryRadius(glm::vec3 center, float radius, EntityHandle* out, size_t capacity, uint32_t mask) const
+{
+	size_t count = 0;
+	float radiusSquared = radius * radius;
+
+	queryColliders(AABB::fromCenter(center, glm::vec3{ radius }), [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+	{
+		if ((layer & mask) && collider.getDistanceSquared(center) <= radiusSquared)
+		{
+			if (count < capacity)
+			{
+				out[count] = ent;
+			}
+
+			++count;
+		}
+
+		return true;
+	});
+
+	return count;
+}
+
+bool Broadphase::raycast(const Ray& ray, SpatialHit& hit, uint32_t mask) const
+{
+	glm::vec3 invDirection = 1.f / ray.direction;
+
+	hit = SpatialHit{ INVALID_ENTITY, ray.maxDistance };
+
+	rayColliders(ray, [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+	{
+		float distance;
+
+		if ((layer & mask) && collider.intersectRay(ray.origin, invDirection, hit.distance, distance))
+		{
+			// Ties go to the lower handle so the result does not depend on the structure
+			if (hit.ent == INVALID_ENTITY || distance < hit.distance || (distance == hit.distance && ent < hit.ent))
+			{
+				hit = SpatialHit{ ent, distance };
+			}
+		}
+
+		return hit.distance;
+	});
+
+	return hit.ent != INVALID_ENTITY;
+}
+
+size_t Broadphase::raycastAll(const Ray& ray, SpatialHit* out, size_t capacity, uint32_t mask) const
+{
+	if (capacity == 0)
+		return 0;
+
+	glm::vec3 invDirection = 1.f / ray.direction;
+
+	size_t count = 0;
+
+	rayColliders(ray, [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+	{
+		float distance;
+
+		if ((layer & mask) && collider.intersectRay(ray.origin, invDirection, ray.maxDistance, distance))
+		{
+			count = insertHit(out, count, capacity, SpatialHit{ ent, distance });
+		}
+
+		// Once the buffer is full nothing behind the furthest hit can get in
+		return count == capacity ? out[count - 1].distance : ray.maxDistance;
+	});
+
+	return count;
+}
+
+size_t Broadphase::queryNearest(glm::vec3 point, size_t k, float maxDistance, SpatialHit* out, uint32_t mask) const
+{
+	if (k == 0)
+		return 0;
+
+	float radius = std::min(NEAREST_START_RADIUS, maxDistance);
+
+	while (true)
+	{
+		size_t count = 0;
+		float radiusSquared = radius * radius;
+
+		queryColliders(AABB::fromCenter(point, glm::vec3{ radius }), [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+		{
+			float distanceSquared = collider.getDistanceSquared(point);
+
+			if ((layer & mask) && distanceSquared <= radiusSquared)
+			{
+				count = insertHit(out, count, k, SpatialHit{ ent, std::sqrt(distanceSquared) });
+			}
+
+			return true;
+		});
+
+		// Everything within radius has been seen, so k hits inside it are the k nearest
+		if (count == k || radius >= maxDistance)
+			return count;
+
+		radius = std::min(radius * 2.f, maxDistance);
+	}
+}
+
+void Broadphase::queryAABBBatch(const AABB* boxes, size_t count, size_t capacity, EntityHandle* out, uint32_t* hitCounts, uint32_t mask) const
+{
+	JobSystem::get().parallelFor(count, QUERY_GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			hitCounts[i] = static_cast<uint32_t>(queryAABB(boxes[i], out + i * capacity, capacity, mask));
+		}
+	});
+}
+
+void Broadphase::queryRadiusBatch(const glm::vec3* centers, const float* radii, size_t count, size_t capacity, EntityHandle* out, uint32_t* hitCounts, uint32_t mask) const
+{
+	JobSystem::get().parallelFor(count, QUERY_GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			hitCounts[i] = static_cast<uint32_t>(queryRadius(centers[i], radii[i], out + i * capacity, capacity, mask));
+		}
+	});
+}
+
+void Broadphase::raycastBatch(const Ray* rays, size_t count, SpatialHit* out, uint32_t mask) const
+{
+	JobSystem::get().parallelFor(count, QUERY_GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			raycast(rays[i], out[i], mask);
+		}
+	});
+}
+
+void Broadphase::queryNearestBatch(const glm::vec3* points, size_t count, size_t k, float maxDistance, SpatialHit* out, uint32_t* hitCounts, uint32_t mask) const
+{
+	JobSystem::get().parallelFor(count, QUERY_GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			hitCounts[i] = static_cast<uint32_t>(queryNearest(points[i], k, maxDistance, out + i * k, mask));
+		}
+	});
+}
+
+void Broadphase::rayColliders(const Ray& ray, const RayCallback& callback) const
+{
+	glm::vec3 end = ray.origin + ray.direction * ray.maxDistance;
+
+	AABB bounds{ glm::min(ray.origin, end), glm::max(ray.origin, end) };
+
+	queryColliders(bounds, [&](EntityHandle ent, const AABB& collider, uint32_t layer)
+	{
+		return callback(ent, collider, layer) >= 0.f;
+	});
+}
+
+size_t Broadphase::insertHit(SpatialHit* out, size_t count, size_t capacity, SpatialHit hit)
+{
+	// Ties go to the lower handle so the result does not depend on the structure
+	size_t position = count;
+
+	while (position > 0 && (hit.distance < out[position - 1].distance ||
+		(hit.distance == out[position - 1].distance && hit.ent < out[position - 1].ent)))
+	{
+		--position;
+	}
+
+	if (position >= capacity)
+		return count;
+
+	size_t last = std::min(count, capacity - 1);
+
+	for (size_t i = last; i > position; --i)
+	{
+		out[i] = out[i - 1];
+	}
+
+	out[position] = hit;
+
+	return std::min(count + 1, capacity);
+}
@@ -0,0 +1,418 @@
+/**
+ * @file	Broadphase.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Common interface for the collision broadphase structures
+ */
+
+#pragma once
+
+#include "EntityManager.h"
+#include "CollisionComponent.h"
+#include "AABB.h"
+#include "SpatialQuery.h"
+#include "Narrowphase.h"
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+
+/**
+ * @brief Broadphase error class
+ */
+class Broadphase_error : public std::logic_error {
+	using std::logic_error::logic_error;
+};
+
+/**
+ * @brief A pair of entities whose colliders overlap.
+ */
+typedef std::pair<EntityHandle, EntityHandle> CollisionPair;
+
+/**
+ * @brief Statistics from the last broadphase update.
+ */
+struct BroadphaseStats
+{
+	/**
+	 * @brief Time spent updating the structure and finding pairs (in seconds).
+	 */
+	float updateTime{ 0.f };
+
+	/**
+	 * @brief Number of entities handled by the broadphase.
+	 */
+	uint32_t entityCount{ 0 };
+
+	/**
+	 * @brief Number of overlap tests done.
+	 */
+	uint32_t pairTests{ 0 };
+
+	/**
+	 * @brief Number of times a whole group of colliders was skipped since its layers can not collide.
+	 */
+	uint32_t groupsSkipped{ 0 };
+
+	/**
+	 * @brief Number of pairs only found by sweeping fast colliders.
+	 */
+	uint32_t sweptPairs{ 0 };
+
+	/**
+	 * @brief Number of pairs whose boxes overlapped but whose shapes did not touch.
+	 */
+	uint32_t narrowRejected{ 0 };
+
+	/**
+	 * @brief Number of overlapping pairs found.
+	 */
+	uint32_t pairsFound{ 0 };
+
+	/**
+	 * @brief Number of pairs that started to overlap.
+	 */
+	uint32_t pairsBegun{ 0 };
+
+	/**
+	 * @brief Number of pairs that stopped overlapping.
+	 */
+	uint32_t pairsEnded{ 0 };
+};
+
+/**
+ * @brief Base class for the structures finding potentially colliding entities.
+ *
+ * Implementations keep track of the entities themselves and are asked once
+ * per frame for all overlapping pairs. The base class takes care of timing
+ * and keeps a cache of the pairs from frame to frame. Events are only posted
+ * when a pair starts (CollisionBeginEvent) or stops (CollisionEndEvent)
+ * overlapping, pairs that keep overlapping cost nothing unless the batched
+ * CollisionStayEvent is enabled.
+ *
+ * Overlapping boxes are passed to the Narrowphase, which drops the pairs
+ * whose shapes do not touch and computes contacts for the rest.
+ *
+ * Colliders flagged as fast are swept from where they were at the last
+ * update, so they can not pass through thin colliders at low frame rates.
+ * A fast collider that would have passed through another is moved back to
+ * where it first touches it.
+ *
+ * The structure can also be queried for the colliders in a box or sphere,
+ * along a ray or nearest to a point. Queries see the structure as of the
+ * last update, write to buffers owned by the caller and never allocate.
+ * Only colliders whose layer is in the mask of the query are reported.
+ */
+class Broadphase
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param entMan Pointer to the entity manager.
+	 * @param evMan Pointer to the event manager.
+	 */
+	Broadphase(EntityManager* entMan, EventManager* evMan);
+
+	/**
+	 * @brief Destructor.
+	 */
+	virtual ~Broadphase();
+
+	/**
+	 * @brief Updates the structure and posts events for all pairs that started
+	 * or stopped overlapping since the last update, followed by one
+	 * CollisionContactsEvent with the contacts of all touching pairs.
+	 */
+	void update();
+
+	/**
+	 * @brief Updates the structure and appends all overlapping pairs to pairs.
+	 * @param pairs Vector to append the pairs to.
+	 */
+	virtual void findPairs(std::vector<CollisionPair>& pairs) = 0;
+
+	/**
+	 * @brief Starts tracking an entity.
+	 * @param ent Handle to entity
+	 */
+	virtual void pushEntity(EntityHandle ent) = 0;
+
+	/**
+	 * @brief Gets the name of the broadphase, for reports.
+	 * @return Name of the broadphase.
+	 */
+	virtual const char* getName() const = 0;
+
+	/**
+	 * @brief Gets the statistics of the last update.
+	 * @return Statistics.
+	 */
+	const BroadphaseStats& getStats() const { return _stats; }
+
+	/**
+	 * @brief Sets whether a CollisionStayEvent should be posted every update.
+	 * @param value True to post.
+	 */
+	void setStayEventsEnabled(bool value) { _stayEvents = value; }
+
+	/**
+	 * @brief Gets the contacts of the last update, in the order the pairs
+	 * were found. Pairs only found by sweeping fast colliders have none.
+	 * @return Ref to contacts.
+	 */
+	const std::vector<CollisionContact>& getContacts() const { return _narrowphase->getContacts(); }
+
+	/**
+	 * @brief Finds the colliders overlapping a box.
+	 * @param box The box.
+	 * @param out Buffer for the found entities.
+	 * @param capacity Size of out.
+	 * @param mask Layers to look for.
+	 * @return Number of colliders found. May exceed capacity, only the first
+	 * capacity are written.
+	 */
+	size_t queryAABB(const AABB& box, EntityHandle* out, size_t capacity, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Finds the colliders within radius of a point.
+	 * @param center The point.
+	 * @param radius Radius of the sphere.
+	 * @param out Buffer for the found entities.
+	 * @param capacity Size of out.
+	 * @param mask Layers to look for.
+	 * @return Number of colliders found. May exceed capacity, only the first
+	 * capacity are written.
+	 */
+	size_t queryRadius(glm::vec3 center, float radius, EntityHandle* out, size_t capacity, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Finds the first collider hit by a ray.
+	 * @param ray The ray.
+	 * @param hit Set to the hit, or to INVALID_ENTITY if nothing was hit.
+	 * @param mask Layers to look for.
+	 * @return True if anything was hit.
+	 */
+	bool raycast(const Ray& ray, SpatialHit& hit, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Finds all colliders hit by a ray, nearest first.
+	 * @param ray The ray.
+	 * @param out Buffer for the hits.
+	 * @param capacity Size of out. Only the nearest hits are kept.
+	 * @param mask Layers to look for.
+	 * @return Number of hits written.
+	 */
+	size_t raycastAll(const Ray& ray, SpatialHit* out, size_t capacity, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Finds the k colliders nearest to a point, nearest first.
+	 * @param point The point.
+	 * @param k Number of colliders to find, out must have room for k hits.
+	 * @param maxDistance Colliders further away are ignored.
+	 * @param out Buffer for the hits.
+	 * @param mask Layers to look for.
+	 * @return Number of hits written, less than k if not enough were in range.
+	 */
+	size_t queryNearest(glm::vec3 point, size_t k, float maxDistance, SpatialHit* out, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Runs many box queries spread over the jobs.
+	 * @param boxes The boxes.
+	 * @param count Number of queries.
+	 * @param capacity Room per query in out.
+	 * @param out Buffer of count * capacity entities, query i writes from i * capacity.
+	 * @param hitCounts Buffer of count counters, set like the return value of queryAABB.
+	 * @param mask Layers to look for.
+	 */
+	void queryAABBBatch(const AABB* boxes, size_t count, size_t capacity, EntityHandle* out, uint32_t* hitCounts, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Runs many radius queries spread over the jobs.
+	 * @param centers The points.
+	 * @param radii Radius of every query.
+	 * @param count Number of queries.
+	 * @param capacity Room per query in out.
+	 * @param out Buffer of count * capacity entities, query i writes from i * capacity.
+	 * @param hitCounts Buffer of count counters, set like the return value of queryRadius.
+	 * @param mask Layers to look for.
+	 */
+	void queryRadiusBatch(const glm::vec3* centers, const float* radii, size_t count, size_t capacity, EntityHandle* out, uint32_t* hitCounts, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Runs many first hit ray casts spread over the jobs.
+	 * @param rays The rays.
+	 * @param count Number of rays.
+	 * @param out Buffer of count hits, INVALID_ENTITY for the rays that hit nothing.
+	 * @param mask Layers to look for.
+	 */
+	void raycastBatch(const Ray* rays, size_t count, SpatialHit* out, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Runs many nearest neighbour queries spread over the jobs.
+	 * @param points The points.
+	 * @param count Number of queries.
+	 * @param k Number of colliders to find per query.
+	 * @param maxDistance Colliders further away are ignored.
+	 * @param out Buffer of count * k hits, query i writes from i * k.
+	 * @param hitCounts Buffer of count counters, set like the return value of queryNearest.
+	 * @param mask Layers to look for.
+	 */
+	void queryNearestBatch(const glm::vec3* points, size_t count, size_t k, float maxDistance, SpatialHit* out, uint32_t* hitCounts, uint32_t mask = LAYER_ALL) const;
+
+	/**
+	 * @brief Radius the nearest neighbour search starts with, doubled until
+	 * enough colliders are found.
+	 */
+	static constexpr float NEAREST_START_RADIUS{ 4.f };
+
+protected:
+	/**
+	 * @brief Calls callback with every collider that may overlap box, as of
+	 * the last update. Must only read, queries may run on several jobs.
+	 * @param box The box.
+	 * @param callback Callback.
+	 */
+	virtual void queryColliders(const AABB& box, const ColliderCallback& callback) const = 0;
+
+	/**
+	 * @brief Calls callback with every collider that may be hit by a ray.
+	 * Queries the bounds of the ray unless overridden by a structure that
+	 * can follow the ray. Must only read, queries may run on several jobs.
+	 * @param ray The ray.
+	 * @param callback Callback.
+	 */
+	virtual void rayColliders(const Ray& ray, const RayCallback& callback) const;
+
+	/**
+	 * @brief Pointer to the scenes' entityManager
+	 */
+	EntityManager* _enM;
+
+	/**
+	 * @brief Pointer to the scenes' eventManager
+	 */
+	EventManager* _evM;
+
+	/**
+	 * @brief Statistics of the last update. Filled in by the implementations.
+	 */
+	BroadphaseStats _stats{};
+
+	/**
+	 * @brief Fast colliders of this update. Filled in by the implementations
+	 * while finding pairs.
+	 */
+	std::vector<EntityHandle> _fastEntities{};
+
+private:
+	/**
+	 * @brief A pair in the cache.
+	 */
+	struct Contact
+	{
+		/**
+		 * @brief The pair, in the order it was first found.
+		 */
+		CollisionPair pair;
+
+		/**
+		 * @brief Last update the pair was found in.
+		 */
+		uint32_t generation;
+	};
+
+	/**
+	 * @brief Updates the cache with the pairs of this update and posts the events.
+	 */
+	void updateContacts();
+
+	/**
+	 * @brief Sweeps the fast colliders from their last positions, appends
+	 * the pairs of the first colliders they hit on the way and moves them
+	 * back to the time of impact.
+	 * @param pairs Vector to append the pairs to.
+	 */
+	void sweepFast(std::vector<CollisionPair>& pairs);
+
+	/**
+	 * @brief Gets the cache key of a pair, the same for both orders.
+	 * @param pair The pair.
+	 * @return Key.
+	 */
+	static uint64_t getKey(const CollisionPair& pair);
+
+	/**
+	 * @brief Inserts a hit into a buffer sorted by distance, dropping the
+	 * furthest hit if the buffer is full.
+	 * @param out The buffer.
+	 * @param count Number of hits in out.
+	 * @param capacity Size of out.
+	 * @param hit The hit.
+	 * @return New number of hits in out.
+	 */
+	static size_t insertHit(SpatialHit* out, size_t count, size_t capacity, SpatialHit hit);
+
+	/**
+	 * @brief Number of queries per job in the batched queries.
+	 */
+	static constexpr size_t QUERY_GRAIN_SIZE{ 64 };
+
+	/**
+	 * @brief Shape tests of the overlapping pairs.
+	 */
+	Narrowphase* _narrowphase;
+
+	/**
+	 * @brief Pair buffer reused between updates.
+	 */
+	std::vector<CollisionPair> _pairs{};
+
+	/**
+	 * @brief Pairs overlapping as of the last update.
+	 */
+	std::unordered_map<uint64_t, Contact> _contacts{};
+
+	/**
+	 * @brief Number of the current update.
+	 */
+	uint32_t _generation{ 0 };
+
+	/**
+	 * @brief Position of every fast collider at the last update.
+	 */
+	std::unordered_map<EntityHandle, glm::vec3> _sweepStarts{};
+
+	/**
+	 * @brief Positions for the next update, swapped with _sweepStarts so
+	 * colliders that are gone are dropped.
+	 */
+	std::unordered_map<EntityHandle, glm::vec3> _nextSweepStarts{};
+
+	/**
+	 * @brief Time of impact and collider of every hit of the current sweep,
+	 * reused between sweeps.
+	 */
+	std::vector<std::pair<float, EntityHandle>> _sweepHits{};
+
+	/**
+	 * @brief Whether a CollisionStayEvent is posted every update.
+	 */
+	bool _stayEvents{ false };
+
+	/**
+	 * @brief Pairs that started to overlap this update.
+	 */
+	std::vector<CollisionPair> _begun{};
+
+	/**
+	 * @brief Pairs that kept overlapping this update.
+	 */
+	std::vector<CollisionPair> _staying{};
+
+	/**
+	 * @brief Pairs that stopped overlapping this update, with their keys.
+	 */
+	std::vector<std::pair<uint64_t, CollisionPair>> _ended{};
+};
@@ -0,0 +1,260 @@
+/**
+ * @file	BroadphaseBenchmark.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless comparison of the collision broadphases
+ */
+
+#include "BroadphaseBenchmark.h"
+#include "EntityManager.h"
+#include "Quadtree.h"
+#include "SpatialHashGrid.h"
+#include "AABBTreeBroadphase.h"
+#include "CollisionComponent.h"
+#include "TransformComponent.h"
+#include "QuadtreeComponent.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief A collider of the scene and how it moves.
+	 */
+	struct BenchmarkCollider
+	{
+		/**
+		 * @brief Center of the circle the collider moves on.
+		 */
+		glm::vec3 center;
+
+		/**
+		 * @brief Radius of the circle, zero for static colliders.
+		 */
+		float radius;
+
+		/**
+		 * @brief Angle at the first step.
+		 */
+		float phase;
+
+		/**
+		 * @brief Angle moved per step.
+		 */
+		float speed;
+
+		/**
+		 * @brief Half size of the collider.
+		 */
+		glm::vec3 extent;
+
+		/**
+		 * @brief Whether the collider never moves.
+		 */
+		bool isStatic;
+
+		/**
+		 * @brief Whether the collider is a fast projectile.
+		 */
+		bool fast;
+	};
+
+	/**
+	 * @brief Gets a number in [min, max) from the generator, the same on
+	 * every standard library unlike the std distributions.
+	 * @param rng The generator.
+	 * @param min Smallest number.
+	 * @param max Largest number.
+	 * @return The number.
+	 */
+	float uniform(std::mt19937& rng, float min, float max)
+	{
+		return min + (max - min) * (rng() / 4294967296.f);
+	}
+
+	/**
+	 * @brief Generates the scene of the benchmark.
+	 * @param colliderCount Number of colliders.
+	 * @param worldSize Width and depth of the area the colliders are in.
+	 * @return The colliders.
+	 */
+	std::vector<BenchmarkCollider> generateScene(uint32_t colliderCount, float worldSize)
+	{
+		std::mt19937 rng{ 1234u };
+		std::vector<BenchmarkCollider> colliders(colliderCount);
+
+		float half = worldSize * 0.5f;
+
+		for (uint32_t i = 0; i < colliderCount; ++i)
+		{
+			BenchmarkCollider& collider = colliders[i];
+
+			collider.center = glm::vec3{ uniform(rng, -half, half), uniform(rng, 0.f, 4.f), uniform(rng, -half, half) };
+			collider.phase = uniform(rng, 0.f, 6.2831853f);
+			collider.isStatic = i % 8 == 0;
+			collider.fast = !collider.isStatic && i % 32 == 1;
+
+			if (collider.isStatic)
+			{
+				collider.radius = 0.f;
+				collider.speed = 0.f;
+				collider.extent = glm::vec3{ uniform(rng, 1.f, 3.f), uniform(rng, 1.f, 4.f), uniform(rng, 1.f, 3.f) };
+			}
+			else if (collider.fast)
+			{
+				collider.radius = uniform(rng, 10.f, 20.f);
+				collider.speed = uniform(rng, 0.2f, 0.4f);
+				collider.extent = glm::vec3{ 0.1f };
+			}
+			else
+			{
+				collider.radius = uniform(rng, 1.f, 5.f);
+				collider.speed = uniform(rng, 0.01f, 0.05f);
+				collider.extent = glm::vec3{ uniform(rng, 0.3f, 1.f) };
+			}
+		}
+
+		return colliders;
+	}
+
+	/**
+	 * @brief Gets where a collider is at a step.
+	 * @param collider The collider.
+	 * @param step The step.
+	 * @return The position.
+	 */
+	glm::vec3 getPosition(const BenchmarkCollider& collider, uint32_t step)
+	{
+		float angle = collider.phase + collider.speed * step;
+
+		return collider.center + collider.radius * glm::vec3{ std::cos(angle), 0.f, std::sin(angle) };
+	}
+
+	/**
+	 * @brief Creates the broadphase with the given index.
+	 * @param index 0 for the quadtree, 1 for the spatial hash grid and 2
+	 * for the AABB tree.
+	 * @param enM The entity manager.
+	 * @param evM The event manager.
+	 * @param worldSize Width and depth of the area the colliders move in.
+	 * @return The broadphase.
+	 */
+	Broadphase* createBroadphase(int index, EntityManager* enM, EventManager* evM, float worldSize)
+	{
+		// Room for the colliders moving out of the area
+		uint32_t size = static_cast<uint32_t>(worldSize) + 64;
+
+		switch (index)
+		{
+		case 0:
+			return new Quadtree{ enM, evM, glm::vec2{ 0.f, 0.f }, size, size };
+		case 1:
+			return new SpatialHashGrid{ enM, evM };
+		default:
+			return new AABBTreeBroadphase{ enM, evM };
+		}
+	}
+
+	/**
+	 * @brief Number of broadphases compared.
+	 */
+	const int BROADPHASE_COUNT = 3;
+}
+
+void runBroadphaseBenchmark(uint32_t colliderCount, uint32_t steps)
+{
+	// Keeps the density the same for any number of colliders
+	const float worldSize = std::sqrt(static_cast<float>(colliderCount)) * 4.f;
+
+	std::vector<BenchmarkCollider> colliders = generateScene(colliderCount, worldSize);
+
+	std::cout << "Broadphase benchmark: " << colliderCount << " colliders, " << steps << " steps" << std::endl;
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	for (int index = 0; index < BROADPHASE_COUNT; ++index)
+	{
+		EventManager evM{};
+		EntityManager enM{ &evM, nullptr, nullptr };
+
+		enM.registerComponent<CollisionComponent>("CollisionComponent");
+		enM.registerComponent<TransformComponent>("TransformComponent");
+		enM.registerComponent<QuadtreeComponent>("QuadtreeComponent");
+
+		// Destroyed before the managers, it detaches from them
+		std::unique_ptr<Broadphase> broadphase{ createBroadphase(index, &enM, &evM, worldSize) };
+
+		std::vector<EntityHandle> entities(colliderCount);
+
+		for (uint32_t i = 0; i < colliderCount; ++i)
+		{
+			const BenchmarkCollider& collider = colliders[i];
+
+			EntityHandle ent = enM.createEntity();
+			enM.assignComponent<TransformComponent>(ent, getPosition(collider, 0));
+
+			if (collider.isStatic)
+			{
+				enM.assignComponent<CollisionComponent>(ent, collider.extent, true, LAYER_SCENERY, LAYER_ALL & ~LAYER_SCENERY);
+			}
+			else if (collider.fast)
+			{
+				enM.assignComponent<CollisionComponent>(ent, SHAPE_SPHERE, collider.extent, false, LAYER_PROJECTILE, LAYER_ALL & ~LAYER_PROJECTILE);
+				enM.getComponent<CollisionComponent>(ent)->setFast(true);
+			}
+			else
+			{
+				enM.assignComponent<CollisionComponent>(ent, SHAPE_SPHERE, collider.extent, false);
+			}
+
+			entities[i] = ent;
+		}
+
+		enM.update(0.f);
+
+		BroadphaseStats totals{};
+		double totalTime = 0.0;
+
+		for (uint32_t step = 0; step < steps; ++step)
+		{
+			for (uint32_t i = 0; i < colliderCount; ++i)
+			{
+				if (!colliders[i].isStatic)
+				{
+					enM.getComponent<TransformComponent>(entities[i])->position = getPosition(colliders[i], step);
+				}
+			}
+
+			Clock::time_point start = Clock::now();
+
+			broadphase->update();
+
+			totalTime += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+			const BroadphaseStats& stats = broadphase->getStats();
+
+			totals.pairTests += stats.pairTests;
+			totals.groupsSkipped += stats.groupsSkipped;
+			totals.sweptPairs += stats.sweptPairs;
+			totals.narrowRejected += stats.narrowRejected;
+			totals.pairsFound += stats.pairsFound;
+		}
+
+		double frames = static_cast<double>(steps);
+
+		std::cout << "  " << broadphase->getName() << ":" << std::endl
+			<< "    time:       " << totalTime / frames << " ms/step" << std::endl
+			<< "    pair tests: " << totals.pairTests / frames << std::endl
+			<< "    skipped:    " << totals.groupsSkipped / frames << std::endl
+			<< "    swept:      " << totals.sweptPairs / frames << std::endl
+			<< "    rejected:   " << totals.narrowRejected / frames << std::endl
+			<< "    pairs:      " << totals.pairsFound / frames << std::endl;
+	}
+}
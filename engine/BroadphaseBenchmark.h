@@ -0,0 +1,24 @@
+/**
+ * @file	BroadphaseBenchmark.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless comparison of the collision broadphases
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Runs every broadphase over the same moving scene without opening a
+ * window and prints the time and statistics per step of each.
+ *
+ * The scene is generated from a fixed seed, so runs can be compared with
+ * each other. A part of the colliders are static scenery that does not
+ * collide with itself and a few are fast projectiles, the rest move in
+ * circles. Every broadphase should report the same number of pairs.
+ *
+ * @param colliderCount Number of colliders.
+ * @param steps Number of steps to run each broadphase.
+ */
+void runBroadphaseBenchmark(uint32_t colliderCount = 4096, uint32_t steps = 300);
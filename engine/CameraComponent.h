@@ -27,7 +27,7 @@ public:
 	 * @brief XML constructor
 	 * @param node Node with camera info.
 	 */
-	explicit CameraComponent(rapidxml::xml_node<>* node) {} // TODO: Lgg till
+	explicit CameraComponent(rapidxml::xml_node<>* node) {} // TODO: Lägg till
 
 	/**
 	 * @brief Camera object
@@ -0,0 +1,24 @@
+/**
+ * @file	CollisionBeginEvent.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Event for when two entities start to overlap
+ */
+
+#pragma once
+
+#include "CollisionEvent.h"
+
+/**
+ * @brief Posted by the broadphase on the first frame two entities overlap.
+ */
+class CollisionBeginEvent : public CollisionEvent
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param entHandle1 Entity Handle for a member of the collision.
+	 * @param entHandle2 Entity Handle for other member of collision.
+	 */
+	explicit CollisionBeginEvent(EntityHandle entHandle1, EntityHandle entHandle2) : CollisionEvent(entHandle1, entHandle2) {}
+};
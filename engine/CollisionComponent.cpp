@@ -1,13 +1,212 @@
 /**
 * @file	CollisionComponent.cpp
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-12
 * @brief	Collision component
 */
 
 #include "CollisionComponent.h"
+#include "Utils.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	/**
+	 * \brief Parses layers given as numbers or names separated by '|'
+	 * \param value String to parse
+	 * \return Layer bits
+	 */
+	uint32_t parseLayers(const std::string& value)
+	{
+		uint32_t result{ 0 };
+
+		std::stringstream ss{ value };
+		std::string token;
+
+		while (std::getline(ss, token, '|'))
+		{
+			token.erase(0, token.find_first_not_of(" \t\n"));
+			token.erase(token.find_last_not_of(" \t\n") + 1);
+
+			if (token == "DEFAULT")
+				result |= LAYER_DEFAULT;
+			else if (token == "SCENERY")
+				result |= LAYER_SCENERY;
+			else if (token == "PROJECTILE")
+				result |= LAYER_PROJECTILE;
+			else if (token == "ALL")
+				result |= LAYER_ALL;
+			else if (!token.empty())
+				result |= static_cast<uint32_t>(std::stoul(token, nullptr, 0));
+		}
+
+		return result;
+	}
+}
+
+CollisionComponent::CollisionComponent(CollisionShape shape, glm::vec3 size, bool isStatic, uint32_t layer, uint32_t mask) :
+	reach{},
+	extent{},
+	staticCollider{ isStatic },
+	layer{ layer },
+	mask{ mask },
+	shape{ shape },
+	size{ size }
+{
+	updateBounds();
+}
+
+CollisionComponent::CollisionComponent(rapidxml::xml_node<>* node) :
+	reach{},
+	extent{},
+	staticCollider{ false },
+	layer{ LAYER_DEFAULT },
+	mask{ LAYER_ALL },
+	shape{ SHAPE_BOX },
+	size{}
+{
+	rapidxml::xml_node<>* extentNode = node->first_node("extent");
+	rapidxml::xml_node<>* shapeNode = node->first_node("shape");
+
+	if (shapeNode)
+	{
+		std::string name{ shapeNode->value() };
+
+		if (name == "sphere")
+			shape = SHAPE_SPHERE;
+		else if (name == "capsule")
+			shape = SHAPE_CAPSULE;
+		else if (name == "box")
+			shape = SHAPE_BOX;
+		else if (name == "obb")
+			shape = SHAPE_OBB;
+		else
+			throw std::invalid_argument{ "Unknown collision shape '" + name + "'" };
+
+		if (rapidxml::xml_node<>* sizeNode = node->first_node("size"))
+		{
+			std::stringstream ss{ sizeNode->value() };
+
+			ss >> size;
+		}
+
+		updateBounds();
+	}
+	else if (extentNode)
+	{
+		std::stringstream ss{ extentNode->value() };
+
+		ss >> extent;
+
+		reach = glm::max(extent.x, extent.z);
+		size = extent;
+	}
+	else if (rapidxml::xml_node<>* reachNode = node->first_node("reach"))
+	{
+		std::stringstream ss{ reachNode->value() };
+
+		ss >> reach;
+
+		extent = glm::vec3{ reach };
+		size = extent;
+	}
+
+	if (rapidxml::xml_node<>* staticNode = node->first_node("static"))
+	{
+		std::string value{ staticNode->value() };
+
+		staticCollider = value == "true" || value == "1";
+	}
+
+	if (rapidxml::xml_node<>* fastNode = node->first_node("fast"))
+	{
+		std::string value{ fastNode->value() };
+
+		fast = value == "true" || value == "1";
+	}
+
+	if (rapidxml::xml_node<>* layerNode = node->first_node("layer"))
+	{
+		layer = parseLayers(layerNode->value());
+	}
+
+	if (rapidxml::xml_node<>* maskNode = node->first_node("mask"))
+	{
+		mask = parseLayers(maskNode->value());
+	}
+}
 
 float CollisionComponent::getReach() const
 {
 	return reach;
 }
+
+glm::vec3 CollisionComponent::getExtent() const
+{
+	return extent;
+}
+
+CollisionShape CollisionComponent::getShape() const
+{
+	return shape;
+}
+
+glm::vec3 CollisionComponent::getSize() const
+{
+	return size;
+}
+
+bool CollisionComponent::isStatic() const
+{
+	return staticCollider;
+}
+
+bool CollisionComponent::isFast() const
+{
+	return fast;
+}
+
+void CollisionComponent::setFast(bool value)
+{
+	fast = value;
+}
+
+uint32_t CollisionComponent::getLayer() const
+{
+	return layer;
+}
+
+uint32_t CollisionComponent::getMask() const
+{
+	return mask;
+}
+
+bool CollisionComponent::canCollide(const CollisionComponent& other) const
+{
+	return canCollide(layer, mask, other.layer, other.mask);
+}
+
+void CollisionComponent::updateBounds()
+{
+	switch (shape)
+	{
+	case SHAPE_SPHERE:
+		extent = glm::vec3{ size.x };
+		break;
+	case SHAPE_CAPSULE:
+		extent = glm::vec3{ size.x, size.y + size.x, size.x };
+		break;
+	case SHAPE_OBB:
+		// Bounds the box in any rotation, so rotating never needs a refit
+		extent = glm::vec3{ glm::length(size) };
+		break;
+	default:
+		extent = size;
+		break;
+	}
+
+	reach = glm::max(extent.x, extent.z);
+}
@@ -1,6 +1,6 @@
 /**
 * @file	CollisionComponent.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-12
 * @brief	Collision component
 */
@@ -8,6 +8,71 @@
 #pragma once
 #include "Component.h"
 #include <rapidxml/rapidxml.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+/**
+ * \brief Collision layers
+ * 
+ * A collider is in one or more layers and collides with the colliders whose
+ * layers are in its mask, as long as they have its layer in their masks too.
+ */
+enum CollisionLayer : uint32_t
+{
+	/**
+	 * \brief Everything not in another layer
+	 */
+	LAYER_DEFAULT = 1 << 0,
+
+	/**
+	 * \brief Trees, rocks and other props
+	 */
+	LAYER_SCENERY = 1 << 1,
+
+	/**
+	 * \brief Projectiles
+	 */
+	LAYER_PROJECTILE = 1 << 2,
+
+	/**
+	 * \brief All layers
+	 */
+	LAYER_ALL = 0xFFFFFFFF
+};
+
+/**
+ * \brief Shapes tested by the narrowphase
+ * 
+ * Ordered so that a pair of shapes is always handled with the lower shape first.
+ */
+enum CollisionShape : uint8_t
+{
+	/**
+	 * \brief Sphere, size.x is the radius
+	 */
+	SHAPE_SPHERE,
+
+	/**
+	 * \brief Upright capsule, size.x is the radius and size.y half the length of the segment
+	 */
+	SHAPE_CAPSULE,
+
+	/**
+	 * \brief Axis aligned box, size is the half size
+	 */
+	SHAPE_BOX,
+
+	/**
+	 * \brief Box following the rotation of the transform, size is the half size
+	 */
+	SHAPE_OBB,
+
+	/**
+	 * \brief Number of shapes
+	 */
+	SHAPE_COUNT
+};
+
 /**
  * \brief Collision component
  */
@@ -19,26 +84,177 @@ public:
 
 	/**
 	 * \brief Contructor (common constructor)
-	 * \param reach The reach of the collider
+	 * \param reach The reach of the collider, in all directions
+	 * \param isStatic Whether the collider never moves
+	 * \param layer Layers of the collider
+	 * \param mask Layers the collider collides with
+	 */
+	explicit CollisionComponent(float reach, bool isStatic = false, uint32_t layer = LAYER_DEFAULT, uint32_t mask = LAYER_ALL) : reach{reach}, extent{reach}, staticCollider{isStatic}, layer{layer}, mask{mask}, shape{SHAPE_BOX}, size{reach}{};
+
+	/**
+	 * \brief Contructor for box shaped colliders
+	 * \param extent Half size of the collider along each axis
+	 * \param isStatic Whether the collider never moves
+	 * \param layer Layers of the collider
+	 * \param mask Layers the collider collides with
+	 */
+	explicit CollisionComponent(glm::vec3 extent, bool isStatic = false, uint32_t layer = LAYER_DEFAULT, uint32_t mask = LAYER_ALL) : reach{glm::max(extent.x, extent.z)}, extent{extent}, staticCollider{isStatic}, layer{layer}, mask{mask}, shape{SHAPE_BOX}, size{extent}{};
+
+	/**
+	 * \brief Contructor for any shape
+	 * \param shape Shape of the collider
+	 * \param size Size of the shape, see CollisionShape
+	 * \param isStatic Whether the collider never moves
+	 * \param layer Layers of the collider
+	 * \param mask Layers the collider collides with
 	 */
-	explicit CollisionComponent(float reach) : reach{reach}{};
+	explicit CollisionComponent(CollisionShape shape, glm::vec3 size, bool isStatic = false, uint32_t layer = LAYER_DEFAULT, uint32_t mask = LAYER_ALL);
 	
 	/**
 	 * \brief Contructor from xml
+	 * 
+	 * Reads either a <reach> or an <extent> node, or a <shape> node
+	 * (sphere, capsule, box or obb) with a <size> node. Optional nodes are
+	 * <static>, <fast>, <layer> and <mask>. Layers are given as numbers or
+	 * as names separated by '|', like "SCENERY|PROJECTILE".
+	 * 
 	 * \param node an xml node
 	 */
-	explicit CollisionComponent(rapidxml::xml_node<>* node) : reach{} {}
+	explicit CollisionComponent(rapidxml::xml_node<>* node);
 	~CollisionComponent() = default;
 
 	/**
 	 * \brief Returns the reach of the collider
+	 * 
+	 * The reach is the largest horizontal extent, for structures that only
+	 * work in the XZ plane.
+	 * 
 	 * \return Reach of collider
 	 */
 	float getReach() const;
+
+	/**
+	 * \brief Returns the half size of the collider along each axis
+	 * \return Extent of collider
+	 */
+	glm::vec3 getExtent() const;
+
+	/**
+	 * \brief Returns the shape tested by the narrowphase
+	 * \return Shape of collider
+	 */
+	CollisionShape getShape() const;
+
+	/**
+	 * \brief Returns the size of the shape, see CollisionShape
+	 * \return Size of shape
+	 */
+	glm::vec3 getSize() const;
+
+	/**
+	 * \brief Returns whether the collider never moves
+	 * 
+	 * Static colliders are kept in a separate structure that is only rebuilt
+	 * when static colliders are added or removed.
+	 * 
+	 * \return True if static
+	 */
+	bool isStatic() const;
+
+	/**
+	 * \brief Returns whether the collider moves fast enough to pass through
+	 * other colliders between two updates
+	 * 
+	 * Fast colliders are swept from their position at the last update, so
+	 * they collide with everything they passed on the way.
+	 * 
+	 * \return True if fast
+	 */
+	bool isFast() const;
+
+	/**
+	 * \brief Sets whether the collider is swept between updates
+	 * \param value True if fast
+	 */
+	void setFast(bool value);
+
+	/**
+	 * \brief Returns the layers of the collider
+	 * \return Layer bits
+	 */
+	uint32_t getLayer() const;
+
+	/**
+	 * \brief Returns the layers the collider collides with
+	 * \return Mask bits
+	 */
+	uint32_t getMask() const;
+
+	/**
+	 * \brief Checks whether two colliders can collide according to their layers
+	 * \param other The other collider
+	 * \return True if they can collide
+	 */
+	bool canCollide(const CollisionComponent& other) const;
+
+	/**
+	 * \brief Checks whether two colliders can collide according to their layers
+	 * \param layer1 Layers of first collider
+	 * \param mask1 Mask of first collider
+	 * \param layer2 Layers of second collider
+	 * \param mask2 Mask of second collider
+	 * \return True if they can collide
+	 */
+	static bool canCollide(uint32_t layer1, uint32_t mask1, uint32_t layer2, uint32_t mask2);
 private:
 	/**
 	 * \brief Reach of the collider
 	 */
-	const float reach;
+	float reach;
+
+	/**
+	 * \brief Half size of the collider along each axis
+	 */
+	glm::vec3 extent;
+
+	/**
+	 * \brief Whether the collider never moves
+	 */
+	bool staticCollider;
+
+	/**
+	 * \brief Whether the collider is swept between updates
+	 */
+	bool fast{ false };
+
+	/**
+	 * \brief Layers of the collider
+	 */
+	uint32_t layer;
+
+	/**
+	 * \brief Layers the collider collides with
+	 */
+	uint32_t mask;
+
+	/**
+	 * \brief Shape tested by the narrowphase
+	 */
+	CollisionShape shape;
+
+	/**
+	 * \brief Size of the shape
+	 */
+	glm::vec3 size;
+
+	/**
+	 * \brief Sets the extent and reach to bound the shape in any rotation
+	 */
+	void updateBounds();
 };
 
+inline bool CollisionComponent::canCollide(uint32_t layer1, uint32_t mask1, uint32_t layer2, uint32_t mask2)
+{
+	return (layer1 & mask2) != 0 && (layer2 & mask1) != 0;
+}
+
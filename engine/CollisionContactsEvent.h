@@ -0,0 +1,38 @@
+/**
+ * @file	CollisionContactsEvent.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Event for all contacts found by the broadphase in an update
+ */
+
+#pragma once
+
+#include "Event.h"
+#include "Narrowphase.h"
+
+#include <cstddef>
+
+/**
+ * @brief Posted by the broadphase once per frame with the contacts of all
+ * touching pairs. Not posted if there are none.
+ */
+class CollisionContactsEvent : public Event
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param contacts Pointer to the first contact.
+	 * @param count Number of contacts.
+	 */
+	explicit CollisionContactsEvent(const CollisionContact* contacts, size_t count) : contacts(contacts), count(count) {}
+
+	/**
+	 * @brief Pointer to the first contact. Only valid while the event is handled.
+	 */
+	const CollisionContact* contacts;
+
+	/**
+	 * @brief Number of contacts.
+	 */
+	size_t count;
+};
@@ -0,0 +1,27 @@
+/**
+ * @file	CollisionEndEvent.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Event for when two entities stop overlapping
+ */
+
+#pragma once
+
+#include "CollisionEvent.h"
+
+/**
+ * @brief Posted by the broadphase on the first frame two entities no longer overlap.
+ *
+ * Also posted when one of the entities has been destroyed, so the entities
+ * might not exist anymore when this is handled.
+ */
+class CollisionEndEvent : public CollisionEvent
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param entHandle1 Entity Handle for a member of the collision.
+	 * @param entHandle2 Entity Handle for other member of collision.
+	 */
+	explicit CollisionEndEvent(EntityHandle entHandle1, EntityHandle entHandle2) : CollisionEvent(entHandle1, entHandle2) {}
+};
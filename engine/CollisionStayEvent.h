@@ -0,0 +1,38 @@
+/**
+ * @file	CollisionStayEvent.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Event for all pairs of entities that keep overlapping
+ */
+
+#pragma once
+
+#include "Event.h"
+#include "Broadphase.h"
+
+#include <cstddef>
+
+/**
+ * @brief Posted by the broadphase once per frame with all pairs that overlapped
+ * the frame before as well. Only posted if enabled on the broadphase.
+ */
+class CollisionStayEvent : public Event
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param pairs Pointer to the first pair.
+	 * @param count Number of pairs.
+	 */
+	explicit CollisionStayEvent(const CollisionPair* pairs, size_t count) : pairs(pairs), count(count) {}
+
+	/**
+	 * @brief Pointer to the first pair. Only valid while the event is handled.
+	 */
+	const CollisionPair* pairs;
+
+	/**
+	 * @brief Number of pairs.
+	 */
+	size_t count;
+};
@@ -1,6 +1,6 @@
 /**
 * @file	Component.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	2017-03-06
 * @brief	Abstract component base class
 */
@@ -1,6 +1,6 @@
 /**
 * @file	ComponentAssignedEvent.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-12
 * @brief	Event for when a component was assigned to an entity
 */
@@ -0,0 +1,326 @@
+/**
+ * @file	DynamicAABBTree.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Incrementally updated bounding volume hierarchy
+ */
+
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+
+constexpr int32_t DynamicAABBTree::NULL_NODE;
+constexpr int32_t DynamicAABBTree::QUERY_STACK_SIZE;
+
+DynamicAABBTree::DynamicAABBTree(float margin) :
+	_margin{ margin }
+{
+}
+
+int32_t DynamicAABBTree::createProxy(const AABB& aabb, EntityHandle ent)
+{
+	int32_t proxy = allocateNode();
+
+	_nodes[proxy].aabb = aabb.expand(_margin);
+	_nodes[proxy].ent = ent;
+	_nodes[proxy].height = 0;
+
+	insertLeaf(proxy);
+
+	++_proxyCount;
+
+	return proxy;
+}
+
+void DynamicAABBTree::destroyProxy(int32_t proxy)
+{
+	removeLeaf(proxy);
+	freeNode(proxy);
+
+	--_proxyCount;
+}
+
+bool DynamicAABBTree::moveProxy(int32_t proxy, const AABB& aabb, glm::vec3 displacement)
+{
+	if (_nodes[proxy].aabb.contains(aabb))
+		return false;
+
+	removeLeaf(proxy);
+
+	AABB fat = aabb.expand(_margin);
+
+	fat.min += glm::min(displacement, glm::vec3{ 0.f });
+	fat.max += glm::max(displacement, glm::vec3{ 0.f });
+
+	_nodes[proxy].aabb = fat;
+
+	insertLeaf(proxy);
+
+	return true;
+}
+
+void DynamicAABBTree::clear()
+{
+	_nodes.clear();
+	_root = NULL_NODE;
+	_freeList = NULL_NODE;
+	_proxyCount = 0;
+}
+
+int32_t DynamicAABBTree::allocateNode()
+{
+	if (_freeList == NULL_NODE)
+	{
+		_nodes.push_back(Node{});
+
+		return static_cast<int32_t>(_nodes.size() - 1);
+	}
+
+	int32_t node = _freeList;
+
+	_freeList = _nodes[node].parent;
+	_nodes[node] = Node{};
+
+	return node;
+}
+
+void DynamicAABBTree::freeNode(int32_t node)
+{
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+	_freeList = node;
+}
+
+void DynamicAABBTree::insertLeaf(int32_t leaf)
+{
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[leaf].parent = NULL_NODE;
+
+		return;
+	}
+
+	// Walk down towards the cheapest sibling
+	AABB leafBox = _nodes[leaf].aabb;
+	int32_t index = _root;
+
+	while (!_nodes[index].isLeaf())
+	{
+		int32_t child1 = _nodes[index].child1;
+		int32_t child2 = _nodes[index].child2;
+
+		float area = _nodes[index].aabb.getSurfaceArea();
+		float combinedArea = _nodes[index].aabb.merge(leafBox).getSurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child)
+		{
+			AABB merged = leafBox.merge(_nodes[child].aabb);
+
+			if (_nodes[child].isLeaf())
+			{
+				return merged.getSurfaceArea() + inheritanceCost;
+			}
+
+			return merged.getSurfaceArea() - _nodes[child].aabb.getSurfaceArea() + inheritanceCost;
+		};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int32_t sibling = index;
+
+	// New parent for the sibling and the leaf
+	int32_t oldParent = _nodes[sibling].parent;
+	int32_t newParent = allocateNode();
+
+	_nodes[newParent].parent = oldParent;
+	_nodes[newParent].aabb = leafBox.merge(_nodes[sibling].aabb);
+	_nodes[newParent].height = _nodes[sibling].height + 1;
+	_nodes[newParent].child1 = sibling;
+	_nodes[newParent].child2 = leaf;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (_nodes[oldParent].child1 == sibling)
+		{
+			_nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			_nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		_root = newParent;
+	}
+
+	// Refit and rebalance the way up
+	index = _nodes[leaf].parent;
+
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+
+		int32_t child1 = _nodes[index].child1;
+		int32_t child2 = _nodes[index].child2;
+
+		_nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+		_nodes[index].aabb = _nodes[child1].aabb.merge(_nodes[child2].aabb);
+
+		index = _nodes[index].parent;
+	}
+}
+
+void DynamicAABBTree::removeLeaf(int32_t leaf)
+{
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+
+		return;
+	}
+
+	int32_t parent = _nodes[leaf].parent;
+	int32_t grandParent = _nodes[parent].parent;
+	int32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	if (grandParent == NULL_NODE)
+	{
+		_root = sibling;
+		_nodes[sibling].parent = NULL_NODE;
+
+		freeNode(parent);
+
+		return;
+	}
+
+	// Replace the parent with the sibling
+	if (_nodes[grandParent].child1 == parent)
+	{
+		_nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		_nodes[grandParent].child2 = sibling;
+	}
+
+	_nodes[sibling].parent = grandParent;
+
+	freeNode(parent);
+
+	int32_t index = grandParent;
+
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+
+		int32_t child1 = _nodes[index].child1;
+		int32_t child2 = _nodes[index].child2;
+
+		_nodes[index].aabb = _nodes[child1].aabb.merge(_nodes[child2].aabb);
+		_nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+
+		index = _nodes[index].parent;
+	}
+}
+
+int32_t DynamicAABBTree::balance(int32_t a)
+{
+	Node& nodeA = _nodes[a];
+
+	if (nodeA.isLeaf() || nodeA.height < 2)
+		return a;
+
+	int32_t b = nodeA.child1;
+	int32_t c = nodeA.child2;
+
+	int32_t diff = _nodes[c].height - _nodes[b].height;
+
+	// Rotate the higher child up, the same way for both sides
+	auto rotateUp = [this, a](int32_t up, int32_t other, bool upIsChild2)
+	{
+		Node& nodeA = _nodes[a];
+		Node& nodeUp = _nodes[up];
+
+		int32_t f = nodeUp.child1;
+		int32_t g = nodeUp.child2;
+
+		nodeUp.child1 = a;
+		nodeUp.parent = nodeA.parent;
+		nodeA.parent = up;
+
+		if (nodeUp.parent != NULL_NODE)
+		{
+			Node& upParent = _nodes[nodeUp.parent];
+
+			if (upParent.child1 == a)
+			{
+				upParent.child1 = up;
+			}
+			else
+			{
+				upParent.child2 = up;
+			}
+		}
+		else
+		{
+			_root = up;
+		}
+
+		// The higher grandchild stays with up, the lower one goes to a
+		int32_t keep = _nodes[f].height > _nodes[g].height ? f : g;
+		int32_t give = keep == f ? g : f;
+
+		nodeUp.child2 = keep;
+
+		if (upIsChild2)
+		{
+			nodeA.child2 = give;
+		}
+		else
+		{
+			nodeA.child1 = give;
+		}
+
+		_nodes[give].parent = a;
+
+		nodeA.aabb = _nodes[other].aabb.merge(_nodes[give].aabb);
+		nodeUp.aabb = nodeA.aabb.merge(_nodes[keep].aabb);
+
+		nodeA.height = 1 + std::max(_nodes[other].height, _nodes[give].height);
+		nodeUp.height = 1 + std::max(nodeA.height, _nodes[keep].height);
+	};
+
+	if (diff > 1)
+	{
+		rotateUp(c, b, true);
+
+		return c;
+	}
+
+	if (diff < -1)
+	{
+		rotateUp(b, c, false);
+
+		return b;
+	}
+
+	return a;
+}
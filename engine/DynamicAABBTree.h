@@ -0,0 +1,296 @@
+/**
+ * @file	DynamicAABBTree.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Incrementally updated bounding volume hierarchy
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "EntityManager.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Bounding volume hierarchy of fattened AABBs.
+ *
+ * Every proxy is stored with its box grown by a margin, so a proxy only has
+ * to be reinserted once it has moved out of its fat box. Leaves are inserted
+ * where they increase the surface area of the tree the least and the tree is
+ * kept balanced with rotations.
+ *
+ * Queries only read the tree and can run from several threads at once.
+ */
+class DynamicAABBTree
+{
+public:
+	/**
+	 * @brief Index of a missing node.
+	 */
+	static constexpr int32_t NULL_NODE{ -1 };
+
+	/**
+	 * @brief Constructor.
+	 * @param margin Distance the boxes of the proxies are fattened with.
+	 */
+	explicit DynamicAABBTree(float margin = 0.2f);
+
+	/**
+	 * @brief Creates a proxy for an entity.
+	 * @param aabb Tight box of the entity.
+	 * @param ent Handle to entity.
+	 * @return Proxy ID.
+	 */
+	int32_t createProxy(const AABB& aabb, EntityHandle ent);
+
+	/**
+	 * @brief Removes a proxy.
+	 * @param proxy Proxy ID.
+	 */
+	void destroyProxy(int32_t proxy);
+
+	/**
+	 * @brief Moves a proxy. Only touches the tree if the box left the fat box.
+	 *
+	 * The new fat box is stretched along the displacement, so proxies moving
+	 * steadily are not reinserted every frame.
+	 *
+	 * @param proxy Proxy ID.
+	 * @param aabb New tight box.
+	 * @param displacement Expected movement until the next update.
+	 * @return True if the proxy was reinserted.
+	 */
+	bool moveProxy(int32_t proxy, const AABB& aabb, glm::vec3 displacement = glm::vec3{ 0.f });
+
+	/**
+	 * @brief Removes all proxies.
+	 */
+	void clear();
+
+	/**
+	 * @brief Gets the fat box of a proxy.
+	 * @param proxy Proxy ID.
+	 * @return Fat box.
+	 */
+	const AABB& getFatAABB(int32_t proxy) const { return _nodes[proxy].aabb; }
+
+	/**
+	 * @brief Gets the entity of a proxy.
+	 * @param proxy Proxy ID.
+	 * @return Handle to entity.
+	 */
+	EntityHandle getEntity(int32_t proxy) const { return _nodes[proxy].ent; }
+
+	/**
+	 * @brief Gets the number of proxies in the tree.
+	 * @return Number of proxies.
+	 */
+	size_t getProxyCount() const { return _proxyCount; }
+
+	/**
+	 * @brief Gets the height of the tree.
+	 * @return Height, 0 for an empty tree or a single leaf.
+	 */
+	int32_t getHeight() const { return _root == NULL_NODE ? 0 : _nodes[_root].height; }
+
+	/**
+	 * @brief Calls callback with every proxy whose fat box overlaps aabb.
+	 * @tparam Func Callable as bool(int32_t proxy). Returning false stops the query.
+	 * @param aabb Box to query.
+	 * @param callback Callback.
+	 */
+	template <typename Func>
+	void query(const AABB& aabb, Func&& callback) const;
+
+	/**
+	 * @brief Calls callback with every proxy whose fat box is hit by a ray.
+	 * @tparam Func Callable as float(int32_t proxy), returning the max distance
+	 * for the rest of the cast. Returning a negative value stops the cast.
+	 * @param origin Origin of the ray.
+	 * @param direction Direction of the ray.
+	 * @param maxDistance Max distance along the ray.
+	 * @param callback Callback.
+	 */
+	template <typename Func>
+	void rayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, Func&& callback) const;
+
+private:
+
+	/**
+	 * @brief Node in the tree. Leaves are proxies.
+	 */
+	struct Node
+	{
+		/**
+		 * @brief Fat box of a leaf, or the box of all leaves below.
+		 */
+		AABB aabb{};
+
+		/**
+		 * @brief Entity of a leaf.
+		 */
+		EntityHandle ent{ 0 };
+
+		/**
+		 * @brief Parent node, or next free node when on the free list.
+		 */
+		int32_t parent{ NULL_NODE };
+
+		/**
+		 * @brief First child.
+		 */
+		int32_t child1{ NULL_NODE };
+
+		/**
+		 * @brief Second child.
+		 */
+		int32_t child2{ NULL_NODE };
+
+		/**
+		 * @brief Height above the leaves. 0 for leaves, -1 for free nodes.
+		 */
+		int32_t height{ -1 };
+
+		/**
+		 * @brief Checks whether the node is a leaf.
+		 * @return True if leaf.
+		 */
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	/**
+	 * @brief Gets a node from the free list, growing the pool if needed.
+	 * @return Node index.
+	 */
+	int32_t allocateNode();
+
+	/**
+	 * @brief Puts a node back on the free list.
+	 * @param node Node index.
+	 */
+	void freeNode(int32_t node);
+
+	/**
+	 * @brief Inserts a leaf where it increases the surface area the least.
+	 * @param leaf Node index of the leaf.
+	 */
+	void insertLeaf(int32_t leaf);
+
+	/**
+	 * @brief Removes a leaf from the tree without freeing it.
+	 * @param leaf Node index of the leaf.
+	 */
+	void removeLeaf(int32_t leaf);
+
+	/**
+	 * @brief Rotates the subtree at a node if it is unbalanced.
+	 * @param a Node index.
+	 * @return Index of the node now at the top of the subtree.
+	 */
+	int32_t balance(int32_t a);
+
+	/**
+	 * @brief Max depth of the query stack. The tree is kept balanced so its
+	 * height stays far below this.
+	 */
+	static constexpr int32_t QUERY_STACK_SIZE{ 256 };
+
+	/**
+	 * @brief Node pool.
+	 */
+	std::vector<Node> _nodes{};
+
+	/**
+	 * @brief Root node.
+	 */
+	int32_t _root{ NULL_NODE };
+
+	/**
+	 * @brief First free node.
+	 */
+	int32_t _freeList{ NULL_NODE };
+
+	/**
+	 * @brief Number of proxies.
+	 */
+	size_t _proxyCount{ 0 };
+
+	/**
+	 * @brief Distance the boxes are fattened with.
+	 */
+	float _margin;
+};
+
+template <typename Func>
+void DynamicAABBTree::query(const AABB& aabb, Func&& callback) const
+{
+	if (_root == NULL_NODE)
+		return;
+
+	int32_t stack[QUERY_STACK_SIZE];
+	int32_t top = 0;
+
+	stack[top++] = _root;
+
+	while (top > 0)
+	{
+		int32_t index = stack[--top];
+		const Node& node = _nodes[index];
+
+		if (!node.aabb.overlaps(aabb))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (!callback(index))
+				return;
+		}
+		else
+		{
+			stack[top++] = node.child1;
+			stack[top++] = node.child2;
+		}
+	}
+}
+
+template <typename Func>
+void DynamicAABBTree::rayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, Func&& callback) const
+{
+	if (_root == NULL_NODE)
+		return;
+
+	glm::vec3 invDirection = 1.f / direction;
+
+	int32_t stack[QUERY_STACK_SIZE];
+	int32_t top = 0;
+
+	stack[top++] = _root;
+
+	while (top > 0)
+	{
+		int32_t index = stack[--top];
+		const Node& node = _nodes[index];
+
+		float distance;
+
+		if (!node.aabb.intersectRay(origin, invDirection, maxDistance, distance))
+			continue;
+
+		if (node.isLeaf())
+		{
+			float value = callback(index);
+
+			if (value < 0.f)
+				return;
+
+			maxDistance = std::min(maxDistance, value);
+		}
+		else
+		{
+			stack[top++] = node.child1;
+			stack[top++] = node.child2;
+		}
+	}
+}
@@ -54,6 +54,8 @@ namespace engine
 		assetManager = new AssetManager{};
 
 		window->setCursorMode(CursorMode::DISABLED);
+
+		renderThread = new RenderThread{ window };
 	}
 
 	void Engine::run()
@@ -62,9 +64,20 @@ namespace engine
 		int fps{ 0 };
 
 		GLfloat timeElapsed{ 0.f };
+		GLfloat tickTime{ 0.f };
+
+		renderingTimer.reset();
 
 		while (!window->shouldClose())
 		{
+			// Only switched between frames, when no frame is rendering
+			if (nextThreadedRendering != threadedRendering)
+			{
+				switchRendering();
+			}
+
+			LatencyClock::time_point frameStart = LatencyClock::now();
+
 			Scene* currentScene = Scenes.find(activeScene)->second;
 			userinterface::UIManager* uiManager = currentScene->getUIManager();
 
@@ -74,6 +87,7 @@ namespace engine
 
 			timeElapsed += timeDelta;
 			frames++;
+			renderingFrames++;
 			if (timeElapsed > 1.f)
 			{
 				timeElapsed -= 1.f;
@@ -104,6 +118,9 @@ namespace engine
 
 					if (ev.key.key == GLFW_KEY_2 && ev.key.action == Action::PRESS)
 						uiManager->getElement<userinterface::UIProgressBar>("testBar")->incrementValue(10.f);
+
+					if (ev.key.key == GLFW_KEY_M && ev.key.action == Action::PRESS)
+						setThreadedRendering(!nextThreadedRendering);
 				}
 				break;
 				case EventType::MOUSE_MOVED_EVENT:
@@ -147,27 +164,55 @@ namespace engine
 				}
 			}
 
-			currentScene->getEntityManager()->update(static_cast<float>(timeDelta));
-
-			GLfloat tickTime = dutyTimer.reset();
+			uint32_t presented = latencyFrames;
+			float latency = presented > 0 ? latencyTotal / 1000.f / presented : 0.f;
 
-			char buf[100];
-			sprintf(buf, "%i FPS, TimeDelta: %f, CPU: %.1f%%", fps, timeDelta, 100.f*tickTime / timeDelta);
+			// Set before the update, which records the user interface of the frame
+			char buf[128];
+			sprintf(buf, "%i FPS, TimeDelta: %f, CPU: %.1f%%, Latency: %.1f ms%s",
+				fps, timeDelta, 100.f*tickTime / timeDelta, latency, threadedRendering ? " (threaded)" : "");
 
 			uiManager->getElement<userinterface::UILabel>("testRect")->setText(buf);
 
-			glDisable(GL_DEPTH_TEST);
+			EntityManager* entityManager = currentScene->getEntityManager();
+
+			entityManager->update(static_cast<float>(timeDelta));
+
+			// The update prepared the frame, which is rendered from its own copy
+			RenderingSystem* renderer = entityManager->getSystem<RenderingSystem>();
+			size_t frame = renderer->getPreparedFrame();
+
+			RenderThread::FrameJob job = [this, renderer, frame, frameStart]()
+			{
+				renderer->render(frame);
+				window->swapBuffers();
+				recordLatency(frameStart);
+			};
 
-			uiManager->draw();
+			if (threadedRendering)
+			{
+				// Waits for the previous frame, the next is simulated while this renders
+				renderThread->submit(job);
+			}
+			else
+			{
+				job();
+			}
 
-			glEnable(GL_DEPTH_TEST);
+			tickTime = dutyTimer.reset();
 
-			window->display();
+			window->processEvents();
 		}
+
+		renderThread->stop();
+
+		reportRendering();
 	}
 
 	void Engine::cleanup()
 	{
+		delete renderThread;
+
 		delete window;
 
 		for (auto& i : Scenes) delete i.second;
@@ -235,6 +280,56 @@ namespace engine
 		return assetManager;
 	}
 
+	void Engine::setThreadedRendering(bool threaded)
+	{
+		nextThreadedRendering = threaded;
+	}
+
+	void Engine::switchRendering()
+	{
+		// The last frame of the old mode is part of its measurements
+		renderThread->finish();
+
+		reportRendering();
+
+		threadedRendering = nextThreadedRendering;
+
+		if (threadedRendering)
+		{
+			renderThread->start();
+		}
+		else
+		{
+			renderThread->stop();
+		}
+	}
+
+	void Engine::reportRendering()
+	{
+		GLfloat time = renderingTimer.reset();
+
+		uint32_t presented = latencyFrames.exchange(0);
+		uint64_t latency = latencyTotal.exchange(0);
+
+		uint32_t frames = renderingFrames;
+		renderingFrames = 0;
+
+		if (presented == 0 || time <= 0.f) return;
+
+		std::cout << (threadedRendering ? "Threaded" : "Single threaded") << " rendering over " << frames << " frames:" << std::endl
+			<< "  throughput: " << frames / time << " FPS" << std::endl
+			<< "  frame time: " << time / frames * 1000.f << " ms" << std::endl
+			<< "  latency:    " << latency / 1000.f / presented << " ms" << std::endl;
+	}
+
+	void Engine::recordLatency(LatencyClock::time_point start)
+	{
+		LatencyClock::duration latency = LatencyClock::now() - start;
+
+		latencyTotal += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+		++latencyFrames;
+	}
+
 	void Engine::dumpInfo(std::ostream& stream)
 	{
 		bool listExtensions = false;
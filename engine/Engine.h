@@ -8,6 +8,8 @@
 #pragma once
 
 #include <map>
+#include <atomic>
+#include <chrono>
 
 #include "EngineDLL.h"
 
@@ -22,6 +24,7 @@
 
 #include "UIManager.h"
 #include "Timer.h"
+#include "RenderThread.h"
 
 /**
  * @brief Map Containing game scenes.
@@ -109,8 +112,38 @@ namespace engine
 		*/
 		AssetManager* getAssetManager() const;
 
+		/**
+		 * @brief Selects whether frames are rendered on a thread of their
+		 * own, taking effect at the start of the next frame.
+		 * @param threaded True to render on the render thread.
+		 */
+		void setThreadedRendering(bool threaded);
+
 	private:
 
+		/**
+		 * @brief Clock measuring the latency of frames.
+		 */
+		typedef std::chrono::high_resolution_clock LatencyClock;
+
+		/**
+		 * @brief Switches to the selected rendering mode, reporting the
+		 * frames rendered in the old one.
+		 */
+		void switchRendering();
+
+		/**
+		 * @brief Prints the throughput and latency of the current rendering
+		 * mode and starts measuring anew.
+		 */
+		void reportRendering();
+
+		/**
+		 * @brief Adds a presented frame to the latency measurements.
+		 * @param start When the frame started, before its input was read.
+		 */
+		void recordLatency(LatencyClock::time_point start);
+
 		/**
 		 * @brief Dumps OpenGL info
 		 * @param stream Stream to use
@@ -141,5 +174,41 @@ namespace engine
 		 * @brief Timer to provide timestep info.
 		 */
 		Timer timer{};
+
+		/**
+		 * @brief Thread rendering the frames in threaded mode.
+		 */
+		RenderThread* renderThread{ nullptr };
+
+		/**
+		 * @brief Whether frames are rendered on the render thread.
+		 */
+		bool threadedRendering{ false };
+
+		/**
+		 * @brief Rendering mode to switch to at the start of the next frame.
+		 */
+		bool nextThreadedRendering{ false };
+
+		/**
+		 * @brief Timer measuring the time spent in the current mode.
+		 */
+		Timer renderingTimer{};
+
+		/**
+		 * @brief Frames started in the current mode.
+		 */
+		uint32_t renderingFrames{ 0 };
+
+		/**
+		 * @brief Latency of the frames presented in the current mode, from
+		 * reading input to swapping buffers, in microseconds.
+		 */
+		std::atomic<uint64_t> latencyTotal{ 0 };
+
+		/**
+		 * @brief Frames presented in the current mode.
+		 */
+		std::atomic<uint32_t> latencyFrames{ 0 };
 	};
 }
@@ -1,6 +1,6 @@
 /**
 * @file		EntityManager.cpp
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date		2017-03-05
 * @brief	Container for all the components for all entities
 */
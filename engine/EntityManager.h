@@ -24,7 +24,7 @@
 #include "Event.h"
 #include "Subscriber.h"
 
-// Br var mer n tillrckligt
+// Bör var mer än tillräckligt
 #define MAX_COMPONENTS 128
 
 #define USE_ASSERT 1
@@ -570,6 +570,15 @@ public:
 	typename std::enable_if<std::is_base_of<System, T>::value>::type
 		registerSystem(Args ... args);
 
+	/**
+	 * @brief Gets a registered system.
+	 * @tparam T System type.
+	 * @return Pointer to the first system of type T, nullptr if none.
+	 */
+	template <typename T>
+	typename std::enable_if<std::is_base_of<System, T>::value, T*>::type
+		getSystem();
+
 	/**
 	 * @brief Creates a new blank entity.
 	 * @return Entity Handle.
@@ -1028,7 +1037,7 @@ template <typename T, typename ... Args>
 typename std::enable_if<std::is_base_of<System, T>::value>::type
 EntityManager::registerSystem(Args ... args)
 {
-	T* system = new T(std::forward<Args...>(args)...);
+	T* system = new T(std::forward<Args>(args)...);
 
 	system->registerManagers(this, eventManager, assetManager, uiManager);
 
@@ -1037,6 +1046,21 @@ EntityManager::registerSystem(Args ... args)
 	system->startUp();
 }
 
+template <typename T>
+typename std::enable_if<std::is_base_of<System, T>::value, T*>::type
+EntityManager::getSystem()
+{
+	for (System* system : _systems)
+	{
+		T* result = dynamic_cast<T*>(system);
+
+		if (result)
+			return result;
+	}
+
+	return nullptr;
+}
+
 template <typename T, typename ... Args>
 typename std::enable_if<std::is_base_of<Component, T>::value>::type
 EntityManager::assignComponent(EntityHandle entHandle, Args... args)
@@ -0,0 +1,609 @@
+/**
+ * @file	FrameGraph.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Render passes of a frame ordered and culled by their resources
+ */
+
+#include "FrameGraph.h"
+
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
+#include <algorithm>
+#include <chrono>
+
+constexpr GLuint FrameGraph::NO_FRAMEBUFFER;
+
+namespace
+{
+	/**
+	 * @brief How a texture format is allocated.
+	 */
+	struct FormatInfo
+	{
+		/**
+		 * @brief Pixel format given to glTexImage2D.
+		 */
+		GLenum format;
+
+		/**
+		 * @brief Bytes per pixel, as assumed for the memory report.
+		 */
+		uint32_t bytesPerPixel;
+
+		/**
+		 * @brief Whether it is attached as depth.
+		 */
+		bool depth;
+	};
+
+	/**
+	 * @brief Gets how a texture format is allocated.
+	 * @param internalFormat The format.
+	 * @return Format info.
+	 */
+	FormatInfo getFormatInfo(GLenum internalFormat)
+	{
+		switch (internalFormat)
+		{
+		case GL_RGBA16F:
+			return FormatInfo{ GL_RGBA, 8, false };
+		case GL_RGB16F:
+			return FormatInfo{ GL_RGB, 6, false };
+		case GL_RGBA8:
+			return FormatInfo{ GL_RGBA, 4, false };
+		case GL_DEPTH_COMPONENT24:
+			return FormatInfo{ GL_DEPTH_COMPONENT, 4, true };
+		case GL_DEPTH_COMPONENT32F:
+			return FormatInfo{ GL_DEPTH_COMPONENT, 4, true };
+		default:
+			throw FrameGraph_error("Unsupported frame graph texture format");
+		}
+	}
+
+	/**
+	 * @brief Gets the size of a texture.
+	 * @param desc Description of the texture.
+	 * @return Size in bytes.
+	 */
+	uint64_t getTextureBytes(const FrameTextureDesc& desc)
+	{
+		return static_cast<uint64_t>(desc.width) * desc.height * getFormatInfo(desc.internalFormat).bytesPerPixel;
+	}
+
+	/**
+	 * @brief Checks if two textures are interchangeable.
+	 * @param lhs First description.
+	 * @param rhs Second description.
+	 * @return True if equal.
+	 */
+	bool equalDescs(const FrameTextureDesc& lhs, const FrameTextureDesc& rhs)
+	{
+		return lhs.width == rhs.width &&
+			lhs.height == rhs.height &&
+			lhs.internalFormat == rhs.internalFormat;
+	}
+}
+
+FramePassBuilder::FramePassBuilder(FrameGraph& graph, uint32_t pass)
+	: _graph{ graph }, _pass{ pass }
+{
+
+}
+
+FramePassBuilder& FramePassBuilder::read(FrameResource resource)
+{
+	_graph.checkResource(resource);
+
+	FrameGraph::Pass& pass = _graph._passes[_pass];
+
+	if (std::find(pass.writes.begin(), pass.writes.end(), resource) != pass.writes.end())
+	{
+		throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' reads and writes '").append(_graph._resources[resource].name).append("'"));
+	}
+
+	pass.reads.push_back(resource);
+
+	return *this;
+}
+
+FramePassBuilder& FramePassBuilder::write(FrameResource resource)
+{
+	_graph.checkResource(resource);
+
+	FrameGraph::Pass& pass = _graph._passes[_pass];
+
+	if (std::find(pass.reads.begin(), pass.reads.end(), resource) != pass.reads.end())
+	{
+		throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' reads and writes '").append(_graph._resources[resource].name).append("'"));
+	}
+
+	pass.writes.push_back(resource);
+
+	return *this;
+}
+
+FrameGraph::FrameGraph()
+{
+
+}
+
+FrameGraph::~FrameGraph()
+{
+	release();
+}
+
+void FrameGraph::reset()
+{
+	_resources.clear();
+	_passes.clear();
+	_compiled = false;
+}
+
+FrameResource FrameGraph::createTexture(const std::string& name, FrameTextureDesc desc)
+{
+	// Fails early on formats that cannot be allocated
+	getFormatInfo(desc.internalFormat);
+
+	_resources.push_back(Resource{ name, desc, false, NO_FRAMEBUFFER, -1, -1, 0 });
+
+	return static_cast<FrameResource>(_resources.size() - 1);
+}
+
+FrameResource FrameGraph::importResource(const std::string& name, GLuint framebuffer, GLsizei width, GLsizei height)
+{
+	_resources.push_back(Resource{ name, FrameTextureDesc{ width, height, GL_NONE }, true, framebuffer, -1, -1, 0 });
+
+	return static_cast<FrameResource>(_resources.size() - 1);
+}
+
+FramePassBuilder FrameGraph::addPass(const std::string& name, PassFunction execute)
+{
+	_passes.push_back(Pass{ name, execute, {}, {}, false, NO_FRAMEBUFFER, 0, 0 });
+
+	return FramePassBuilder{ *this, static_cast<uint32_t>(_passes.size() - 1) };
+}
+
+void FrameGraph::compile()
+{
+	cull();
+	findLifetimes();
+	allocateTextures();
+	assignFramebuffers();
+
+	_stats = FrameGraphStats{};
+
+	_stats.passes = static_cast<uint32_t>(_passes.size());
+
+	for (const Pass& pass : _passes)
+	{
+		if (!pass.kept)
+		{
+			++_stats.culledPasses;
+		}
+	}
+
+	for (const Resource& resource : _resources)
+	{
+		if (!resource.imported && resource.firstPass >= 0)
+		{
+			++_stats.textures;
+			_stats.textureBytes += getTextureBytes(resource.desc);
+		}
+	}
+
+	_stats.physicalTextures = static_cast<uint32_t>(_textures.size());
+
+	for (const PhysicalTexture& texture : _textures)
+	{
+		_stats.allocatedBytes += getTextureBytes(texture.desc);
+	}
+
+	_compiled = true;
+}
+
+void FrameGraph::execute()
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	if (!_compiled)
+	{
+		throw FrameGraph_error("Frame graph executed without being compiled");
+	}
+
+	GLState& state = GLState::get();
+
+	_reports.clear();
+
+	for (Pass& pass : _passes)
+	{
+		if (!pass.kept)
+		{
+			_reports.push_back(FramePassReport{ pass.name, true, 0.0 });
+			continue;
+		}
+
+		Clock::time_point start = Clock::now();
+
+		if (pass.framebuffer != NO_FRAMEBUFFER)
+		{
+			state.bindFramebuffer(pass.framebuffer);
+			state.viewport(0, 0, pass.width, pass.height);
+		}
+
+		pass.execute();
+
+		Clock::time_point end = Clock::now();
+
+		_reports.push_back(FramePassReport{ pass.name, false, std::chrono::duration<double, std::milli>(end - start).count() });
+	}
+}
+
+GLuint FrameGraph::getTexture(FrameResource resource) const
+{
+	checkResource(resource);
+
+	GLuint texture = _resources[resource].texture;
+
+	if (texture == 0)
+	{
+		throw FrameGraph_error(std::string("'").append(_resources[resource].name).append("' has no texture"));
+	}
+
+	return texture;
+}
+
+void FrameGraph::cull()
+{
+	// Resources a kept pass after the current one reads
+	std::vector<bool> needed(_resources.size(), false);
+
+	for (size_t i = 0; i < _resources.size(); ++i)
+	{
+		needed[i] = _resources[i].imported;
+	}
+
+	// Walk backwards, so every reader is decided before the passes it reads from
+	for (auto it = _passes.rbegin(); it != _passes.rend(); ++it)
+	{
+		Pass& pass = *it;
+
+		pass.kept = false;
+
+		for (FrameResource resource : pass.writes)
+		{
+			if (needed[resource])
+			{
+				pass.kept = true;
+				break;
+			}
+		}
+
+		if (pass.kept)
+		{
+			for (FrameResource resource : pass.reads)
+			{
+				needed[resource] = true;
+			}
+		}
+	}
+}
+
+void FrameGraph::findLifetimes()
+{
+	std::vector<bool> written(_resources.size(), false);
+
+	for (size_t i = 0; i < _passes.size(); ++i)
+	{
+		const Pass& pass = _passes[i];
+
+		if (!pass.kept)
+		{
+			continue;
+		}
+
+		int32_t index = static_cast<int32_t>(i);
+
+		for (FrameResource resource : pass.reads)
+		{
+			Resource& read = _resources[resource];
+
+			if (!read.imported && !written[resource])
+			{
+				throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' reads '").append(read.name).append("' before it is written"));
+			}
+
+			read.lastPass = index;
+		}
+
+		for (FrameResource resource : pass.writes)
+		{
+			Resource& write = _resources[resource];
+
+			if (write.firstPass < 0)
+			{
+				write.firstPass = index;
+			}
+
+			write.lastPass = index;
+			written[resource] = true;
+		}
+	}
+}
+
+void FrameGraph::allocateTextures()
+{
+	for (PhysicalTexture& texture : _textures)
+	{
+		texture.used = false;
+		texture.busyUntil = -1;
+	}
+
+	for (size_t i = 0; i < _passes.size(); ++i)
+	{
+		const Pass& pass = _passes[i];
+
+		if (!pass.kept)
+		{
+			continue;
+		}
+
+		int32_t index = static_cast<int32_t>(i);
+
+		// Resources start with a write, so only writes can be first uses
+		for (FrameResource id : pass.writes)
+		{
+			Resource& resource = _resources[id];
+
+			if (resource.imported || resource.firstPass != index)
+			{
+				continue;
+			}
+
+			PhysicalTexture& texture = _textures[acquireTexture(resource.desc, index)];
+
+			texture.used = true;
+			texture.busyUntil = resource.lastPass;
+
+			resource.texture = texture.texture;
+		}
+	}
+
+	releaseUnusedTextures();
+}
+
+size_t FrameGraph::acquireTexture(const FrameTextureDesc& desc, int32_t pass)
+{
+	for (size_t i = 0; i < _textures.size(); ++i)
+	{
+		const PhysicalTexture& texture = _textures[i];
+
+		// Free if no resource of this frame holds it past the previous pass
+		if (equalDescs(texture.desc, desc) && (!texture.used || texture.busyUntil < pass))
+		{
+			return i;
+		}
+	}
+
+	FormatInfo info = getFormatInfo(desc.internalFormat);
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	GLuint handle = device.createTexture();
+
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, handle);
+
+	device.texImage2D(
+		GL_TEXTURE_2D,
+		desc.internalFormat,
+		desc.width,
+		desc.height,
+		info.format,
+		GL_FLOAT,
+		nullptr);
+
+	GLint filter = info.depth ? GL_NEAREST : GL_LINEAR;
+
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	_textures.push_back(PhysicalTexture{ desc, handle, false, -1 });
+
+	return _textures.size() - 1;
+}
+
+void FrameGraph::releaseUnusedTextures()
+{
+	std::vector<GLuint> unused;
+
+	for (const PhysicalTexture& texture : _textures)
+	{
+		if (!texture.used)
+		{
+			unused.push_back(texture.texture);
+		}
+	}
+
+	if (unused.empty())
+	{
+		return;
+	}
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	for (auto it = _framebuffers.begin(); it != _framebuffers.end();)
+	{
+		bool stale = std::find_first_of(it->first.begin(), it->first.end(), unused.begin(), unused.end()) != it->first.end();
+
+		if (stale)
+		{
+			device.deleteFramebuffer(it->second);
+			it = _framebuffers.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (GLuint texture : unused)
+	{
+		device.deleteTexture(texture);
+	}
+
+	_textures.erase(
+		std::remove_if(_textures.begin(), _textures.end(), [](const PhysicalTexture& texture) { return !texture.used; }),
+		_textures.end());
+
+	// Deleting unbinds the objects behind the back of the cache
+	GLState::get().invalidate();
+}
+
+void FrameGraph::assignFramebuffers()
+{
+	for (Pass& pass : _passes)
+	{
+		pass.framebuffer = NO_FRAMEBUFFER;
+
+		if (!pass.kept)
+		{
+			continue;
+		}
+
+		std::vector<GLuint> colors;
+		GLuint depth = 0;
+		bool sized = false;
+
+		for (FrameResource id : pass.writes)
+		{
+			const Resource& resource = _resources[id];
+
+			if (resource.imported)
+			{
+				if (resource.framebuffer == NO_FRAMEBUFFER)
+				{
+					continue;
+				}
+
+				if (pass.framebuffer != NO_FRAMEBUFFER || !colors.empty() || depth != 0)
+				{
+					throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' writes more than one framebuffer"));
+				}
+
+				pass.framebuffer = resource.framebuffer;
+				pass.width = resource.desc.width;
+				pass.height = resource.desc.height;
+				continue;
+			}
+
+			if (pass.framebuffer != NO_FRAMEBUFFER)
+			{
+				throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' writes more than one framebuffer"));
+			}
+
+			if (sized && (resource.desc.width != pass.width || resource.desc.height != pass.height))
+			{
+				throw FrameGraph_error(std::string("Pass '").append(pass.name).append("' writes textures of different sizes"));
+			}
+
+			pass.width = resource.desc.width;
+			pass.height = resource.desc.height;
+			sized = true;
+
+			if (getFormatInfo(resource.desc.internalFormat).depth)
+			{
+				depth = resource.texture;
+			}
+			else
+			{
+				colors.push_back(resource.texture);
+			}
+		}
+
+		if (sized)
+		{
+			pass.framebuffer = getFramebuffer(colors, depth);
+		}
+	}
+}
+
+GLuint FrameGraph::getFramebuffer(const std::vector<GLuint>& colors, GLuint depth)
+{
+	std::vector<GLuint> key = colors;
+
+	key.push_back(0);
+	key.push_back(depth);
+
+	auto it = _framebuffers.find(key);
+
+	if (it != _framebuffers.end())
+	{
+		return it->second;
+	}
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	GLuint framebuffer = device.createFramebuffer();
+
+	GLState::get().bindFramebuffer(framebuffer);
+
+	std::vector<GLenum> attachments;
+
+	for (size_t i = 0; i < colors.size(); ++i)
+	{
+		GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+
+		device.framebufferTexture(attachment, GL_TEXTURE_2D, colors[i]);
+
+		attachments.push_back(attachment);
+	}
+
+	if (depth != 0)
+	{
+		device.framebufferTexture(GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth);
+	}
+
+	device.drawBuffers(static_cast<GLsizei>(attachments.size()), attachments.data());
+
+	if (!device.isFramebufferComplete())
+	{
+		throw FrameGraph_error("Frame graph framebuffer not complete");
+	}
+
+	_framebuffers.emplace(key, framebuffer);
+
+	return framebuffer;
+}
+
+void FrameGraph::release()
+{
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	for (auto& framebuffer : _framebuffers)
+	{
+		device.deleteFramebuffer(framebuffer.second);
+	}
+
+	_framebuffers.clear();
+
+	for (PhysicalTexture& texture : _textures)
+	{
+		device.deleteTexture(texture.texture);
+	}
+
+	_textures.clear();
+
+	GLState::get().invalidate();
+}
+
+void FrameGraph::checkResource(FrameResource resource) const
+{
+	if (resource >= _resources.size())
+	{
+		throw FrameGraph_error("Unknown frame graph resource");
+	}
+}
@@ -0,0 +1,479 @@
+/**
+ * @file	FrameGraph.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Render passes of a frame ordered and culled by their resources
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <stdexcept>
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+/**
+ * @brief FrameGraph error class
+ */
+class FrameGraph_error : public std::logic_error {
+	using std::logic_error::logic_error;
+};
+
+/**
+ * @brief Handle of a resource in the frame graph.
+ */
+typedef uint32_t FrameResource;
+
+/**
+ * @brief Description of a texture created by the frame graph.
+ */
+struct FrameTextureDesc
+{
+	/**
+	 * @brief Width in pixels.
+	 */
+	GLsizei width;
+
+	/**
+	 * @brief Height in pixels.
+	 */
+	GLsizei height;
+
+	/**
+	 * @brief GL_RGBA16F, GL_RGB16F, GL_RGBA8, GL_DEPTH_COMPONENT24 or
+	 * GL_DEPTH_COMPONENT32F.
+	 */
+	GLenum internalFormat;
+};
+
+/**
+ * @brief What a pass cost in the last executed frame.
+ */
+struct FramePassReport
+{
+	/**
+	 * @brief Name of the pass.
+	 */
+	std::string name;
+
+	/**
+	 * @brief Whether the pass was culled.
+	 */
+	bool culled;
+
+	/**
+	 * @brief CPU time spent issuing the pass, in milliseconds.
+	 */
+	double time;
+};
+
+/**
+ * @brief Resources and passes of the last compiled frame.
+ */
+struct FrameGraphStats
+{
+	/**
+	 * @brief Number of passes added.
+	 */
+	uint32_t passes{ 0 };
+
+	/**
+	 * @brief Number of passes culled.
+	 */
+	uint32_t culledPasses{ 0 };
+
+	/**
+	 * @brief Number of textures used by passes that are kept.
+	 */
+	uint32_t textures{ 0 };
+
+	/**
+	 * @brief Number of textures allocated to hold them.
+	 */
+	uint32_t physicalTextures{ 0 };
+
+	/**
+	 * @brief Bytes the used textures would take without aliasing.
+	 */
+	uint64_t textureBytes{ 0 };
+
+	/**
+	 * @brief Bytes of the allocated textures.
+	 */
+	uint64_t allocatedBytes{ 0 };
+};
+
+class FrameGraph;
+
+/**
+ * @brief Declares the resources a pass reads and writes.
+ */
+class FramePassBuilder
+{
+public:
+	/**
+	 * @brief Declares a resource the pass reads.
+	 * @param resource The resource.
+	 * @return Ref. to self.
+	 */
+	FramePassBuilder& read(FrameResource resource);
+
+	/**
+	 * @brief Declares a resource the pass writes. Written textures are
+	 * attached to the framebuffer of the pass in the order they are
+	 * declared, depth textures to the depth attachment.
+	 * @param resource The resource.
+	 * @return Ref. to self.
+	 */
+	FramePassBuilder& write(FrameResource resource);
+
+private:
+	friend class FrameGraph;
+
+	/**
+	 * @brief Constructor.
+	 * @param graph The graph.
+	 * @param pass Index of the pass.
+	 */
+	FramePassBuilder(FrameGraph& graph, uint32_t pass);
+
+	/**
+	 * @brief The graph.
+	 */
+	FrameGraph& _graph;
+
+	/**
+	 * @brief Index of the pass.
+	 */
+	uint32_t _pass;
+};
+
+/**
+ * @brief Passes of a frame, declared with the resources they read and write.
+ *
+ * The frame is declared again every frame: reset(), the resources and the
+ * passes in the order they run, then compile() and execute().
+ *
+ * Passes writing an imported resource are always kept. Any other pass is
+ * culled unless a later pass that is kept reads something it writes.
+ *
+ * Textures created through the graph only live from the first to the last
+ * pass that is kept and uses them. Textures with the same description whose
+ * lifetimes do not overlap share one OpenGL texture. The textures and the
+ * framebuffers made from them are kept between frames and deleted in the
+ * first frame that does not use them.
+ *
+ * Before a pass runs, the framebuffer of the textures it writes is bound and
+ * the viewport set to their size. A pass writing an imported framebuffer
+ * gets that bound instead, and a pass writing neither binds its own. Render
+ * to texture followed by sampling needs no barrier in OpenGL, so the graph
+ * only rejects passes that read what they write.
+ */
+class FrameGraph
+{
+public:
+	/**
+	 * @brief Function issuing the commands of a pass.
+	 */
+	typedef std::function<void()> PassFunction;
+
+	/**
+	 * @brief Constructor.
+	 */
+	FrameGraph();
+
+	/**
+	 * @brief Destructor. Deletes the textures and framebuffers.
+	 */
+	~FrameGraph();
+
+	/**
+	 * @brief Constructor
+	 */
+	FrameGraph(const FrameGraph&) = delete;
+
+	/**
+	 * @brief Assignment operator
+	 * @return Ref. to self.
+	 */
+	FrameGraph& operator=(const FrameGraph&) = delete;
+
+	/**
+	 * @brief Removes all passes and resources, keeping the allocated
+	 * textures for the next frame.
+	 */
+	void reset();
+
+	/**
+	 * @brief Declares a texture the graph allocates.
+	 * @param name Name used in reports.
+	 * @param desc Description of the texture.
+	 * @return The resource.
+	 */
+	FrameResource createTexture(const std::string& name, FrameTextureDesc desc);
+
+	/**
+	 * @brief Declares a resource owned outside the graph, such as the
+	 * screen or the shadow maps.
+	 * @param name Name used in reports.
+	 * @param framebuffer Framebuffer bound for passes writing the resource,
+	 * or NO_FRAMEBUFFER if they bind their own.
+	 * @param width Width of the framebuffer.
+	 * @param height Height of the framebuffer.
+	 * @return The resource.
+	 */
+	FrameResource importResource(const std::string& name, GLuint framebuffer = NO_FRAMEBUFFER, GLsizei width = 0, GLsizei height = 0);
+
+	/**
+	 * @brief Adds a pass, after all passes added before it.
+	 * @param name Name used in reports.
+	 * @param execute Issues the commands of the pass.
+	 * @return Builder declaring the resources of the pass.
+	 */
+	FramePassBuilder addPass(const std::string& name, PassFunction execute);
+
+	/**
+	 * @brief Culls passes, allocates textures and derives framebuffers.
+	 */
+	void compile();
+
+	/**
+	 * @brief Runs the passes that are kept.
+	 */
+	void execute();
+
+	/**
+	 * @brief Gets the texture holding a resource, for passes to bind.
+	 * @param resource A texture created through the graph and used by the
+	 * pass.
+	 * @return Texture handle.
+	 */
+	GLuint getTexture(FrameResource resource) const;
+
+	/**
+	 * @brief Gets the resources and passes of the last compiled frame.
+	 * @return Statistics.
+	 */
+	const FrameGraphStats& getStats() const { return _stats; }
+
+	/**
+	 * @brief Gets the passes of the last executed frame.
+	 * @return One report per pass, in order.
+	 */
+	const std::vector<FramePassReport>& getPassReports() const { return _reports; }
+
+	/**
+	 * @brief Imported resource that binds no framebuffer.
+	 */
+	static constexpr GLuint NO_FRAMEBUFFER{ 0xFFFFFFFFu };
+
+private:
+	friend class FramePassBuilder;
+
+	/**
+	 * @brief Resource declared this frame.
+	 */
+	struct Resource
+	{
+		/**
+		 * @brief Name used in reports.
+		 */
+		std::string name;
+
+		/**
+		 * @brief Description, if created by the graph.
+		 */
+		FrameTextureDesc desc;
+
+		/**
+		 * @brief Whether the resource is owned outside the graph.
+		 */
+		bool imported;
+
+		/**
+		 * @brief Framebuffer of an imported resource.
+		 */
+		GLuint framebuffer;
+
+		/**
+		 * @brief First pass kept that uses the resource, -1 if none.
+		 */
+		int32_t firstPass;
+
+		/**
+		 * @brief Last pass kept that uses the resource, -1 if none.
+		 */
+		int32_t lastPass;
+
+		/**
+		 * @brief Texture holding the resource, 0 until allocated.
+		 */
+		GLuint texture;
+	};
+
+	/**
+	 * @brief Pass declared this frame.
+	 */
+	struct Pass
+	{
+		/**
+		 * @brief Name used in reports.
+		 */
+		std::string name;
+
+		/**
+		 * @brief Issues the commands of the pass.
+		 */
+		PassFunction execute;
+
+		/**
+		 * @brief Resources read.
+		 */
+		std::vector<FrameResource> reads;
+
+		/**
+		 * @brief Resources written.
+		 */
+		std::vector<FrameResource> writes;
+
+		/**
+		 * @brief Whether the pass is kept.
+		 */
+		bool kept;
+
+		/**
+		 * @brief Framebuffer bound before the pass, or NO_FRAMEBUFFER.
+		 */
+		GLuint framebuffer;
+
+		/**
+		 * @brief Width of the framebuffer.
+		 */
+		GLsizei width;
+
+		/**
+		 * @brief Height of the framebuffer.
+		 */
+		GLsizei height;
+	};
+
+	/**
+	 * @brief Texture allocated by the graph.
+	 */
+	struct PhysicalTexture
+	{
+		/**
+		 * @brief Description of the texture.
+		 */
+		FrameTextureDesc desc;
+
+		/**
+		 * @brief OpenGL handle.
+		 */
+		GLuint texture;
+
+		/**
+		 * @brief Whether a resource uses the texture this frame.
+		 */
+		bool used;
+
+		/**
+		 * @brief Last pass of the resource using the texture.
+		 */
+		int32_t busyUntil;
+	};
+
+	/**
+	 * @brief Marks the passes to keep.
+	 */
+	void cull();
+
+	/**
+	 * @brief Finds the first and last pass kept using every resource.
+	 */
+	void findLifetimes();
+
+	/**
+	 * @brief Gives every used texture resource a texture, reusing textures
+	 * whose last user has finished.
+	 */
+	void allocateTextures();
+
+	/**
+	 * @brief Gets a texture that is free at a pass, creating one if needed.
+	 * @param desc Description of the texture.
+	 * @param pass The pass.
+	 * @return Index in _textures.
+	 */
+	size_t acquireTexture(const FrameTextureDesc& desc, int32_t pass);
+
+	/**
+	 * @brief Deletes the textures no resource used this frame.
+	 */
+	void releaseUnusedTextures();
+
+	/**
+	 * @brief Picks the framebuffer of every pass that is kept.
+	 */
+	void assignFramebuffers();
+
+	/**
+	 * @brief Gets the framebuffer with a set of attachments, creating it if
+	 * needed.
+	 * @param colors Color attachments, in order.
+	 * @param depth Depth attachment, or 0.
+	 * @return Framebuffer handle.
+	 */
+	GLuint getFramebuffer(const std::vector<GLuint>& colors, GLuint depth);
+
+	/**
+	 * @brief Deletes all textures and framebuffers.
+	 */
+	void release();
+
+	/**
+	 * @brief Checks that a handle names a resource of this frame.
+	 * @param resource The resource.
+	 */
+	void checkResource(FrameResource resource) const;
+
+	/**
+	 * @brief Resources of this frame.
+	 */
+	std::vector<Resource> _resources;
+
+	/**
+	 * @brief Passes of this frame, in order.
+	 */
+	std::vector<Pass> _passes;
+
+	/**
+	 * @brief Textures allocated by the graph.
+	 */
+	std::vector<PhysicalTexture> _textures;
+
+	/**
+	 * @brief Framebuffers by their color attachments, followed by 0 and
+	 * the depth attachment.
+	 */
+	std::map<std::vector<GLuint>, GLuint> _framebuffers;
+
+	/**
+	 * @brief Whether the frame has been compiled since it was reset.
+	 */
+	bool _compiled{ false };
+
+	/**
+	 * @brief Statistics of the last compiled frame.
+	 */
+	FrameGraphStats _stats{};
+
+	/**
+	 * @brief Passes of the last executed frame.
+	 */
+	std::vector<FramePassReport> _reports;
+};
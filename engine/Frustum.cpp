@@ -0,0 +1,74 @@
+/**
+ * @file	Frustum.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	View frustum for culling
+ */
+
+#include "Frustum.h"
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProj)
+{
+	// Rows of the matrix, glm stores it by column
+	glm::vec4 rows[4];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		rows[i] = glm::vec4{ viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i] };
+	}
+
+	Frustum result;
+
+	result.planes[0] = rows[3] + rows[0];
+	result.planes[1] = rows[3] - rows[0];
+	result.planes[2] = rows[3] + rows[1];
+	result.planes[3] = rows[3] - rows[1];
+	result.planes[4] = rows[3] + rows[2];
+	result.planes[5] = rows[3] - rows[2];
+
+	for (glm::vec4& plane : result.planes)
+	{
+		plane /= glm::length(glm::vec3{ plane });
+	}
+
+	return result;
+}
+
+Containment Frustum::classify(const AABB& aabb) const
+{
+	Containment result = CONTAINMENT_INSIDE;
+
+	for (const glm::vec4& plane : planes)
+	{
+		glm::vec3 normal{ plane };
+
+		// Corners furthest along and against the normal
+		glm::vec3 positive = glm::mix(aabb.min, aabb.max, glm::greaterThanEqual(normal, glm::vec3{ 0.f }));
+		glm::vec3 negative = glm::mix(aabb.max, aabb.min, glm::greaterThanEqual(normal, glm::vec3{ 0.f }));
+
+		if (glm::dot(normal, positive) + plane.w < 0.f)
+		{
+			return CONTAINMENT_OUTSIDE;
+		}
+
+		if (glm::dot(normal, negative) + plane.w < 0.f)
+		{
+			result = CONTAINMENT_PARTIAL;
+		}
+	}
+
+	return result;
+}
+
+bool Frustum::intersectsSphere(glm::vec3 center, float radius) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3{ plane }, center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file	Frustum.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	View frustum for culling
+ */
+
+#pragma once
+
+#include "AABB.h"
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief The six planes bounding what a camera can see.
+ *
+ * Every plane is stored as a normal pointing into the frustum and a
+ * distance, so a point p is inside when dot(normal, p) + w >= 0 for all
+ * planes.
+ */
+struct Frustum
+{
+	/**
+	 * @brief Left, right, bottom, top, near and far planes.
+	 */
+	glm::vec4 planes[6];
+
+	/**
+	 * @brief Extracts the planes of a projection times view matrix.
+	 * @param viewProj The matrix.
+	 * @return The frustum, in the space the matrix transforms from.
+	 */
+	static Frustum fromMatrix(const glm::mat4& viewProj);
+
+	/**
+	 * @brief Tests a box against the frustum.
+	 * @param aabb The box.
+	 * @return Where the box lies. Boxes near the corners may be reported
+	 * partly inside although they are outside.
+	 */
+	Containment classify(const AABB& aabb) const;
+
+	/**
+	 * @brief Tests a sphere against the frustum.
+	 * @param center Center of the sphere.
+	 * @param radius Radius of the sphere.
+	 * @return False if the sphere is outside.
+	 */
+	bool intersectsSphere(glm::vec3 center, float radius) const;
+};
@@ -0,0 +1,179 @@
+/**
+ * @file	FrustumCuller.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Culls bounding spheres against a frustum
+ */
+
+#include "FrustumCuller.h"
+
+#include <utility>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define FRUSTUM_CULLER_SSE
+#include <xmmintrin.h>
+#endif
+
+void FrustumCuller::SphereSet::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	radius.clear();
+	id.clear();
+}
+
+void FrustumCuller::SphereSet::push(uint32_t sphereId, glm::vec3 center, float sphereRadius)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	z.push_back(center.z);
+	radius.push_back(sphereRadius);
+	id.push_back(sphereId);
+}
+
+bool FrustumCuller::SphereSet::equals(const SphereSet& other) const
+{
+	return id == other.id && x == other.x && y == other.y && z == other.z && radius == other.radius;
+}
+
+void FrustumCuller::clear()
+{
+	_static.clear();
+	_dynamic.clear();
+}
+
+void FrustumCuller::add(uint32_t id, glm::vec3 center, float radius, bool isStatic)
+{
+	(isStatic ? _static : _dynamic).push(id, center, radius);
+}
+
+void FrustumCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible)
+{
+	_stats = CullStats{};
+
+	size_t firstVisible = visible.size();
+
+	updateHierarchy();
+
+	// Whole subtrees are accepted or rejected, only the leaves cut by the
+	// frustum are tested sphere by sphere
+	_candidates.clear();
+
+	uint32_t reached = 0;
+
+	_hierarchy.traverse([&](const AABB& aabb)
+	{
+		return frustum.classify(aabb);
+	},
+	[&](const StaticBVH::Item& item, bool inside)
+	{
+		uint32_t index = item.ent;
+
+		++reached;
+
+		if (inside)
+		{
+			visible.push_back(_built.id[index]);
+		}
+		else
+		{
+			_candidates.push(_built.id[index], glm::vec3{ _built.x[index], _built.y[index], _built.z[index] }, _built.radius[index]);
+		}
+	});
+
+	_stats.hierarchyResolved = static_cast<uint32_t>(_built.id.size()) - reached + static_cast<uint32_t>(visible.size() - firstVisible);
+
+	testSpheres(frustum, _candidates, visible);
+	testSpheres(frustum, _dynamic, visible);
+
+	_stats.visible = static_cast<uint32_t>(visible.size() - firstVisible);
+	_stats.culled = static_cast<uint32_t>(_built.id.size() + _dynamic.id.size()) - _stats.visible;
+}
+
+void FrustumCuller::testSpheres(const Frustum& frustum, const SphereSet& spheres, std::vector<uint32_t>& visible)
+{
+	size_t count = spheres.id.size();
+
+	_stats.sphereTests += static_cast<uint32_t>(count);
+
+	size_t i = 0;
+
+#ifdef FRUSTUM_CULLER_SSE
+	__m128 planeX[6];
+	__m128 planeY[6];
+	__m128 planeZ[6];
+	__m128 planeW[6];
+
+	for (int p = 0; p < 6; ++p)
+	{
+		planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+		planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+		planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+		planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+	}
+
+	__m128 zero = _mm_setzero_ps();
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&spheres.x[i]);
+		__m128 y = _mm_loadu_ps(&spheres.y[i]);
+		__m128 z = _mm_loadu_ps(&spheres.z[i]);
+		__m128 r = _mm_loadu_ps(&spheres.radius[i]);
+
+		// A sphere is outside if it is behind any plane by more than its radius
+		__m128 outside = zero;
+
+		for (int p = 0; p < 6; ++p)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, r), zero));
+		}
+
+		int mask = _mm_movemask_ps(outside);
+
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			if (!(mask & (1 << lane)))
+			{
+				visible.push_back(spheres.id[i + lane]);
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (frustum.intersectsSphere(glm::vec3{ spheres.x[i], spheres.y[i], spheres.z[i] }, spheres.radius[i]))
+		{
+			visible.push_back(spheres.id[i]);
+		}
+	}
+}
+
+void FrustumCuller::updateHierarchy()
+{
+	if (_static.equals(_built))
+	{
+		return;
+	}
+
+	std::swap(_static, _built);
+
+	std::vector<StaticBVH::Item> items;
+
+	items.reserve(_built.id.size());
+
+	for (uint32_t i = 0; i < _built.id.size(); ++i)
+	{
+		glm::vec3 center{ _built.x[i], _built.y[i], _built.z[i] };
+
+		items.push_back(StaticBVH::Item{ AABB::fromCenter(center, glm::vec3{ _built.radius[i] }), i });
+	}
+
+	_hierarchy.build(std::move(items));
+}
@@ -0,0 +1,176 @@
+/**
+ * @file	FrustumCuller.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Culls bounding spheres against a frustum
+ */
+
+#pragma once
+
+#include "Frustum.h"
+#include "StaticBVH.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Statistics from the last cull.
+ */
+struct CullStats
+{
+	/**
+	 * @brief Number of spheres that are visible.
+	 */
+	uint32_t visible{ 0 };
+
+	/**
+	 * @brief Number of spheres that were culled.
+	 */
+	uint32_t culled{ 0 };
+
+	/**
+	 * @brief Number of spheres tested one by one.
+	 */
+	uint32_t sphereTests{ 0 };
+
+	/**
+	 * @brief Number of static spheres accepted or rejected with their subtree.
+	 */
+	uint32_t hierarchyResolved{ 0 };
+};
+
+/**
+ * @brief Finds which bounding spheres a frustum can see.
+ *
+ * Static spheres are kept in a StaticBVH that is only rebuilt when they
+ * change. Subtrees outside the frustum are rejected and subtrees inside it
+ * accepted without looking at their spheres. The remaining spheres, and all
+ * moving ones, are tested four at a time with SSE.
+ */
+class FrustumCuller
+{
+public:
+	/**
+	 * @brief Removes all spheres.
+	 */
+	void clear();
+
+	/**
+	 * @brief Adds a sphere.
+	 * @param id Id reported if the sphere is visible.
+	 * @param center Center in world space.
+	 * @param radius Radius.
+	 * @param isStatic Whether the sphere does not move between frames.
+	 */
+	void add(uint32_t id, glm::vec3 center, float radius, bool isStatic);
+
+	/**
+	 * @brief Finds the visible spheres.
+	 * @param frustum The frustum.
+	 * @param visible Ids of the visible spheres are added here.
+	 */
+	void cull(const Frustum& frustum, std::vector<uint32_t>& visible);
+
+	/**
+	 * @brief Gets the statistics of the last cull.
+	 * @return Statistics.
+	 */
+	const CullStats& getStats() const { return _stats; }
+
+private:
+	/**
+	 * @brief Spheres in arrays per coordinate.
+	 */
+	struct SphereSet
+	{
+		/**
+		 * @brief Center x.
+		 */
+		std::vector<float> x;
+
+		/**
+		 * @brief Center y.
+		 */
+		std::vector<float> y;
+
+		/**
+		 * @brief Center z.
+		 */
+		std::vector<float> z;
+
+		/**
+		 * @brief Radius.
+		 */
+		std::vector<float> radius;
+
+		/**
+		 * @brief Id.
+		 */
+		std::vector<uint32_t> id;
+
+		/**
+		 * @brief Removes all spheres.
+		 */
+		void clear();
+
+		/**
+		 * @brief Adds a sphere.
+		 * @param sphereId Id.
+		 * @param center Center.
+		 * @param sphereRadius Radius.
+		 */
+		void push(uint32_t sphereId, glm::vec3 center, float sphereRadius);
+
+		/**
+		 * @brief Checks if two sets hold the same spheres in the same order.
+		 * @param other The other set.
+		 * @return True if equal.
+		 */
+		bool equals(const SphereSet& other) const;
+	};
+
+	/**
+	 * @brief Tests every sphere of a set.
+	 * @param frustum The frustum.
+	 * @param spheres The spheres.
+	 * @param visible Ids of the visible spheres are added here.
+	 */
+	void testSpheres(const Frustum& frustum, const SphereSet& spheres, std::vector<uint32_t>& visible);
+
+	/**
+	 * @brief Rebuilds the hierarchy if the static spheres changed.
+	 */
+	void updateHierarchy();
+
+	/**
+	 * @brief Static spheres added since the last clear.
+	 */
+	SphereSet _static{};
+
+	/**
+	 * @brief Moving spheres added since the last clear.
+	 */
+	SphereSet _dynamic{};
+
+	/**
+	 * @brief Static spheres the hierarchy was built from.
+	 */
+	SphereSet _built{};
+
+	/**
+	 * @brief Static spheres in leaves partly inside the frustum.
+	 */
+	SphereSet _candidates{};
+
+	/**
+	 * @brief Hierarchy over _built. The entity of every item is the index of its sphere.
+	 */
+	StaticBVH _hierarchy{};
+
+	/**
+	 * @brief Statistics of the last cull.
+	 */
+	CullStats _stats{};
+};
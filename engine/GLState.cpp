@@ -0,0 +1,283 @@
+/**
+ * @file	GLState.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Cache of OpenGL state that filters redundant changes
+ */
+
+#include "GLState.h"
+
+#include "GraphicsDevice.h"
+
+constexpr GLuint GLState::MAX_TEXTURE_UNITS;
+constexpr GLuint GLState::UNKNOWN;
+
+GLState& GLState::get()
+{
+	static GLState state{};
+
+	return state;
+}
+
+GLState::GLState()
+{
+	invalidate();
+}
+
+void GLState::beginFrame()
+{
+	_lastFrame = _stats;
+	_stats = GLStateStats{};
+
+	invalidate();
+}
+
+void GLState::invalidate()
+{
+	_program = UNKNOWN;
+	_vertexArray = UNKNOWN;
+	_arrayBuffer = UNKNOWN;
+	_elementBuffers.clear();
+	_framebuffer = UNKNOWN;
+	_activeTexture = UNKNOWN;
+
+	for (TextureUnit& unit : _textures)
+	{
+		unit = TextureUnit{ UNKNOWN, UNKNOWN, UNKNOWN };
+	}
+
+	_depthTest = UNKNOWN;
+	_cullFace = UNKNOWN;
+	_blend = UNKNOWN;
+	_cullMode = UNKNOWN;
+	_depthFunc = UNKNOWN;
+	_blendSource = UNKNOWN;
+	_blendDestination = UNKNOWN;
+	_polygonMode = UNKNOWN;
+
+	for (GLuint& value : _viewport)
+	{
+		value = UNKNOWN;
+	}
+}
+
+void GLState::invalidateBuffers()
+{
+	_arrayBuffer = UNKNOWN;
+	_elementBuffers.clear();
+}
+
+void GLState::useProgram(GLuint program)
+{
+	if (change(_program, program))
+	{
+		GraphicsDevice::get().useProgram(program);
+	}
+}
+
+void GLState::bindVertexArray(GLuint vao)
+{
+	if (change(_vertexArray, vao))
+	{
+		GraphicsDevice::get().bindVertexArray(vao);
+	}
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+	if (target == GL_ARRAY_BUFFER)
+	{
+		if (change(_arrayBuffer, buffer))
+		{
+			GraphicsDevice::get().bindBuffer(target, buffer);
+		}
+
+		return;
+	}
+
+	// The element buffer belongs to the bound vertex array
+	if (target == GL_ELEMENT_ARRAY_BUFFER && _vertexArray != UNKNOWN)
+	{
+		auto it = _elementBuffers.emplace(_vertexArray, UNKNOWN).first;
+
+		if (change(it->second, buffer))
+		{
+			GraphicsDevice::get().bindBuffer(target, buffer);
+		}
+
+		return;
+	}
+
+	++_stats.issued;
+	GraphicsDevice::get().bindBuffer(target, buffer);
+}
+
+void GLState::bindFramebuffer(GLuint framebuffer)
+{
+	if (change(_framebuffer, framebuffer))
+	{
+		GraphicsDevice::get().bindFramebuffer(framebuffer);
+	}
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	GLuint* cached = nullptr;
+
+	if (unit < MAX_TEXTURE_UNITS)
+	{
+		switch (target)
+		{
+		case GL_TEXTURE_2D:
+			cached = &_textures[unit].texture2D;
+			break;
+		case GL_TEXTURE_CUBE_MAP:
+			cached = &_textures[unit].cubeMap;
+			break;
+		case GL_TEXTURE_BUFFER:
+			cached = &_textures[unit].buffer;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (!cached)
+	{
+		activeTexture(unit);
+
+		++_stats.issued;
+		GraphicsDevice::get().bindTexture(target, texture);
+		return;
+	}
+
+	if (*cached == texture)
+	{
+		++_stats.filtered;
+		return;
+	}
+
+	activeTexture(unit);
+
+	change(*cached, texture);
+	GraphicsDevice::get().bindTexture(target, texture);
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+	if (change(_activeTexture, unit))
+	{
+		GraphicsDevice::get().activeTexture(unit);
+	}
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled)
+{
+	GLuint* cached = nullptr;
+
+	switch (capability)
+	{
+	case GL_DEPTH_TEST:
+		cached = &_depthTest;
+		break;
+	case GL_CULL_FACE:
+		cached = &_cullFace;
+		break;
+	case GL_BLEND:
+		cached = &_blend;
+		break;
+	default:
+		break;
+	}
+
+	if (cached && !change(*cached, enabled ? 1 : 0))
+	{
+		return;
+	}
+
+	if (!cached)
+	{
+		++_stats.issued;
+	}
+
+	GraphicsDevice::get().setEnabled(capability, enabled);
+}
+
+void GLState::cullFace(GLenum mode)
+{
+	if (change(_cullMode, mode))
+	{
+		GraphicsDevice::get().cullFace(mode);
+	}
+}
+
+void GLState::depthFunc(GLenum func)
+{
+	if (change(_depthFunc, func))
+	{
+		GraphicsDevice::get().depthFunc(func);
+	}
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination)
+{
+	if (_blendSource == source && _blendDestination == destination)
+	{
+		++_stats.filtered;
+		return;
+	}
+
+	++_stats.issued;
+
+	_blendSource = source;
+	_blendDestination = destination;
+
+	GraphicsDevice::get().blendFunc(source, destination);
+}
+
+void GLState::polygonMode(GLenum mode)
+{
+	if (change(_polygonMode, mode))
+	{
+		GraphicsDevice::get().polygonMode(mode);
+	}
+}
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	GLuint value[4] = {
+		static_cast<GLuint>(x),
+		static_cast<GLuint>(y),
+		static_cast<GLuint>(width),
+		static_cast<GLuint>(height) };
+
+	if (value[0] == _viewport[0] && value[1] == _viewport[1] && value[2] == _viewport[2] && value[3] == _viewport[3])
+	{
+		++_stats.filtered;
+		return;
+	}
+
+	++_stats.issued;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		_viewport[i] = value[i];
+	}
+
+	GraphicsDevice::get().viewport(x, y, width, height);
+}
+
+bool GLState::change(GLuint& cached, GLuint value)
+{
+	if (cached == value)
+	{
+		++_stats.filtered;
+		return false;
+	}
+
+	++_stats.issued;
+
+	cached = value;
+
+	return true;
+}
@@ -0,0 +1,291 @@
+/**
+ * @file	GLState.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Cache of OpenGL state that filters redundant changes
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @brief Calls to the state cache during one frame.
+ */
+struct GLStateStats
+{
+	/**
+	 * @brief Number of calls passed on to OpenGL.
+	 */
+	uint32_t issued{ 0 };
+
+	/**
+	 * @brief Number of calls dropped because the state was already set.
+	 */
+	uint32_t filtered{ 0 };
+};
+
+/**
+ * @brief Remembers the OpenGL state set through it and drops changes to
+ * the state it already holds.
+ *
+ * Tracks the program, vertex array, array and element buffers, the
+ * framebuffer, the 2D, cube map and buffer textures of every unit, the
+ * depth test, face culling, blending and the polygon mode. The element
+ * buffer is part of the vertex array, so it is remembered per vertex
+ * array. Changes that are not dropped are issued to the current
+ * GraphicsDevice. State set directly with OpenGL is not seen, which is why
+ * the cache forgets everything at the start of every frame.
+ */
+class GLState
+{
+public:
+	/**
+	 * @brief Gets the state of the context.
+	 * @return The state cache.
+	 */
+	static GLState& get();
+
+	/**
+	 * @brief Forgets all state and starts counting a new frame.
+	 */
+	void beginFrame();
+
+	/**
+	 * @brief Forgets all state, so the next change of everything is issued.
+	 */
+	void invalidate();
+
+	/**
+	 * @brief Forgets the array and element buffer bindings, after code
+	 * that binds buffers directly.
+	 */
+	void invalidateBuffers();
+
+	/**
+	 * @brief Sets the program.
+	 * @param program Program handle.
+	 */
+	void useProgram(GLuint program);
+
+	/**
+	 * @brief Binds a vertex array.
+	 * @param vao Vertex array handle.
+	 */
+	void bindVertexArray(GLuint vao);
+
+	/**
+	 * @brief Binds a buffer. Targets other than the array and element
+	 * buffers are always issued.
+	 * @param target Buffer target.
+	 * @param buffer Buffer handle.
+	 */
+	void bindBuffer(GLenum target, GLuint buffer);
+
+	/**
+	 * @brief Binds a framebuffer for drawing and reading.
+	 * @param framebuffer Framebuffer handle.
+	 */
+	void bindFramebuffer(GLuint framebuffer);
+
+	/**
+	 * @brief Binds a texture to a unit, changing the active unit if needed.
+	 * @param unit Texture unit, from 0.
+	 * @param target GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP or GL_TEXTURE_BUFFER.
+	 * Other targets are always issued.
+	 * @param texture Texture handle.
+	 */
+	void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+	/**
+	 * @brief Sets the active texture unit.
+	 * @param unit Texture unit, from 0.
+	 */
+	void activeTexture(GLuint unit);
+
+	/**
+	 * @brief Enables or disables a capability. Capabilities other than the
+	 * depth test, face culling and blending are always issued.
+	 * @param capability The capability.
+	 * @param enabled Whether to enable it.
+	 */
+	void setEnabled(GLenum capability, bool enabled);
+
+	/**
+	 * @brief Sets the culled faces.
+	 * @param mode Face mode.
+	 */
+	void cullFace(GLenum mode);
+
+	/**
+	 * @brief Sets the depth comparison.
+	 * @param func Comparison function.
+	 */
+	void depthFunc(GLenum func);
+
+	/**
+	 * @brief Sets the blend factors.
+	 * @param source Source factor.
+	 * @param destination Destination factor.
+	 */
+	void blendFunc(GLenum source, GLenum destination);
+
+	/**
+	 * @brief Sets the polygon mode of front and back faces.
+	 * @param mode Polygon mode.
+	 */
+	void polygonMode(GLenum mode);
+
+	/**
+	 * @brief Sets the viewport.
+	 * @param x Left edge.
+	 * @param y Bottom edge.
+	 * @param width Width.
+	 * @param height Height.
+	 */
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	/**
+	 * @brief Gets the calls of the last whole frame.
+	 * @return Statistics.
+	 */
+	const GLStateStats& getStats() const { return _lastFrame; }
+
+	/**
+	 * @brief Number of texture units tracked, higher units are always issued.
+	 */
+	static constexpr GLuint MAX_TEXTURE_UNITS{ 32 };
+
+	/**
+	 * @brief Value of state that is not known.
+	 */
+	static constexpr GLuint UNKNOWN{ 0xFFFFFFFFu };
+
+private:
+	/**
+	 * @brief Constructor.
+	 */
+	GLState();
+
+	/**
+	 * @brief Sets a cached value.
+	 * @param cached Cached value.
+	 * @param value New value.
+	 * @return True if the call has to be issued.
+	 */
+	bool change(GLuint& cached, GLuint value);
+
+	/**
+	 * @brief Texture bindings of one unit.
+	 */
+	struct TextureUnit
+	{
+		/**
+		 * @brief GL_TEXTURE_2D binding.
+		 */
+		GLuint texture2D;
+
+		/**
+		 * @brief GL_TEXTURE_CUBE_MAP binding.
+		 */
+		GLuint cubeMap;
+
+		/**
+		 * @brief GL_TEXTURE_BUFFER binding.
+		 */
+		GLuint buffer;
+	};
+
+	/**
+	 * @brief Program in use.
+	 */
+	GLuint _program;
+
+	/**
+	 * @brief Bound vertex array.
+	 */
+	GLuint _vertexArray;
+
+	/**
+	 * @brief Bound GL_ARRAY_BUFFER.
+	 */
+	GLuint _arrayBuffer;
+
+	/**
+	 * @brief Element buffer of every vertex array bound this frame.
+	 */
+	std::unordered_map<GLuint, GLuint> _elementBuffers;
+
+	/**
+	 * @brief Bound framebuffer.
+	 */
+	GLuint _framebuffer;
+
+	/**
+	 * @brief Active texture unit.
+	 */
+	GLuint _activeTexture;
+
+	/**
+	 * @brief Bindings of every tracked unit.
+	 */
+	TextureUnit _textures[MAX_TEXTURE_UNITS];
+
+	/**
+	 * @brief GL_DEPTH_TEST, UNKNOWN, 0 or 1.
+	 */
+	GLuint _depthTest;
+
+	/**
+	 * @brief GL_CULL_FACE, UNKNOWN, 0 or 1.
+	 */
+	GLuint _cullFace;
+
+	/**
+	 * @brief GL_BLEND, UNKNOWN, 0 or 1.
+	 */
+	GLuint _blend;
+
+	/**
+	 * @brief Culled faces.
+	 */
+	GLuint _cullMode;
+
+	/**
+	 * @brief Depth comparison.
+	 */
+	GLuint _depthFunc;
+
+	/**
+	 * @brief Blend source factor.
+	 */
+	GLuint _blendSource;
+
+	/**
+	 * @brief Blend destination factor.
+	 */
+	GLuint _blendDestination;
+
+	/**
+	 * @brief Polygon mode.
+	 */
+	GLuint _polygonMode;
+
+	/**
+	 * @brief Viewport, x, y, width and height.
+	 */
+	GLuint _viewport[4];
+
+	/**
+	 * @brief Calls of the current frame.
+	 */
+	GLStateStats _stats{};
+
+	/**
+	 * @brief Calls of the last whole frame.
+	 */
+	GLStateStats _lastFrame{};
+};
@@ -0,0 +1,38 @@
+/**
+ * @file	GraphicsDevice.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Commands the renderer sends to the graphics API every frame
+ */
+
+#include "GraphicsDevice.h"
+
+#include "OpenGLDevice.h"
+#include "GLState.h"
+
+namespace
+{
+	/**
+	 * @brief Device set with GraphicsDevice::set().
+	 */
+	GraphicsDevice* currentDevice = nullptr;
+}
+
+GraphicsDevice& GraphicsDevice::get()
+{
+	static OpenGLDevice openGLDevice{};
+
+	if (currentDevice)
+	{
+		return *currentDevice;
+	}
+
+	return openGLDevice;
+}
+
+void GraphicsDevice::set(GraphicsDevice* device)
+{
+	currentDevice = device;
+
+	GLState::get().invalidate();
+}
@@ -0,0 +1,519 @@
+/**
+ * @file	GraphicsDevice.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Commands the renderer sends to the graphics API every frame
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief A uniform of a linked program.
+ */
+struct ActiveUniform
+{
+	/**
+	 * @brief Name of the uniform. Arrays of plain types are named by their
+	 * first element, as "name[0]".
+	 */
+	std::string name;
+
+	/**
+	 * @brief Number of elements, 1 if not an array.
+	 */
+	GLint size;
+};
+
+/**
+ * @brief The graphics API as seen by the renderer.
+ *
+ * Covers the commands issued while drawing a frame: binds, state changes,
+ * uniform and buffer uploads, draws and clears. Also covers creating what
+ * the frames are drawn with: buffers, vertex arrays, shaders, textures and
+ * framebuffers. Changing the parameters of a texture after it has been
+ * created is still done with OpenGL directly. Values are OpenGL enums,
+ * whatever the device.
+ *
+ * Everything drawing a frame goes through get(), which is the OpenGL device
+ * unless another device has been set.
+ */
+class GraphicsDevice
+{
+public:
+	/**
+	 * @brief Gets the current device.
+	 * @return The device.
+	 */
+	static GraphicsDevice& get();
+
+	/**
+	 * @brief Sets the current device. The state cache is invalidated, since
+	 * the new device does not hold the cached state.
+	 * @param device The device, or nullptr for the OpenGL device. Not owned.
+	 */
+	static void set(GraphicsDevice* device);
+
+	/**
+	 * @brief Destructor.
+	 */
+	virtual ~GraphicsDevice() = default;
+
+	/**
+	 * @brief Sets the program.
+	 * @param program Program handle.
+	 */
+	virtual void useProgram(GLuint program) = 0;
+
+	/**
+	 * @brief Binds a vertex array.
+	 * @param vao Vertex array handle.
+	 */
+	virtual void bindVertexArray(GLuint vao) = 0;
+
+	/**
+	 * @brief Binds a buffer.
+	 * @param target Buffer target.
+	 * @param buffer Buffer handle.
+	 */
+	virtual void bindBuffer(GLenum target, GLuint buffer) = 0;
+
+	/**
+	 * @brief Binds part of a buffer to an indexed binding.
+	 * @param target Buffer target.
+	 * @param index Binding index.
+	 * @param buffer Buffer handle.
+	 * @param offset Offset in bytes.
+	 * @param size Size in bytes.
+	 */
+	virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
+
+	/**
+	 * @brief Binds a framebuffer for drawing and reading.
+	 * @param framebuffer Framebuffer handle.
+	 */
+	virtual void bindFramebuffer(GLuint framebuffer) = 0;
+
+	/**
+	 * @brief Sets the active texture unit.
+	 * @param unit Texture unit, from 0.
+	 */
+	virtual void activeTexture(GLuint unit) = 0;
+
+	/**
+	 * @brief Binds a texture to the active unit.
+	 * @param target Texture target.
+	 * @param texture Texture handle.
+	 */
+	virtual void bindTexture(GLenum target, GLuint texture) = 0;
+
+	/**
+	 * @brief Enables or disables a capability.
+	 * @param capability The capability.
+	 * @param enabled Whether to enable it.
+	 */
+	virtual void setEnabled(GLenum capability, bool enabled) = 0;
+
+	/**
+	 * @brief Sets the culled faces.
+	 * @param mode Face mode.
+	 */
+	virtual void cullFace(GLenum mode) = 0;
+
+	/**
+	 * @brief Sets the depth comparison.
+	 * @param func Comparison function.
+	 */
+	virtual void depthFunc(GLenum func) = 0;
+
+	/**
+	 * @brief Sets the blend factors.
+	 * @param source Source factor.
+	 * @param destination Destination factor.
+	 */
+	virtual void blendFunc(GLenum source, GLenum destination) = 0;
+
+	/**
+	 * @brief Sets the polygon mode of front and back faces.
+	 * @param mode Polygon mode.
+	 */
+	virtual void polygonMode(GLenum mode) = 0;
+
+	/**
+	 * @brief Sets the viewport.
+	 * @param x Left edge.
+	 * @param y Bottom edge.
+	 * @param width Width.
+	 * @param height Height.
+	 */
+	virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+
+	/**
+	 * @brief Creates a buffer.
+	 * @return Buffer handle.
+	 */
+	virtual GLuint createBuffer() = 0;
+
+	/**
+	 * @brief Deletes a buffer.
+	 * @param buffer Buffer handle.
+	 */
+	virtual void deleteBuffer(GLuint buffer) = 0;
+
+	/**
+	 * @brief Creates a vertex array.
+	 * @return Vertex array handle.
+	 */
+	virtual GLuint createVertexArray() = 0;
+
+	/**
+	 * @brief Deletes a vertex array.
+	 * @param vao Vertex array handle.
+	 */
+	virtual void deleteVertexArray(GLuint vao) = 0;
+
+	/**
+	 * @brief Allocates the storage of the bound buffer.
+	 * @param target Buffer target.
+	 * @param size Size in bytes.
+	 * @param data Initial data, or nullptr.
+	 * @param usage Usage hint.
+	 */
+	virtual void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) = 0;
+
+	/**
+	 * @brief Writes part of the bound buffer.
+	 * @param target Buffer target.
+	 * @param offset Offset in bytes.
+	 * @param size Size in bytes.
+	 * @param data The data.
+	 */
+	virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+
+	/**
+	 * @brief Whether bufferStorage() may be used.
+	 * @return True if immutable buffer storage is supported.
+	 */
+	virtual bool hasBufferStorage() const = 0;
+
+	/**
+	 * @brief Allocates immutable storage for the bound buffer.
+	 * @param target Buffer target.
+	 * @param size Size in bytes.
+	 * @param flags Storage flags.
+	 */
+	virtual void bufferStorage(GLenum target, GLsizeiptr size, GLbitfield flags) = 0;
+
+	/**
+	 * @brief Maps part of the bound buffer.
+	 * @param target Buffer target.
+	 * @param offset Offset in bytes.
+	 * @param size Size in bytes.
+	 * @param access Access flags.
+	 * @return The mapped memory, or nullptr on failure.
+	 */
+	virtual void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr size, GLbitfield access) = 0;
+
+	/**
+	 * @brief Unmaps the bound buffer.
+	 * @param target Buffer target.
+	 */
+	virtual void unmapBuffer(GLenum target) = 0;
+
+	/**
+	 * @brief Points a vertex attribute at float data in the bound array buffer.
+	 * @param location Attribute location.
+	 * @param size Number of floats per vertex.
+	 * @param stride Bytes between vertices, 0 if packed.
+	 * @param offset Offset of the first vertex in bytes.
+	 */
+	virtual void vertexAttribPointer(GLuint location, GLint size, GLsizei stride, GLsizeiptr offset) = 0;
+
+	/**
+	 * @brief Sets how often a vertex attribute advances.
+	 * @param location Attribute location.
+	 * @param divisor 0 for every vertex, n for every n instances.
+	 */
+	virtual void vertexAttribDivisor(GLuint location, GLuint divisor) = 0;
+
+	/**
+	 * @brief Enables or disables a vertex attribute of the bound vertex array.
+	 * @param location Attribute location.
+	 * @param enabled Whether to enable it.
+	 */
+	virtual void setAttribArrayEnabled(GLuint location, bool enabled) = 0;
+
+	/**
+	 * @brief Creates a shader.
+	 * @param type Shader type.
+	 * @return Shader handle.
+	 */
+	virtual GLuint createShader(GLenum type) = 0;
+
+	/**
+	 * @brief Compiles a shader.
+	 * @param shader Shader handle.
+	 * @param source Source of the shader.
+	 * @param log Set to the errors if the compilation fails.
+	 * @return True if the shader compiled.
+	 */
+	virtual bool compileShader(GLuint shader, const std::string& source, std::string& log) = 0;
+
+	/**
+	 * @brief Deletes a shader.
+	 * @param shader Shader handle.
+	 */
+	virtual void deleteShader(GLuint shader) = 0;
+
+	/**
+	 * @brief Creates a program.
+	 * @return Program handle.
+	 */
+	virtual GLuint createProgram() = 0;
+
+	/**
+	 * @brief Attaches a shader to a program.
+	 * @param program Program handle.
+	 * @param shader Shader handle.
+	 */
+	virtual void attachShader(GLuint program, GLuint shader) = 0;
+
+	/**
+	 * @brief Sets the location of a vertex attribute, used by the next link.
+	 * @param program Program handle.
+	 * @param location Attribute location.
+	 * @param name Name of the attribute.
+	 */
+	virtual void bindAttribLocation(GLuint program, GLuint location, const char* name) = 0;
+
+	/**
+	 * @brief Links a program.
+	 * @param program Program handle.
+	 * @param log Set to the errors if the link fails.
+	 * @return True if the program linked.
+	 */
+	virtual bool linkProgram(GLuint program, std::string& log) = 0;
+
+	/**
+	 * @brief Deletes a program.
+	 * @param program Program handle.
+	 */
+	virtual void deleteProgram(GLuint program) = 0;
+
+	/**
+	 * @brief Gets the uniforms of a linked program.
+	 * @param program Program handle.
+	 * @param uniforms Filled with the uniforms.
+	 */
+	virtual void getActiveUniforms(GLuint program, std::vector<ActiveUniform>& uniforms) = 0;
+
+	/**
+	 * @brief Gets the location of a uniform.
+	 * @param program Program handle.
+	 * @param name Name of the uniform.
+	 * @return The location, or -1 if the program has no such uniform.
+	 */
+	virtual GLint getUniformLocation(GLuint program, const char* name) = 0;
+
+	/**
+	 * @brief Binds a uniform block of a program to an indexed binding.
+	 * Nothing is done if the program has no such block.
+	 * @param program Program handle.
+	 * @param name Name of the block.
+	 * @param binding Binding index.
+	 */
+	virtual void bindUniformBlock(GLuint program, const char* name, GLuint binding) = 0;
+
+	/**
+	 * @brief Creates a texture.
+	 * @return Texture handle.
+	 */
+	virtual GLuint createTexture() = 0;
+
+	/**
+	 * @brief Deletes a texture.
+	 * @param texture Texture handle.
+	 */
+	virtual void deleteTexture(GLuint texture) = 0;
+
+	/**
+	 * @brief Allocates the first level of the bound texture.
+	 * @param target Texture target, or a face of the bound cube map.
+	 * @param internalFormat Format of the texture.
+	 * @param width Width.
+	 * @param height Height.
+	 * @param format Format of the data.
+	 * @param type Type of the data.
+	 * @param data Initial pixels, or nullptr.
+	 */
+	virtual void texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) = 0;
+
+	/**
+	 * @brief Sets a parameter of the bound texture.
+	 * @param target Texture target.
+	 * @param name Name of the parameter.
+	 * @param value Value.
+	 */
+	virtual void texParameter(GLenum target, GLenum name, GLint value) = 0;
+
+	/**
+	 * @brief Sets the border color of the bound texture.
+	 * @param target Texture target.
+	 * @param color The color.
+	 */
+	virtual void texBorderColor(GLenum target, glm::vec4 color) = 0;
+
+	/**
+	 * @brief Generates the mipmaps of the bound texture.
+	 * @param target Texture target.
+	 */
+	virtual void generateMipmap(GLenum target) = 0;
+
+	/**
+	 * @brief Makes the bound buffer texture read from a buffer.
+	 * @param internalFormat Format of the texels.
+	 * @param buffer Buffer handle.
+	 */
+	virtual void texBuffer(GLenum internalFormat, GLuint buffer) = 0;
+
+	/**
+	 * @brief Sets how pixels are read from memory.
+	 * @param name Name of the parameter.
+	 * @param value Value.
+	 */
+	virtual void pixelStore(GLenum name, GLint value) = 0;
+
+	/**
+	 * @brief Creates a framebuffer.
+	 * @return Framebuffer handle.
+	 */
+	virtual GLuint createFramebuffer() = 0;
+
+	/**
+	 * @brief Deletes a framebuffer.
+	 * @param framebuffer Framebuffer handle.
+	 */
+	virtual void deleteFramebuffer(GLuint framebuffer) = 0;
+
+	/**
+	 * @brief Attaches the first level of a texture to the bound framebuffer.
+	 * @param attachment Attachment point.
+	 * @param target GL_TEXTURE_2D, or GL_TEXTURE_CUBE_MAP to attach every
+	 * face as a layer.
+	 * @param texture Texture handle.
+	 */
+	virtual void framebufferTexture(GLenum attachment, GLenum target, GLuint texture) = 0;
+
+	/**
+	 * @brief Sets the color attachments drawn to by the bound framebuffer.
+	 * @param count Number of attachments, 0 to neither draw nor read color.
+	 * @param buffers The attachments.
+	 */
+	virtual void drawBuffers(GLsizei count, const GLenum* buffers) = 0;
+
+	/**
+	 * @brief Checks if the bound framebuffer can be drawn to.
+	 * @return True if complete.
+	 */
+	virtual bool isFramebufferComplete() = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, float value) = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, int value) = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, glm::vec2 value) = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, glm::vec3 value) = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, glm::vec4 value) = 0;
+
+	/**
+	 * @brief Sets a uniform of the program in use.
+	 * @param location Uniform location.
+	 * @param value Value.
+	 */
+	virtual void uniform(GLint location, const glm::mat4& value) = 0;
+
+	/**
+	 * @brief Clears buffers of the bound framebuffer.
+	 * @param mask Buffers to clear.
+	 */
+	virtual void clear(GLbitfield mask) = 0;
+
+	/**
+	 * @brief Draws vertices in order.
+	 * @param mode Primitive mode.
+	 * @param first First vertex.
+	 * @param count Number of vertices.
+	 */
+	virtual void drawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+
+	/**
+	 * @brief Draws with a range of GL_UNSIGNED_INT indices of the bound
+	 * element buffer.
+	 * @param mode Primitive mode.
+	 * @param first First index.
+	 * @param count Number of indices.
+	 */
+	virtual void drawElements(GLenum mode, GLuint first, GLsizei count) = 0;
+
+	/**
+	 * @brief Draws several instances with a range of GL_UNSIGNED_INT indices
+	 * of the bound element buffer.
+	 * @param mode Primitive mode.
+	 * @param first First index.
+	 * @param count Number of indices.
+	 * @param instances Number of instances.
+	 */
+	virtual void drawElementsInstanced(GLenum mode, GLuint first, GLsizei count, GLsizei instances) = 0;
+
+	/**
+	 * @brief Inserts a fence after the commands issued so far.
+	 * @return The fence, or nullptr if the device has nothing to wait for.
+	 */
+	virtual GLsync fence() = 0;
+
+	/**
+	 * @brief Waits for a fence and deletes it.
+	 * @param fence The fence, not nullptr.
+	 */
+	virtual void waitFence(GLsync fence) = 0;
+
+	/**
+	 * @brief Gets an integer limit of the device.
+	 * @param name Name of the limit.
+	 * @return The value.
+	 */
+	virtual GLint getInteger(GLenum name) = 0;
+};
@@ -0,0 +1,165 @@
+/**
+ * @file	JobSystem.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Minimal worker pool for data parallel jobs.
+ */
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(size_t workerCount)
+{
+	if (workerCount == 0)
+	{
+		size_t cores = std::thread::hardware_concurrency();
+
+		workerCount = cores > 1 ? cores - 1 : 0;
+	}
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(&JobSystem::workerLoop, this);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		quit = true;
+	}
+
+	workAvailable.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const RangeJob& job)
+{
+	if (count == 0)
+		return;
+
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	size_t chunkCount = getChunkCount(count, grainSize);
+
+	// Not worth waking anyone up for.
+	if (chunkCount == 1 || workers.empty())
+	{
+		for (size_t begin = 0; begin < count; begin += grainSize)
+		{
+			job(begin, std::min(begin + grainSize, count));
+		}
+
+		return;
+	}
+
+	Batch batch;
+	batch.job = &job;
+	batch.count = count;
+	batch.grainSize = grainSize;
+	batch.chunkCount = chunkCount;
+	batch.nextChunk = 0;
+	batch.remaining = chunkCount;
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		batches.push_back(&batch);
+	}
+
+	workAvailable.notify_all();
+
+	// Help out until there is nothing left to pick up.
+	while (true)
+	{
+		size_t chunk;
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+
+			if (batch.nextChunk >= batch.chunkCount)
+				break;
+
+			chunk = claimChunk(batch);
+		}
+
+		runChunk(batch, chunk);
+	}
+
+	std::unique_lock<std::mutex> lock{ mutex };
+	workDone.wait(lock, [&batch]() { return batch.remaining == 0; });
+}
+
+size_t JobSystem::getThreadCount() const
+{
+	return workers.size() + 1;
+}
+
+size_t JobSystem::getChunkCount(size_t count, size_t grainSize)
+{
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	return (count + grainSize - 1) / grainSize;
+}
+
+JobSystem& JobSystem::get()
+{
+	static JobSystem jobSystem{};
+
+	return jobSystem;
+}
+
+void JobSystem::workerLoop()
+{
+	while (true)
+	{
+		Batch* batch;
+		size_t chunk;
+
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			workAvailable.wait(lock, [this]() { return quit || !batches.empty(); });
+
+			if (quit)
+				return;
+
+			// Claim under the same lock as the lookup, the batch lives on the
+			// stack of the submitting thread and is gone once it is finished.
+			batch = batches.front();
+			chunk = claimChunk(*batch);
+		}
+
+		runChunk(*batch, chunk);
+	}
+}
+
+size_t JobSystem::claimChunk(Batch& batch)
+{
+	size_t chunk = batch.nextChunk++;
+
+	if (batch.nextChunk == batch.chunkCount)
+	{
+		batches.erase(std::find(batches.begin(), batches.end(), &batch));
+	}
+
+	return chunk;
+}
+
+void JobSystem::runChunk(Batch& batch, size_t chunk)
+{
+	size_t begin = chunk * batch.grainSize;
+	size_t end = std::min(begin + batch.grainSize, batch.count);
+
+	(*batch.job)(begin, end);
+
+	if (--batch.remaining == 0)
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		workDone.notify_all();
+	}
+}
@@ -0,0 +1,174 @@
+/**
+ * @file	JobSystem.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Minimal worker pool for data parallel jobs.
+ */
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <cstddef>
+
+/**
+ * @brief Worker pool running data parallel jobs.
+ *
+ * Work is always split into chunks of a fixed grain size, so chunk i always
+ * covers the same range of indices. Callers that want a deterministic result
+ * can give each chunk its own output buffer and merge the buffers in chunk
+ * order afterwards.
+ */
+class JobSystem
+{
+public:
+	/**
+	 * @brief Function type of a job. Gets called with the index range [begin, end).
+	 */
+	typedef std::function<void(size_t begin, size_t end)> RangeJob;
+
+	/**
+	 * @brief Constructor.
+	 * @param workerCount Number of worker threads. 0 means one less than the number of cores.
+	 */
+	explicit JobSystem(size_t workerCount = 0);
+
+	/**
+	 * @brief Destructor. Joins all workers.
+	 */
+	~JobSystem();
+
+	/**
+	 * @brief Copy constructor.
+	 */
+	JobSystem(const JobSystem&) = delete;
+
+	/**
+	 * @brief Copy assignment operator.
+	 * @return Ref to self.
+	 */
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/**
+	 * @brief Runs job over [0, count) split into chunks of grainSize and blocks until done.
+	 *
+	 * The calling thread participates in the work.
+	 *
+	 * @param count Number of elements.
+	 * @param grainSize Number of elements per chunk.
+	 * @param job Job to run on every chunk.
+	 */
+	void parallelFor(size_t count, size_t grainSize, const RangeJob& job);
+
+	/**
+	 * @brief Gets the number of threads that can work on jobs, including the caller.
+	 * @return Number of threads.
+	 */
+	size_t getThreadCount() const;
+
+	/**
+	 * @brief Gets the number of chunks parallelFor will split count elements into.
+	 * @param count Number of elements.
+	 * @param grainSize Number of elements per chunk.
+	 * @return Number of chunks.
+	 */
+	static size_t getChunkCount(size_t count, size_t grainSize);
+
+	/**
+	 * @brief Gets the engine wide job system.
+	 * @return Ref to job system.
+	 */
+	static JobSystem& get();
+
+private:
+
+	/**
+	 * @brief A batch of chunks submitted by one parallelFor call.
+	 */
+	struct Batch
+	{
+		/**
+		 * @brief Job to run.
+		 */
+		const RangeJob* job;
+
+		/**
+		 * @brief Number of elements.
+		 */
+		size_t count;
+
+		/**
+		 * @brief Elements per chunk.
+		 */
+		size_t grainSize;
+
+		/**
+		 * @brief Number of chunks.
+		 */
+		size_t chunkCount;
+
+		/**
+		 * @brief Next chunk to be picked up. Guarded by the pool mutex.
+		 */
+		size_t nextChunk;
+
+		/**
+		 * @brief Number of chunks not yet finished.
+		 */
+		std::atomic<size_t> remaining;
+	};
+
+	/**
+	 * @brief Main loop of the worker threads.
+	 */
+	void workerLoop();
+
+	/**
+	 * @brief Claims the next chunk of a batch. Must be called with the mutex held.
+	 * @param batch The batch to claim from.
+	 * @return Index of the claimed chunk.
+	 */
+	size_t claimChunk(Batch& batch);
+
+	/**
+	 * @brief Runs a claimed chunk and signals if it was the last one.
+	 * @param batch The batch the chunk belongs to.
+	 * @param chunk Index of the chunk.
+	 */
+	void runChunk(Batch& batch, size_t chunk);
+
+	/**
+	 * @brief Worker threads.
+	 */
+	std::vector<std::thread> workers{};
+
+	/**
+	 * @brief Batches with chunks left to pick up.
+	 */
+	std::deque<Batch*> batches{};
+
+	/**
+	 * @brief Mutex guarding batches.
+	 */
+	std::mutex mutex{};
+
+	/**
+	 * @brief Signalled when a batch is submitted or the pool shuts down.
+	 */
+	std::condition_variable workAvailable{};
+
+	/**
+	 * @brief Signalled when a batch is finished.
+	 */
+	std::condition_variable workDone{};
+
+	/**
+	 * @brief Whether the workers should shut down.
+	 */
+	bool quit{ false };
+};
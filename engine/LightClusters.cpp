@@ -0,0 +1,233 @@
+/**
+ * @file	LightClusters.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Assigns point lights to a view space cluster grid
+ */
+
+#include "LightClusters.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+
+constexpr uint32_t LightClusters::GRID_X;
+constexpr uint32_t LightClusters::GRID_Y;
+constexpr uint32_t LightClusters::GRID_Z;
+constexpr uint32_t LightClusters::TEXELS_PER_LIGHT;
+
+void LightClusters::build(
+	const std::vector<PointLight>& lights,
+	uint32_t shadowCount,
+	const glm::mat4& view,
+	const glm::mat4& proj,
+	float nearPlane,
+	float farPlane,
+	float cutoff)
+{
+	static constexpr uint32_t SLICE_SIZE = GRID_X * GRID_Y;
+
+	uint32_t lightCount = static_cast<uint32_t>(lights.size());
+
+	_stats = ClusterStats{};
+	_stats.lights = lightCount;
+
+	_bounds.resize(lightCount);
+
+	for (uint32_t i = 0; i < lightCount; ++i)
+	{
+		glm::vec3 center = glm::vec3{ view * glm::vec4{ lights[i].getPosition(), 1.f } };
+
+		_bounds[i] = getBounds(center, lights[i].calculateRange(cutoff), proj, nearPlane, farPlane);
+	}
+
+	_sliceIndices.resize(GRID_Z);
+	_clusters.resize(SLICE_SIZE * GRID_Z);
+
+	// Slices share nothing, so each one is counted and filled on its own
+	JobSystem::get().parallelFor(GRID_Z, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t z = begin; z < end; ++z)
+		{
+			glm::uvec2* clusters = &_clusters[z * SLICE_SIZE];
+
+			std::fill(clusters, clusters + SLICE_SIZE, glm::uvec2{ 0, 0 });
+
+			auto forEachCluster = [&](const std::function<void(uint32_t, uint32_t)>& func)
+			{
+				for (uint32_t i = 0; i < lightCount; ++i)
+				{
+					const LightBounds& bounds = _bounds[i];
+
+					if (!bounds.visible || z < bounds.minZ || z > bounds.maxZ)
+					{
+						continue;
+					}
+
+					for (uint32_t y = bounds.minY; y <= bounds.maxY; ++y)
+					{
+						for (uint32_t x = bounds.minX; x <= bounds.maxX; ++x)
+						{
+							func(i, y * GRID_X + x);
+						}
+					}
+				}
+			};
+
+			forEachCluster([&](uint32_t, uint32_t cluster)
+			{
+				++clusters[cluster].y;
+			});
+
+			uint32_t offset = 0;
+
+			for (uint32_t cluster = 0; cluster < SLICE_SIZE; ++cluster)
+			{
+				clusters[cluster].x = offset;
+				offset += clusters[cluster].y;
+				clusters[cluster].y = 0;
+			}
+
+			std::vector<uint32_t>& indices = _sliceIndices[z];
+
+			indices.resize(offset);
+
+			forEachCluster([&](uint32_t light, uint32_t cluster)
+			{
+				indices[clusters[cluster].x + clusters[cluster].y++] = light;
+			});
+		}
+	});
+
+	// Pack everything for the shader, integers are exact in floats up to 2^24
+	_data.clear();
+
+	for (uint32_t i = 0; i < lightCount; ++i)
+	{
+		const PointLight& light = lights[i];
+
+		float shadowIndex = i < shadowCount ? static_cast<float>(i) : -1.f;
+
+		_data.push_back(glm::vec4{ light.getPosition(), shadowIndex });
+		_data.push_back(glm::vec4{ light.getAmbient(), light.getConstant() });
+		_data.push_back(glm::vec4{ light.getDiffuse(), light.getLinear() });
+		_data.push_back(glm::vec4{ light.getSpecular(), light.getQuadratic() });
+	}
+
+	_clusterOffset = static_cast<uint32_t>(_data.size());
+
+	uint32_t sliceBase = 0;
+
+	for (uint32_t z = 0; z < GRID_Z; ++z)
+	{
+		for (uint32_t cluster = 0; cluster < SLICE_SIZE; ++cluster)
+		{
+			glm::uvec2 header = _clusters[z * SLICE_SIZE + cluster];
+
+			_data.push_back(glm::vec4{ static_cast<float>(sliceBase + header.x), static_cast<float>(header.y), 0.f, 0.f });
+
+			_stats.maxPerCluster = std::max(_stats.maxPerCluster, header.y);
+		}
+
+		sliceBase += static_cast<uint32_t>(_sliceIndices[z].size());
+	}
+
+	_indexOffset = static_cast<uint32_t>(_data.size());
+
+	_stats.assignments = sliceBase;
+
+	_data.resize(_indexOffset + (sliceBase + 3) / 4, glm::vec4{ 0.f });
+
+	uint32_t index = 0;
+
+	for (uint32_t z = 0; z < GRID_Z; ++z)
+	{
+		for (uint32_t light : _sliceIndices[z])
+		{
+			_data[_indexOffset + index / 4][index % 4] = static_cast<float>(light);
+			++index;
+		}
+	}
+}
+
+LightClusters::LightBounds LightClusters::getBounds(glm::vec3 center, float radius, const glm::mat4& proj, float nearPlane, float farPlane)
+{
+	LightBounds bounds{ 0, GRID_X - 1, 0, GRID_Y - 1, 0, GRID_Z - 1, true };
+
+	// Lights that never fall off reach every cluster
+	if (std::isinf(radius))
+	{
+		return bounds;
+	}
+
+	float depth = -center.z;
+
+	if (depth + radius < nearPlane || depth - radius > farPlane)
+	{
+		bounds.visible = false;
+		return bounds;
+	}
+
+	bounds.minZ = getSlice(depth - radius, nearPlane, farPlane);
+	bounds.maxZ = getSlice(depth + radius, nearPlane, farPlane);
+
+	// Spheres reaching behind the near plane can cover any tile
+	if (depth - radius <= nearPlane)
+	{
+		return bounds;
+	}
+
+	glm::vec2 ndcMin{ std::numeric_limits<float>::max() };
+	glm::vec2 ndcMax{ -std::numeric_limits<float>::max() };
+
+	// The projected box around the sphere covers the projected sphere
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		glm::vec3 offset{
+			corner & 1 ? radius : -radius,
+			corner & 2 ? radius : -radius,
+			corner & 4 ? radius : -radius };
+
+		glm::vec4 clip = proj * glm::vec4{ center + offset, 1.f };
+
+		glm::vec2 ndc = glm::vec2{ clip } / clip.w;
+
+		ndcMin = glm::min(ndcMin, ndc);
+		ndcMax = glm::max(ndcMax, ndc);
+	}
+
+	if (ndcMax.x < -1.f || ndcMin.x > 1.f || ndcMax.y < -1.f || ndcMin.y > 1.f)
+	{
+		bounds.visible = false;
+		return bounds;
+	}
+
+	auto toTile = [](float ndc, uint32_t tiles)
+	{
+		float tile = std::floor((ndc * 0.5f + 0.5f) * tiles);
+
+		return static_cast<uint32_t>(glm::clamp(tile, 0.f, static_cast<float>(tiles - 1)));
+	};
+
+	bounds.minX = toTile(ndcMin.x, GRID_X);
+	bounds.maxX = toTile(ndcMax.x, GRID_X);
+	bounds.minY = toTile(ndcMin.y, GRID_Y);
+	bounds.maxY = toTile(ndcMax.y, GRID_Y);
+
+	return bounds;
+}
+
+uint32_t LightClusters::getSlice(float depth, float nearPlane, float farPlane)
+{
+	if (depth <= nearPlane)
+	{
+		return 0;
+	}
+
+	float slice = std::floor(std::log(depth / nearPlane) / std::log(farPlane / nearPlane) * GRID_Z);
+
+	return static_cast<uint32_t>(glm::min(slice, static_cast<float>(GRID_Z - 1)));
+}
@@ -0,0 +1,198 @@
+/**
+ * @file	LightClusters.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Assigns point lights to a view space cluster grid
+ */
+
+#pragma once
+
+#include "PointLight.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Statistics from the last build.
+ */
+struct ClusterStats
+{
+	/**
+	 * @brief Number of lights in the grid.
+	 */
+	uint32_t lights{ 0 };
+
+	/**
+	 * @brief Number of light indices over all clusters.
+	 */
+	uint32_t assignments{ 0 };
+
+	/**
+	 * @brief Largest number of lights in one cluster.
+	 */
+	uint32_t maxPerCluster{ 0 };
+};
+
+/**
+ * @brief Bins point lights into a grid of view space clusters.
+ *
+ * The screen is split into GRID_X by GRID_Y tiles and the view depth into
+ * GRID_Z slices growing exponentially from the near plane. Every light is
+ * added to the clusters its range overlaps, so a fragment only has to
+ * shade the lights of its own cluster. Slices are binned in parallel.
+ *
+ * Everything the shader needs is packed into one array of vec4 texels:
+ * four texels per light, then one (offset, count) texel per cluster, then
+ * the light indices of all clusters four to a texel.
+ */
+class LightClusters
+{
+public:
+	/**
+	 * @brief Bins the lights.
+	 * @param lights The lights.
+	 * @param shadowCount The first shadowCount lights have a shadow map with
+	 * the same index.
+	 * @param view View matrix.
+	 * @param proj Projection matrix.
+	 * @param nearPlane Near plane of the projection.
+	 * @param farPlane Far plane of the projection.
+	 * @param cutoff Attenuation below which a light is left out.
+	 */
+	void build(
+		const std::vector<PointLight>& lights,
+		uint32_t shadowCount,
+		const glm::mat4& view,
+		const glm::mat4& proj,
+		float nearPlane,
+		float farPlane,
+		float cutoff);
+
+	/**
+	 * @brief Gets the packed lights and clusters.
+	 * @return Texels.
+	 */
+	const std::vector<glm::vec4>& getData() const { return _data; }
+
+	/**
+	 * @brief Gets the texel of the first cluster.
+	 * @return Texel index.
+	 */
+	uint32_t getClusterOffset() const { return _clusterOffset; }
+
+	/**
+	 * @brief Gets the texel of the first light indices.
+	 * @return Texel index.
+	 */
+	uint32_t getIndexOffset() const { return _indexOffset; }
+
+	/**
+	 * @brief Gets the statistics of the last build.
+	 * @return Statistics.
+	 */
+	const ClusterStats& getStats() const { return _stats; }
+
+	/**
+	 * @brief Number of tiles across the screen.
+	 */
+	static constexpr uint32_t GRID_X{ 16 };
+
+	/**
+	 * @brief Number of tiles down the screen.
+	 */
+	static constexpr uint32_t GRID_Y{ 9 };
+
+	/**
+	 * @brief Number of depth slices.
+	 */
+	static constexpr uint32_t GRID_Z{ 24 };
+
+	/**
+	 * @brief Number of texels per light.
+	 */
+	static constexpr uint32_t TEXELS_PER_LIGHT{ 4 };
+
+private:
+	/**
+	 * @brief Clusters a light may touch.
+	 */
+	struct LightBounds
+	{
+		/**
+		 * @brief First and last tile across.
+		 */
+		uint32_t minX, maxX;
+
+		/**
+		 * @brief First and last tile down.
+		 */
+		uint32_t minY, maxY;
+
+		/**
+		 * @brief First and last depth slice.
+		 */
+		uint32_t minZ, maxZ;
+
+		/**
+		 * @brief Whether the light touches any cluster.
+		 */
+		bool visible;
+	};
+
+	/**
+	 * @brief Finds the clusters a light sphere may touch.
+	 * @param center Center in view space.
+	 * @param radius Radius, may be infinite.
+	 * @param proj Projection matrix.
+	 * @param nearPlane Near plane.
+	 * @param farPlane Far plane.
+	 * @return Bounds.
+	 */
+	static LightBounds getBounds(glm::vec3 center, float radius, const glm::mat4& proj, float nearPlane, float farPlane);
+
+	/**
+	 * @brief Gets the slice holding a view depth.
+	 * @param depth Positive view depth.
+	 * @param nearPlane Near plane.
+	 * @param farPlane Far plane.
+	 * @return Slice, clamped to the grid.
+	 */
+	static uint32_t getSlice(float depth, float nearPlane, float farPlane);
+
+	/**
+	 * @brief Bounds of every light.
+	 */
+	std::vector<LightBounds> _bounds{};
+
+	/**
+	 * @brief Light indices of every slice, by cluster.
+	 */
+	std::vector<std::vector<uint32_t>> _sliceIndices{};
+
+	/**
+	 * @brief (offset in slice, count) of every cluster.
+	 */
+	std::vector<glm::uvec2> _clusters{};
+
+	/**
+	 * @brief Packed lights and clusters.
+	 */
+	std::vector<glm::vec4> _data{};
+
+	/**
+	 * @brief Texel of the first cluster.
+	 */
+	uint32_t _clusterOffset{ 0 };
+
+	/**
+	 * @brief Texel of the first light indices.
+	 */
+	uint32_t _indexOffset{ 0 };
+
+	/**
+	 * @brief Statistics of the last build.
+	 */
+	ClusterStats _stats{};
+};
@@ -0,0 +1,502 @@
+/**
+ * @file	MeshSimplifier.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Mesh simplification by quadric error edge collapses
+ */
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <limits>
+
+constexpr float MeshSimplifier::ATTRIBUTE_WEIGHT;
+constexpr float MeshSimplifier::BORDER_WEIGHT;
+constexpr float MeshSimplifier::MIN_NORMAL_COSINE;
+
+void MeshSimplifier::Quadric::addPlane(const glm::dvec3& normal, const glm::dvec3& point, double weight)
+{
+	double a = normal.x;
+	double b = normal.y;
+	double c = normal.z;
+	double d = -glm::dot(normal, point);
+
+	m[0] += weight * a * a;
+	m[1] += weight * a * b;
+	m[2] += weight * a * c;
+	m[3] += weight * a * d;
+	m[4] += weight * b * b;
+	m[5] += weight * b * c;
+	m[6] += weight * b * d;
+	m[7] += weight * c * c;
+	m[8] += weight * c * d;
+	m[9] += weight * d * d;
+}
+
+void MeshSimplifier::Quadric::add(const Quadric& other)
+{
+	for (int i = 0; i < 10; ++i)
+	{
+		m[i] += other.m[i];
+	}
+}
+
+double MeshSimplifier::Quadric::evaluate(const glm::dvec3& p) const
+{
+	// p^T Q p with p = (x, y, z, 1)
+	return
+		m[0] * p.x * p.x + 2.0 * m[1] * p.x * p.y + 2.0 * m[2] * p.x * p.z + 2.0 * m[3] * p.x +
+		m[4] * p.y * p.y + 2.0 * m[5] * p.y * p.z + 2.0 * m[6] * p.y +
+		m[7] * p.z * p.z + 2.0 * m[8] * p.z +
+		m[9];
+}
+
+MeshSimplifier::MeshSimplifier(
+	const GLfloat* positions,
+	const GLfloat* normals,
+	const GLfloat* texCoords,
+	size_t vertexCount,
+	const GLuint* indices,
+	size_t indexCount)
+{
+	_normals.resize(vertexCount);
+	_texCoords.resize(vertexCount);
+	_vertexPoints.resize(vertexCount);
+
+	// Seams split a position into several vertices, which must move together
+	std::map<std::array<GLfloat, 3>, uint32_t> points;
+
+	glm::dvec3 min{ std::numeric_limits<double>::max() };
+	glm::dvec3 max{ -std::numeric_limits<double>::max() };
+
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		std::array<GLfloat, 3> position{ { positions[v * 3 + 0], positions[v * 3 + 1], positions[v * 3 + 2] } };
+
+		auto result = points.emplace(position, static_cast<uint32_t>(_positions.size()));
+
+		if (result.second)
+		{
+			_positions.push_back(glm::dvec3{ position[0], position[1], position[2] });
+			_pointVertices.emplace_back();
+		}
+
+		uint32_t point = result.first->second;
+
+		_vertexPoints[v] = point;
+		_pointVertices[point].push_back(static_cast<uint32_t>(v));
+
+		_normals[v] = normals ? glm::vec3{ normals[v * 3 + 0], normals[v * 3 + 1], normals[v * 3 + 2] } : glm::vec3{};
+		_texCoords[v] = texCoords ? glm::vec2{ texCoords[v * 2 + 0], texCoords[v * 2 + 1] } : glm::vec2{};
+
+		min = glm::min(min, _positions[point]);
+		max = glm::max(max, _positions[point]);
+	}
+
+	size_t pointCount = _positions.size();
+
+	_pointTriangles.resize(pointCount);
+	_quadrics.resize(pointCount, Quadric{});
+	_versions.assign(pointCount, 0);
+	_collapsed.assign(pointCount, false);
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		uint32_t triangle = static_cast<uint32_t>(_triangles.size());
+
+		_triangles.push_back(std::array<uint32_t, 3>{ { indices[i], indices[i + 1], indices[i + 2] } });
+
+		uint32_t a = getPoint(triangle, 0);
+		uint32_t b = getPoint(triangle, 1);
+		uint32_t c = getPoint(triangle, 2);
+
+		// Triangles with two corners at one position draw nothing
+		if (a == b || b == c || c == a)
+		{
+			_triangles.pop_back();
+			continue;
+		}
+
+		_pointTriangles[a].push_back(triangle);
+		_pointTriangles[b].push_back(triangle);
+		_pointTriangles[c].push_back(triangle);
+	}
+
+	_removed.assign(_triangles.size(), false);
+	_liveTriangles = _triangles.size();
+
+	// Attribute distances are compared with squared distances on the mesh
+	if (vertexCount > 0)
+	{
+		_attributeScale = ATTRIBUTE_WEIGHT * static_cast<float>(glm::dot(max - min, max - min) * 0.25);
+	}
+
+	buildQuadrics();
+
+	for (uint32_t point = 0; point < pointCount; ++point)
+	{
+		pushCollapses(point);
+	}
+}
+
+void MeshSimplifier::simplify(size_t targetIndexCount)
+{
+	while (_liveTriangles * 3 > targetIndexCount && !_heap.empty())
+	{
+		std::pop_heap(_heap.begin(), _heap.end());
+		Collapse candidate = _heap.back();
+		_heap.pop_back();
+
+		// Points that changed since have pushed their collapses again
+		if (_collapsed[candidate.from] || _collapsed[candidate.to] ||
+			_versions[candidate.from] != candidate.fromVersion ||
+			_versions[candidate.to] != candidate.toVersion)
+		{
+			continue;
+		}
+
+		if (!canCollapse(candidate.from, candidate.to))
+		{
+			continue;
+		}
+
+		_error = std::max(_error, candidate.cost);
+
+		collapse(candidate.from, candidate.to);
+	}
+}
+
+void MeshSimplifier::getIndices(std::vector<GLuint>& indices) const
+{
+	indices.clear();
+	indices.reserve(_liveTriangles * 3);
+
+	for (size_t triangle = 0; triangle < _triangles.size(); ++triangle)
+	{
+		if (!_removed[triangle])
+		{
+			indices.insert(indices.end(), _triangles[triangle].begin(), _triangles[triangle].end());
+		}
+	}
+}
+
+void MeshSimplifier::buildQuadrics()
+{
+	// Number of triangles along every edge, to find the open borders
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> edges;
+
+	for (uint32_t triangle = 0; triangle < _triangles.size(); ++triangle)
+	{
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t a = getPoint(triangle, corner);
+			uint32_t b = getPoint(triangle, (corner + 1) % 3);
+
+			++edges[std::make_pair(std::min(a, b), std::max(a, b))];
+		}
+	}
+
+	for (uint32_t triangle = 0; triangle < _triangles.size(); ++triangle)
+	{
+		const glm::dvec3& p0 = _positions[getPoint(triangle, 0)];
+		const glm::dvec3& p1 = _positions[getPoint(triangle, 1)];
+		const glm::dvec3& p2 = _positions[getPoint(triangle, 2)];
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+
+		double length = glm::length(normal);
+
+		if (length == 0.0)
+		{
+			continue;
+		}
+
+		normal /= length;
+
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			_quadrics[getPoint(triangle, corner)].addPlane(normal, p0, 1.0);
+		}
+
+		// A plane through the border edge, perpendicular to the triangle,
+		// keeps the border from moving inwards
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t a = getPoint(triangle, corner);
+			uint32_t b = getPoint(triangle, (corner + 1) % 3);
+
+			if (edges[std::make_pair(std::min(a, b), std::max(a, b))] != 1)
+			{
+				continue;
+			}
+
+			glm::dvec3 borderNormal = glm::cross(_positions[b] - _positions[a], normal);
+
+			double borderLength = glm::length(borderNormal);
+
+			if (borderLength == 0.0)
+			{
+				continue;
+			}
+
+			borderNormal /= borderLength;
+
+			_quadrics[a].addPlane(borderNormal, _positions[a], BORDER_WEIGHT);
+			_quadrics[b].addPlane(borderNormal, _positions[a], BORDER_WEIGHT);
+		}
+	}
+}
+
+void MeshSimplifier::pushCollapses(uint32_t point)
+{
+	if (_collapsed[point])
+	{
+		return;
+	}
+
+	std::vector<uint32_t> neighbours;
+
+	getNeighbours(point, neighbours);
+
+	for (uint32_t neighbour : neighbours)
+	{
+		_heap.push_back(Collapse{ getCost(point, neighbour), point, neighbour, _versions[point], _versions[neighbour] });
+		std::push_heap(_heap.begin(), _heap.end());
+	}
+}
+
+float MeshSimplifier::getCost(uint32_t from, uint32_t to) const
+{
+	Quadric quadric = _quadrics[from];
+	quadric.add(_quadrics[to]);
+
+	double error = quadric.evaluate(_positions[to]);
+
+	// How far the vertices of the removed point move in normal and texture space
+	float attributes = 0.f;
+
+	for (uint32_t vertex : _pointVertices[from])
+	{
+		float distance;
+
+		findClosestVertex(vertex, to, distance);
+
+		attributes += distance;
+	}
+
+	return static_cast<float>(std::max(error, 0.0)) + attributes * _attributeScale;
+}
+
+bool MeshSimplifier::canCollapse(uint32_t from, uint32_t to) const
+{
+	// The points opposite the edge are the only neighbours the two points
+	// may share, any other would be joined by two triangles after the collapse
+	std::vector<uint32_t> opposite;
+
+	for (uint32_t triangle : _pointTriangles[from])
+	{
+		if (_removed[triangle] || !touches(triangle, to))
+		{
+			continue;
+		}
+
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t point = getPoint(triangle, corner);
+
+			if (point != from && point != to && std::find(opposite.begin(), opposite.end(), point) == opposite.end())
+			{
+				opposite.push_back(point);
+			}
+		}
+	}
+
+	std::vector<uint32_t> fromNeighbours;
+	std::vector<uint32_t> toNeighbours;
+
+	getNeighbours(from, fromNeighbours);
+	getNeighbours(to, toNeighbours);
+
+	for (uint32_t neighbour : fromNeighbours)
+	{
+		if (neighbour != to &&
+			std::find(toNeighbours.begin(), toNeighbours.end(), neighbour) != toNeighbours.end() &&
+			std::find(opposite.begin(), opposite.end(), neighbour) == opposite.end())
+		{
+			return false;
+		}
+	}
+
+	// The triangles that remain must keep facing the same way
+	for (uint32_t triangle : _pointTriangles[from])
+	{
+		if (_removed[triangle] || touches(triangle, to))
+		{
+			continue;
+		}
+
+		glm::dvec3 before[3];
+		glm::dvec3 after[3];
+
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t point = getPoint(triangle, corner);
+
+			before[corner] = _positions[point];
+			after[corner] = _positions[point == from ? to : point];
+		}
+
+		glm::dvec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+		glm::dvec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+		double lengthBefore = glm::length(normalBefore);
+		double lengthAfter = glm::length(normalAfter);
+
+		if (lengthBefore == 0.0)
+		{
+			continue;
+		}
+
+		if (lengthAfter == 0.0 ||
+			glm::dot(normalBefore, normalAfter) < MIN_NORMAL_COSINE * lengthBefore * lengthAfter)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MeshSimplifier::collapse(uint32_t from, uint32_t to)
+{
+	std::vector<std::pair<uint32_t, uint32_t>> remap;
+
+	for (uint32_t vertex : _pointVertices[from])
+	{
+		float distance;
+
+		remap.push_back(std::make_pair(vertex, findClosestVertex(vertex, to, distance)));
+	}
+
+	for (uint32_t triangle : _pointTriangles[from])
+	{
+		if (_removed[triangle])
+		{
+			continue;
+		}
+
+		// Triangles along the edge collapse to nothing
+		if (touches(triangle, to))
+		{
+			_removed[triangle] = true;
+			--_liveTriangles;
+			continue;
+		}
+
+		for (uint32_t& vertex : _triangles[triangle])
+		{
+			if (_vertexPoints[vertex] != from)
+			{
+				continue;
+			}
+
+			for (const std::pair<uint32_t, uint32_t>& mapping : remap)
+			{
+				if (mapping.first == vertex)
+				{
+					vertex = mapping.second;
+					break;
+				}
+			}
+		}
+
+		_pointTriangles[to].push_back(triangle);
+	}
+
+	std::vector<uint32_t>& triangles = _pointTriangles[to];
+
+	triangles.erase(
+		std::remove_if(triangles.begin(), triangles.end(), [this](uint32_t triangle) { return _removed[triangle]; }),
+		triangles.end());
+
+	_pointTriangles[from].clear();
+	_pointTriangles[from].shrink_to_fit();
+
+	_quadrics[to].add(_quadrics[from]);
+	_collapsed[from] = true;
+
+	// The kept point and its neighbours have new costs
+	std::vector<uint32_t> neighbours;
+
+	getNeighbours(to, neighbours);
+
+	++_versions[to];
+
+	for (uint32_t neighbour : neighbours)
+	{
+		++_versions[neighbour];
+	}
+
+	pushCollapses(to);
+
+	for (uint32_t neighbour : neighbours)
+	{
+		pushCollapses(neighbour);
+	}
+}
+
+uint32_t MeshSimplifier::findClosestVertex(uint32_t vertex, uint32_t point, float& distance) const
+{
+	uint32_t closest = _pointVertices[point].front();
+
+	distance = std::numeric_limits<float>::max();
+
+	for (uint32_t candidate : _pointVertices[point])
+	{
+		glm::vec3 normal = _normals[vertex] - _normals[candidate];
+		glm::vec2 texCoord = _texCoords[vertex] - _texCoords[candidate];
+
+		float candidateDistance = glm::dot(normal, normal) + glm::dot(texCoord, texCoord);
+
+		if (candidateDistance < distance)
+		{
+			distance = candidateDistance;
+			closest = candidate;
+		}
+	}
+
+	return closest;
+}
+
+void MeshSimplifier::getNeighbours(uint32_t point, std::vector<uint32_t>& neighbours) const
+{
+	neighbours.clear();
+
+	for (uint32_t triangle : _pointTriangles[point])
+	{
+		if (_removed[triangle])
+		{
+			continue;
+		}
+
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t neighbour = getPoint(triangle, corner);
+
+			if (neighbour != point && std::find(neighbours.begin(), neighbours.end(), neighbour) == neighbours.end())
+			{
+				neighbours.push_back(neighbour);
+			}
+		}
+	}
+}
+
+bool MeshSimplifier::touches(uint32_t triangle, uint32_t point) const
+{
+	return
+		getPoint(triangle, 0) == point ||
+		getPoint(triangle, 1) == point ||
+		getPoint(triangle, 2) == point;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file	MeshSimplifier.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Mesh simplification by quadric error edge collapses
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Removes triangles from an indexed triangle mesh while keeping its
+ * shape and attributes, using quadric error metrics.
+ *
+ * Vertices sharing a position, such as the corners of a UV or normal seam,
+ * are collapsed together as one point. A collapse moves a point onto a
+ * neighbour and keeps the neighbour's position, so only indices change and
+ * every level can be drawn from the original vertex buffer. The vertices
+ * of the removed point take over the vertex of the neighbour with the
+ * closest normal and texture coordinates.
+ *
+ * The cost of a collapse is the quadric error of the kept position over the
+ * planes of the triangles around both points, plus how far the normals and
+ * texture coordinates move. Open borders add planes along the border so
+ * their outline is kept. Collapses that would fold the surface onto itself
+ * or flip a triangle are skipped.
+ *
+ * Simplifying continues from the previous call, so a chain of levels is
+ * built by calling simplify() with smaller and smaller targets.
+ */
+class MeshSimplifier
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param positions Three floats per vertex.
+	 * @param normals Three floats per vertex, or nullptr.
+	 * @param texCoords Two floats per vertex, or nullptr.
+	 * @param vertexCount Number of vertices.
+	 * @param indices Three indices per triangle.
+	 * @param indexCount Number of indices.
+	 */
+	MeshSimplifier(
+		const GLfloat* positions,
+		const GLfloat* normals,
+		const GLfloat* texCoords,
+		size_t vertexCount,
+		const GLuint* indices,
+		size_t indexCount);
+
+	/**
+	 * @brief Collapses edges, cheapest first, until at most targetIndexCount
+	 * indices remain or nothing more can be collapsed.
+	 * @param targetIndexCount Number of indices to reach.
+	 */
+	void simplify(size_t targetIndexCount);
+
+	/**
+	 * @brief Gets the indices of the remaining triangles, in their original
+	 * order.
+	 * @param indices Vector to fill.
+	 */
+	void getIndices(std::vector<GLuint>& indices) const;
+
+	/**
+	 * @brief Gets the number of indices remaining.
+	 * @return Number of indices.
+	 */
+	size_t getIndexCount() const { return _liveTriangles * 3; }
+
+	/**
+	 * @brief Gets the largest cost of the collapses so far.
+	 * @return Squared distance in model units.
+	 */
+	float getError() const { return _error; }
+
+	/**
+	 * @brief Weight of moving a normal or texture coordinate, relative to
+	 * the squared size of the mesh.
+	 */
+	static constexpr float ATTRIBUTE_WEIGHT{ 0.01f };
+
+	/**
+	 * @brief Weight of the planes along open borders.
+	 */
+	static constexpr float BORDER_WEIGHT{ 10.f };
+
+	/**
+	 * @brief Smallest cosine between a triangle normal before and after a
+	 * collapse.
+	 */
+	static constexpr float MIN_NORMAL_COSINE{ 0.25f };
+
+private:
+	/**
+	 * @brief Sum of squared distances to a set of planes, as a symmetric
+	 * 4x4 matrix.
+	 */
+	struct Quadric
+	{
+		/**
+		 * @brief Upper triangle of the matrix, row by row.
+		 */
+		double m[10];
+
+		/**
+		 * @brief Adds the squared distance to a plane.
+		 * @param normal Unit normal of the plane.
+		 * @param point Point on the plane.
+		 * @param weight Weight of the plane.
+		 */
+		void addPlane(const glm::dvec3& normal, const glm::dvec3& point, double weight);
+
+		/**
+		 * @brief Adds another quadric.
+		 * @param other The quadric.
+		 */
+		void add(const Quadric& other);
+
+		/**
+		 * @brief Gets the error of a position.
+		 * @param p The position.
+		 * @return Weighted sum of squared distances.
+		 */
+		double evaluate(const glm::dvec3& p) const;
+	};
+
+	/**
+	 * @brief Candidate collapse of one point onto another.
+	 */
+	struct Collapse
+	{
+		/**
+		 * @brief Cost of the collapse.
+		 */
+		float cost;
+
+		/**
+		 * @brief Point removed.
+		 */
+		uint32_t from;
+
+		/**
+		 * @brief Point kept.
+		 */
+		uint32_t to;
+
+		/**
+		 * @brief Version of from when the cost was computed.
+		 */
+		uint32_t fromVersion;
+
+		/**
+		 * @brief Version of to when the cost was computed.
+		 */
+		uint32_t toVersion;
+
+		/**
+		 * @brief Orders the cheapest collapse first in a heap.
+		 * @param other Collapse to compare with.
+		 * @return True if this collapse costs more.
+		 */
+		bool operator<(const Collapse& other) const { return cost > other.cost; }
+	};
+
+	/**
+	 * @brief Adds the planes of the triangles and the open borders to the
+	 * quadrics of the points.
+	 */
+	void buildQuadrics();
+
+	/**
+	 * @brief Adds the collapses of every edge around a point to the heap.
+	 * @param point The point.
+	 */
+	void pushCollapses(uint32_t point);
+
+	/**
+	 * @brief Gets the cost of a collapse.
+	 * @param from Point removed.
+	 * @param to Point kept.
+	 * @return The cost.
+	 */
+	float getCost(uint32_t from, uint32_t to) const;
+
+	/**
+	 * @brief Checks that a collapse keeps the surface manifold around the
+	 * edge and flips no triangle.
+	 * @param from Point removed.
+	 * @param to Point kept.
+	 * @return True if the collapse is allowed.
+	 */
+	bool canCollapse(uint32_t from, uint32_t to) const;
+
+	/**
+	 * @brief Collapses a point onto another.
+	 * @param from Point removed.
+	 * @param to Point kept.
+	 */
+	void collapse(uint32_t from, uint32_t to);
+
+	/**
+	 * @brief Gets the vertex at a point whose attributes are closest to a
+	 * vertex.
+	 * @param vertex The vertex.
+	 * @param point The point.
+	 * @param distance Set to the squared attribute distance.
+	 * @return The closest vertex.
+	 */
+	uint32_t findClosestVertex(uint32_t vertex, uint32_t point, float& distance) const;
+
+	/**
+	 * @brief Gets the points sharing a triangle with a point.
+	 * @param point The point.
+	 * @param neighbours Vector to fill, without duplicates.
+	 */
+	void getNeighbours(uint32_t point, std::vector<uint32_t>& neighbours) const;
+
+	/**
+	 * @brief Gets the point of a corner of a triangle.
+	 * @param triangle The triangle.
+	 * @param corner 0, 1 or 2.
+	 * @return The point.
+	 */
+	uint32_t getPoint(uint32_t triangle, int corner) const { return _vertexPoints[_triangles[triangle][corner]]; }
+
+	/**
+	 * @brief Checks if a triangle touches a point.
+	 * @param triangle The triangle.
+	 * @param point The point.
+	 * @return True if any corner is at the point.
+	 */
+	bool touches(uint32_t triangle, uint32_t point) const;
+
+	/**
+	 * @brief Normal of every vertex.
+	 */
+	std::vector<glm::vec3> _normals;
+
+	/**
+	 * @brief Texture coordinates of every vertex.
+	 */
+	std::vector<glm::vec2> _texCoords;
+
+	/**
+	 * @brief Point of every vertex.
+	 */
+	std::vector<uint32_t> _vertexPoints;
+
+	/**
+	 * @brief Position of every point.
+	 */
+	std::vector<glm::dvec3> _positions;
+
+	/**
+	 * @brief Vertices at every point.
+	 */
+	std::vector<std::vector<uint32_t>> _pointVertices;
+
+	/**
+	 * @brief Triangles around every point, including removed ones.
+	 */
+	std::vector<std::vector<uint32_t>> _pointTriangles;
+
+	/**
+	 * @brief Quadric of every point.
+	 */
+	std::vector<Quadric> _quadrics;
+
+	/**
+	 * @brief Version of every point, changed whenever its collapses do.
+	 */
+	std::vector<uint32_t> _versions;
+
+	/**
+	 * @brief Whether every point has been collapsed.
+	 */
+	std::vector<bool> _collapsed;
+
+	/**
+	 * @brief Vertices of every triangle.
+	 */
+	std::vector<std::array<uint32_t, 3>> _triangles;
+
+	/**
+	 * @brief Whether every triangle has been removed.
+	 */
+	std::vector<bool> _removed;
+
+	/**
+	 * @brief Heap of candidate collapses, some of them out of date.
+	 */
+	std::vector<Collapse> _heap;
+
+	/**
+	 * @brief Number of triangles not removed.
+	 */
+	size_t _liveTriangles{ 0 };
+
+	/**
+	 * @brief Weight of the attribute distance, scaled to the mesh.
+	 */
+	float _attributeScale{ 0.f };
+
+	/**
+	 * @brief Largest cost of the collapses so far.
+	 */
+	float _error{ 0.f };
+};
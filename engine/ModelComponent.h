@@ -28,7 +28,7 @@ public:
 	 * @brief XML Constructor
 	 * @param node XML node
 	 */
-	explicit ModelComponent(rapidxml::xml_node<>* node) {} // TODO: Lgg till
+	explicit ModelComponent(rapidxml::xml_node<>* node) {} // TODO: Lägg till
 
 	/**
 	 * @brief ID getter
@@ -0,0 +1,634 @@
+/**
+ * @file	Narrowphase.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Exact shape tests for the pairs found by the broadphase
+ */
+
+#include "Narrowphase.h"
+#include "TransformComponent.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NARROWPHASE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	typedef Narrowphase::Shape Shape;
+	typedef Narrowphase::Result Result;
+
+	/**
+	 * @brief Result for shapes that do not touch.
+	 */
+	const Result MISS{ glm::vec3{}, 0.f, glm::vec3{}, false };
+
+	/**
+	 * @brief Gets the closest point on a segment.
+	 * @param p0 Start of the segment.
+	 * @param p1 End of the segment.
+	 * @param point The point.
+	 * @return Closest point.
+	 */
+	glm::vec3 closestOnSegment(glm::vec3 p0, glm::vec3 p1, glm::vec3 point)
+	{
+		glm::vec3 d = p1 - p0;
+
+		float length2 = glm::dot(d, d);
+
+		if (length2 <= 0.f)
+			return p0;
+
+		float t = glm::clamp(glm::dot(point - p0, d) / length2, 0.f, 1.f);
+
+		return p0 + d * t;
+	}
+
+	/**
+	 * @brief Gets the closest points between two segments.
+	 * @param p0 Start of first segment.
+	 * @param p1 End of first segment.
+	 * @param q0 Start of second segment.
+	 * @param q1 End of second segment.
+	 * @param c1 Set to the closest point on the first segment.
+	 * @param c2 Set to the closest point on the second segment.
+	 */
+	void closestBetweenSegments(glm::vec3 p0, glm::vec3 p1, glm::vec3 q0, glm::vec3 q1, glm::vec3& c1, glm::vec3& c2)
+	{
+		glm::vec3 d1 = p1 - p0;
+		glm::vec3 d2 = q1 - q0;
+		glm::vec3 r = p0 - q0;
+
+		float a = glm::dot(d1, d1);
+		float e = glm::dot(d2, d2);
+		float f = glm::dot(d2, r);
+
+		float s = 0.f;
+		float t = 0.f;
+
+		if (a <= 0.f && e <= 0.f)
+		{
+			c1 = p0;
+			c2 = q0;
+
+			return;
+		}
+
+		if (a <= 0.f)
+		{
+			t = glm::clamp(f / e, 0.f, 1.f);
+		}
+		else
+		{
+			float c = glm::dot(d1, r);
+
+			if (e <= 0.f)
+			{
+				s = glm::clamp(-c / a, 0.f, 1.f);
+			}
+			else
+			{
+				float b = glm::dot(d1, d2);
+				float denom = a * e - b * b;
+
+				// Parallel segments pick any point, the second clamp fixes it up
+				s = denom != 0.f ? glm::clamp((b * f - c * e) / denom, 0.f, 1.f) : 0.f;
+				t = (b * s + f) / e;
+
+				if (t < 0.f)
+				{
+					t = 0.f;
+					s = glm::clamp(-c / a, 0.f, 1.f);
+				}
+				else if (t > 1.f)
+				{
+					t = 1.f;
+					s = glm::clamp((b - c) / a, 0.f, 1.f);
+				}
+			}
+		}
+
+		c1 = p0 + d1 * s;
+		c2 = q0 + d2 * t;
+	}
+
+	/**
+	 * @brief Tests two spheres.
+	 * @param c1 Center of first sphere.
+	 * @param r1 Radius of first sphere.
+	 * @param c2 Center of second sphere.
+	 * @param r2 Radius of second sphere.
+	 * @return The result.
+	 */
+	Result sphereSphere(glm::vec3 c1, float r1, glm::vec3 c2, float r2)
+	{
+		glm::vec3 d = c2 - c1;
+
+		float distance2 = glm::dot(d, d);
+		float radius = r1 + r2;
+
+		if (distance2 >= radius * radius)
+			return MISS;
+
+		float distance = std::sqrt(distance2);
+
+		// Concentric spheres get pushed apart along any axis
+		glm::vec3 normal = distance > 0.f ? d / distance : glm::vec3{ 0.f, 1.f, 0.f };
+
+		float depth = radius - distance;
+
+		return Result{ normal, depth, c1 + normal * (r1 - depth * 0.5f), true };
+	}
+
+	/**
+	 * @brief Tests a sphere against an axis aligned box.
+	 * @param center Center of the sphere.
+	 * @param radius Radius of the sphere.
+	 * @param boxCenter Center of the box.
+	 * @param half Half size of the box.
+	 * @return The result, normal from the sphere to the box.
+	 */
+	Result sphereBox(glm::vec3 center, float radius, glm::vec3 boxCenter, glm::vec3 half)
+	{
+		glm::vec3 local = center - boxCenter;
+		glm::vec3 closest = glm::clamp(local, -half, half);
+		glm::vec3 d = local - closest;
+
+		float distance2 = glm::dot(d, d);
+
+		if (distance2 >= radius * radius)
+			return MISS;
+
+		if (distance2 > 0.f)
+		{
+			float distance = std::sqrt(distance2);
+
+			return Result{ -d / distance, radius - distance, boxCenter + closest, true };
+		}
+
+		// Center inside the box, push out through the nearest face
+		glm::vec3 inside = half - glm::abs(local);
+
+		int axis = 0;
+
+		if (inside.y < inside[axis]) axis = 1;
+		if (inside.z < inside[axis]) axis = 2;
+
+		glm::vec3 normal{};
+		normal[axis] = local[axis] < 0.f ? 1.f : -1.f;
+
+		return Result{ normal, radius + inside[axis], center, true };
+	}
+
+	/**
+	 * @brief Tests two axis aligned boxes.
+	 * @param c1 Center of first box.
+	 * @param h1 Half size of first box.
+	 * @param c2 Center of second box.
+	 * @param h2 Half size of second box.
+	 * @return The result.
+	 */
+	Result boxBox(glm::vec3 c1, glm::vec3 h1, glm::vec3 c2, glm::vec3 h2)
+	{
+		glm::vec3 d = c2 - c1;
+		glm::vec3 overlap = h1 + h2 - glm::abs(d);
+
+		if (overlap.x <= 0.f || overlap.y <= 0.f || overlap.z <= 0.f)
+			return MISS;
+
+		int axis = 0;
+
+		if (overlap.y < overlap[axis]) axis = 1;
+		if (overlap.z < overlap[axis]) axis = 2;
+
+		glm::vec3 normal{};
+		normal[axis] = d[axis] < 0.f ? -1.f : 1.f;
+
+		// Middle of the overlapping region
+		glm::vec3 low = glm::max(c1 - h1, c2 - h2);
+		glm::vec3 high = glm::min(c1 + h1, c2 + h2);
+
+		return Result{ normal, overlap[axis], (low + high) * 0.5f, true };
+	}
+
+	/**
+	 * @brief Tests a capsule against an axis aligned box.
+	 *
+	 * Uses the point on the segment closest to the box as a sphere, found in
+	 * two steps, which is exact unless the segment runs deep into the box.
+	 *
+	 * @param p0 Start of the segment.
+	 * @param p1 End of the segment.
+	 * @param radius Radius of the capsule.
+	 * @param boxCenter Center of the box.
+	 * @param half Half size of the box.
+	 * @return The result, normal from the capsule to the box.
+	 */
+	Result capsuleBox(glm::vec3 p0, glm::vec3 p1, float radius, glm::vec3 boxCenter, glm::vec3 half)
+	{
+		glm::vec3 point = closestOnSegment(p0, p1, boxCenter);
+		glm::vec3 onBox = boxCenter + glm::clamp(point - boxCenter, -half, half);
+
+		point = closestOnSegment(p0, p1, onBox);
+
+		return sphereBox(point, radius, boxCenter, half);
+	}
+
+	/**
+	 * @brief Tests two boxes with the separating axis test.
+	 * @param c1 Center of first box.
+	 * @param r1 Rotation of first box.
+	 * @param h1 Half size of first box.
+	 * @param c2 Center of second box.
+	 * @param r2 Rotation of second box.
+	 * @param h2 Half size of second box.
+	 * @return The result.
+	 */
+	Result obbObb(glm::vec3 c1, const glm::mat3& r1, glm::vec3 h1, glm::vec3 c2, const glm::mat3& r2, glm::vec3 h2)
+	{
+		glm::vec3 d = c2 - c1;
+
+		float bestOverlap = INFINITY;
+		glm::vec3 bestAxis{};
+
+		// Returns false if the axis separates the boxes
+		auto testAxis = [&](glm::vec3 axis)
+		{
+			float length2 = glm::dot(axis, axis);
+
+			// Cross products of parallel edges are no axes
+			if (length2 < 1e-8f)
+				return true;
+
+			axis /= std::sqrt(length2);
+
+			float p1 = h1.x * std::abs(glm::dot(r1[0], axis)) + h1.y * std::abs(glm::dot(r1[1], axis)) + h1.z * std::abs(glm::dot(r1[2], axis));
+			float p2 = h2.x * std::abs(glm::dot(r2[0], axis)) + h2.y * std::abs(glm::dot(r2[1], axis)) + h2.z * std::abs(glm::dot(r2[2], axis));
+			float distance = glm::dot(d, axis);
+			float overlap = p1 + p2 - std::abs(distance);
+
+			if (overlap <= 0.f)
+				return false;
+
+			if (overlap < bestOverlap)
+			{
+				bestOverlap = overlap;
+				bestAxis = distance < 0.f ? -axis : axis;
+			}
+
+			return true;
+		};
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (!testAxis(r1[i]) || !testAxis(r2[i]))
+				return MISS;
+		}
+
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				if (!testAxis(glm::cross(r1[i], r2[j])))
+					return MISS;
+			}
+		}
+
+		// Deepest corner of the second box, moved halfway out
+		glm::vec3 corner = c2;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			corner -= r2[i] * (h2[i] * (glm::dot(r2[i], bestAxis) < 0.f ? -1.f : 1.f));
+		}
+
+		return Result{ bestAxis, bestOverlap, corner + bestAxis * (bestOverlap * 0.5f), true };
+	}
+
+	/**
+	 * @brief Gets the segment of a capsule.
+	 * @param shape The capsule.
+	 * @param p0 Set to the lower end.
+	 * @param p1 Set to the upper end.
+	 */
+	void getSegment(const Shape& shape, glm::vec3& p0, glm::vec3& p1)
+	{
+		glm::vec3 half{ 0.f, shape.size.y, 0.f };
+
+		p0 = shape.center - half;
+		p1 = shape.center + half;
+	}
+
+	/**
+	 * @brief Moves a result from the local space of a box to world space.
+	 * @param result The result in local space.
+	 * @param box The box.
+	 * @return The result in world space.
+	 */
+	Result toWorld(Result result, const Shape& box)
+	{
+		if (result.hit)
+		{
+			result.normal = box.rotation * result.normal;
+			result.point = box.center + box.rotation * result.point;
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Moves a point to the local space of a box.
+	 * @param point The point.
+	 * @param box The box.
+	 * @return The point in local space.
+	 */
+	glm::vec3 toLocal(glm::vec3 point, const Shape& box)
+	{
+		return glm::transpose(box.rotation) * (point - box.center);
+	}
+
+	/**
+	 * @brief Tests two shapes, the lower shape first.
+	 * @param a Lower shape.
+	 * @param b Higher shape.
+	 * @return The result.
+	 */
+	Result testShapes(const Shape& a, const Shape& b)
+	{
+		glm::vec3 p0, p1, q0, q1;
+
+		switch (a.type)
+		{
+		case SHAPE_SPHERE:
+			switch (b.type)
+			{
+			case SHAPE_SPHERE:
+				return sphereSphere(a.center, a.size.x, b.center, b.size.x);
+			case SHAPE_CAPSULE:
+				getSegment(b, q0, q1);
+				return sphereSphere(a.center, a.size.x, closestOnSegment(q0, q1, a.center), b.size.x);
+			case SHAPE_BOX:
+				return sphereBox(a.center, a.size.x, b.center, b.size);
+			case SHAPE_OBB:
+				return toWorld(sphereBox(toLocal(a.center, b), a.size.x, glm::vec3{}, b.size), b);
+			default:
+				return MISS;
+			}
+		case SHAPE_CAPSULE:
+			getSegment(a, p0, p1);
+
+			switch (b.type)
+			{
+			case SHAPE_CAPSULE:
+			{
+				glm::vec3 c1, c2;
+
+				getSegment(b, q0, q1);
+				closestBetweenSegments(p0, p1, q0, q1, c1, c2);
+
+				return sphereSphere(c1, a.size.x, c2, b.size.x);
+			}
+			case SHAPE_BOX:
+				return capsuleBox(p0, p1, a.size.x, b.center, b.size);
+			case SHAPE_OBB:
+				return toWorld(capsuleBox(toLocal(p0, b), toLocal(p1, b), a.size.x, glm::vec3{}, b.size), b);
+			default:
+				return MISS;
+			}
+		case SHAPE_BOX:
+			switch (b.type)
+			{
+			case SHAPE_BOX:
+				return boxBox(a.center, a.size, b.center, b.size);
+			case SHAPE_OBB:
+				return obbObb(a.center, glm::mat3{ 1.f }, a.size, b.center, b.rotation, b.size);
+			default:
+				return MISS;
+			}
+		case SHAPE_OBB:
+			return obbObb(a.center, a.rotation, a.size, b.center, b.rotation, b.size);
+		default:
+			return MISS;
+		}
+	}
+}
+
+Narrowphase::Narrowphase(EntityManager* entMan) :
+	_enM{ entMan },
+	_batches(SHAPE_COUNT * SHAPE_COUNT)
+{
+}
+
+uint32_t Narrowphase::process(std::vector<std::pair<EntityHandle, EntityHandle>>& pairs)
+{
+	size_t count = pairs.size();
+
+	_shapesA.resize(count);
+	_shapesB.resize(count);
+	_swapped.resize(count);
+	_results.resize(count);
+
+	for (auto& batch : _batches)
+	{
+		batch.clear();
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Shape a = readShape(pairs[i].first);
+		Shape b = readShape(pairs[i].second);
+
+		_swapped[i] = b.type < a.type;
+
+		if (_swapped[i])
+		{
+			std::swap(a, b);
+		}
+
+		_shapesA[i] = a;
+		_shapesB[i] = b;
+
+		_batches[getBatch(a.type, b.type)].push_back(static_cast<uint32_t>(i));
+	}
+
+	for (uint32_t batch = 0; batch < _batches.size(); ++batch)
+	{
+		if (!_batches[batch].empty())
+		{
+			runBatch(batch, _batches[batch]);
+		}
+	}
+
+	// Compact in pair order, the contacts follow the remaining pairs
+	_contacts.clear();
+
+	size_t kept = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Result& result = _results[i];
+
+		if (!result.hit)
+			continue;
+
+		glm::vec3 normal = _swapped[i] ? -result.normal : result.normal;
+
+		_contacts.push_back(CollisionContact{ pairs[i].first, pairs[i].second, normal, result.depth, result.point });
+
+		pairs[kept++] = pairs[i];
+	}
+
+	pairs.resize(kept);
+
+	return static_cast<uint32_t>(count - kept);
+}
+
+Narrowphase::Shape Narrowphase::readShape(EntityHandle ent)
+{
+	CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+	TransformComponent* transform = _enM->getComponent<TransformComponent>(ent);
+
+	Shape shape{ glm::mat3{ 1.f }, transform->position, collider->getSize(), collider->getShape() };
+
+	if (shape.type == SHAPE_OBB && transform->angle != 0.f)
+	{
+		shape.rotation = glm::mat3{ glm::rotate(glm::mat4{ 1.f }, transform->angle, transform->rotationAxis) };
+	}
+
+	return shape;
+}
+
+void Narrowphase::runBatch(uint32_t batch, const std::vector<uint32_t>& items)
+{
+	if (batch == getBatch(SHAPE_SPHERE, SHAPE_SPHERE))
+	{
+		runSphereBatch(items);
+	}
+	else if (batch == getBatch(SHAPE_BOX, SHAPE_BOX))
+	{
+		runBoxBatch(items);
+	}
+	else
+	{
+		for (auto i : items)
+		{
+			_results[i] = testShapes(_shapesA[i], _shapesB[i]);
+		}
+	}
+}
+
+void Narrowphase::runSphereBatch(const std::vector<uint32_t>& items)
+{
+#ifdef NARROWPHASE_SSE
+	// Lanes dx, dy, dz and radius sum, padded to whole groups of four
+	size_t count = items.size();
+	size_t padded = (count + 3) & ~size_t(3);
+
+	_lanes.assign(padded * 4, 0.f);
+
+	float* dx = &_lanes[0];
+	float* dy = dx + padded;
+	float* dz = dy + padded;
+	float* rs = dz + padded;
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		const Shape& a = _shapesA[items[k]];
+		const Shape& b = _shapesB[items[k]];
+
+		dx[k] = b.center.x - a.center.x;
+		dy[k] = b.center.y - a.center.y;
+		dz[k] = b.center.z - a.center.z;
+		rs[k] = a.size.x + b.size.x;
+	}
+
+	for (size_t k = 0; k < padded; k += 4)
+	{
+		__m128 x = _mm_loadu_ps(dx + k);
+		__m128 y = _mm_loadu_ps(dy + k);
+		__m128 z = _mm_loadu_ps(dz + k);
+		__m128 r = _mm_loadu_ps(rs + k);
+
+		__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distance2, _mm_mul_ps(r, r)));
+
+		for (size_t lane = 0; lane < 4 && k + lane < count; ++lane)
+		{
+			uint32_t i = items[k + lane];
+
+			_results[i] = (mask & (1 << lane)) ? testShapes(_shapesA[i], _shapesB[i]) : MISS;
+		}
+	}
+#else
+	for (auto i : items)
+	{
+		_results[i] = testShapes(_shapesA[i], _shapesB[i]);
+	}
+#endif
+}
+
+void Narrowphase::runBoxBatch(const std::vector<uint32_t>& items)
+{
+#ifdef NARROWPHASE_SSE
+	// Lanes |d| and half size sums per axis, padded to whole groups of four
+	size_t count = items.size();
+	size_t padded = (count + 3) & ~size_t(3);
+
+	_lanes.assign(padded * 6, 0.f);
+
+	float* dx = &_lanes[0];
+	float* dy = dx + padded;
+	float* dz = dy + padded;
+	float* hx = dz + padded;
+	float* hy = hx + padded;
+	float* hz = hy + padded;
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		const Shape& a = _shapesA[items[k]];
+		const Shape& b = _shapesB[items[k]];
+
+		dx[k] = b.center.x - a.center.x;
+		dy[k] = b.center.y - a.center.y;
+		dz[k] = b.center.z - a.center.z;
+		hx[k] = a.size.x + b.size.x;
+		hy[k] = a.size.y + b.size.y;
+		hz[k] = a.size.z + b.size.z;
+	}
+
+	// Clearing the sign bit gives the absolute value
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	for (size_t k = 0; k < padded; k += 4)
+	{
+		__m128 x = _mm_and_ps(_mm_loadu_ps(dx + k), absMask);
+		__m128 y = _mm_and_ps(_mm_loadu_ps(dy + k), absMask);
+		__m128 z = _mm_and_ps(_mm_loadu_ps(dz + k), absMask);
+
+		__m128 inside = _mm_and_ps(_mm_and_ps(
+			_mm_cmplt_ps(x, _mm_loadu_ps(hx + k)),
+			_mm_cmplt_ps(y, _mm_loadu_ps(hy + k))),
+			_mm_cmplt_ps(z, _mm_loadu_ps(hz + k)));
+
+		int mask = _mm_movemask_ps(inside);
+
+		for (size_t lane = 0; lane < 4 && k + lane < count; ++lane)
+		{
+			uint32_t i = items[k + lane];
+
+			_results[i] = (mask & (1 << lane)) ? testShapes(_shapesA[i], _shapesB[i]) : MISS;
+		}
+	}
+#else
+	for (auto i : items)
+	{
+		_results[i] = testShapes(_shapesA[i], _shapesB[i]);
+	}
+#endif
+}
@@ -0,0 +1,209 @@
+/**
+ * @file	Narrowphase.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Exact shape tests for the pairs found by the broadphase
+ */
+
+#pragma once
+
+#include "EntityManager.h"
+#include "CollisionComponent.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @brief Contact between two touching colliders.
+ */
+struct CollisionContact
+{
+	/**
+	 * @brief Handle to first entity.
+	 */
+	EntityHandle ent1;
+
+	/**
+	 * @brief Handle to second entity.
+	 */
+	EntityHandle ent2;
+
+	/**
+	 * @brief Contact normal, pointing from the first entity to the second.
+	 */
+	glm::vec3 normal;
+
+	/**
+	 * @brief Penetration depth along the normal.
+	 */
+	float depth;
+
+	/**
+	 * @brief Contact point in world space.
+	 */
+	glm::vec3 point;
+};
+
+/**
+ * @brief Tests the actual shapes of the pairs found by the broadphase.
+ *
+ * Pairs are sorted into one batch per combination of shapes, so every batch
+ * runs a single test function and nothing is dispatched per pair. The
+ * sphere and box batches first reject pairs four at a time with SSE and
+ * only compute contacts for the pairs that touch.
+ *
+ * Contacts are written in the order of the pairs to one packed buffer.
+ */
+class Narrowphase
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param entMan Pointer to the entity manager.
+	 */
+	explicit Narrowphase(EntityManager* entMan);
+
+	/**
+	 * @brief Tests the shapes of the pairs, removes the pairs that do not
+	 * touch and fills the contacts of the rest.
+	 * @param pairs The pairs, keeps the order of the touching ones.
+	 * @return Number of pairs removed.
+	 */
+	uint32_t process(std::vector<std::pair<EntityHandle, EntityHandle>>& pairs);
+
+	/**
+	 * @brief Gets the contacts of the last process, one per remaining pair.
+	 * @return Ref to contacts.
+	 */
+	const std::vector<CollisionContact>& getContacts() const { return _contacts; }
+
+	/**
+	 * @brief A collider as seen by the tests.
+	 */
+	struct Shape
+	{
+		/**
+		 * @brief Rotation, only used by SHAPE_OBB.
+		 */
+		glm::mat3 rotation;
+
+		/**
+		 * @brief Center in world space.
+		 */
+		glm::vec3 center;
+
+		/**
+		 * @brief Size, see CollisionShape.
+		 */
+		glm::vec3 size;
+
+		/**
+		 * @brief Shape.
+		 */
+		CollisionShape type;
+	};
+
+	/**
+	 * @brief Result of a test.
+	 */
+	struct Result
+	{
+		/**
+		 * @brief Normal from the first shape to the second.
+		 */
+		glm::vec3 normal;
+
+		/**
+		 * @brief Penetration depth.
+		 */
+		float depth;
+
+		/**
+		 * @brief Contact point.
+		 */
+		glm::vec3 point;
+
+		/**
+		 * @brief Whether the shapes touch.
+		 */
+		bool hit;
+	};
+
+private:
+	/**
+	 * @brief Gets the batch of a combination of shapes.
+	 * @param a Lower shape.
+	 * @param b Higher shape.
+	 * @return Batch index.
+	 */
+	static uint32_t getBatch(CollisionShape a, CollisionShape b) { return a * SHAPE_COUNT + b; }
+
+	/**
+	 * @brief Reads the shape of a collider.
+	 * @param ent Handle to entity.
+	 * @return The shape.
+	 */
+	Shape readShape(EntityHandle ent);
+
+	/**
+	 * @brief Tests all pairs of a batch.
+	 * @param batch Batch index.
+	 * @param items Pair indices in the batch.
+	 */
+	void runBatch(uint32_t batch, const std::vector<uint32_t>& items);
+
+	/**
+	 * @brief Tests a batch of sphere pairs, rejecting four at a time.
+	 * @param items Pair indices in the batch.
+	 */
+	void runSphereBatch(const std::vector<uint32_t>& items);
+
+	/**
+	 * @brief Tests a batch of axis aligned box pairs, rejecting four at a time.
+	 * @param items Pair indices in the batch.
+	 */
+	void runBoxBatch(const std::vector<uint32_t>& items);
+
+	/**
+	 * @brief Pointer to the entity manager.
+	 */
+	EntityManager* _enM;
+
+	/**
+	 * @brief Lower shape of every pair.
+	 */
+	std::vector<Shape> _shapesA{};
+
+	/**
+	 * @brief Higher shape of every pair.
+	 */
+	std::vector<Shape> _shapesB{};
+
+	/**
+	 * @brief Whether the entities of a pair were swapped to put the lower shape first.
+	 */
+	std::vector<uint8_t> _swapped{};
+
+	/**
+	 * @brief Pair indices of every batch.
+	 */
+	std::vector<std::vector<uint32_t>> _batches{};
+
+	/**
+	 * @brief Result of every pair.
+	 */
+	std::vector<Result> _results{};
+
+	/**
+	 * @brief Scratch lanes for the batched rejection tests.
+	 */
+	std::vector<float> _lanes{};
+
+	/**
+	 * @brief Contacts of the remaining pairs.
+	 */
+	std::vector<CollisionContact> _contacts{};
+};
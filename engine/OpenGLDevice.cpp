@@ -0,0 +1,460 @@
+/**
+ * @file	OpenGLDevice.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Graphics device issuing the commands to OpenGL
+ */
+
+#include "OpenGLDevice.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+void OpenGLDevice::useProgram(GLuint program)
+{
+	glUseProgram(program);
+}
+
+void OpenGLDevice::bindVertexArray(GLuint vao)
+{
+	glBindVertexArray(vao);
+}
+
+void OpenGLDevice::bindBuffer(GLenum target, GLuint buffer)
+{
+	glBindBuffer(target, buffer);
+}
+
+void OpenGLDevice::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void OpenGLDevice::bindFramebuffer(GLuint framebuffer)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void OpenGLDevice::activeTexture(GLuint unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void OpenGLDevice::bindTexture(GLenum target, GLuint texture)
+{
+	glBindTexture(target, texture);
+}
+
+void OpenGLDevice::setEnabled(GLenum capability, bool enabled)
+{
+	if (enabled)
+	{
+		glEnable(capability);
+	}
+	else
+	{
+		glDisable(capability);
+	}
+}
+
+void OpenGLDevice::cullFace(GLenum mode)
+{
+	glCullFace(mode);
+}
+
+void OpenGLDevice::depthFunc(GLenum func)
+{
+	glDepthFunc(func);
+}
+
+void OpenGLDevice::blendFunc(GLenum source, GLenum destination)
+{
+	glBlendFunc(source, destination);
+}
+
+void OpenGLDevice::polygonMode(GLenum mode)
+{
+	glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+void OpenGLDevice::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	glViewport(x, y, width, height);
+}
+
+GLuint OpenGLDevice::createBuffer()
+{
+	GLuint buffer = 0;
+
+	glGenBuffers(1, &buffer);
+
+	return buffer;
+}
+
+void OpenGLDevice::deleteBuffer(GLuint buffer)
+{
+	glDeleteBuffers(1, &buffer);
+}
+
+GLuint OpenGLDevice::createVertexArray()
+{
+	GLuint vao = 0;
+
+	glGenVertexArrays(1, &vao);
+
+	return vao;
+}
+
+void OpenGLDevice::deleteVertexArray(GLuint vao)
+{
+	glDeleteVertexArrays(1, &vao);
+}
+
+void OpenGLDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	glBufferData(target, size, data, usage);
+}
+
+void OpenGLDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	glBufferSubData(target, offset, size, data);
+}
+
+bool OpenGLDevice::hasBufferStorage() const
+{
+	return GLEW_ARB_buffer_storage != 0;
+}
+
+void OpenGLDevice::bufferStorage(GLenum target, GLsizeiptr size, GLbitfield flags)
+{
+	glBufferStorage(target, size, nullptr, flags);
+}
+
+void* OpenGLDevice::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr size, GLbitfield access)
+{
+	return glMapBufferRange(target, offset, size, access);
+}
+
+void OpenGLDevice::unmapBuffer(GLenum target)
+{
+	glUnmapBuffer(target);
+}
+
+void OpenGLDevice::vertexAttribPointer(GLuint location, GLint size, GLsizei stride, GLsizeiptr offset)
+{
+	glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(offset));
+}
+
+void OpenGLDevice::vertexAttribDivisor(GLuint location, GLuint divisor)
+{
+	glVertexAttribDivisor(location, divisor);
+}
+
+void OpenGLDevice::setAttribArrayEnabled(GLuint location, bool enabled)
+{
+	if (enabled)
+	{
+		glEnableVertexAttribArray(location);
+	}
+	else
+	{
+		glDisableVertexAttribArray(location);
+	}
+}
+
+GLuint OpenGLDevice::createShader(GLenum type)
+{
+	return glCreateShader(type);
+}
+
+bool OpenGLDevice::compileShader(GLuint shader, const std::string& source, std::string& log)
+{
+	const GLchar* text = source.c_str();
+
+	glShaderSource(shader, 1, &text, nullptr);
+	glCompileShader(shader);
+
+	GLint success = 0;
+
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+	if (success)
+	{
+		return true;
+	}
+
+	GLint length = 0;
+
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+
+	std::vector<GLchar> buffer(static_cast<size_t>(length) + 1);
+
+	glGetShaderInfoLog(shader, static_cast<GLsizei>(buffer.size()), nullptr, buffer.data());
+
+	log = buffer.data();
+
+	return false;
+}
+
+void OpenGLDevice::deleteShader(GLuint shader)
+{
+	glDeleteShader(shader);
+}
+
+GLuint OpenGLDevice::createProgram()
+{
+	return glCreateProgram();
+}
+
+void OpenGLDevice::attachShader(GLuint program, GLuint shader)
+{
+	glAttachShader(program, shader);
+}
+
+void OpenGLDevice::bindAttribLocation(GLuint program, GLuint location, const char* name)
+{
+	glBindAttribLocation(program, location, name);
+}
+
+bool OpenGLDevice::linkProgram(GLuint program, std::string& log)
+{
+	glLinkProgram(program);
+
+	GLint success = 0;
+
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+	if (success)
+	{
+		return true;
+	}
+
+	GLint length = 0;
+
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+	std::vector<GLchar> buffer(static_cast<size_t>(length) + 1);
+
+	glGetProgramInfoLog(program, static_cast<GLsizei>(buffer.size()), nullptr, buffer.data());
+
+	log = buffer.data();
+
+	return false;
+}
+
+void OpenGLDevice::deleteProgram(GLuint program)
+{
+	glDeleteProgram(program);
+}
+
+void OpenGLDevice::getActiveUniforms(GLuint program, std::vector<ActiveUniform>& uniforms)
+{
+	uniforms.clear();
+
+	GLint count = 0;
+	GLint maxLength = 0;
+
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::vector<GLchar> buffer(static_cast<size_t>(maxLength) + 1);
+
+	for (GLint i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+
+		glGetActiveUniform(program, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+
+		uniforms.push_back(ActiveUniform{ std::string{ buffer.data(), static_cast<size_t>(length) }, size });
+	}
+}
+
+GLint OpenGLDevice::getUniformLocation(GLuint program, const char* name)
+{
+	return glGetUniformLocation(program, name);
+}
+
+void OpenGLDevice::bindUniformBlock(GLuint program, const char* name, GLuint binding)
+{
+	GLuint index = glGetUniformBlockIndex(program, name);
+
+	if (index != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, index, binding);
+	}
+}
+
+GLuint OpenGLDevice::createTexture()
+{
+	GLuint texture = 0;
+
+	glGenTextures(1, &texture);
+
+	return texture;
+}
+
+void OpenGLDevice::deleteTexture(GLuint texture)
+{
+	glDeleteTextures(1, &texture);
+}
+
+void OpenGLDevice::texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data)
+{
+	glTexImage2D(target, 0, internalFormat, width, height, 0, format, type, data);
+}
+
+void OpenGLDevice::texParameter(GLenum target, GLenum name, GLint value)
+{
+	glTexParameteri(target, name, value);
+}
+
+void OpenGLDevice::texBorderColor(GLenum target, glm::vec4 color)
+{
+	glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, glm::value_ptr(color));
+}
+
+void OpenGLDevice::generateMipmap(GLenum target)
+{
+	glGenerateMipmap(target);
+}
+
+void OpenGLDevice::texBuffer(GLenum internalFormat, GLuint buffer)
+{
+	glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer);
+}
+
+void OpenGLDevice::pixelStore(GLenum name, GLint value)
+{
+	glPixelStorei(name, value);
+}
+
+GLuint OpenGLDevice::createFramebuffer()
+{
+	GLuint framebuffer = 0;
+
+	glGenFramebuffers(1, &framebuffer);
+
+	return framebuffer;
+}
+
+void OpenGLDevice::deleteFramebuffer(GLuint framebuffer)
+{
+	glDeleteFramebuffers(1, &framebuffer);
+}
+
+void OpenGLDevice::framebufferTexture(GLenum attachment, GLenum target, GLuint texture)
+{
+	if (target == GL_TEXTURE_CUBE_MAP)
+	{
+		glFramebufferTexture(GL_FRAMEBUFFER, attachment, texture, 0);
+	}
+	else
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, target, texture, 0);
+	}
+}
+
+void OpenGLDevice::drawBuffers(GLsizei count, const GLenum* buffers)
+{
+	if (count == 0)
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	else
+	{
+		glDrawBuffers(count, buffers);
+	}
+}
+
+bool OpenGLDevice::isFramebufferComplete()
+{
+	return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OpenGLDevice::uniform(GLint location, float value)
+{
+	glUniform1f(location, value);
+}
+
+void OpenGLDevice::uniform(GLint location, int value)
+{
+	glUniform1i(location, value);
+}
+
+void OpenGLDevice::uniform(GLint location, glm::vec2 value)
+{
+	glUniform2f(location, value.x, value.y);
+}
+
+void OpenGLDevice::uniform(GLint location, glm::vec3 value)
+{
+	glUniform3f(location, value.x, value.y, value.z);
+}
+
+void OpenGLDevice::uniform(GLint location, glm::vec4 value)
+{
+	glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+
+void OpenGLDevice::uniform(GLint location, const glm::mat4& value)
+{
+	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void OpenGLDevice::clear(GLbitfield mask)
+{
+	glClear(mask);
+}
+
+void OpenGLDevice::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	glDrawArrays(mode, first, count);
+}
+
+void OpenGLDevice::drawElements(GLenum mode, GLuint first, GLsizei count)
+{
+	glDrawElements(mode, count, GL_UNSIGNED_INT, reinterpret_cast<const void*>(first * sizeof(GLuint)));
+}
+
+void OpenGLDevice::drawElementsInstanced(GLenum mode, GLuint first, GLsizei count, GLsizei instances)
+{
+	glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, reinterpret_cast<const void*>(first * sizeof(GLuint)), instances);
+}
+
+GLsync OpenGLDevice::fence()
+{
+	return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OpenGLDevice::waitFence(GLsync fence)
+{
+	static constexpr GLuint64 TIMEOUT = 1000000000ull;
+
+	// Flush on the first wait, so the fence is sure to be signalled
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+
+	while (true)
+	{
+		GLenum status = glClientWaitSync(fence, flags, TIMEOUT);
+
+		if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED)
+		{
+			break;
+		}
+
+		flags = 0;
+	}
+
+	glDeleteSync(fence);
+}
+
+GLint OpenGLDevice::getInteger(GLenum name)
+{
+	GLint value = 0;
+
+	glGetIntegerv(name, &value);
+
+	return value;
+}
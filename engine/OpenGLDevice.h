@@ -0,0 +1,336 @@
+/**
+ * @file	OpenGLDevice.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Graphics device issuing the commands to OpenGL
+ */
+
+#pragma once
+
+#include "GraphicsDevice.h"
+
+/**
+ * @brief Passes every command straight on to the OpenGL context.
+ */
+class OpenGLDevice : public GraphicsDevice
+{
+public:
+	/**
+	 * @brief Calls glUseProgram.
+	 */
+	void useProgram(GLuint program) override;
+
+	/**
+	 * @brief Calls glBindVertexArray.
+	 */
+	void bindVertexArray(GLuint vao) override;
+
+	/**
+	 * @brief Calls glBindBuffer.
+	 */
+	void bindBuffer(GLenum target, GLuint buffer) override;
+
+	/**
+	 * @brief Calls glBindBufferRange.
+	 */
+	void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override;
+
+	/**
+	 * @brief Calls glBindFramebuffer with GL_FRAMEBUFFER.
+	 */
+	void bindFramebuffer(GLuint framebuffer) override;
+
+	/**
+	 * @brief Calls glActiveTexture.
+	 */
+	void activeTexture(GLuint unit) override;
+
+	/**
+	 * @brief Calls glBindTexture.
+	 */
+	void bindTexture(GLenum target, GLuint texture) override;
+
+	/**
+	 * @brief Calls glEnable or glDisable.
+	 */
+	void setEnabled(GLenum capability, bool enabled) override;
+
+	/**
+	 * @brief Calls glCullFace.
+	 */
+	void cullFace(GLenum mode) override;
+
+	/**
+	 * @brief Calls glDepthFunc.
+	 */
+	void depthFunc(GLenum func) override;
+
+	/**
+	 * @brief Calls glBlendFunc.
+	 */
+	void blendFunc(GLenum source, GLenum destination) override;
+
+	/**
+	 * @brief Calls glPolygonMode with GL_FRONT_AND_BACK.
+	 */
+	void polygonMode(GLenum mode) override;
+
+	/**
+	 * @brief Calls glViewport.
+	 */
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+
+	/**
+	 * @brief Calls glGenBuffers.
+	 */
+	GLuint createBuffer() override;
+
+	/**
+	 * @brief Calls glDeleteBuffers.
+	 */
+	void deleteBuffer(GLuint buffer) override;
+
+	/**
+	 * @brief Calls glGenVertexArrays.
+	 */
+	GLuint createVertexArray() override;
+
+	/**
+	 * @brief Calls glDeleteVertexArrays.
+	 */
+	void deleteVertexArray(GLuint vao) override;
+
+	/**
+	 * @brief Calls glBufferData.
+	 */
+	void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+
+	/**
+	 * @brief Calls glBufferSubData.
+	 */
+	void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+
+	/**
+	 * @brief Whether the context supports ARB_buffer_storage.
+	 */
+	bool hasBufferStorage() const override;
+
+	/**
+	 * @brief Calls glBufferStorage without initial data.
+	 */
+	void bufferStorage(GLenum target, GLsizeiptr size, GLbitfield flags) override;
+
+	/**
+	 * @brief Calls glMapBufferRange.
+	 */
+	void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr size, GLbitfield access) override;
+
+	/**
+	 * @brief Calls glUnmapBuffer.
+	 */
+	void unmapBuffer(GLenum target) override;
+
+	/**
+	 * @brief Calls glVertexAttribPointer with unnormalized floats.
+	 */
+	void vertexAttribPointer(GLuint location, GLint size, GLsizei stride, GLsizeiptr offset) override;
+
+	/**
+	 * @brief Calls glVertexAttribDivisor.
+	 */
+	void vertexAttribDivisor(GLuint location, GLuint divisor) override;
+
+	/**
+	 * @brief Calls glEnableVertexAttribArray or glDisableVertexAttribArray.
+	 */
+	void setAttribArrayEnabled(GLuint location, bool enabled) override;
+
+	/**
+	 * @brief Calls glCreateShader.
+	 */
+	GLuint createShader(GLenum type) override;
+
+	/**
+	 * @brief Calls glShaderSource and glCompileShader, and gets the info log
+	 * on failure.
+	 */
+	bool compileShader(GLuint shader, const std::string& source, std::string& log) override;
+
+	/**
+	 * @brief Calls glDeleteShader.
+	 */
+	void deleteShader(GLuint shader) override;
+
+	/**
+	 * @brief Calls glCreateProgram.
+	 */
+	GLuint createProgram() override;
+
+	/**
+	 * @brief Calls glAttachShader.
+	 */
+	void attachShader(GLuint program, GLuint shader) override;
+
+	/**
+	 * @brief Calls glBindAttribLocation.
+	 */
+	void bindAttribLocation(GLuint program, GLuint location, const char* name) override;
+
+	/**
+	 * @brief Calls glLinkProgram, and gets the info log on failure.
+	 */
+	bool linkProgram(GLuint program, std::string& log) override;
+
+	/**
+	 * @brief Calls glDeleteProgram.
+	 */
+	void deleteProgram(GLuint program) override;
+
+	/**
+	 * @brief Calls glGetActiveUniform for every active uniform.
+	 */
+	void getActiveUniforms(GLuint program, std::vector<ActiveUniform>& uniforms) override;
+
+	/**
+	 * @brief Calls glGetUniformLocation.
+	 */
+	GLint getUniformLocation(GLuint program, const char* name) override;
+
+	/**
+	 * @brief Calls glGetUniformBlockIndex and glUniformBlockBinding.
+	 */
+	void bindUniformBlock(GLuint program, const char* name, GLuint binding) override;
+
+	/**
+	 * @brief Calls glGenTextures.
+	 */
+	GLuint createTexture() override;
+
+	/**
+	 * @brief Calls glDeleteTextures.
+	 */
+	void deleteTexture(GLuint texture) override;
+
+	/**
+	 * @brief Calls glTexImage2D for level 0.
+	 */
+	void texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) override;
+
+	/**
+	 * @brief Calls glTexParameteri.
+	 */
+	void texParameter(GLenum target, GLenum name, GLint value) override;
+
+	/**
+	 * @brief Calls glTexParameterfv with GL_TEXTURE_BORDER_COLOR.
+	 */
+	void texBorderColor(GLenum target, glm::vec4 color) override;
+
+	/**
+	 * @brief Calls glGenerateMipmap.
+	 */
+	void generateMipmap(GLenum target) override;
+
+	/**
+	 * @brief Calls glTexBuffer with GL_TEXTURE_BUFFER.
+	 */
+	void texBuffer(GLenum internalFormat, GLuint buffer) override;
+
+	/**
+	 * @brief Calls glPixelStorei.
+	 */
+	void pixelStore(GLenum name, GLint value) override;
+
+	/**
+	 * @brief Calls glGenFramebuffers.
+	 */
+	GLuint createFramebuffer() override;
+
+	/**
+	 * @brief Calls glDeleteFramebuffers.
+	 */
+	void deleteFramebuffer(GLuint framebuffer) override;
+
+	/**
+	 * @brief Calls glFramebufferTexture2D, or glFramebufferTexture for a
+	 * cube map.
+	 */
+	void framebufferTexture(GLenum attachment, GLenum target, GLuint texture) override;
+
+	/**
+	 * @brief Calls glDrawBuffers, or glDrawBuffer and glReadBuffer with
+	 * GL_NONE without attachments.
+	 */
+	void drawBuffers(GLsizei count, const GLenum* buffers) override;
+
+	/**
+	 * @brief Calls glCheckFramebufferStatus.
+	 */
+	bool isFramebufferComplete() override;
+
+	/**
+	 * @brief Calls glUniform1f.
+	 */
+	void uniform(GLint location, float value) override;
+
+	/**
+	 * @brief Calls glUniform1i.
+	 */
+	void uniform(GLint location, int value) override;
+
+	/**
+	 * @brief Calls glUniform2f.
+	 */
+	void uniform(GLint location, glm::vec2 value) override;
+
+	/**
+	 * @brief Calls glUniform3f.
+	 */
+	void uniform(GLint location, glm::vec3 value) override;
+
+	/**
+	 * @brief Calls glUniform4f.
+	 */
+	void uniform(GLint location, glm::vec4 value) override;
+
+	/**
+	 * @brief Calls glUniformMatrix4fv.
+	 */
+	void uniform(GLint location, const glm::mat4& value) override;
+
+	/**
+	 * @brief Calls glClear.
+	 */
+	void clear(GLbitfield mask) override;
+
+	/**
+	 * @brief Calls glDrawArrays.
+	 */
+	void drawArrays(GLenum mode, GLint first, GLsizei count) override;
+
+	/**
+	 * @brief Calls glDrawElements.
+	 */
+	void drawElements(GLenum mode, GLuint first, GLsizei count) override;
+
+	/**
+	 * @brief Calls glDrawElementsInstanced.
+	 */
+	void drawElementsInstanced(GLenum mode, GLuint first, GLsizei count, GLsizei instances) override;
+
+	/**
+	 * @brief Calls glFenceSync.
+	 */
+	GLsync fence() override;
+
+	/**
+	 * @brief Calls glClientWaitSync until the fence is signalled, then
+	 * glDeleteSync.
+	 */
+	void waitFence(GLsync fence) override;
+
+	/**
+	 * @brief Calls glGetIntegerv.
+	 */
+	GLint getInteger(GLenum name) override;
+};
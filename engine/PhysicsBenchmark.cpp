@@ -0,0 +1,102 @@
+/**
+ * @file	PhysicsBenchmark.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless benchmark of the physics
+ */
+
+#include "PhysicsBenchmark.h"
+#include "EntityManager.h"
+#include "AABBTreeBroadphase.h"
+#include "CollisionComponent.h"
+#include "TransformComponent.h"
+#include "RigidBodyComponent.h"
+#include "PhysicsSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+void runPhysicsBenchmark(uint32_t bodyCount, uint32_t steps)
+{
+	const float dt = 1.f / 60.f;
+	const float spacing = 1.5f;
+
+	EventManager evM{};
+	EntityManager enM{ &evM, nullptr, nullptr };
+
+	enM.registerComponent<CollisionComponent>("CollisionComponent");
+	enM.registerComponent<TransformComponent>("TransformComponent");
+	enM.registerComponent<RigidBodyComponent>("RigidBodyComponent");
+	enM.registerSystem<PhysicsSystem>();
+
+	AABBTreeBroadphase broadphase{ &enM, &evM };
+
+	// Square layers of spheres above a static floor
+	uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(bodyCount / 8.f)));
+	float halfWidth = side * spacing * 0.5f;
+
+	EntityHandle floor = enM.createEntity();
+	enM.assignComponent<TransformComponent>(floor, glm::vec3{ 0.f, -1.f, 0.f });
+	enM.assignComponent<CollisionComponent>(floor, SHAPE_BOX, glm::vec3{ halfWidth + 1.f, 1.f, halfWidth + 1.f }, true);
+
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		uint32_t x = i % side;
+		uint32_t z = (i / side) % side;
+		uint32_t y = i / (side * side);
+
+		// Every other layer is offset so the spheres do not stack straight
+		float offset = (y % 2) * spacing * 0.5f;
+
+		glm::vec3 position{ x * spacing - halfWidth + offset, 1.f + y * spacing, z * spacing - halfWidth + offset };
+
+		EntityHandle ent = enM.createEntity();
+		enM.assignComponent<TransformComponent>(ent, position);
+		enM.assignComponent<CollisionComponent>(ent, SHAPE_SPHERE, glm::vec3{ 0.5f }, false);
+		enM.assignComponent<RigidBodyComponent>(ent, 1.f, glm::vec3{}, 0.2f, 0.5f);
+	}
+
+	enM.update(0.f);
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	double broadphaseTime = 0.0;
+	double physicsTime = 0.0;
+
+	for (uint32_t step = 0; step < steps; ++step)
+	{
+		Clock::time_point start = Clock::now();
+
+		broadphase.update();
+
+		Clock::time_point middle = Clock::now();
+
+		enM.update(dt);
+
+		Clock::time_point end = Clock::now();
+
+		broadphaseTime += std::chrono::duration<double, std::milli>(middle - start).count();
+		physicsTime += std::chrono::duration<double, std::milli>(end - middle).count();
+	}
+
+	uint32_t awakeCount = 0;
+
+	enM.each<RigidBodyComponent>([&](EntityHandle, RigidBodyComponent* body)
+	{
+		if (body->awake)
+		{
+			++awakeCount;
+		}
+	});
+
+	double totalTime = broadphaseTime + physicsTime;
+
+	std::cout << "Physics benchmark: " << bodyCount << " bodies, " << steps << " steps" << std::endl;
+	std::cout << "  Collision: " << broadphaseTime / steps << " ms/step" << std::endl;
+	std::cout << "  Physics:   " << physicsTime / steps << " ms/step" << std::endl;
+	std::cout << "  Total:     " << totalTime / steps << " ms/step, " << bodyCount * static_cast<double>(steps) / totalTime << " bodies/ms" << std::endl;
+	std::cout << "  Awake:     " << awakeCount << " of " << bodyCount << " bodies at the end" << std::endl;
+}
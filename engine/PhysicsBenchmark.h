@@ -0,0 +1,23 @@
+/**
+ * @file	PhysicsBenchmark.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless benchmark of the physics
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Drops a pile of spheres on a floor without opening a window and
+ * prints the time per step and the number of bodies simulated per
+ * millisecond.
+ *
+ * Runs the AABB tree broadphase, the narrowphase and the PhysicsSystem the
+ * same way a scene does.
+ *
+ * @param bodyCount Number of bodies.
+ * @param steps Number of steps to run.
+ */
+void runPhysicsBenchmark(uint32_t bodyCount = 4096, uint32_t steps = 600);
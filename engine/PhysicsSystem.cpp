@@ -0,0 +1,565 @@
+/**
+ * @file	PhysicsSystem.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Rigid body physics system
+ */
+
+#include "PhysicsSystem.h"
+#include "TransformComponent.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr uint32_t PhysicsSystem::SOLVER_ITERATIONS;
+constexpr float PhysicsSystem::SLEEP_VELOCITY;
+constexpr float PhysicsSystem::SLEEP_DELAY;
+constexpr float PhysicsSystem::BAUMGARTE;
+constexpr float PhysicsSystem::PENETRATION_SLOP;
+constexpr float PhysicsSystem::RESTITUTION_THRESHOLD;
+constexpr uint32_t PhysicsSystem::NO_BODY;
+constexpr size_t PhysicsSystem::GRAIN_SIZE;
+
+void PhysicsSystem::startUp()
+{
+	ev->addSubscriber<CollisionContactsEvent>(this);
+	ev->addSubscriber<ComponentAssignedEvent<RigidBodyComponent>>(this);
+	ev->addSubscriber<EntityDestroyedEvent>(this);
+}
+
+void PhysicsSystem::shutDown()
+{
+	ev->removeSubscriber<CollisionContactsEvent>(this);
+	ev->removeSubscriber<ComponentAssignedEvent<RigidBodyComponent>>(this);
+	ev->removeSubscriber<EntityDestroyedEvent>(this);
+}
+
+void PhysicsSystem::handleEvent(const CollisionContactsEvent& ev)
+{
+	_contacts.insert(_contacts.end(), ev.contacts, ev.contacts + ev.count);
+}
+
+void PhysicsSystem::handleEvent(const ComponentAssignedEvent<RigidBodyComponent>& ev)
+{
+	_pending.push_back(ev.entHandle);
+}
+
+void PhysicsSystem::handleEvent(const EntityDestroyedEvent& ev)
+{
+	_entToRemove.push_back(ev.entHandle);
+}
+
+void PhysicsSystem::update(float dt)
+{
+	updateBodies();
+
+	_stats = PhysicsStats{};
+	_stats.bodyCount = static_cast<uint32_t>(_entities.size());
+
+	if (_entities.empty() || dt <= 0.f)
+	{
+		_contacts.clear();
+		return;
+	}
+
+	gather();
+	buildConstraints(dt);
+	buildIslands();
+
+	// Integrate velocities
+	for (uint32_t body : _islandBodies)
+	{
+		if (_invMass[body] == 0.f)
+		{
+			continue;
+		}
+
+		if (_useGravity[body])
+		{
+			_velocity[body] += _gravity * dt;
+		}
+
+		_velocity[body] *= 1.f / (1.f + dt * _damping[body]);
+	}
+
+	// Islands share no bodies, so they can be solved at the same time
+	uint32_t islandCount = static_cast<uint32_t>(_bodyStart.size()) - 1;
+
+	JobSystem::get().parallelFor(islandCount, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			solveIsland(static_cast<uint32_t>(i));
+		}
+	});
+
+	// Integrate positions
+	for (uint32_t body : _islandBodies)
+	{
+		_position[body] += _velocity[body] * dt;
+	}
+
+	updateSleep(dt);
+	scatter();
+
+	_stats.awakeCount = static_cast<uint32_t>(_islandBodies.size());
+	_stats.islandCount = islandCount;
+	_stats.constraintCount = static_cast<uint32_t>(_constraints.size());
+
+	_contacts.clear();
+}
+
+void PhysicsSystem::updateBodies()
+{
+	if (!_entToRemove.empty())
+	{
+		for (EntityHandle ent : _entToRemove)
+		{
+			_bodyIndex.erase(ent);
+		}
+
+		_pending.erase(std::remove_if(_pending.begin(), _pending.end(), [&](EntityHandle ent)
+		{
+			return std::find(_entToRemove.begin(), _entToRemove.end(), ent) != _entToRemove.end();
+		}), _pending.end());
+
+		_entToRemove.clear();
+
+		// Compact the arrays in order, so the body order stays the same on every run
+		uint32_t count = 0;
+
+		for (uint32_t i = 0; i < _entities.size(); ++i)
+		{
+			if (_bodyIndex.find(_entities[i]) == _bodyIndex.end())
+			{
+				continue;
+			}
+
+			_entities[count] = _entities[i];
+			_position[count] = _position[i];
+			_velocity[count] = _velocity[i];
+			_invMass[count] = _invMass[i];
+			_restitution[count] = _restitution[i];
+			_friction[count] = _friction[i];
+			_damping[count] = _damping[i];
+			_useGravity[count] = _useGravity[i];
+			_awake[count] = _awake[i];
+			_stillTime[count] = _stillTime[i];
+
+			_bodyIndex[_entities[count]] = count;
+
+			++count;
+		}
+
+		_entities.resize(count);
+		_position.resize(count);
+		_velocity.resize(count);
+		_invMass.resize(count);
+		_restitution.resize(count);
+		_friction.resize(count);
+		_damping.resize(count);
+		_useGravity.resize(count);
+		_awake.resize(count);
+		_stillTime.resize(count);
+	}
+
+	if (_pending.empty())
+	{
+		return;
+	}
+
+	std::vector<EntityHandle> waiting;
+
+	for (EntityHandle ent : _pending)
+	{
+		if (_bodyIndex.find(ent) != _bodyIndex.end())
+		{
+			continue;
+		}
+
+		// The transform may be assigned after the body
+		if (!em->hasComponent<TransformComponent>(ent))
+		{
+			waiting.push_back(ent);
+			continue;
+		}
+
+		_bodyIndex[ent] = static_cast<uint32_t>(_entities.size());
+
+		_entities.push_back(ent);
+		_position.push_back(glm::vec3{});
+		_velocity.push_back(glm::vec3{});
+		_invMass.push_back(0.f);
+		_restitution.push_back(0.f);
+		_friction.push_back(0.f);
+		_damping.push_back(0.f);
+		_useGravity.push_back(0);
+		_awake.push_back(1);
+		_stillTime.push_back(0.f);
+	}
+
+	_pending.swap(waiting);
+}
+
+void PhysicsSystem::gather()
+{
+	_fellAsleep.assign(_entities.size(), 0);
+
+	JobSystem::get().parallelFor(_entities.size(), GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			RigidBodyComponent* body = em->getComponent<RigidBodyComponent>(_entities[i]);
+
+			_awake[i] = body->awake;
+
+			// Sleeping bodies are only read again once they wake up
+			if (!body->awake)
+			{
+				continue;
+			}
+
+			_position[i] = em->getComponent<TransformComponent>(_entities[i])->position;
+			_velocity[i] = body->velocity;
+			_invMass[i] = body->mass > 0.f ? 1.f / body->mass : 0.f;
+			_restitution[i] = body->restitution;
+			_friction[i] = body->friction;
+			_damping[i] = body->damping;
+			_useGravity[i] = body->useGravity;
+		}
+	});
+}
+
+void PhysicsSystem::wake(uint32_t body)
+{
+	RigidBodyComponent* comp = em->getComponent<RigidBodyComponent>(_entities[body]);
+
+	comp->awake = true;
+
+	_awake[body] = 1;
+	_stillTime[body] = 0.f;
+
+	_position[body] = em->getComponent<TransformComponent>(_entities[body])->position;
+	_velocity[body] = comp->velocity;
+	_invMass[body] = comp->mass > 0.f ? 1.f / comp->mass : 0.f;
+	_restitution[body] = comp->restitution;
+	_friction[body] = comp->friction;
+	_damping[body] = comp->damping;
+	_useGravity[body] = comp->useGravity;
+}
+
+void PhysicsSystem::buildConstraints(float dt)
+{
+	_constraints.clear();
+
+	auto indexOf = [&](EntityHandle ent)
+	{
+		auto it = _bodyIndex.find(ent);
+
+		return it == _bodyIndex.end() ? NO_BODY : it->second;
+	};
+
+	for (const CollisionContact& contact : _contacts)
+	{
+		uint32_t a = indexOf(contact.ent1);
+		uint32_t b = indexOf(contact.ent2);
+
+		bool awakeA = a != NO_BODY && _awake[a];
+		bool awakeB = b != NO_BODY && _awake[b];
+
+		// Nothing moves, the contact can be skipped
+		if (!awakeA && !awakeB)
+		{
+			continue;
+		}
+
+		if (a != NO_BODY && !awakeA)
+		{
+			wake(a);
+		}
+
+		if (b != NO_BODY && !awakeB)
+		{
+			wake(b);
+		}
+
+		float invMassA = a != NO_BODY ? _invMass[a] : 0.f;
+		float invMassB = b != NO_BODY ? _invMass[b] : 0.f;
+
+		if (invMassA + invMassB == 0.f)
+		{
+			continue;
+		}
+
+		Constraint constraint;
+
+		constraint.a = a;
+		constraint.b = b;
+		constraint.normal = contact.normal;
+
+		// Any two directions perpendicular to the normal will do for friction
+		glm::vec3 axis = std::abs(contact.normal.x) < 0.57735f ? glm::vec3{ 1.f, 0.f, 0.f } : glm::vec3{ 0.f, 1.f, 0.f };
+		constraint.tangent1 = glm::normalize(glm::cross(contact.normal, axis));
+		constraint.tangent2 = glm::cross(contact.normal, constraint.tangent1);
+
+		// Colliders without a body take the values of the body they touch
+		float restitutionA = a != NO_BODY ? _restitution[a] : _restitution[b];
+		float restitutionB = b != NO_BODY ? _restitution[b] : _restitution[a];
+		float frictionA = a != NO_BODY ? _friction[a] : _friction[b];
+		float frictionB = b != NO_BODY ? _friction[b] : _friction[a];
+
+		constraint.friction = std::sqrt(frictionA * frictionB);
+		constraint.effectiveMass = 1.f / (invMassA + invMassB);
+
+		constraint.bias = BAUMGARTE / dt * std::max(contact.depth - PENETRATION_SLOP, 0.f);
+
+		glm::vec3 velocityA = a != NO_BODY ? _velocity[a] : glm::vec3{};
+		glm::vec3 velocityB = b != NO_BODY ? _velocity[b] : glm::vec3{};
+
+		float normalVelocity = glm::dot(velocityB - velocityA, contact.normal);
+
+		if (normalVelocity < -RESTITUTION_THRESHOLD)
+		{
+			constraint.bias = std::max(constraint.bias, -std::max(restitutionA, restitutionB) * normalVelocity);
+		}
+
+		constraint.normalImpulse = 0.f;
+		constraint.tangentImpulse1 = 0.f;
+		constraint.tangentImpulse2 = 0.f;
+
+		_constraints.push_back(constraint);
+	}
+}
+
+uint32_t PhysicsSystem::findRoot(uint32_t body)
+{
+	while (_parent[body] != body)
+	{
+		_parent[body] = _parent[_parent[body]];
+		body = _parent[body];
+	}
+
+	return body;
+}
+
+void PhysicsSystem::buildIslands()
+{
+	uint32_t bodyCount = static_cast<uint32_t>(_entities.size());
+
+	_parent.resize(bodyCount);
+
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		_parent[i] = i;
+	}
+
+	// Bodies without mass are never pushed, so they do not join islands
+	for (const Constraint& constraint : _constraints)
+	{
+		if (constraint.a == NO_BODY || constraint.b == NO_BODY || _invMass[constraint.a] == 0.f || _invMass[constraint.b] == 0.f)
+		{
+			continue;
+		}
+
+		uint32_t rootA = findRoot(constraint.a);
+		uint32_t rootB = findRoot(constraint.b);
+
+		if (rootA != rootB)
+		{
+			_parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+		}
+	}
+
+	// Number the islands in body order, so the result does not depend on the contact order
+	_island.assign(bodyCount, NO_BODY);
+	_bodyStart.assign(1, 0);
+
+	std::vector<uint32_t> rootIsland(bodyCount, NO_BODY);
+
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		if (!_awake[i])
+		{
+			continue;
+		}
+
+		uint32_t root = findRoot(i);
+
+		if (rootIsland[root] == NO_BODY)
+		{
+			rootIsland[root] = static_cast<uint32_t>(_bodyStart.size()) - 1;
+			_bodyStart.push_back(0);
+		}
+
+		_island[i] = rootIsland[root];
+		++_bodyStart[_island[i] + 1];
+	}
+
+	uint32_t islandCount = static_cast<uint32_t>(_bodyStart.size()) - 1;
+
+	for (uint32_t i = 0; i < islandCount; ++i)
+	{
+		_bodyStart[i + 1] += _bodyStart[i];
+	}
+
+	_islandBodies.resize(_bodyStart[islandCount]);
+
+	std::vector<uint32_t> cursor(_bodyStart.begin(), _bodyStart.end() - 1);
+
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		if (_island[i] != NO_BODY)
+		{
+			_islandBodies[cursor[_island[i]]++] = i;
+		}
+	}
+
+	// Constraints go to the island of their pushable body
+	_constraintStart.assign(islandCount + 1, 0);
+
+	auto islandOf = [&](const Constraint& constraint)
+	{
+		return constraint.a != NO_BODY && _invMass[constraint.a] > 0.f ? _island[constraint.a] : _island[constraint.b];
+	};
+
+	for (const Constraint& constraint : _constraints)
+	{
+		++_constraintStart[islandOf(constraint) + 1];
+	}
+
+	for (uint32_t i = 0; i < islandCount; ++i)
+	{
+		_constraintStart[i + 1] += _constraintStart[i];
+	}
+
+	_islandConstraints.resize(_constraints.size());
+
+	cursor.assign(_constraintStart.begin(), _constraintStart.end() - 1);
+
+	for (uint32_t i = 0; i < _constraints.size(); ++i)
+	{
+		_islandConstraints[cursor[islandOf(_constraints[i])]++] = i;
+	}
+}
+
+void PhysicsSystem::solveIsland(uint32_t island)
+{
+	uint32_t begin = _constraintStart[island];
+	uint32_t end = _constraintStart[island + 1];
+
+	if (begin == end)
+	{
+		return;
+	}
+
+	for (uint32_t iteration = 0; iteration < SOLVER_ITERATIONS; ++iteration)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			Constraint& c = _constraints[_islandConstraints[i]];
+
+			// Bodies without mass may be shared between islands, so they are only read
+			float invMassA = c.a != NO_BODY ? _invMass[c.a] : 0.f;
+			float invMassB = c.b != NO_BODY ? _invMass[c.b] : 0.f;
+
+			glm::vec3 velocityA = c.a != NO_BODY ? _velocity[c.a] : glm::vec3{};
+			glm::vec3 velocityB = c.b != NO_BODY ? _velocity[c.b] : glm::vec3{};
+
+			glm::vec3 relative = velocityB - velocityA;
+
+			// Normal impulse, never pulls the bodies together
+			float lambda = (c.bias - glm::dot(relative, c.normal)) * c.effectiveMass;
+			float impulse = std::max(c.normalImpulse + lambda, 0.f);
+			lambda = impulse - c.normalImpulse;
+			c.normalImpulse = impulse;
+
+			glm::vec3 p = c.normal * lambda;
+
+			// Friction impulses, bounded by the normal impulse
+			float maxFriction = c.friction * c.normalImpulse;
+
+			relative += p * (invMassA + invMassB);
+
+			float lambda1 = -glm::dot(relative, c.tangent1) * c.effectiveMass;
+			impulse = glm::clamp(c.tangentImpulse1 + lambda1, -maxFriction, maxFriction);
+			lambda1 = impulse - c.tangentImpulse1;
+			c.tangentImpulse1 = impulse;
+
+			float lambda2 = -glm::dot(relative, c.tangent2) * c.effectiveMass;
+			impulse = glm::clamp(c.tangentImpulse2 + lambda2, -maxFriction, maxFriction);
+			lambda2 = impulse - c.tangentImpulse2;
+			c.tangentImpulse2 = impulse;
+
+			p += c.tangent1 * lambda1 + c.tangent2 * lambda2;
+
+			if (invMassA > 0.f)
+			{
+				_velocity[c.a] -= p * invMassA;
+			}
+
+			if (invMassB > 0.f)
+			{
+				_velocity[c.b] += p * invMassB;
+			}
+		}
+	}
+}
+
+void PhysicsSystem::updateSleep(float dt)
+{
+	uint32_t islandCount = static_cast<uint32_t>(_bodyStart.size()) - 1;
+
+	for (uint32_t island = 0; island < islandCount; ++island)
+	{
+		float stillTime = SLEEP_DELAY;
+
+		for (uint32_t i = _bodyStart[island]; i < _bodyStart[island + 1]; ++i)
+		{
+			uint32_t body = _islandBodies[i];
+
+			if (glm::dot(_velocity[body], _velocity[body]) > SLEEP_VELOCITY * SLEEP_VELOCITY)
+			{
+				_stillTime[body] = 0.f;
+			}
+			else
+			{
+				_stillTime[body] += dt;
+			}
+
+			stillTime = std::min(stillTime, _stillTime[body]);
+		}
+
+		if (stillTime < SLEEP_DELAY)
+		{
+			continue;
+		}
+
+		for (uint32_t i = _bodyStart[island]; i < _bodyStart[island + 1]; ++i)
+		{
+			uint32_t body = _islandBodies[i];
+
+			_velocity[body] = glm::vec3{};
+			_awake[body] = 0;
+			_fellAsleep[body] = 1;
+		}
+	}
+}
+
+void PhysicsSystem::scatter()
+{
+	JobSystem::get().parallelFor(_islandBodies.size(), GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			uint32_t body = _islandBodies[i];
+
+			RigidBodyComponent* comp = em->getComponent<RigidBodyComponent>(_entities[body]);
+
+			comp->velocity = _velocity[body];
+			comp->awake = !_fellAsleep[body];
+
+			em->getComponent<TransformComponent>(_entities[body])->position = _position[body];
+		}
+	});
+}
@@ -0,0 +1,394 @@
+/**
+ * @file	PhysicsSystem.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Rigid body physics system
+ */
+
+#pragma once
+
+#include "System.h"
+#include "Subscriber.h"
+#include "EntityManager.h"
+#include "RigidBodyComponent.h"
+#include "CollisionContactsEvent.h"
+#include "EntityDestroyedEvent.h"
+#include "ComponentAssignedEvent.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @brief Statistics from the last physics step.
+ */
+struct PhysicsStats
+{
+	/**
+	 * @brief Number of bodies.
+	 */
+	uint32_t bodyCount{ 0 };
+
+	/**
+	 * @brief Number of bodies that were simulated.
+	 */
+	uint32_t awakeCount{ 0 };
+
+	/**
+	 * @brief Number of islands solved.
+	 */
+	uint32_t islandCount{ 0 };
+
+	/**
+	 * @brief Number of contact constraints solved.
+	 */
+	uint32_t constraintCount{ 0 };
+};
+
+/**
+ * @brief Moves the entities with a RigidBodyComponent.
+ *
+ * Bodies are kept in arrays per property. Every step integrates the
+ * velocities, solves the contacts posted by the broadphase with sequential
+ * impulses and integrates the positions (semi-implicit Euler).
+ *
+ * Bodies connected by contacts form islands that are solved on their own
+ * jobs. An island whose bodies have all been nearly still for SLEEP_DELAY
+ * seconds falls asleep, and sleeping bodies are skipped until something
+ * awake touches them.
+ */
+class PhysicsSystem : public System, public Subscriber<CollisionContactsEvent>, public Subscriber<ComponentAssignedEvent<RigidBodyComponent>>, public Subscriber<EntityDestroyedEvent>
+{
+public:
+	/**
+	 * @brief Constructor.
+	 */
+	PhysicsSystem() {}
+
+	/**
+	 * @brief Startup routine.
+	 */
+	void startUp() override;
+
+	/**
+	 * @brief Shutdown routine.
+	 */
+	void shutDown() override;
+
+	/**
+	 * @brief Steps the simulation.
+	 * @param dt Timestep.
+	 */
+	void update(float dt) override;
+
+	/**
+	 * @brief Contacts handler, keeps the contacts for the next step.
+	 * @param ev The recieved event to be handled.
+	 */
+	void handleEvent(const CollisionContactsEvent& ev) override;
+
+	/**
+	 * @brief RigidBodyComponent assignment handler.
+	 * @param ev The recieved event to be handled.
+	 */
+	void handleEvent(const ComponentAssignedEvent<RigidBodyComponent>& ev) override;
+
+	/**
+	 * @brief Destroyed entity handler.
+	 * @param ev The recieved event to be handled.
+	 */
+	void handleEvent(const EntityDestroyedEvent& ev) override;
+
+	/**
+	 * @brief Sets the gravity.
+	 * @param value Acceleration in units per second squared.
+	 */
+	void setGravity(glm::vec3 value) { _gravity = value; }
+
+	/**
+	 * @brief Gets the gravity.
+	 * @return Acceleration in units per second squared.
+	 */
+	glm::vec3 getGravity() const { return _gravity; }
+
+	/**
+	 * @brief Gets the statistics of the last step.
+	 * @return Statistics.
+	 */
+	const PhysicsStats& getStats() const { return _stats; }
+
+	/**
+	 * @brief Number of solver iterations per step.
+	 */
+	static constexpr uint32_t SOLVER_ITERATIONS{ 8 };
+
+	/**
+	 * @brief Speed below which a body counts as still.
+	 */
+	static constexpr float SLEEP_VELOCITY{ 0.05f };
+
+	/**
+	 * @brief Time all bodies in an island must be still before it falls asleep.
+	 */
+	static constexpr float SLEEP_DELAY{ 0.5f };
+
+	/**
+	 * @brief Fraction of the penetration corrected per second, times the step rate.
+	 */
+	static constexpr float BAUMGARTE{ 0.2f };
+
+	/**
+	 * @brief Penetration left alone, keeps resting contacts from jittering.
+	 */
+	static constexpr float PENETRATION_SLOP{ 0.01f };
+
+	/**
+	 * @brief Approach speed below which bodies do not bounce.
+	 */
+	static constexpr float RESTITUTION_THRESHOLD{ 1.f };
+
+private:
+	/**
+	 * @brief A contact between two bodies, or a body and a collider.
+	 */
+	struct Constraint
+	{
+		/**
+		 * @brief First body, NO_BODY for a collider.
+		 */
+		uint32_t a;
+
+		/**
+		 * @brief Second body, NO_BODY for a collider.
+		 */
+		uint32_t b;
+
+		/**
+		 * @brief Normal from a to b.
+		 */
+		glm::vec3 normal;
+
+		/**
+		 * @brief First friction direction.
+		 */
+		glm::vec3 tangent1;
+
+		/**
+		 * @brief Second friction direction.
+		 */
+		glm::vec3 tangent2;
+
+		/**
+		 * @brief Separation speed the contact aims for.
+		 */
+		float bias;
+
+		/**
+		 * @brief Friction coefficient.
+		 */
+		float friction;
+
+		/**
+		 * @brief One over the sum of the inverse masses.
+		 */
+		float effectiveMass;
+
+		/**
+		 * @brief Accumulated normal impulse.
+		 */
+		float normalImpulse;
+
+		/**
+		 * @brief Accumulated impulse along tangent1.
+		 */
+		float tangentImpulse1;
+
+		/**
+		 * @brief Accumulated impulse along tangent2.
+		 */
+		float tangentImpulse2;
+	};
+
+	/**
+	 * @brief Drops destroyed bodies and adds new ones.
+	 */
+	void updateBodies();
+
+	/**
+	 * @brief Reads the bodies from their components.
+	 */
+	void gather();
+
+	/**
+	 * @brief Turns the contacts into constraints and wakes bodies touched by awake ones.
+	 * @param dt Timestep.
+	 */
+	void buildConstraints(float dt);
+
+	/**
+	 * @brief Sorts the awake bodies and the constraints into islands.
+	 */
+	void buildIslands();
+
+	/**
+	 * @brief Solves the constraints of an island.
+	 * @param island Island index.
+	 */
+	void solveIsland(uint32_t island);
+
+	/**
+	 * @brief Puts islands that have been still long enough to sleep.
+	 * @param dt Timestep.
+	 */
+	void updateSleep(float dt);
+
+	/**
+	 * @brief Writes the bodies back to their components.
+	 */
+	void scatter();
+
+	/**
+	 * @brief Wakes a sleeping body.
+	 * @param body Body index.
+	 */
+	void wake(uint32_t body);
+
+	/**
+	 * @brief Finds the root of a body in the island forest.
+	 * @param body Body index.
+	 * @return Root body.
+	 */
+	uint32_t findRoot(uint32_t body);
+
+	/**
+	 * @brief Index for colliders without a body.
+	 */
+	static constexpr uint32_t NO_BODY{ 0xFFFFFFFF };
+
+	/**
+	 * @brief Number of bodies per job when reading and writing components.
+	 */
+	static constexpr size_t GRAIN_SIZE{ 256 };
+
+	/**
+	 * @brief Gravity.
+	 */
+	glm::vec3 _gravity{ 0.f, -9.82f, 0.f };
+
+	/**
+	 * @brief Statistics of the last step.
+	 */
+	PhysicsStats _stats{};
+
+	/**
+	 * @brief Entities that got a body since the last step.
+	 */
+	std::vector<EntityHandle> _pending{};
+
+	/**
+	 * @brief Entities destroyed since the last step.
+	 */
+	std::vector<EntityHandle> _entToRemove{};
+
+	/**
+	 * @brief Body index of every entity with a body.
+	 */
+	std::unordered_map<EntityHandle, uint32_t> _bodyIndex{};
+
+	/**
+	 * @brief Entity of every body.
+	 */
+	std::vector<EntityHandle> _entities{};
+
+	/**
+	 * @brief Position of every body.
+	 */
+	std::vector<glm::vec3> _position{};
+
+	/**
+	 * @brief Velocity of every body.
+	 */
+	std::vector<glm::vec3> _velocity{};
+
+	/**
+	 * @brief One over the mass of every body, 0 for bodies without mass.
+	 */
+	std::vector<float> _invMass{};
+
+	/**
+	 * @brief Restitution of every body.
+	 */
+	std::vector<float> _restitution{};
+
+	/**
+	 * @brief Friction of every body.
+	 */
+	std::vector<float> _friction{};
+
+	/**
+	 * @brief Damping of every body.
+	 */
+	std::vector<float> _damping{};
+
+	/**
+	 * @brief Whether gravity pulls every body.
+	 */
+	std::vector<uint8_t> _useGravity{};
+
+	/**
+	 * @brief Whether every body is awake.
+	 */
+	std::vector<uint8_t> _awake{};
+
+	/**
+	 * @brief Whether every body fell asleep this step and has to be written back once more.
+	 */
+	std::vector<uint8_t> _fellAsleep{};
+
+	/**
+	 * @brief Time every body has been still.
+	 */
+	std::vector<float> _stillTime{};
+
+	/**
+	 * @brief Parent of every body in the island forest.
+	 */
+	std::vector<uint32_t> _parent{};
+
+	/**
+	 * @brief Island of every body, NO_BODY if asleep.
+	 */
+	std::vector<uint32_t> _island{};
+
+	/**
+	 * @brief Contacts posted since the last step.
+	 */
+	std::vector<CollisionContact> _contacts{};
+
+	/**
+	 * @brief Constraints of the step.
+	 */
+	std::vector<Constraint> _constraints{};
+
+	/**
+	 * @brief Constraints sorted by island.
+	 */
+	std::vector<uint32_t> _islandConstraints{};
+
+	/**
+	 * @brief First constraint of every island in _islandConstraints, plus one past the end.
+	 */
+	std::vector<uint32_t> _constraintStart{};
+
+	/**
+	 * @brief Bodies sorted by island.
+	 */
+	std::vector<uint32_t> _islandBodies{};
+
+	/**
+	 * @brief First body of every island in _islandBodies, plus one past the end.
+	 */
+	std::vector<uint32_t> _bodyStart{};
+};
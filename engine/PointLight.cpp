@@ -7,6 +7,9 @@
 
 #include "PointLight.h"
 
+#include <cmath>
+#include <limits>
+
 PointLight::PointLight(
 	const glm::vec3& position,
 	const glm::vec3& ambient,
@@ -98,3 +101,26 @@ float PointLight::calculateAttenuation(float distance)
 {
 	return 1.f / (constant + linear*distance + quadratic*distance*distance);
 }
+
+float PointLight::calculateRange(float cutoff) const
+{
+	// Solve c + l*d + q*d^2 = 1/cutoff for the positive root
+	float target = 1.f / cutoff - constant;
+
+	if (target <= 0.f)
+	{
+		return 0.f;
+	}
+
+	if (quadratic > 0.f)
+	{
+		return (-linear + std::sqrt(linear*linear + 4.f*quadratic*target)) / (2.f*quadratic);
+	}
+
+	if (linear > 0.f)
+	{
+		return target / linear;
+	}
+
+	return std::numeric_limits<float>::infinity();
+}
@@ -133,6 +133,13 @@ public:
 	 * @return Attenuation factor
 	 */
 	float calculateAttenuation(float distance);
+
+	/**
+	 * @brief Calculate the distance where the attenuation falls to a cutoff.
+	 * @param cutoff Smallest attenuation factor that still lights anything.
+	 * @return Range, infinite if the light never falls off that far.
+	 */
+	float calculateRange(float cutoff) const;
 private:
 	
 	/**
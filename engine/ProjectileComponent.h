@@ -1,6 +1,6 @@
 /**
 * @file	ProjectileComponent.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-12
 * @brief	Projectile component
 */
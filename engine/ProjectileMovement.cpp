@@ -1,6 +1,6 @@
 /**
 * @file	ProjectileMovement.cpp
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-15
 * @brief	Projectile movement system
 */
@@ -27,7 +27,8 @@ void ProjectileMovement::handleEvent(const KeyEvent & ev)
 		CameraComponent* cameraComponent = em->getComponent<CameraComponent>(1);
 		em->assignComponent<TransformComponent>(newProjectile, glm::vec3{ cameraTransform->position });
 		em->assignComponent<ModelComponent>(newProjectile, "bunneh");
-		em->assignComponent<CollisionComponent>(newProjectile, 1.f);
+		em->assignComponent<CollisionComponent>(newProjectile, 1.f, false, LAYER_PROJECTILE);
+		em->getComponent<CollisionComponent>(newProjectile)->setFast(true);
 		em->assignComponent<ProjectileComponent>(newProjectile, 60, cameraComponent->camera.getFrontVector());
 		em->assignComponent<MaterialComponent>(newProjectile, glm::vec3{ 10.f,1.f,1.f }, glm::vec3{ 10.f,1.f,1.f }, glm::vec3{1.f,1.f,1.f}, 64);
 		em->assignComponent<PointLightComponent>(newProjectile,
@@ -41,29 +42,24 @@ void ProjectileMovement::handleEvent(const KeyEvent & ev)
 	}
 }
 
-void ProjectileMovement::handleEvent(const CollisionEvent & ev)
+void ProjectileMovement::handleEvent(const CollisionBeginEvent & ev)
 {
 	if(em->hasComponent<ProjectileComponent>(ev.entHandle1) || em->hasComponent<ProjectileComponent>(ev.entHandle2))
 	{
-		TransformComponent* trans1 = em->getComponent<TransformComponent>(ev.entHandle1);
-		TransformComponent* trans2 = em->getComponent<TransformComponent>(ev.entHandle2);
-		if (std::abs(trans1->position.y - trans2->position.y) < 2)
-		{
-			em->destroyEntity(ev.entHandle1);
-			em->destroyEntity(ev.entHandle2);
-		}
+		em->destroyEntity(ev.entHandle1);
+		em->destroyEntity(ev.entHandle2);
 	}
 }
 
 void ProjectileMovement::startUp()
 {
-	ev->addSubscriber<CollisionEvent>(this);
+	ev->addSubscriber<CollisionBeginEvent>(this);
 	ev->addSubscriber<KeyEvent>(this);
 }
 
 void ProjectileMovement::shutDown()
 {
-	ev->removeSubscriber<CollisionEvent>(this);
+	ev->removeSubscriber<CollisionBeginEvent>(this);
 	ev->removeSubscriber<KeyEvent>(this);
 }
 
@@ -1,6 +1,6 @@
 /**
 * @file	ProjectileMovement.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-15
 * @brief	Projectile movement system
 */
@@ -8,7 +8,7 @@
 #pragma once
 #include "System.h"
 #include "Subscriber.h"
-#include "CollisionEvent.h"
+#include "CollisionBeginEvent.h"
 #include "EntityManager.h"
 #include "KeyEvent.h"
 #include "CameraController.h"
@@ -18,7 +18,7 @@ class MouseEvent;
 /**
  * \brief Projectile movement system
  */
-class ProjectileMovement : public System, public Subscriber<KeyEvent>, public Subscriber<CollisionEvent>
+class ProjectileMovement : public System, public Subscriber<KeyEvent>, public Subscriber<CollisionBeginEvent>
 {
 	friend class CameraController;
 public:
@@ -37,7 +37,7 @@ public:
 	* @brief Collision Event Handler
 	* @param ev Collision Event
 	*/
-	void handleEvent(const CollisionEvent& ev) override;
+	void handleEvent(const CollisionBeginEvent& ev) override;
 
 	/**
 	* @brief Startup routine
@@ -1,16 +1,50 @@
 #include "Quadtree.h"
 #include "CollisionComponent.h"
 #include "QuadtreeComponent.h"
-#include "CollisionEvent.h"
+#include "JobSystem.h"
+
+#include <algorithm>
 
 #define NW 1;
 #define NE 2;
 #define SW 3;
 #define SE 4;
 
+constexpr size_t Quadtree::BULK_THRESHOLD;
+constexpr uint8_t Quadtree::PARALLEL_DEPTH;
+constexpr uint8_t Quadroot::MAX_BULK_DEPTH;
+
+namespace
+{
+	/**
+	 * \brief Quantizes a coordinate within the root to 10 bits
+	 * \param t Coordinate relative to the root, 0 to 1
+	 * \return Quantized coordinate
+	 */
+	uint32_t quantize(float t)
+	{
+		return static_cast<uint32_t>(std::min(std::max(t * 1024.f, 0.f), 1023.f));
+	}
+
+	/**
+	 * \brief Spreads the lower 10 bits of v to every other bit
+	 * \param v Value to spread
+	 * \return Spread value
+	 */
+	uint32_t spreadBits(uint32_t v)
+	{
+		v &= 0x000003FF;
+		v = (v | (v << 8)) & 0x00FF00FF;
+		v = (v | (v << 4)) & 0x0F0F0F0F;
+		v = (v | (v << 2)) & 0x33333333;
+		v = (v | (v << 1)) & 0x55555555;
+
+		return v;
+	}
+}
+
 Quadtree::Quadtree(EntityManager* entMan, EventManager* evMan, glm::vec2 pos, uint32_t width, uint32_t height) :
-	_enM{entMan},
-	_evM{evMan},
+	Broadphase(entMan, evMan),
 	_entToRemove{}
 {
 	_evM->addSubscriber<EntityDestroyedEvent>(this);
@@ -25,10 +59,24 @@ Quadtree::Quadtree(EntityManager* entMan, EventManager* evMan, glm::vec2 pos, ui
 
 Quadtree::~Quadtree()
 {
+	_evM->removeSubscriber<EntityDestroyedEvent>(this);
+	_evM->removeSubscriber<ComponentAssignedEvent<TransformComponent>>(this);
+
+	for (auto ent : _entToRemove)
+	{
+		_quadtree->delEnt(ent.second, ent.first);
+	}
+
+	// Leave the entities clean so that another tree can pick them up
+	for (auto ent : _quadtree->getAllEntities())
+	{
+		_enM->detachComponent<QuadtreeComponent>(ent);
+	}
+
 	delete _quadtree;
 }
 
-void Quadtree::update()
+void Quadtree::findPairs(std::vector<CollisionPair>& pairs)
 {
 	for (auto ent : _entToRemove)
 	{
@@ -36,24 +84,123 @@ void Quadtree::update()
 	}
 	_entToRemove.clear();
 
+	addPending();
+
 	_quadtree->update();
-	_quadtree->collisionCheck();
+	_quadtree->updateLayers();
+
+	for (auto ent : _quadtree->getAllEntities())
+	{
+		if (_enM->hasComponent<CollisionComponent>(ent) && _enM->getComponent<CollisionComponent>(ent)->isFast())
+		{
+			_fastEntities.push_back(ent);
+		}
+	}
+
+	// The tree is only read from here on, so the subtrees can be checked on their own jobs
+	_tasks.clear();
+	_quadtree->gatherCollisionTasks(_tasks, PARALLEL_DEPTH);
+
+	size_t taskCount = _tasks.size();
+
+	if (_taskPairs.size() < taskCount)
+	{
+		_taskPairs.resize(taskCount);
+	}
+
+	_taskStats.assign(taskCount, BroadphaseStats{});
+
+	JobSystem::get().parallelFor(taskCount, 1, [this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			_taskPairs[i].clear();
+
+			if (_tasks[i].subtree)
+			{
+				_tasks[i].quad->collisionCheck(_taskPairs[i], _taskStats[i]);
+			}
+			else
+			{
+				_tasks[i].quad->collisionCheckOwn(_taskPairs[i], _taskStats[i]);
+			}
+		}
+	});
+
+	// Merge in task order so the result does not depend on the scheduling
+	_stats.pairTests = 0;
+	_stats.groupsSkipped = 0;
+
+	for (size_t i = 0; i < taskCount; ++i)
+	{
+		pairs.insert(pairs.end(), _taskPairs[i].begin(), _taskPairs[i].end());
+		_stats.pairTests += _taskStats[i].pairTests;
+		_stats.groupsSkipped += _taskStats[i].groupsSkipped;
+	}
+
+	_stats.entityCount = _quadtree->getTotalEntCount();
+}
+
+void Quadtree::queryColliders(const AABB& box, const ColliderCallback& callback) const
+{
+	_quadtree->query(box, callback);
 }
 
 void Quadtree::pushEntity(EntityHandle ent)
 {
-	if(_enM->hasComponent<QuadtreeComponent>(ent))
+	if(_enM->hasComponent<QuadtreeComponent>(ent) || std::find(_entToAdd.begin(), _entToAdd.end(), ent) != _entToAdd.end())
 	{
 		throw Quadtree_error(std::string("Duplicate entity '").append(std::to_string(ent)).append("' in quadtree"));
 	}
 
-	_enM->assignComponent<QuadtreeComponent>(ent);
+	_entToAdd.push_back(ent);
+}
+
+void Quadtree::addPending()
+{
+	if (_entToAdd.empty())
+		return;
 
-	_quadtree->pushEnt(ent);
+	for (auto ent : _entToAdd)
+	{
+		_enM->assignComponent<QuadtreeComponent>(ent);
+	}
+
+	if (_entToAdd.size() >= _quadtree->getTotalEntCount())
+	{
+		// At least as many new as old, cheaper to start over than to split
+		// quads over and over
+		std::vector<EntityHandle> ents = _quadtree->getAllEntities();
+		ents.insert(ents.end(), _entToAdd.begin(), _entToAdd.end());
+
+		_quadtree->bulkBuild(ents);
+	}
+	else if (_entToAdd.size() > BULK_THRESHOLD)
+	{
+		// Only the new entities are sorted, the tree is kept
+		_quadtree->bulkAdd(_entToAdd);
+	}
+	else
+	{
+		for (auto ent : _entToAdd)
+		{
+			_quadtree->pushEnt(ent);
+		}
+	}
+
+	_entToAdd.clear();
 }
 
 void Quadtree::handleEvent(const EntityDestroyedEvent& ev)
 {
+	auto pending = std::find(_entToAdd.begin(), _entToAdd.end(), ev.entHandle);
+
+	if (pending != _entToAdd.end())
+	{
+		_entToAdd.erase(pending);
+		return;
+	}
+
 	if (_enM->hasComponent<QuadtreeComponent>(ev.entHandle))
 	{
 		_entToRemove.push_back(std::pair<EntityHandle, uint32_t>{ ev.entHandle, _enM->getComponent<QuadtreeComponent>(ev.entHandle)->getPosition() });
@@ -62,8 +209,8 @@ void Quadtree::handleEvent(const EntityDestroyedEvent& ev)
 
 void Quadtree::handleEvent(const ComponentAssignedEvent<TransformComponent>& ev)
 {
-	_enM->assignComponent<QuadtreeComponent>(ev.entHandle);
-	_quadtree->pushEnt(ev.entHandle);
+	// Inserted on the next update, in bulk if many arrive at once
+	_entToAdd.push_back(ev.entHandle);
 }
 
 Quadroot::Quadroot(EntityManager* entMan, EventManager* evMan, glm::vec2 nw, glm::vec2 ne, glm::vec2 sw, glm::vec2 se) :
@@ -100,8 +247,6 @@ Quadleaf::Quadleaf(EntityManager* entMan, EventManager* evMan, Quadroot* par, ui
 	
 	_treePosition = par->_treePosition + (4 + (quad % 4))*std::pow(8, _depth - 1);
 
-	std::cout << "New leaf with position: " << _treePosition << std::endl;
-
 	_width = par->_width / 2;
 	_height = par->_height / 2;
 
@@ -338,7 +483,7 @@ void Quadleaf::update()
 			}
 			else
 			{
-				// gr ingenting!
+				// gör ingenting!
 			}
 		}
 		else
@@ -362,54 +507,21 @@ void Quadleaf::update()
 	}
 }
 
-void Quadleaf::collisionCheck()
+void Quadleaf::collisionCheckOwn(std::vector<CollisionPair>& pairs, BroadphaseStats& stats)
 {
-	if (_sw != nullptr)
-	{
-		_nw->collisionCheck();
-		_ne->collisionCheck();
-		_sw->collisionCheck();
-		_se->collisionCheck();
-	}
+	Quadroot::collisionCheckOwn(pairs, stats);
 
-	for (auto i = _entities.begin(); i != _entities.end(); ++i)
+	for (auto& collider : _colliders)
 	{
-		if (!_enM->hasComponent<CollisionComponent>(*i))
-		{
-			continue;
-		}
-		for (auto j = i + 1; j != _entities.end(); ++j)
-		{
-			if (!_enM->hasComponent<CollisionComponent>(*j))
-			{
-				continue;
-			}
-
-			if (hasOverlap(*i, *j))
-			{
-				_evM->postEvent(CollisionEvent(*i, *j));
-			}
-		}
-		_parent->collideUp(*i);
+		_parent->collideUp(collider.second, static_cast<uint32_t>(collider.first >> 32), static_cast<uint32_t>(collider.first), pairs, stats);
 	}
 }
 
-void Quadleaf::collideUp(EntityHandle ent)
+void Quadleaf::collideUp(EntityHandle ent, uint32_t layer, uint32_t mask, std::vector<CollisionPair>& pairs, BroadphaseStats& stats)
 {
-	for (auto j = _entities.begin(); j != _entities.end(); ++j)
-	{
-		if (!_enM->hasComponent<CollisionComponent>(*j))
-		{
-			continue;
-		}
-
-		if (hasOverlap(ent, *j))
-		{
-			_evM->postEvent(CollisionEvent(ent, *j));
-		}
-	}
+	Quadroot::collideUp(ent, layer, mask, pairs, stats);
 
-	_parent->collideUp(ent);
+	_parent->collideUp(ent, layer, mask, pairs, stats);
 }
 
 void Quadleaf::moveUp(EntityHandle ent)
@@ -632,12 +744,12 @@ void Quadroot::update()
 			}
 			else
 			{
-				// gr ingenting!
+				// gör ingenting!
 			}
 		}
 		else
 		{
-			// Kan inte flytta upp den. r i roten. Lt vara.
+			// Kan inte flytta upp den. Är i roten. Låt vara.
 		}
 	}
 
@@ -671,7 +783,6 @@ void Quadroot::delEnt(uint32_t pos, EntityHandle ent)
 
 		throw Quadtree_error("Entity to be deleted not found in given quad position");
 	}
-	std::cout << "position to be deleted" << pos << std::endl;
 	if (_sw == nullptr) throw Quadtree_error("Position in delEnt says deeper but there are no more levels");
 
 	switch(pos & 0b11) // directions % 4, so se = 0, nw = 1, ne = 2, sw = 3
@@ -719,6 +830,143 @@ bool Quadroot::collapseCheck()
 	return false;
 }
 
+void Quadroot::bulkBuild(const std::vector<EntityHandle>& ents)
+{
+	delete _nw;
+	delete _ne;
+	delete _sw;
+	delete _se;
+	_nw = nullptr;
+	_ne = nullptr;
+	_sw = nullptr;
+	_se = nullptr;
+
+	_entities.clear();
+	_entCount = 0;
+
+	bulkAdd(ents);
+}
+
+void Quadroot::bulkAdd(const std::vector<EntityHandle>& ents)
+{
+	std::vector<BulkItem> items{};
+	items.reserve(ents.size());
+
+	for (auto ent : ents)
+	{
+		items.push_back(makeBulkItem(ent));
+	}
+
+	// Entities close in the tree end up close in memory
+	std::sort(items.begin(), items.end(), [](const BulkItem& a, const BulkItem& b)
+	{
+		return a.code < b.code || (a.code == b.code && a.ent < b.ent);
+	});
+
+	bulkPush(items);
+}
+
+Quadroot::BulkItem Quadroot::makeBulkItem(EntityHandle ent) const
+{
+	BulkItem item;
+
+	item.ent = ent;
+	item.position = _enM->getComponent<TransformComponent>(ent)->position;
+	item.reach = _enM->hasComponent<CollisionComponent>(ent) ? _enM->getComponent<CollisionComponent>(ent)->getReach() : -1.f;
+
+	uint32_t x = quantize((item.position.x - _nwCorn.x) / _width);
+	uint32_t z = quantize((item.position.z - _swCorn.y) / _height);
+
+	item.code = spreadBits(x) | (spreadBits(z) << 1);
+
+	return item;
+}
+
+void Quadroot::bulkPush(std::vector<BulkItem>& items)
+{
+	if (items.empty())
+		return;
+
+	if (_sw == nullptr)
+	{
+		// The entities already here are placed again together with the new
+		// ones, so the quad splits the same way pushEnt would split it
+		for (auto ent : _entities)
+		{
+			items.push_back(makeBulkItem(ent));
+		}
+
+		_entities.clear();
+		_entCount = 0;
+
+		bulkInsert(items);
+
+		return;
+	}
+
+	pushDown(items);
+}
+
+void Quadroot::bulkInsert(std::vector<BulkItem>& items)
+{
+	// Same limit as pushEnt, which splits when the eighth entity arrives
+	if (items.size() <= 7 || _depth >= MAX_BULK_DEPTH)
+	{
+		for (auto& item : items)
+		{
+			_entities.push_back(item.ent);
+			_enM->getComponent<QuadtreeComponent>(item.ent)->setPosition(_treePosition);
+		}
+
+		_entCount += static_cast<uint32_t>(items.size());
+
+		return;
+	}
+
+	split();
+
+	pushDown(items);
+}
+
+void Quadroot::pushDown(std::vector<BulkItem>& items)
+{
+	Quadleaf* leaves[4]{ _nw, _ne, _sw, _se };
+	std::vector<BulkItem> leafItems[4]{};
+
+	for (auto& item : items)
+	{
+		uint8_t quad = whichQuad(item.position);
+
+		if (leaves[quad - 1]->isInside(item))
+		{
+			leafItems[quad - 1].push_back(item);
+		}
+		else
+		{
+			// Straddles the leaves, stays here
+			_entities.push_back(item.ent);
+			_enM->getComponent<QuadtreeComponent>(item.ent)->setPosition(_treePosition);
+			_entCount += 1;
+		}
+	}
+
+	items.clear();
+	items.shrink_to_fit();
+
+	for (int i = 0; i < 4; ++i)
+	{
+		leaves[i]->bulkPush(leafItems[i]);
+	}
+}
+
+bool Quadroot::isInside(const BulkItem& item) const
+{
+	float reach = std::max(item.reach, 0.f);
+
+	return (item.position.x - reach) >= _nwCorn.x && (item.position.x + reach) <= _neCorn.x &&
+		(item.position.z - reach) >= _swCorn.y && (item.position.z + reach) <= _nwCorn.y;
+}
+
 std::vector<EntityHandle> Quadroot::getAllEntities()
 {
 	std::vector<EntityHandle> tmpVec = _entities;
@@ -740,64 +988,186 @@ std::vector<EntityHandle> Quadroot::getAllEntities()
 	}
 }
 
-void Quadroot::collisionCheck()
+void Quadroot::collisionCheck(std::vector<CollisionPair>& pairs, BroadphaseStats& stats)
 {
 	if (_sw != nullptr)
 	{
-		_nw->collisionCheck();
-		_ne->collisionCheck();
-		_sw->collisionCheck();
-		_se->collisionCheck();
+		_nw->collisionCheck(pairs, stats);
+		_ne->collisionCheck(pairs, stats);
+		_sw->collisionCheck(pairs, stats);
+		_se->collisionCheck(pairs, stats);
 	}
-	for (auto i = _entities.begin(); i != _entities.end(); ++i)
+
+	collisionCheckOwn(pairs, stats);
+}
+
+void Quadroot::updateLayers()
+{
+	_colliders.clear();
+	_groups.clear();
+	_layers = 0;
+	_masks = 0;
+
+	for (auto ent : _entities)
 	{
-		if(!_enM->hasComponent<CollisionComponent>(*i))
-		{
+		if (!_enM->hasComponent<CollisionComponent>(ent))
 			continue;
+
+		CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+
+		uint64_t key = (static_cast<uint64_t>(collider->getLayer()) << 32) | collider->getMask();
+
+		_colliders.push_back(std::make_pair(key, ent));
+		_layers |= collider->getLayer();
+		_masks |= collider->getMask();
+	}
+
+	std::sort(_colliders.begin(), _colliders.end());
+
+	for (uint32_t i = 0; i < _colliders.size(); ++i)
+	{
+		if (_groups.empty() || _colliders[_groups.back().begin].first != _colliders[i].first)
+		{
+			uint64_t key = _colliders[i].first;
+
+			_groups.push_back(LayerGroup{ static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key), i, i });
 		}
-		for (auto j = i + 1; j != _entities.end(); ++j)
+
+		_groups.back().end = i + 1;
+	}
+
+	if (_sw != nullptr)
+	{
+		_nw->updateLayers();
+		_ne->updateLayers();
+		_sw->updateLayers();
+		_se->updateLayers();
+	}
+}
+
+void Quadroot::collisionCheckOwn(std::vector<CollisionPair>& pairs, BroadphaseStats& stats)
+{
+	for (size_t a = 0; a < _groups.size(); ++a)
+	{
+		for (size_t b = a; b < _groups.size(); ++b)
 		{
-			if (!_enM->hasComponent<CollisionComponent>(*j))
+			const LayerGroup& first = _groups[a];
+			const LayerGroup& second = _groups[b];
+
+			if (!CollisionComponent::canCollide(first.layer, first.mask, second.layer, second.mask))
 			{
+				stats.groupsSkipped += 1;
 				continue;
 			}
 
-			if(hasOverlap(*i, *j))
+			for (uint32_t i = first.begin; i < first.end; ++i)
 			{
-				_evM->postEvent(CollisionEvent(*i, *j));
+				// Within a group, only colliders after this one
+				for (uint32_t j = a == b ? i + 1 : second.begin; j < second.end; ++j)
+				{
+					stats.pairTests += 1;
+					if (hasOverlap(_colliders[i].second, _colliders[j].second))
+					{
+						pairs.push_back(CollisionPair(_colliders[i].second, _colliders[j].second));
+					}
+				}
 			}
 		}
 	}
 }
 
-void Quadroot::collideUp(EntityHandle ent)
+void Quadroot::gatherCollisionTasks(std::vector<QuadCollisionTask>& tasks, uint8_t splitDepth)
+{
+	if (_sw == nullptr || _depth >= splitDepth)
+	{
+		tasks.push_back(QuadCollisionTask{ this, true });
+		return;
+	}
+
+	_nw->gatherCollisionTasks(tasks, splitDepth);
+	_ne->gatherCollisionTasks(tasks, splitDepth);
+	_sw->gatherCollisionTasks(tasks, splitDepth);
+	_se->gatherCollisionTasks(tasks, splitDepth);
+
+	tasks.push_back(QuadCollisionTask{ this, false });
+}
+
+void Quadroot::collideUp(EntityHandle ent, uint32_t layer, uint32_t mask, std::vector<CollisionPair>& pairs, BroadphaseStats& stats)
 {
-	for (auto j = _entities.begin(); j != _entities.end(); ++j)
+	// Nothing in the quad can collide with the entity, skip it in one test
+	if (!CollisionComponent::canCollide(layer, mask, _layers, _masks))
+	{
+		stats.groupsSkipped += 1;
+		return;
+	}
+
+	for (auto& group : _groups)
 	{
-		if (!_enM->hasComponent<CollisionComponent>(*j))
+		if (!CollisionComponent::canCollide(layer, mask, group.layer, group.mask))
 		{
+			stats.groupsSkipped += 1;
 			continue;
 		}
 
-		if (hasOverlap(ent, *j))
+		for (uint32_t j = group.begin; j < group.end; ++j)
 		{
-			_evM->postEvent(CollisionEvent(ent, *j));
+			stats.pairTests += 1;
+			if (hasOverlap(ent, _colliders[j].second))
+			{
+				pairs.push_back(CollisionPair(ent, _colliders[j].second));
+			}
 		}
 	}
 }
 
+bool Quadroot::query(const AABB& box, const ColliderCallback& callback) const
+{
+	for (auto ent : _entities)
+	{
+		if (!_enM->hasComponent<CollisionComponent>(ent))
+			continue;
+
+		CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+		glm::vec3 position = _enM->getComponent<TransformComponent>(ent)->position;
+
+		if (!callback(ent, AABB::fromCenter(position, collider->getExtent()), collider->getLayer()))
+			return false;
+	}
+
+	if (_sw == nullptr)
+		return true;
+
+	// Entities below the root stay within their quad
+	for (const Quadroot* leaf : { static_cast<const Quadroot*>(_nw), static_cast<const Quadroot*>(_ne), static_cast<const Quadroot*>(_sw), static_cast<const Quadroot*>(_se) })
+	{
+		if (leaf->overlapsQuad(box) && !leaf->query(box, callback))
+			return false;
+	}
+
+	return true;
+}
+
+bool Quadroot::overlapsQuad(const AABB& box) const
+{
+	return box.min.x <= _neCorn.x && box.max.x >= _nwCorn.x &&
+		box.min.z <= _nwCorn.y && box.max.z >= _swCorn.y;
+}
+
 bool Quadroot::hasOverlap(EntityHandle ent1, EntityHandle ent2) const
 {
 	glm::vec3 pos1 = _enM->getComponent<TransformComponent>(ent1)->position;
-	float reach1 = _enM->getComponent<CollisionComponent>(ent1)->getReach();
+	glm::vec3 ext1 = _enM->getComponent<CollisionComponent>(ent1)->getExtent();
 
 	glm::vec3 pos2 = _enM->getComponent<TransformComponent>(ent2)->position;
-	float reach2 = _enM->getComponent<CollisionComponent>(ent2)->getReach();
-
-	if (pos1.x - reach1 < pos2.x + reach2 &&
-		pos1.x + reach1 > pos2.x - reach2 &&
-		pos1.z - reach1 < pos2.z + reach2 &&
-		pos1.z + reach1 > pos2.z - reach2) 
+	glm::vec3 ext2 = _enM->getComponent<CollisionComponent>(ent2)->getExtent();
+
+	// The tree only sorts in XZ, but vertically separated entities do not collide
+	if (pos1.x - ext1.x < pos2.x + ext2.x &&
+		pos1.x + ext1.x > pos2.x - ext2.x &&
+		pos1.y - ext1.y < pos2.y + ext2.y &&
+		pos1.y + ext1.y > pos2.y - ext2.y &&
+		pos1.z - ext1.z < pos2.z + ext2.z &&
+		pos1.z + ext1.z > pos2.z - ext2.z) 
 	{
 		return true;
 	}
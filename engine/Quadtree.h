@@ -1,5 +1,6 @@
 #pragma once
 #include "EntityManager.h"
+#include "Broadphase.h"
 #include <vector>
 #include "TransformComponent.h"
 #include <stdexcept>
@@ -17,10 +18,30 @@ class Quadtree_error : public std::logic_error {
 class Quadroot;
 class Quadleaf;
 
+/**
+ * \brief A piece of the collision check that can run on its own job
+ */
+struct QuadCollisionTask
+{
+	/**
+	 * \brief The quad to check
+	 */
+	Quadroot* quad;
+
+	/**
+	 * \brief Whether to check the whole subtree or only the inhabitants of the quad
+	 */
+	bool subtree;
+};
+
 /**
  * \brief Outwards visible Quadtree class, calling the actual structure
+ * 
+ * The colliders of every quad are grouped by layer and mask each update, so
+ * the collision check skips a whole group, or a whole quad, that can not
+ * collide with a collider in one test.
  */
-class Quadtree : public Subscriber<EntityDestroyedEvent>, public Subscriber<ComponentAssignedEvent<TransformComponent>>
+class Quadtree : public Broadphase, public Subscriber<EntityDestroyedEvent>, public Subscriber<ComponentAssignedEvent<TransformComponent>>
 {
 public:
 	/**
@@ -30,18 +51,29 @@ public:
 	 * \param height Height (y-height) of quadtree
 	 */
 	Quadtree(EntityManager* entMan, EventManager* evMan, glm::vec2 position, uint32_t width, uint32_t height);
+
+	/**
+	 * \brief Destructor. Detaches the QuadtreeComponents of all entities in the tree
+	 */
 	~Quadtree();
 
 	/**
-	 * \brief Updates all placements of all entities in the tree 
+	 * \brief Updates all placements of all entities in the tree and collects the colliding pairs
+	 * \param pairs Vector to append the colliding pairs to
 	 */
-	void update();
+	void findPairs(std::vector<CollisionPair>& pairs) override;
 
 	/**
 	 * \brief Pushes an entity into the tree, placing it correctly
 	 * \param ent Handle to entity
 	 */
-	void pushEntity(EntityHandle ent);
+	void pushEntity(EntityHandle ent) override;
+
+	/**
+	 * \brief Gets the name of the broadphase
+	 * \return "Quadtree"
+	 */
+	const char* getName() const override { return "Quadtree"; }
 
 
 	/**
@@ -62,34 +94,69 @@ public:
 	 * \brief Entitycounter
 	 * \return The number of entities in the current quad
 	 */
-	uint16_t getEntCount();
+	uint32_t getEntCount();
 
 	/**
 	 * \brief Entitycounter
 	 * \return The number of total entities in and below the current quad
 	 */
-	uint16_t getTotalEntCount();
+	uint32_t getTotalEntCount();
+
+	/**
+	 * \brief Number of entities arriving between two updates above which they
+	 * are sorted and pushed down the tree in bulk instead of one by one. The
+	 * whole tree is only rebuilt when at least as many arrive as it holds.
+	 */
+	static constexpr size_t BULK_THRESHOLD{ 64 };
+
+	/**
+	 * \brief Depth below which every subtree is checked for collisions as one job
+	 */
+	static constexpr uint8_t PARALLEL_DEPTH{ 3 };
+
+protected:
+	/**
+	 * \brief Calls callback with the colliders in the quads overlapping box
+	 * \param box The box
+	 * \param callback Callback
+	 */
+	void queryColliders(const AABB& box, const ColliderCallback& callback) const override;
 
 private:
+	/**
+	 * \brief Inserts the entities that have arrived since the last update
+	 */
+	void addPending();
+
 	/**
 	 * \brief Vector holding the pending entities to be removed
 	 */
 	std::vector<std::pair<EntityHandle, uint32_t>> _entToRemove{};
 
+	/**
+	 * \brief Vector holding the pending entities to be added
+	 */
+	std::vector<EntityHandle> _entToAdd{};
+
 	/**
 	 * \brief The actual quadtree pointer
 	 */
 	Quadroot* _quadtree;
 
 	/**
-	 * \brief Pointer to the scenes' entityManager
+	 * \brief Collision tasks of the current update, in the order of a sequential check
 	 */
-	EntityManager* _enM;
+	std::vector<QuadCollisionTask> _tasks{};
 
 	/**
-	 * \brief Pointer to the scenes' eventManager
+	 * \brief Pair buffers of every task, merged in task order once all are done
 	 */
-	EventManager* _evM;
+	std::vector<std::vector<CollisionPair>> _taskPairs{};
+
+	/**
+	 * \brief Statistics of every task
+	 */
+	std::vector<BroadphaseStats> _taskStats{};
 };
 
 class Quadroot
@@ -143,16 +210,73 @@ public:
 	 */
 	std::vector<EntityHandle> getAllEntities();
 
+	/**
+	 * \brief Throws away the current tree and builds it again from ents in one pass
+	 * 
+	 * The entities are sorted by the Morton code of their position and then
+	 * distributed top down, so every quad is split at most once and no
+	 * entity is ever pushed twice. The quads are fixed halves of their
+	 * parent rather than boxes fitted to their content, so packing leaves
+	 * bottom up would give the same quads as splitting the sorted entities
+	 * by their Morton code prefix top down.
+	 * 
+	 * \param ents Handles to all entities to be in the tree
+	 */
+	void bulkBuild(const std::vector<EntityHandle>& ents);
+
+	/**
+	 * \brief Sorts ents by Morton code and pushes them down the current tree in one pass
+	 * 
+	 * Only the quads the entities end up in are touched, the entities
+	 * already there are placed again with the new ones.
+	 * 
+	 * \param ents Handles to the entities to add
+	 */
+	void bulkAdd(const std::vector<EntityHandle>& ents);
+
+	/**
+	 * \brief Groups the colliders of current quad and the quads below by layer and mask
+	 * 
+	 * Must be called after update and before the collision check, which
+	 * skips whole groups that can not collide instead of testing every pair.
+	 */
+	void updateLayers();
+
 	/**
 	 * \brief Checks collision of all inhabitants of current quad and calls collisionCheck for any leaves
+	 * \param pairs Vector to append the colliding pairs to
+	 * \param stats Statistics to count the overlap tests in
 	 */
-	virtual void collisionCheck();
+	void collisionCheck(std::vector<CollisionPair>& pairs, BroadphaseStats& stats);
+
+	/**
+	 * \brief Checks collision of the inhabitants of current quad only, against each other and the quads above
+	 * \param pairs Vector to append the colliding pairs to
+	 * \param stats Statistics to count the overlap tests in
+	 */
+	virtual void collisionCheckOwn(std::vector<CollisionPair>& pairs, BroadphaseStats& stats);
+
+	/**
+	 * \brief Splits the collision check of current quad into tasks that only read the tree
+	 * 
+	 * Quads above splitDepth get a task for their own inhabitants, after the
+	 * tasks of their leaves, so running the tasks one by one gives the same
+	 * pairs in the same order as collisionCheck.
+	 * 
+	 * \param tasks Vector to append the tasks to
+	 * \param splitDepth Depth at which a whole subtree becomes one task
+	 */
+	void gatherCollisionTasks(std::vector<QuadCollisionTask>& tasks, uint8_t splitDepth);
 
 	/**
 	 * \brief Help function of collisionCheck which compares collision with a lower entity and ones of higher levels
-	 * \param ent 
+	 * \param ent Handle to entity
+	 * \param layer Collision layers of the entity
+	 * \param mask Collision mask of the entity
+	 * \param pairs Vector to append the colliding pairs to
+	 * \param stats Statistics to count the overlap tests in
 	 */
-	virtual void collideUp(EntityHandle ent);
+	virtual void collideUp(EntityHandle ent, uint32_t layer, uint32_t mask, std::vector<CollisionPair>& pairs, BroadphaseStats& stats);
 
 	/**
 	 * \brief Determines whether ent1 and ent2 has any overlap (collision)
@@ -162,6 +286,21 @@ public:
 	 */
 	bool hasOverlap(EntityHandle ent1, EntityHandle ent2) const;
 
+	/**
+	 * \brief Calls callback with the colliders in and below current quad that may overlap box
+	 * \param box The box
+	 * \param callback Callback
+	 * \return False if the callback stopped the query
+	 */
+	bool query(const AABB& box, const ColliderCallback& callback) const;
+
+	/**
+	 * \brief Checks if the quad overlaps box, seen from above
+	 * \param box The box
+	 * \return True if they overlap
+	 */
+	bool overlapsQuad(const AABB& box) const;
+
 	/**
 	 * \brief Coordinates of northwest corner
 	 */
@@ -206,14 +345,104 @@ public:
 	* \brief Entitycounter
 	* \return The number of entities in the current quad
 	*/
-	uint16_t getEntCount();
+	uint32_t getEntCount();
 
 	/**
 	* \brief Entitycounter
 	* \return The total number of entities in and below the current quad
 	*/
-	uint16_t getTotalEntCount();
+	uint32_t getTotalEntCount();
 protected:
+	/**
+	 * \brief A run of colliders in the quad sharing layers and mask
+	 */
+	struct LayerGroup
+	{
+		/**
+		 * \brief Collision layers of the colliders
+		 */
+		uint32_t layer;
+
+		/**
+		 * \brief Collision mask of the colliders
+		 */
+		uint32_t mask;
+
+		/**
+		 * \brief Index into _colliders of the first collider
+		 */
+		uint32_t begin;
+
+		/**
+		 * \brief Index into _colliders past the last collider
+		 */
+		uint32_t end;
+	};
+
+	/**
+	 * \brief An entity on its way into the tree during a bulk build
+	 */
+	struct BulkItem
+	{
+		/**
+		 * \brief Morton code of the position within the quad the item was
+		 * made in, only used for sorting
+		 */
+		uint32_t code;
+
+		/**
+		 * \brief Handle to entity
+		 */
+		EntityHandle ent;
+
+		/**
+		 * \brief Position of entity
+		 */
+		glm::vec3 position;
+
+		/**
+		 * \brief Reach of the collider, negative if the entity has none
+		 */
+		float reach;
+	};
+
+	/**
+	 * \brief Places the items in the quad and builds the leaves below it
+	 * \param items Items sorted by Morton code
+	 */
+	void bulkInsert(std::vector<BulkItem>& items);
+
+	/**
+	 * \brief Adds the items to a quad that may already hold entities and leaves
+	 * \param items Items sorted by Morton code
+	 */
+	void bulkPush(std::vector<BulkItem>& items);
+
+	/**
+	 * \brief Hands the items to the leaves they fit in and keeps the rest in the current quad
+	 * \param items Items sorted by Morton code
+	 */
+	void pushDown(std::vector<BulkItem>& items);
+
+	/**
+	 * \brief Collects what a bulk build needs to know about an entity
+	 * \param ent Handle to entity
+	 * \return The item, with its Morton code within the current quad
+	 */
+	BulkItem makeBulkItem(EntityHandle ent) const;
+
+	/**
+	 * \brief isInside for an entity in a bulk build
+	 * \param item The item
+	 * \return True if it is within the quad, else false
+	 */
+	bool isInside(const BulkItem& item) const;
+
+	/**
+	 * \brief Max depth of a bulk built tree, the tree position has room for 10 levels
+	 */
+	static constexpr uint8_t MAX_BULK_DEPTH{ 10 };
+
 	/**
 	 * \brief Checks which leaf the given position is within
 	 * \param position coordinates of the point
@@ -251,7 +480,27 @@ protected:
 	/**
 	 * \brief The number of entities in the quad
 	 */
-	uint8_t _entCount{ 0 };
+	uint32_t _entCount{ 0 };
+
+	/**
+	 * \brief Entities in the quad that have a collider, keyed by layers in the upper and mask in the lower half, sorted by key
+	 */
+	std::vector<std::pair<uint64_t, EntityHandle>> _colliders{};
+
+	/**
+	 * \brief Runs of colliders in _colliders sharing layers and mask
+	 */
+	std::vector<LayerGroup> _groups{};
+
+	/**
+	 * \brief All layers of the colliders in the quad
+	 */
+	uint32_t _layers{ 0 };
+
+	/**
+	 * \brief All masks of the colliders in the quad
+	 */
+	uint32_t _masks{ 0 };
 
 	/**
 	 * \brief Pointer to northwest leaf (child)
@@ -311,15 +560,21 @@ public:
 
 
 	/**
-	 * \brief Called by parent and does collision check, calls the childrens collisionCheck
+	 * \brief Does collision check of the inhabitants, also against the higher levels of the tree
+	 * \param pairs Vector to append the colliding pairs to
+	 * \param stats Statistics to count the overlap tests in
 	 */
-	void collisionCheck() override;
+	void collisionCheckOwn(std::vector<CollisionPair>& pairs, BroadphaseStats& stats) override;
 
 	/**
 	 * \brief Does collision detection for an entity and the higher leves of the tree
 	 * \param ent Handle to entity
+	 * \param layer Collision layers of the entity
+	 * \param mask Collision mask of the entity
+	 * \param pairs Vector to append the colliding pairs to
+	 * \param stats Statistics to count the overlap tests in
 	 */
-	void collideUp(EntityHandle ent) override;
+	void collideUp(EntityHandle ent, uint32_t layer, uint32_t mask, std::vector<CollisionPair>& pairs, BroadphaseStats& stats) override;
 
 private:
 	/**
@@ -334,11 +589,11 @@ private:
 	Quadroot* _parent{ nullptr };
 };
 
-inline uint16_t Quadroot::getEntCount()
+inline uint32_t Quadroot::getEntCount()
 {
 	return _entCount;
 }
-inline uint16_t Quadroot::getTotalEntCount()
+inline uint32_t Quadroot::getTotalEntCount()
 {
 	if(_sw != nullptr)
 	{
@@ -347,11 +602,11 @@ inline uint16_t Quadroot::getTotalEntCount()
 
 	return _entCount;
 }
-inline uint16_t Quadtree::getEntCount()
+inline uint32_t Quadtree::getEntCount()
 {
 	return _quadtree->getEntCount();
 }
-inline uint16_t Quadtree::getTotalEntCount()
+inline uint32_t Quadtree::getTotalEntCount()
 {
 	return _quadtree->getTotalEntCount();
 }
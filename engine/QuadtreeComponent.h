@@ -1,6 +1,6 @@
 /**
 * @file	QuadtreeComponent.h
-* @Author	Kevin Kjelln
+* @Author	Kevin Kjellén
 * @date	    2017-05-12
 * @brief	Quadtree component
 */
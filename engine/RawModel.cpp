@@ -8,6 +8,61 @@
 #include "RawModel.h"
 
 #include "loadobj.h"
+#include "GraphicsDevice.h"
+#include "MeshSimplifier.h"
+
+constexpr GLuint RawModel::INSTANCE_MODEL_LOCATION;
+constexpr uint32_t RawModel::MAX_LODS;
+constexpr uint32_t RawModel::MIN_LOD_TRIANGLES;
+constexpr float RawModel::MAX_LOD_RATIO;
+
+namespace
+{
+	/**
+	 * @brief Simplifies a model into levels of detail.
+	 * @param m Loaded model data.
+	 * @param lods Level 0 already added, filled with the other levels.
+	 * @param indices Indices of level 0, followed by the other levels.
+	 */
+	void buildLods(const Model* m, std::vector<MeshLod>& lods, std::vector<GLuint>& indices)
+	{
+		MeshSimplifier simplifier{
+			m->vertexArray,
+			m->normalArray,
+			m->texCoordArray,
+			static_cast<size_t>(m->numVertices),
+			m->indexArray,
+			static_cast<size_t>(m->numIndices) };
+
+		std::vector<GLuint> levelIndices;
+
+		// Every level continues simplifying from the one before
+		while (lods.size() < RawModel::MAX_LODS)
+		{
+			size_t previous = static_cast<size_t>(lods.back().indexCount);
+			size_t target = previous / 6 * 3;
+
+			if (target < RawModel::MIN_LOD_TRIANGLES * 3)
+			{
+				break;
+			}
+
+			simplifier.simplify(target);
+
+			// Nothing more can be removed without breaking the surface
+			if (simplifier.getIndexCount() > previous * RawModel::MAX_LOD_RATIO)
+			{
+				break;
+			}
+
+			simplifier.getIndices(levelIndices);
+
+			lods.push_back(MeshLod{ static_cast<GLuint>(indices.size()), static_cast<GLsizei>(levelIndices.size()) });
+
+			indices.insert(indices.end(), levelIndices.begin(), levelIndices.end());
+		}
+	}
+}
 
 RawModel::RawModel(const char* fileName)
 {
@@ -29,20 +84,67 @@ RawModel::RawModel(const char* fileName)
 		textureCoordinates.setupVertexAttribPointer(2, 2);
 	}
 
-	indexBuffer.storeData(m->numIndices * sizeof(GLuint), m->indexArray, GL_STATIC_DRAW);
+	// All levels of detail share the vertices and one index buffer
+	std::vector<GLuint> indices{ m->indexArray, m->indexArray + m->numIndices };
+
+	lods.push_back(MeshLod{ 0, static_cast<GLsizei>(m->numIndices) });
+
+	buildLods(m, lods, indices);
+
+	indexBuffer.storeData(static_cast<GLuint>(indices.size() * sizeof(GLuint)), indices.data(), GL_STATIC_DRAW);
 
 	vao.unbind();
 
+	// Bounds for culling, the model data is gone after this
+	bounds = AABB::fromPoints(m->vertexArray, m->numVertices);
+
+	glm::vec3 center = bounds.getCenter();
+
+	for (int i = 0; i < m->numVertices; ++i)
+	{
+		glm::vec3 position{ m->vertexArray[i * 3 + 0], m->vertexArray[i * 3 + 1], m->vertexArray[i * 3 + 2] };
+
+		boundsRadius = glm::max(boundsRadius, glm::length(position - center));
+	}
+
 	DisposeModel(m);
 }
 
-void RawModel::draw()
+void RawModel::draw(uint32_t lod)
 {
+	const MeshLod& level = getLod(lod);
+
+	// Left bound, so the next draw of the same model binds nothing
 	vao.bind();
 	indexBuffer.bind();
-	glDrawElements(GL_TRIANGLES, indexBuffer.getSize() / sizeof(GLuint), GL_UNSIGNED_INT, 0L);
-	indexBuffer.unbind();
-	vao.unbind();
+	GraphicsDevice::get().drawElements(GL_TRIANGLES, level.firstIndex, level.indexCount);
+}
+
+void RawModel::drawInstanced(VertexBufferObject& instances, GLuint first, GLsizei count, uint32_t lod)
+{
+	const MeshLod& level = getLod(lod);
+
+	vao.bind();
+
+	// A matrix attribute takes one location per column
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		vao.setupInstanceAttribPointer(
+			instances,
+			INSTANCE_MODEL_LOCATION + column,
+			4,
+			sizeof(glm::mat4),
+			first * sizeof(glm::mat4) + column * sizeof(glm::vec4));
+	}
+
+	indexBuffer.bind();
+	GraphicsDevice::get().drawElementsInstanced(GL_TRIANGLES, level.firstIndex, level.indexCount, count);
+
+	// Plain draws must not read from the instance buffer
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		vao.disableAttribArray(INSTANCE_MODEL_LOCATION + column);
+	}
 }
 
 RawModel::~RawModel()
@@ -17,9 +17,34 @@
 #include "VertexArrayObject.h"
 #include "VertexBufferObject.h"
 #include "ShaderProgram.h"
+#include "AABB.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Range of the index buffer drawing one level of detail.
+ */
+struct MeshLod
+{
+	/**
+	 * @brief First index of the level.
+	 */
+	GLuint firstIndex;
+
+	/**
+	 * @brief Number of indices.
+	 */
+	GLsizei indexCount;
+};
 
 /**
  * @brief Raw Model base class
+ *
+ * Simplified levels of detail are built when the model is loaded. Every
+ * level is a range of the same index buffer over the same vertices, level 0
+ * being the full model and every following level about half of the one
+ * before.
  */
 class RawModel
 {
@@ -32,8 +57,71 @@ public:
 
 	/**
 	 * @brief Draws the model to the current context.
+	 * @param lod Level of detail, clamped to the levels of the model.
+	 */
+	virtual void draw(uint32_t lod = 0);
+
+	/**
+	 * @brief Draws several instances of the model with one draw call.
+	 * @param instances Buffer with one model matrix per instance.
+	 * @param first Index of the first model matrix in the buffer.
+	 * @param count Number of instances.
+	 * @param lod Level of detail, clamped to the levels of the model.
+	 */
+	void drawInstanced(VertexBufferObject& instances, GLuint first, GLsizei count, uint32_t lod);
+
+	/**
+	 * @brief Gets the number of levels of detail.
+	 * @return Number of levels, at least 1.
+	 */
+	uint32_t getLodCount() const { return static_cast<uint32_t>(lods.size()); }
+
+	/**
+	 * @brief Gets the number of triangles of a level of detail.
+	 * @param lod Level of detail, clamped to the levels of the model.
+	 * @return Number of triangles.
+	 */
+	uint32_t getTriangleCount(uint32_t lod) const { return static_cast<uint32_t>(getLod(lod).indexCount / 3); }
+
+	/**
+	 * @brief Most levels of detail built for a model.
+	 */
+	static constexpr uint32_t MAX_LODS{ 4 };
+
+	/**
+	 * @brief Fewest triangles a simplified level is built with.
+	 */
+	static constexpr uint32_t MIN_LOD_TRIANGLES{ 64 };
+
+	/**
+	 * @brief A level is only kept if it has at most this part of the
+	 * triangles of the level before.
+	 */
+	static constexpr float MAX_LOD_RATIO{ 0.75f };
+
+	/**
+	 * @brief First of the four attribute locations holding the model matrix
+	 * of an instance.
+	 */
+	static constexpr GLuint INSTANCE_MODEL_LOCATION{ 3 };
+
+	/**
+	 * @brief Gets the box around the vertices in model space.
+	 * @return Bounding box.
+	 */
+	const AABB& getBounds() const { return bounds; }
+
+	/**
+	 * @brief Gets the center of the bounding sphere in model space.
+	 * @return Center.
+	 */
+	glm::vec3 getBoundsCenter() const { return bounds.getCenter(); }
+
+	/**
+	 * @brief Gets the radius of the bounding sphere in model space.
+	 * @return Radius.
 	 */
-	virtual void draw();
+	float getBoundsRadius() const { return boundsRadius; }
 
 	/**
 	 * @brief Destructor.
@@ -41,6 +129,13 @@ public:
 	virtual ~RawModel();
 protected:
 
+	/**
+	 * @brief Gets a level of detail.
+	 * @param lod Level of detail, clamped to the levels of the model.
+	 * @return The level.
+	 */
+	const MeshLod& getLod(uint32_t lod) const { return lods[lod < lods.size() ? lod : lods.size() - 1]; }
+
 	/**
 	 * @brief Model VAO
 	 */
@@ -62,7 +157,22 @@ protected:
 	VertexBufferObject textureCoordinates{ GL_ARRAY_BUFFER };
 
 	/**
-	 * @brief IndexBuffer VBO
+	 * @brief IndexBuffer VBO, holding every level of detail.
 	 */
 	VertexBufferObject indexBuffer{ GL_ELEMENT_ARRAY_BUFFER };
+
+	/**
+	 * @brief Levels of detail, from the full model.
+	 */
+	std::vector<MeshLod> lods{};
+
+	/**
+	 * @brief Box around the vertices in model space.
+	 */
+	AABB bounds{};
+
+	/**
+	 * @brief Radius of the sphere around the vertices, centered on the box.
+	 */
+	float boundsRadius{ 0.f };
 };
\ No newline at end of file
@@ -0,0 +1,1323 @@
+/**
+ * @file	RecordingDevice.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Graphics device recording the commands into a stream
+ */
+
+#include "RecordingDevice.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	/**
+	 * @brief How a command is written in a dump.
+	 */
+	struct CommandFormat
+	{
+		/**
+		 * @brief Name of the command.
+		 */
+		const char* name;
+
+		/**
+		 * @brief Index of the first argument that is a float, arguments
+		 * before it are integers.
+		 */
+		uint32_t firstFloat;
+	};
+
+	/**
+	 * @brief Commands with no float arguments.
+	 */
+	constexpr uint32_t NO_FLOATS = 0xFFFFFFFFu;
+
+	/**
+	 * @brief Format of every command, in the order of RecordedCommand.
+	 */
+	const CommandFormat commandFormats[] = {
+		{ "UseProgram", NO_FLOATS },
+		{ "BindVertexArray", NO_FLOATS },
+		{ "BindBuffer", NO_FLOATS },
+		{ "BindBufferRange", NO_FLOATS },
+		{ "BindFramebuffer", NO_FLOATS },
+		{ "ActiveTexture", NO_FLOATS },
+		{ "BindTexture", NO_FLOATS },
+		{ "SetEnabled", NO_FLOATS },
+		{ "CullFace", NO_FLOATS },
+		{ "DepthFunc", NO_FLOATS },
+		{ "BlendFunc", NO_FLOATS },
+		{ "PolygonMode", NO_FLOATS },
+		{ "Viewport", NO_FLOATS },
+		{ "CreateBuffer", NO_FLOATS },
+		{ "DeleteBuffer", NO_FLOATS },
+		{ "CreateVertexArray", NO_FLOATS },
+		{ "DeleteVertexArray", NO_FLOATS },
+		{ "BufferData", NO_FLOATS },
+		{ "BufferSubData", NO_FLOATS },
+		{ "BufferStorage", NO_FLOATS },
+		{ "MapBufferRange", NO_FLOATS },
+		{ "UnmapBuffer", NO_FLOATS },
+		{ "VertexAttribPointer", NO_FLOATS },
+		{ "VertexAttribDivisor", NO_FLOATS },
+		{ "SetAttribArrayEnabled", NO_FLOATS },
+		{ "CreateShader", NO_FLOATS },
+		{ "CompileShader", NO_FLOATS },
+		{ "DeleteShader", NO_FLOATS },
+		{ "CreateProgram", NO_FLOATS },
+		{ "AttachShader", NO_FLOATS },
+		{ "BindAttribLocation", NO_FLOATS },
+		{ "LinkProgram", NO_FLOATS },
+		{ "DeleteProgram", NO_FLOATS },
+		{ "BindUniformBlock", NO_FLOATS },
+		{ "CreateTexture", NO_FLOATS },
+		{ "DeleteTexture", NO_FLOATS },
+		{ "TexImage2D", NO_FLOATS },
+		{ "TexParameter", NO_FLOATS },
+		{ "TexBorderColor", 1 },
+		{ "GenerateMipmap", NO_FLOATS },
+		{ "TexBuffer", NO_FLOATS },
+		{ "PixelStore", NO_FLOATS },
+		{ "CreateFramebuffer", NO_FLOATS },
+		{ "DeleteFramebuffer", NO_FLOATS },
+		{ "FramebufferTexture", NO_FLOATS },
+		{ "DrawBuffers", NO_FLOATS },
+		{ "Uniform1f", 1 },
+		{ "Uniform1i", NO_FLOATS },
+		{ "Uniform2f", 1 },
+		{ "Uniform3f", 1 },
+		{ "Uniform4f", 1 },
+		{ "UniformMatrix4f", 1 },
+		{ "Clear", NO_FLOATS },
+		{ "DrawArrays", NO_FLOATS },
+		{ "DrawElements", NO_FLOATS },
+		{ "DrawElementsInstanced", NO_FLOATS },
+		{ "Fence", NO_FLOATS },
+		{ "WaitFence", NO_FLOATS }
+	};
+
+	static_assert(
+		sizeof(commandFormats) / sizeof(commandFormats[0]) == static_cast<size_t>(RecordedCommand::Count),
+		"Every command needs a format");
+
+	/**
+	 * @brief Integer constants of GLSL source, by name.
+	 */
+	typedef std::unordered_map<std::string, GLint> Constants;
+
+	/**
+	 * @brief A variable declared in GLSL source.
+	 */
+	struct Declaration
+	{
+		/**
+		 * @brief Name of the type.
+		 */
+		std::string type;
+
+		/**
+		 * @brief Name of the variable.
+		 */
+		std::string name;
+
+		/**
+		 * @brief Number of elements, 0 if not an array.
+		 */
+		GLint size;
+	};
+
+	/**
+	 * @brief Members of the structs of GLSL source, by name of the struct.
+	 */
+	typedef std::unordered_map<std::string, std::vector<Declaration>> Structs;
+
+	/**
+	 * @brief Splits GLSL source into words and single characters, leaving
+	 * out comments and preprocessor lines. Integer defines are collected.
+	 * @param source The source.
+	 * @param tokens Filled with the words and characters.
+	 * @param constants The defines are added to this.
+	 */
+	void tokenize(const std::string& source, std::vector<std::string>& tokens, Constants& constants)
+	{
+		size_t i = 0;
+
+		while (i < source.size())
+		{
+			char c = source[i];
+			char next = i + 1 < source.size() ? source[i + 1] : '\0';
+
+			if (c == '/' && next == '/')
+			{
+				i = source.find('\n', i);
+			}
+			else if (c == '/' && next == '*')
+			{
+				i = source.find("*/", i + 2);
+				i = i == std::string::npos ? i : i + 2;
+			}
+			else if (c == '#')
+			{
+				size_t end = source.find('\n', i);
+
+				std::istringstream line{ source.substr(i + 1, end == std::string::npos ? end : end - i - 1) };
+
+				std::string directive;
+				std::string name;
+				GLint value;
+
+				if (line >> directive >> name >> value && directive == "define")
+				{
+					constants[name] = value;
+				}
+
+				i = end;
+			}
+			else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+			{
+				size_t start = i;
+
+				while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+				{
+					++i;
+				}
+
+				tokens.push_back(source.substr(start, i - start));
+			}
+			else
+			{
+				if (!std::isspace(static_cast<unsigned char>(c)))
+				{
+					tokens.push_back(std::string(1, c));
+				}
+
+				++i;
+			}
+		}
+	}
+
+	/**
+	 * @brief Checks if a token is an integer literal.
+	 * @param token The token.
+	 * @return True if it is only digits.
+	 */
+	bool isInteger(const std::string& token)
+	{
+		return !token.empty() && std::all_of(token.begin(), token.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+	}
+
+	/**
+	 * @brief Skips precision qualifiers.
+	 * @param tokens The tokens.
+	 * @param i Index of the first token to check.
+	 * @return Index of the first token that is not a qualifier.
+	 */
+	size_t skipPrecision(const std::vector<std::string>& tokens, size_t i)
+	{
+		while (i < tokens.size() && (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp"))
+		{
+			++i;
+		}
+
+		return i;
+	}
+
+	/**
+	 * @brief Reads the variables of a declaration, like "a, b[4];".
+	 * @param tokens The tokens.
+	 * @param i Index of the first name.
+	 * @param type Type of the variables.
+	 * @param constants Constants array sizes may be given by.
+	 * @param declarations The variables are added to this.
+	 * @return Index after the semicolon.
+	 */
+	size_t readDeclaration(const std::vector<std::string>& tokens, size_t i, const std::string& type, const Constants& constants, std::vector<Declaration>& declarations)
+	{
+		while (i < tokens.size() && tokens[i] != ";")
+		{
+			if (tokens[i] == ",")
+			{
+				++i;
+				continue;
+			}
+
+			Declaration declaration{ type, tokens[i++], 0 };
+
+			if (i + 2 < tokens.size() && tokens[i] == "[" && tokens[i + 2] == "]")
+			{
+				const std::string& size = tokens[i + 1];
+
+				auto it = constants.find(size);
+
+				// Sizes that are not understood count as a single element
+				declaration.size = isInteger(size) ? std::stoi(size) : it != constants.end() ? it->second : 1;
+
+				i += 3;
+			}
+
+			declarations.push_back(declaration);
+		}
+
+		return i + 1;
+	}
+
+	/**
+	 * @brief Adds a uniform as reported by OpenGL. Arrays of plain types are
+	 * one uniform, structs are one uniform per member and element.
+	 * @param declaration The uniform.
+	 * @param structs Structs of the source.
+	 * @param uniforms The uniforms are added to this.
+	 */
+	void addUniform(const Declaration& declaration, const Structs& structs, std::vector<ActiveUniform>& uniforms)
+	{
+		auto it = structs.find(declaration.type);
+
+		if (it == structs.end())
+		{
+			if (declaration.size > 0)
+			{
+				uniforms.push_back(ActiveUniform{ declaration.name + "[0]", declaration.size });
+			}
+			else
+			{
+				uniforms.push_back(ActiveUniform{ declaration.name, 1 });
+			}
+
+			return;
+		}
+
+		for (GLint element = 0; element < std::max(declaration.size, 1); ++element)
+		{
+			std::string prefix = declaration.name;
+
+			if (declaration.size > 0)
+			{
+				prefix += "[" + std::to_string(element) + "]";
+			}
+
+			for (const Declaration& member : it->second)
+			{
+				addUniform(Declaration{ member.type, prefix + "." + member.name, member.size }, structs, uniforms);
+			}
+		}
+	}
+
+	/**
+	 * @brief Finds the uniforms declared in GLSL source, outside of uniform
+	 * blocks.
+	 *
+	 * Knows plain and struct uniforms, and arrays sized by a literal, a
+	 * define or an int constant. Anything else is skipped.
+	 *
+	 * @param source The source.
+	 * @param uniforms The uniforms are added to this.
+	 */
+	void findUniforms(const std::string& source, std::vector<ActiveUniform>& uniforms)
+	{
+		std::vector<std::string> tokens;
+		Constants constants;
+		Structs structs;
+
+		tokenize(source, tokens, constants);
+
+		size_t i = 0;
+
+		while (i < tokens.size())
+		{
+			if (tokens[i] == "struct" && i + 2 < tokens.size() && tokens[i + 2] == "{")
+			{
+				std::vector<Declaration>& members = structs[tokens[i + 1]];
+
+				i += 3;
+
+				while (i < tokens.size() && tokens[i] != "}")
+				{
+					i = skipPrecision(tokens, i);
+
+					if (i < tokens.size())
+					{
+						i = readDeclaration(tokens, i + 1, tokens[i], constants, members);
+					}
+				}
+
+				++i;
+			}
+			else if (tokens[i] == "const" && i + 4 < tokens.size() && tokens[i + 1] == "int" && tokens[i + 3] == "=")
+			{
+				if (isInteger(tokens[i + 4]))
+				{
+					constants[tokens[i + 2]] = std::stoi(tokens[i + 4]);
+				}
+
+				i += 5;
+			}
+			else if (tokens[i] == "uniform")
+			{
+				size_t type = skipPrecision(tokens, i + 1);
+
+				if (type + 1 >= tokens.size())
+				{
+					break;
+				}
+
+				// The members of a block are read from a buffer
+				if (tokens[type + 1] == "{")
+				{
+					i = std::find(tokens.begin() + type, tokens.end(), "}") - tokens.begin() + 1;
+					continue;
+				}
+
+				std::vector<Declaration> declarations;
+
+				i = readDeclaration(tokens, type + 1, tokens[type], constants, declarations);
+
+				for (const Declaration& declaration : declarations)
+				{
+					addUniform(declaration, structs, uniforms);
+				}
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	/**
+	 * @brief Gets the size of a pixel in memory.
+	 * @param format Format of the data.
+	 * @param type Type of the data.
+	 * @return Size in bytes.
+	 */
+	GLsizeiptr pixelSize(GLenum format, GLenum type)
+	{
+		GLsizeiptr components = 1;
+
+		switch (format)
+		{
+		case GL_RG:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+			components = 3;
+			break;
+		case GL_RGBA:
+		case GL_BGRA:
+			components = 4;
+			break;
+		}
+
+		switch (type)
+		{
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+			return components * 4;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return components * 2;
+		default:
+			return components;
+		}
+	}
+}
+
+RecordingDevice::RecordingDevice(GraphicsDevice* next)
+	: _next{ next }
+{
+
+}
+
+void RecordingDevice::reset()
+{
+	_stream.clear();
+	_stats = RecordingStats{};
+}
+
+void RecordingDevice::dump(const std::string& fileName) const
+{
+	std::ofstream file(fileName);
+
+	if (!file)
+	{
+		throw RecordingDevice_error(std::string("Could not open ").append(fileName));
+	}
+
+	file << "commands " << _stats.commands << "\n";
+	file << "draws " << _stats.draws << "\n";
+	file << "instances " << _stats.instances << "\n";
+	file << "binds " << _stats.binds << "\n";
+	file << "state changes " << _stats.stateChanges << "\n";
+	file << "uniform uploads " << _stats.uniformUploads << "\n";
+	file << "bytes uploaded " << _stats.bytesUploaded << "\n";
+	file << "resources created " << _stats.resourcesCreated << "\n";
+
+	size_t i = 0;
+
+	while (i < _stream.size())
+	{
+		uint32_t header = _stream[i++];
+
+		const CommandFormat& format = commandFormats[header & 0xFF];
+
+		uint32_t count = header >> 8;
+
+		file << format.name;
+
+		for (uint32_t argument = 0; argument < count; ++argument)
+		{
+			uint32_t word = _stream[i++];
+
+			if (argument >= format.firstFloat)
+			{
+				float value;
+
+				std::memcpy(&value, &word, sizeof(value));
+
+				file << " " << value;
+			}
+			else
+			{
+				file << " " << word;
+			}
+		}
+
+		file << "\n";
+	}
+
+	if (!file)
+	{
+		throw RecordingDevice_error(std::string("Could not write ").append(fileName));
+	}
+}
+
+const char* RecordingDevice::getName(RecordedCommand command)
+{
+	return commandFormats[static_cast<size_t>(command)].name;
+}
+
+void RecordingDevice::useProgram(GLuint program)
+{
+	record(RecordedCommand::UseProgram, { program });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->useProgram(program);
+	}
+}
+
+void RecordingDevice::bindVertexArray(GLuint vao)
+{
+	record(RecordedCommand::BindVertexArray, { vao });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->bindVertexArray(vao);
+	}
+}
+
+void RecordingDevice::bindBuffer(GLenum target, GLuint buffer)
+{
+	record(RecordedCommand::BindBuffer, { target, buffer });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->bindBuffer(target, buffer);
+	}
+}
+
+void RecordingDevice::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	record(RecordedCommand::BindBufferRange, { target, index, buffer, static_cast<uint32_t>(offset), static_cast<uint32_t>(size) });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->bindBufferRange(target, index, buffer, offset, size);
+	}
+}
+
+void RecordingDevice::bindFramebuffer(GLuint framebuffer)
+{
+	record(RecordedCommand::BindFramebuffer, { framebuffer });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->bindFramebuffer(framebuffer);
+	}
+}
+
+void RecordingDevice::activeTexture(GLuint unit)
+{
+	record(RecordedCommand::ActiveTexture, { unit });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->activeTexture(unit);
+	}
+}
+
+void RecordingDevice::bindTexture(GLenum target, GLuint texture)
+{
+	record(RecordedCommand::BindTexture, { target, texture });
+	++_stats.binds;
+
+	if (_next)
+	{
+		_next->bindTexture(target, texture);
+	}
+}
+
+void RecordingDevice::setEnabled(GLenum capability, bool enabled)
+{
+	record(RecordedCommand::SetEnabled, { capability, enabled ? 1u : 0u });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->setEnabled(capability, enabled);
+	}
+}
+
+void RecordingDevice::cullFace(GLenum mode)
+{
+	record(RecordedCommand::CullFace, { mode });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->cullFace(mode);
+	}
+}
+
+void RecordingDevice::depthFunc(GLenum func)
+{
+	record(RecordedCommand::DepthFunc, { func });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->depthFunc(func);
+	}
+}
+
+void RecordingDevice::blendFunc(GLenum source, GLenum destination)
+{
+	record(RecordedCommand::BlendFunc, { source, destination });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->blendFunc(source, destination);
+	}
+}
+
+void RecordingDevice::polygonMode(GLenum mode)
+{
+	record(RecordedCommand::PolygonMode, { mode });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->polygonMode(mode);
+	}
+}
+
+void RecordingDevice::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	record(RecordedCommand::Viewport, {
+		static_cast<uint32_t>(x),
+		static_cast<uint32_t>(y),
+		static_cast<uint32_t>(width),
+		static_cast<uint32_t>(height) });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->viewport(x, y, width, height);
+	}
+}
+
+GLuint RecordingDevice::createBuffer()
+{
+	GLuint buffer = _next ? _next->createBuffer() : _nextName++;
+
+	record(RecordedCommand::CreateBuffer, { buffer });
+	++_stats.resourcesCreated;
+
+	return buffer;
+}
+
+void RecordingDevice::deleteBuffer(GLuint buffer)
+{
+	record(RecordedCommand::DeleteBuffer, { buffer });
+
+	if (_next)
+	{
+		_next->deleteBuffer(buffer);
+	}
+}
+
+GLuint RecordingDevice::createVertexArray()
+{
+	GLuint vao = _next ? _next->createVertexArray() : _nextName++;
+
+	record(RecordedCommand::CreateVertexArray, { vao });
+	++_stats.resourcesCreated;
+
+	return vao;
+}
+
+void RecordingDevice::deleteVertexArray(GLuint vao)
+{
+	record(RecordedCommand::DeleteVertexArray, { vao });
+
+	if (_next)
+	{
+		_next->deleteVertexArray(vao);
+	}
+}
+
+void RecordingDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	record(RecordedCommand::BufferData, { target, static_cast<uint32_t>(size), usage });
+
+	// Allocating without data uploads nothing
+	if (data)
+	{
+		_stats.bytesUploaded += size;
+	}
+
+	if (_next)
+	{
+		_next->bufferData(target, size, data, usage);
+	}
+}
+
+void RecordingDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	record(RecordedCommand::BufferSubData, { target, static_cast<uint32_t>(offset), static_cast<uint32_t>(size) });
+
+	_stats.bytesUploaded += size;
+
+	if (_next)
+	{
+		_next->bufferSubData(target, offset, size, data);
+	}
+}
+
+bool RecordingDevice::hasBufferStorage() const
+{
+	return _next ? _next->hasBufferStorage() : false;
+}
+
+void RecordingDevice::bufferStorage(GLenum target, GLsizeiptr size, GLbitfield flags)
+{
+	record(RecordedCommand::BufferStorage, { target, static_cast<uint32_t>(size), flags });
+
+	if (_next)
+	{
+		_next->bufferStorage(target, size, flags);
+	}
+}
+
+void* RecordingDevice::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr size, GLbitfield access)
+{
+	record(RecordedCommand::MapBufferRange, { target, static_cast<uint32_t>(offset), static_cast<uint32_t>(size), access });
+
+	_mappedSize = (access & GL_MAP_WRITE_BIT) ? size : 0;
+
+	if (_next)
+	{
+		return _next->mapBufferRange(target, offset, size, access);
+	}
+
+	_mapped.resize(static_cast<size_t>(size));
+
+	return _mapped.data();
+}
+
+void RecordingDevice::unmapBuffer(GLenum target)
+{
+	record(RecordedCommand::UnmapBuffer, { target });
+
+	_stats.bytesUploaded += _mappedSize;
+	_mappedSize = 0;
+
+	if (_next)
+	{
+		_next->unmapBuffer(target);
+	}
+}
+
+void RecordingDevice::vertexAttribPointer(GLuint location, GLint size, GLsizei stride, GLsizeiptr offset)
+{
+	record(RecordedCommand::VertexAttribPointer, {
+		location,
+		static_cast<uint32_t>(size),
+		static_cast<uint32_t>(stride),
+		static_cast<uint32_t>(offset) });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->vertexAttribPointer(location, size, stride, offset);
+	}
+}
+
+void RecordingDevice::vertexAttribDivisor(GLuint location, GLuint divisor)
+{
+	record(RecordedCommand::VertexAttribDivisor, { location, divisor });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->vertexAttribDivisor(location, divisor);
+	}
+}
+
+void RecordingDevice::setAttribArrayEnabled(GLuint location, bool enabled)
+{
+	record(RecordedCommand::SetAttribArrayEnabled, { location, enabled ? 1u : 0u });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->setAttribArrayEnabled(location, enabled);
+	}
+}
+
+GLuint RecordingDevice::createShader(GLenum type)
+{
+	GLuint shader = _next ? _next->createShader(type) : _nextName++;
+
+	record(RecordedCommand::CreateShader, { type, shader });
+	++_stats.resourcesCreated;
+
+	return shader;
+}
+
+bool RecordingDevice::compileShader(GLuint shader, const std::string& source, std::string& log)
+{
+	record(RecordedCommand::CompileShader, { shader, static_cast<uint32_t>(source.size()) });
+
+	if (_next)
+	{
+		return _next->compileShader(shader, source, log);
+	}
+
+	_shaderSources[shader] = source;
+
+	return true;
+}
+
+void RecordingDevice::deleteShader(GLuint shader)
+{
+	record(RecordedCommand::DeleteShader, { shader });
+
+	if (_next)
+	{
+		_next->deleteShader(shader);
+	}
+
+	_shaderSources.erase(shader);
+}
+
+GLuint RecordingDevice::createProgram()
+{
+	GLuint program = _next ? _next->createProgram() : _nextName++;
+
+	record(RecordedCommand::CreateProgram, { program });
+	++_stats.resourcesCreated;
+
+	return program;
+}
+
+void RecordingDevice::attachShader(GLuint program, GLuint shader)
+{
+	record(RecordedCommand::AttachShader, { program, shader });
+
+	if (_next)
+	{
+		_next->attachShader(program, shader);
+		return;
+	}
+
+	_programShaders[program].push_back(shader);
+}
+
+void RecordingDevice::bindAttribLocation(GLuint program, GLuint location, const char* name)
+{
+	record(RecordedCommand::BindAttribLocation, { program, location });
+
+	if (_next)
+	{
+		_next->bindAttribLocation(program, location, name);
+	}
+}
+
+bool RecordingDevice::linkProgram(GLuint program, std::string& log)
+{
+	record(RecordedCommand::LinkProgram, { program });
+
+	if (_next)
+	{
+		return _next->linkProgram(program, log);
+	}
+
+	std::vector<ActiveUniform>& uniforms = _programUniforms[program];
+	std::unordered_map<std::string, GLint>& locations = _uniformLocations[program];
+
+	uniforms.clear();
+	locations.clear();
+
+	GLint nextLocation = 0;
+
+	std::vector<ActiveUniform> declared;
+
+	for (GLuint shader : _programShaders[program])
+	{
+		auto source = _shaderSources.find(shader);
+
+		if (source == _shaderSources.end())
+		{
+			continue;
+		}
+
+		declared.clear();
+
+		findUniforms(source->second, declared);
+
+		for (const ActiveUniform& uniform : declared)
+		{
+			// Shared by several stages
+			if (locations.count(uniform.name))
+			{
+				continue;
+			}
+
+			uniforms.push_back(uniform);
+
+			size_t bracket = uniform.name.rfind("[0]");
+
+			if (bracket != std::string::npos && bracket + 3 == uniform.name.size())
+			{
+				std::string base = uniform.name.substr(0, bracket);
+
+				locations[base] = nextLocation;
+
+				for (GLint element = 0; element < uniform.size; ++element)
+				{
+					locations[base + "[" + std::to_string(element) + "]"] = nextLocation++;
+				}
+			}
+			else
+			{
+				locations[uniform.name] = nextLocation++;
+			}
+		}
+	}
+
+	return true;
+}
+
+void RecordingDevice::deleteProgram(GLuint program)
+{
+	record(RecordedCommand::DeleteProgram, { program });
+
+	if (_next)
+	{
+		_next->deleteProgram(program);
+	}
+
+	_programShaders.erase(program);
+	_programUniforms.erase(program);
+	_uniformLocations.erase(program);
+}
+
+void RecordingDevice::getActiveUniforms(GLuint program, std::vector<ActiveUniform>& uniforms)
+{
+	if (_next)
+	{
+		_next->getActiveUniforms(program, uniforms);
+		return;
+	}
+
+	auto it = _programUniforms.find(program);
+
+	if (it == _programUniforms.end())
+	{
+		uniforms.clear();
+		return;
+	}
+
+	uniforms = it->second;
+}
+
+GLint RecordingDevice::getUniformLocation(GLuint program, const char* name)
+{
+	if (_next)
+	{
+		return _next->getUniformLocation(program, name);
+	}
+
+	auto it = _uniformLocations.find(program);
+
+	if (it == _uniformLocations.end())
+	{
+		return -1;
+	}
+
+	auto location = it->second.find(name);
+
+	return location == it->second.end() ? -1 : location->second;
+}
+
+void RecordingDevice::bindUniformBlock(GLuint program, const char* name, GLuint binding)
+{
+	record(RecordedCommand::BindUniformBlock, { program, binding });
+
+	if (_next)
+	{
+		_next->bindUniformBlock(program, name, binding);
+	}
+}
+
+GLuint RecordingDevice::createTexture()
+{
+	GLuint texture = _next ? _next->createTexture() : _nextName++;
+
+	record(RecordedCommand::CreateTexture, { texture });
+	++_stats.resourcesCreated;
+
+	return texture;
+}
+
+void RecordingDevice::deleteTexture(GLuint texture)
+{
+	record(RecordedCommand::DeleteTexture, { texture });
+
+	if (_next)
+	{
+		_next->deleteTexture(texture);
+	}
+}
+
+void RecordingDevice::texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data)
+{
+	record(RecordedCommand::TexImage2D, {
+		target,
+		static_cast<uint32_t>(internalFormat),
+		static_cast<uint32_t>(width),
+		static_cast<uint32_t>(height),
+		format,
+		type });
+
+	// Allocating without data uploads nothing
+	if (data)
+	{
+		_stats.bytesUploaded += static_cast<uint64_t>(width) * height * pixelSize(format, type);
+	}
+
+	if (_next)
+	{
+		_next->texImage2D(target, internalFormat, width, height, format, type, data);
+	}
+}
+
+void RecordingDevice::texParameter(GLenum target, GLenum name, GLint value)
+{
+	record(RecordedCommand::TexParameter, { target, name, static_cast<uint32_t>(value) });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->texParameter(target, name, value);
+	}
+}
+
+void RecordingDevice::texBorderColor(GLenum target, glm::vec4 color)
+{
+	record(RecordedCommand::TexBorderColor, { target, bits(color.r), bits(color.g), bits(color.b), bits(color.a) });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->texBorderColor(target, color);
+	}
+}
+
+void RecordingDevice::generateMipmap(GLenum target)
+{
+	record(RecordedCommand::GenerateMipmap, { target });
+
+	if (_next)
+	{
+		_next->generateMipmap(target);
+	}
+}
+
+void RecordingDevice::texBuffer(GLenum internalFormat, GLuint buffer)
+{
+	record(RecordedCommand::TexBuffer, { internalFormat, buffer });
+
+	if (_next)
+	{
+		_next->texBuffer(internalFormat, buffer);
+	}
+}
+
+void RecordingDevice::pixelStore(GLenum name, GLint value)
+{
+	record(RecordedCommand::PixelStore, { name, static_cast<uint32_t>(value) });
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->pixelStore(name, value);
+	}
+}
+
+GLuint RecordingDevice::createFramebuffer()
+{
+	GLuint framebuffer = _next ? _next->createFramebuffer() : _nextName++;
+
+	record(RecordedCommand::CreateFramebuffer, { framebuffer });
+	++_stats.resourcesCreated;
+
+	return framebuffer;
+}
+
+void RecordingDevice::deleteFramebuffer(GLuint framebuffer)
+{
+	record(RecordedCommand::DeleteFramebuffer, { framebuffer });
+
+	if (_next)
+	{
+		_next->deleteFramebuffer(framebuffer);
+	}
+}
+
+void RecordingDevice::framebufferTexture(GLenum attachment, GLenum target, GLuint texture)
+{
+	record(RecordedCommand::FramebufferTexture, { attachment, target, texture });
+
+	if (_next)
+	{
+		_next->framebufferTexture(attachment, target, texture);
+	}
+}
+
+void RecordingDevice::drawBuffers(GLsizei count, const GLenum* buffers)
+{
+	_stream.push_back(static_cast<uint32_t>(RecordedCommand::DrawBuffers) | (static_cast<uint32_t>(count) << 8));
+	_stream.insert(_stream.end(), buffers, buffers + count);
+
+	++_stats.commands;
+	++_stats.stateChanges;
+
+	if (_next)
+	{
+		_next->drawBuffers(count, buffers);
+	}
+}
+
+bool RecordingDevice::isFramebufferComplete()
+{
+	return _next ? _next->isFramebufferComplete() : true;
+}
+
+void RecordingDevice::uniform(GLint location, float value)
+{
+	recordUniform(RecordedCommand::Uniform1f, location, &value, 1);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::uniform(GLint location, int value)
+{
+	record(RecordedCommand::Uniform1i, { static_cast<uint32_t>(location), static_cast<uint32_t>(value) });
+
+	++_stats.uniformUploads;
+	_stats.bytesUploaded += sizeof(value);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::uniform(GLint location, glm::vec2 value)
+{
+	recordUniform(RecordedCommand::Uniform2f, location, glm::value_ptr(value), 2);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::uniform(GLint location, glm::vec3 value)
+{
+	recordUniform(RecordedCommand::Uniform3f, location, glm::value_ptr(value), 3);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::uniform(GLint location, glm::vec4 value)
+{
+	recordUniform(RecordedCommand::Uniform4f, location, glm::value_ptr(value), 4);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::uniform(GLint location, const glm::mat4& value)
+{
+	recordUniform(RecordedCommand::UniformMatrix4f, location, glm::value_ptr(value), 16);
+
+	if (_next)
+	{
+		_next->uniform(location, value);
+	}
+}
+
+void RecordingDevice::clear(GLbitfield mask)
+{
+	record(RecordedCommand::Clear, { mask });
+
+	if (_next)
+	{
+		_next->clear(mask);
+	}
+}
+
+void RecordingDevice::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	record(RecordedCommand::DrawArrays, { mode, static_cast<uint32_t>(first), static_cast<uint32_t>(count) });
+
+	++_stats.draws;
+	++_stats.instances;
+
+	if (_next)
+	{
+		_next->drawArrays(mode, first, count);
+	}
+}
+
+void RecordingDevice::drawElements(GLenum mode, GLuint first, GLsizei count)
+{
+	record(RecordedCommand::DrawElements, { mode, first, static_cast<uint32_t>(count) });
+
+	++_stats.draws;
+	++_stats.instances;
+
+	if (_next)
+	{
+		_next->drawElements(mode, first, count);
+	}
+}
+
+void RecordingDevice::drawElementsInstanced(GLenum mode, GLuint first, GLsizei count, GLsizei instances)
+{
+	record(RecordedCommand::DrawElementsInstanced, { mode, first, static_cast<uint32_t>(count), static_cast<uint32_t>(instances) });
+
+	++_stats.draws;
+	_stats.instances += instances;
+
+	if (_next)
+	{
+		_next->drawElementsInstanced(mode, first, count, instances);
+	}
+}
+
+GLsync RecordingDevice::fence()
+{
+	record(RecordedCommand::Fence, {});
+
+	return _next ? _next->fence() : nullptr;
+}
+
+void RecordingDevice::waitFence(GLsync fence)
+{
+	record(RecordedCommand::WaitFence, {});
+
+	if (_next)
+	{
+		_next->waitFence(fence);
+	}
+}
+
+GLint RecordingDevice::getInteger(GLenum name)
+{
+	if (_next)
+	{
+		return _next->getInteger(name);
+	}
+
+	switch (name)
+	{
+	case GL_MAX_TEXTURE_IMAGE_UNITS:
+		return 16;
+	case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+		return 256;
+	case GL_MAX_UNIFORM_BLOCK_SIZE:
+		return 16384;
+	default:
+		return 0;
+	}
+}
+
+void RecordingDevice::record(RecordedCommand command, std::initializer_list<uint32_t> arguments)
+{
+	_stream.push_back(static_cast<uint32_t>(command) | (static_cast<uint32_t>(arguments.size()) << 8));
+	_stream.insert(_stream.end(), arguments.begin(), arguments.end());
+
+	++_stats.commands;
+}
+
+void RecordingDevice::recordUniform(RecordedCommand command, GLint location, const float* values, uint32_t count)
+{
+	_stream.push_back(static_cast<uint32_t>(command) | ((count + 1) << 8));
+	_stream.push_back(static_cast<uint32_t>(location));
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		_stream.push_back(bits(values[i]));
+	}
+
+	++_stats.commands;
+	++_stats.uniformUploads;
+	_stats.bytesUploaded += count * sizeof(float);
+}
+
+uint32_t RecordingDevice::bits(float value)
+{
+	uint32_t result;
+
+	std::memcpy(&result, &value, sizeof(result));
+
+	return result;
+}
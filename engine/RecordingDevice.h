@@ -0,0 +1,594 @@
+/**
+ * @file	RecordingDevice.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Graphics device recording the commands into a stream
+ */
+
+#pragma once
+
+#include "GraphicsDevice.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief RecordingDevice error class
+ */
+class RecordingDevice_error : public std::logic_error {
+	using std::logic_error::logic_error;
+};
+
+/**
+ * @brief Command in the stream of a RecordingDevice.
+ */
+enum class RecordedCommand : uint8_t
+{
+	UseProgram,
+	BindVertexArray,
+	BindBuffer,
+	BindBufferRange,
+	BindFramebuffer,
+	ActiveTexture,
+	BindTexture,
+	SetEnabled,
+	CullFace,
+	DepthFunc,
+	BlendFunc,
+	PolygonMode,
+	Viewport,
+	CreateBuffer,
+	DeleteBuffer,
+	CreateVertexArray,
+	DeleteVertexArray,
+	BufferData,
+	BufferSubData,
+	BufferStorage,
+	MapBufferRange,
+	UnmapBuffer,
+	VertexAttribPointer,
+	VertexAttribDivisor,
+	SetAttribArrayEnabled,
+	CreateShader,
+	CompileShader,
+	DeleteShader,
+	CreateProgram,
+	AttachShader,
+	BindAttribLocation,
+	LinkProgram,
+	DeleteProgram,
+	BindUniformBlock,
+	CreateTexture,
+	DeleteTexture,
+	TexImage2D,
+	TexParameter,
+	TexBorderColor,
+	GenerateMipmap,
+	TexBuffer,
+	PixelStore,
+	CreateFramebuffer,
+	DeleteFramebuffer,
+	FramebufferTexture,
+	DrawBuffers,
+	Uniform1f,
+	Uniform1i,
+	Uniform2f,
+	Uniform3f,
+	Uniform4f,
+	UniformMatrix4f,
+	Clear,
+	DrawArrays,
+	DrawElements,
+	DrawElementsInstanced,
+	Fence,
+	WaitFence,
+	Count
+};
+
+/**
+ * @brief Counters of the commands recorded since the last reset.
+ */
+struct RecordingStats
+{
+	/**
+	 * @brief Number of commands.
+	 */
+	uint32_t commands{ 0 };
+
+	/**
+	 * @brief Number of draw calls.
+	 */
+	uint32_t draws{ 0 };
+
+	/**
+	 * @brief Number of instances drawn, one per plain draw.
+	 */
+	uint32_t instances{ 0 };
+
+	/**
+	 * @brief Number of program, vertex array, buffer, framebuffer and
+	 * texture binds.
+	 */
+	uint32_t binds{ 0 };
+
+	/**
+	 * @brief Number of other state changes.
+	 */
+	uint32_t stateChanges{ 0 };
+
+	/**
+	 * @brief Number of uniforms set.
+	 */
+	uint32_t uniformUploads{ 0 };
+
+	/**
+	 * @brief Bytes sent in uniforms, buffer data, texture data and mapped
+	 * ranges.
+	 */
+	uint64_t bytesUploaded{ 0 };
+
+	/**
+	 * @brief Number of buffers, vertex arrays, shaders, programs, textures
+	 * and framebuffers created.
+	 */
+	uint32_t resourcesCreated{ 0 };
+};
+
+/**
+ * @brief Records every command with its arguments, and optionally passes
+ * it on to another device.
+ *
+ * Every command is one word holding the command and the number of
+ * arguments, followed by the arguments as one word each. Floats are stored
+ * by their bits. Data sent with buffer and texture uploads and the source of
+ * shaders are not recorded, only their size.
+ * A mapped range counts as uploaded in full when it is unmapped, writes to
+ * a persistently mapped buffer are not seen.
+ *
+ * Without a device to pass the commands on to, no graphics API is needed at
+ * all: handles are numbered from 1, mapped ranges point into memory of the
+ * recorder, fences are nullptr and the limits are the OpenGL 3.3 minimums.
+ * Shaders always compile and programs link, framebuffers are complete, and
+ * a program has every uniform declared in its shaders, used or not.
+ * This is what makes the renderer possible to benchmark headless.
+ */
+class RecordingDevice : public GraphicsDevice
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param next Device the commands are passed on to, or nullptr. Not owned.
+	 */
+	explicit RecordingDevice(GraphicsDevice* next = nullptr);
+
+	/**
+	 * @brief Clears the stream and the counters.
+	 */
+	void reset();
+
+	/**
+	 * @brief Gets the counters.
+	 * @return Counters since the last reset.
+	 */
+	const RecordingStats& getStats() const { return _stats; }
+
+	/**
+	 * @brief Gets the recorded stream.
+	 * @return The stream.
+	 */
+	const std::vector<uint32_t>& getStream() const { return _stream; }
+
+	/**
+	 * @brief Writes the counters and every recorded command, one per line,
+	 * to a text file.
+	 * @param fileName Path of the file.
+	 */
+	void dump(const std::string& fileName) const;
+
+	/**
+	 * @brief Gets the name of a command.
+	 * @param command The command.
+	 * @return Name of the command.
+	 */
+	static const char* getName(RecordedCommand command);
+
+	/**
+	 * @brief Records glUseProgram.
+	 */
+	void useProgram(GLuint program) override;
+
+	/**
+	 * @brief Records glBindVertexArray.
+	 */
+	void bindVertexArray(GLuint vao) override;
+
+	/**
+	 * @brief Records glBindBuffer.
+	 */
+	void bindBuffer(GLenum target, GLuint buffer) override;
+
+	/**
+	 * @brief Records glBindBufferRange.
+	 */
+	void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override;
+
+	/**
+	 * @brief Records glBindFramebuffer with GL_FRAMEBUFFER.
+	 */
+	void bindFramebuffer(GLuint framebuffer) override;
+
+	/**
+	 * @brief Records glActiveTexture.
+	 */
+	void activeTexture(GLuint unit) override;
+
+	/**
+	 * @brief Records glBindTexture.
+	 */
+	void bindTexture(GLenum target, GLuint texture) override;
+
+	/**
+	 * @brief Records glEnable or glDisable.
+	 */
+	void setEnabled(GLenum capability, bool enabled) override;
+
+	/**
+	 * @brief Records glCullFace.
+	 */
+	void cullFace(GLenum mode) override;
+
+	/**
+	 * @brief Records glDepthFunc.
+	 */
+	void depthFunc(GLenum func) override;
+
+	/**
+	 * @brief Records glBlendFunc.
+	 */
+	void blendFunc(GLenum source, GLenum destination) override;
+
+	/**
+	 * @brief Records glPolygonMode with GL_FRONT_AND_BACK.
+	 */
+	void polygonMode(GLenum mode) override;
+
+	/**
+	 * @brief Records glViewport.
+	 */
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+
+	/**
+	 * @brief Records glGenBuffers.
+	 */
+	GLuint createBuffer() override;
+
+	/**
+	 * @brief Records glDeleteBuffers.
+	 */
+	void deleteBuffer(GLuint buffer) override;
+
+	/**
+	 * @brief Records glGenVertexArrays.
+	 */
+	GLuint createVertexArray() override;
+
+	/**
+	 * @brief Records glDeleteVertexArrays.
+	 */
+	void deleteVertexArray(GLuint vao) override;
+
+	/**
+	 * @brief Records glBufferData.
+	 */
+	void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+
+	/**
+	 * @brief Records glBufferSubData.
+	 */
+	void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+
+	/**
+	 * @brief Whether the next device supports it, false without one.
+	 */
+	bool hasBufferStorage() const override;
+
+	/**
+	 * @brief Records glBufferStorage without initial data.
+	 */
+	void bufferStorage(GLenum target, GLsizeiptr size, GLbitfield flags) override;
+
+	/**
+	 * @brief Records glMapBufferRange.
+	 */
+	void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr size, GLbitfield access) override;
+
+	/**
+	 * @brief Records glUnmapBuffer.
+	 */
+	void unmapBuffer(GLenum target) override;
+
+	/**
+	 * @brief Records glVertexAttribPointer with unnormalized floats.
+	 */
+	void vertexAttribPointer(GLuint location, GLint size, GLsizei stride, GLsizeiptr offset) override;
+
+	/**
+	 * @brief Records glVertexAttribDivisor.
+	 */
+	void vertexAttribDivisor(GLuint location, GLuint divisor) override;
+
+	/**
+	 * @brief Records glEnableVertexAttribArray or glDisableVertexAttribArray.
+	 */
+	void setAttribArrayEnabled(GLuint location, bool enabled) override;
+
+	/**
+	 * @brief Records glCreateShader.
+	 */
+	GLuint createShader(GLenum type) override;
+
+	/**
+	 * @brief Records glShaderSource and glCompileShader.
+	 */
+	bool compileShader(GLuint shader, const std::string& source, std::string& log) override;
+
+	/**
+	 * @brief Records glDeleteShader.
+	 */
+	void deleteShader(GLuint shader) override;
+
+	/**
+	 * @brief Records glCreateProgram.
+	 */
+	GLuint createProgram() override;
+
+	/**
+	 * @brief Records glAttachShader.
+	 */
+	void attachShader(GLuint program, GLuint shader) override;
+
+	/**
+	 * @brief Records glBindAttribLocation, without the name.
+	 */
+	void bindAttribLocation(GLuint program, GLuint location, const char* name) override;
+
+	/**
+	 * @brief Records glLinkProgram.
+	 */
+	bool linkProgram(GLuint program, std::string& log) override;
+
+	/**
+	 * @brief Records glDeleteProgram.
+	 */
+	void deleteProgram(GLuint program) override;
+
+	/**
+	 * @brief Gets the uniforms from the next device, or those declared in
+	 * the shaders of the program without one. Not recorded.
+	 */
+	void getActiveUniforms(GLuint program, std::vector<ActiveUniform>& uniforms) override;
+
+	/**
+	 * @brief Gets the location from the next device, or of a uniform
+	 * declared in the shaders of the program without one. Not recorded.
+	 */
+	GLint getUniformLocation(GLuint program, const char* name) override;
+
+	/**
+	 * @brief Records glUniformBlockBinding, without the name.
+	 */
+	void bindUniformBlock(GLuint program, const char* name, GLuint binding) override;
+
+	/**
+	 * @brief Records glGenTextures.
+	 */
+	GLuint createTexture() override;
+
+	/**
+	 * @brief Records glDeleteTextures.
+	 */
+	void deleteTexture(GLuint texture) override;
+
+	/**
+	 * @brief Records glTexImage2D.
+	 */
+	void texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) override;
+
+	/**
+	 * @brief Records glTexParameteri.
+	 */
+	void texParameter(GLenum target, GLenum name, GLint value) override;
+
+	/**
+	 * @brief Records glTexParameterfv with GL_TEXTURE_BORDER_COLOR.
+	 */
+	void texBorderColor(GLenum target, glm::vec4 color) override;
+
+	/**
+	 * @brief Records glGenerateMipmap.
+	 */
+	void generateMipmap(GLenum target) override;
+
+	/**
+	 * @brief Records glTexBuffer.
+	 */
+	void texBuffer(GLenum internalFormat, GLuint buffer) override;
+
+	/**
+	 * @brief Records glPixelStorei.
+	 */
+	void pixelStore(GLenum name, GLint value) override;
+
+	/**
+	 * @brief Records glGenFramebuffers.
+	 */
+	GLuint createFramebuffer() override;
+
+	/**
+	 * @brief Records glDeleteFramebuffers.
+	 */
+	void deleteFramebuffer(GLuint framebuffer) override;
+
+	/**
+	 * @brief Records glFramebufferTexture2D or glFramebufferTexture.
+	 */
+	void framebufferTexture(GLenum attachment, GLenum target, GLuint texture) override;
+
+	/**
+	 * @brief Records glDrawBuffers.
+	 */
+	void drawBuffers(GLsizei count, const GLenum* buffers) override;
+
+	/**
+	 * @brief Whether the next device says so, true without one. Not
+	 * recorded.
+	 */
+	bool isFramebufferComplete() override;
+
+	/**
+	 * @brief Records glUniform1f.
+	 */
+	void uniform(GLint location, float value) override;
+
+	/**
+	 * @brief Records glUniform1i.
+	 */
+	void uniform(GLint location, int value) override;
+
+	/**
+	 * @brief Records glUniform2f.
+	 */
+	void uniform(GLint location, glm::vec2 value) override;
+
+	/**
+	 * @brief Records glUniform3f.
+	 */
+	void uniform(GLint location, glm::vec3 value) override;
+
+	/**
+	 * @brief Records glUniform4f.
+	 */
+	void uniform(GLint location, glm::vec4 value) override;
+
+	/**
+	 * @brief Records glUniformMatrix4fv.
+	 */
+	void uniform(GLint location, const glm::mat4& value) override;
+
+	/**
+	 * @brief Records glClear.
+	 */
+	void clear(GLbitfield mask) override;
+
+	/**
+	 * @brief Records glDrawArrays.
+	 */
+	void drawArrays(GLenum mode, GLint first, GLsizei count) override;
+
+	/**
+	 * @brief Records glDrawElements.
+	 */
+	void drawElements(GLenum mode, GLuint first, GLsizei count) override;
+
+	/**
+	 * @brief Records glDrawElementsInstanced.
+	 */
+	void drawElementsInstanced(GLenum mode, GLuint first, GLsizei count, GLsizei instances) override;
+
+	/**
+	 * @brief Records a fence.
+	 */
+	GLsync fence() override;
+
+	/**
+	 * @brief Records waiting for and deleting a fence.
+	 */
+	void waitFence(GLsync fence) override;
+
+	/**
+	 * @brief Gets a limit of the next device, or the OpenGL 3.3 minimum
+	 * without one. Not recorded.
+	 */
+	GLint getInteger(GLenum name) override;
+
+private:
+	/**
+	 * @brief Appends a command to the stream.
+	 * @param command The command.
+	 * @param arguments Arguments of the command.
+	 */
+	void record(RecordedCommand command, std::initializer_list<uint32_t> arguments);
+
+	/**
+	 * @brief Appends a uniform to the stream and counts it.
+	 * @param command The command.
+	 * @param location Uniform location.
+	 * @param values Floats of the value.
+	 * @param count Number of floats.
+	 */
+	void recordUniform(RecordedCommand command, GLint location, const float* values, uint32_t count);
+
+	/**
+	 * @brief Gets the bits of a float.
+	 * @param value The float.
+	 * @return Its bits.
+	 */
+	static uint32_t bits(float value);
+
+	/**
+	 * @brief Device the commands are passed on to, or nullptr.
+	 */
+	GraphicsDevice* _next;
+
+	/**
+	 * @brief Recorded commands.
+	 */
+	std::vector<uint32_t> _stream;
+
+	/**
+	 * @brief Counters since the last reset.
+	 */
+	RecordingStats _stats{};
+
+	/**
+	 * @brief Next handle handed out without a device to pass on to.
+	 */
+	GLuint _nextName{ 1 };
+
+	/**
+	 * @brief Memory of the mapped range without a device to pass on to.
+	 */
+	std::vector<unsigned char> _mapped;
+
+	/**
+	 * @brief Size of the range mapped last, counted when it is unmapped.
+	 */
+	GLsizeiptr _mappedSize{ 0 };
+
+	/**
+	 * @brief Source of every shader without a device to pass on to.
+	 */
+	std::unordered_map<GLuint, std::string> _shaderSources;
+
+	/**
+	 * @brief Shaders attached to every program without a device to pass
+	 * on to.
+	 */
+	std::unordered_map<GLuint, std::vector<GLuint>> _programShaders;
+
+	/**
+	 * @brief Uniforms of every linked program without a device to pass
+	 * on to.
+	 */
+	std::unordered_map<GLuint, std::vector<ActiveUniform>> _programUniforms;
+
+	/**
+	 * @brief Location of every uniform and array element of every linked
+	 * program without a device to pass on to.
+	 */
+	std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> _uniformLocations;
+};
@@ -0,0 +1,162 @@
+/**
+ * @file	RenderBenchmark.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless benchmark of the renderer
+ */
+
+#include "RenderBenchmark.h"
+#include "RecordingDevice.h"
+#include "EntityManager.h"
+#include "AssetManager.h"
+#include "UIManager.h"
+#include "RenderingSystem.h"
+#include "CameraComponent.h"
+#include "CollisionComponent.h"
+#include "MaterialComponent.h"
+#include "ModelComponent.h"
+#include "PointLightComponent.h"
+#include "TerrainComponent.h"
+#include "TextureComponent.h"
+#include "TransformComponent.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+void runRenderBenchmark(uint32_t modelCount, uint32_t frames)
+{
+	const GLuint width = 1280;
+	const GLuint height = 720;
+	const float dt = 1.f / 60.f;
+	const float spacing = 4.f;
+	const uint32_t lightCount = 8;
+	const uint32_t warmupFrames = 10;
+
+	// Every object below is created and destroyed through the recorder
+	RecordingDevice recorder{};
+	GraphicsDevice::set(&recorder);
+
+	{
+		EventManager evM{};
+		AssetManager asM{};
+		userinterface::UIManager uiM{ width, height };
+		EntityManager enM{ &evM, &asM, &uiM };
+
+		enM.registerComponent<CollisionComponent>("CollisionComponent");
+		enM.registerComponent<TransformComponent>("TransformComponent");
+		enM.registerComponent<ModelComponent>("ModelComponent");
+		enM.registerComponent<CameraComponent>("CameraComponent");
+		enM.registerComponent<TerrainComponent>("TerrainComponent");
+		enM.registerComponent<TextureComponent>("TextureComponent");
+		enM.registerComponent<PointLightComponent>("PointLightComponent");
+		enM.registerComponent<MaterialComponent>("MaterialComponent");
+		enM.registerSystem<RenderingSystem>(width, height);
+
+		RenderingSystem* renderer = enM.getSystem<RenderingSystem>();
+
+		asM.load<RawModel>("bunneh", "../res/models/bunnyplus.obj");
+		asM.load<RawModel>("lowpolytree", "../res/models/lowpolytree.obj");
+		asM.load<Texture2D>("grass", "../res/textures/GrassGreenTexture0003.tga");
+		asM.load<Texture2D>("dirt", "../res/textures/dirt.tga");
+
+		// Square grid of models around the origin, alternating between the
+		// models so both are drawn instanced
+		uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(modelCount))));
+		float halfWidth = side * spacing * 0.5f;
+
+		for (uint32_t i = 0; i < modelCount; ++i)
+		{
+			glm::vec3 position{ (i % side) * spacing - halfWidth, 0.f, (i / side) * spacing - halfWidth };
+			bool tree = i % 2 == 0;
+
+			EntityHandle ent = enM.createEntity();
+			enM.assignComponent<TransformComponent>(ent, position);
+			enM.assignComponent<ModelComponent>(ent, tree ? "lowpolytree" : "bunneh");
+			enM.assignComponent<TextureComponent>(ent);
+			enM.assignComponent<MaterialComponent>(ent, glm::vec3{ 1.f,1.f,1.f }, glm::vec3{ 1.f,1.f,1.f }, glm::vec3{ 0.2f,0.2f,0.2f }, 64);
+
+			enM.getComponent<TextureComponent>(ent)->attach(0, tree ? "grass" : "dirt");
+		}
+
+		// Lights in a ring above the grid
+		for (uint32_t i = 0; i < lightCount; ++i)
+		{
+			float angle = glm::radians(360.f * i / lightCount);
+
+			EntityHandle light = enM.createEntity();
+			enM.assignComponent<TransformComponent>(light, glm::vec3{ std::cos(angle) * halfWidth * 0.5f, 10.f, std::sin(angle) * halfWidth * 0.5f });
+			enM.assignComponent<PointLightComponent>(light,
+				glm::vec3{ 0.1f, 0.1f, 0.1f },	// Ambient
+				glm::vec3{ 0.8f,0.8f,0.8f },	// Diffuse
+				glm::vec3{ 1.0f,1.0f,1.0f },	// Specular
+				1.f,							// Constant
+				0.01f,							// Linear
+				0.003f);						// Quadratic
+		}
+
+		EntityHandle camera = enM.createEntity();
+		enM.assignComponent<TransformComponent>(camera, glm::vec3{});
+		enM.assignComponent<CameraComponent>(camera);
+
+		TransformComponent* cameraTransform = enM.getComponent<TransformComponent>(camera);
+		CameraComponent* cameraComponent = enM.getComponent<CameraComponent>(camera);
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		double updateTime = 0.0;
+		double renderTime = 0.0;
+
+		for (uint32_t frame = 0; frame < warmupFrames + frames; ++frame)
+		{
+			// Circles the grid looking at its center
+			float angle = frame * dt * 0.5f;
+			float pitch = -20.f;
+
+			glm::vec3 position{ std::cos(angle) * halfWidth, halfWidth * 0.4f, std::sin(angle) * halfWidth };
+
+			cameraTransform->position = position;
+			cameraComponent->camera = Camera{ position, glm::vec3{ 0.f,1.f,0.f }, glm::degrees(angle) + 180.f, pitch };
+
+			// Shaders, textures and buffers created by the first frames are
+			// not part of the measurement
+			if (frame == warmupFrames)
+			{
+				recorder.reset();
+
+				updateTime = 0.0;
+				renderTime = 0.0;
+			}
+
+			Clock::time_point start = Clock::now();
+
+			enM.update(dt);
+
+			Clock::time_point middle = Clock::now();
+
+			renderer->render(renderer->getPreparedFrame());
+
+			Clock::time_point end = Clock::now();
+
+			updateTime += std::chrono::duration<double, std::milli>(middle - start).count();
+			renderTime += std::chrono::duration<double, std::milli>(end - middle).count();
+		}
+
+		const RecordingStats& recorded = recorder.getStats();
+
+		std::cout << "Render benchmark: " << modelCount << " models, " << lightCount << " lights, " << frames << " frames" << std::endl;
+		std::cout << "  Update:    " << updateTime / frames << " ms/frame" << std::endl;
+		std::cout << "  Render:    " << renderTime / frames << " ms/frame" << std::endl;
+		std::cout << "  Commands:  " << recorded.commands / static_cast<double>(frames) << " per frame" << std::endl;
+		std::cout << "  Draws:     " << recorded.draws / static_cast<double>(frames) << " per frame, " << recorded.instances / static_cast<double>(frames) << " instances" << std::endl;
+		std::cout << "  Binds:     " << recorded.binds / static_cast<double>(frames) << " per frame" << std::endl;
+		std::cout << "  State:     " << recorded.stateChanges / static_cast<double>(frames) << " changes per frame" << std::endl;
+		std::cout << "  Uniforms:  " << recorded.uniformUploads / static_cast<double>(frames) << " per frame" << std::endl;
+		std::cout << "  Uploaded:  " << recorded.bytesUploaded / static_cast<double>(frames) << " bytes per frame" << std::endl;
+		std::cout << "  Created:   " << recorded.resourcesCreated / static_cast<double>(frames) << " resources per frame" << std::endl;
+	}
+
+	GraphicsDevice::set(nullptr);
+}
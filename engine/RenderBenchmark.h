@@ -0,0 +1,23 @@
+/**
+ * @file	RenderBenchmark.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Headless benchmark of the renderer
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Renders a grid of models lit by a few point lights into a
+ * RecordingDevice, without a window or an OpenGL context, and prints the
+ * time per frame and the commands recorded per frame.
+ *
+ * The camera circles the grid, so culling, level of detail and the shadow
+ * maps see a different view every frame.
+ *
+ * @param modelCount Number of models.
+ * @param frames Number of frames to render.
+ */
+void runRenderBenchmark(uint32_t modelCount = 1024, uint32_t frames = 300);
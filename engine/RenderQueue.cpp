@@ -0,0 +1,89 @@
+/**
+ * @file	RenderQueue.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Queue of draws sorted to minimize state changes
+ */
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+constexpr uint32_t RenderQueue::PASS_MAX;
+constexpr uint32_t RenderQueue::SHADER_MAX;
+constexpr uint32_t RenderQueue::MATERIAL_MAX;
+constexpr uint32_t RenderQueue::TEXTURE_MAX;
+constexpr uint32_t RenderQueue::MESH_MAX;
+constexpr uint32_t RenderQueue::DEPTH_MAX;
+constexpr uint32_t RenderQueue::DEPTH_SHIFT;
+constexpr uint32_t RenderQueue::MESH_SHIFT;
+constexpr uint32_t RenderQueue::TEXTURE_SHIFT;
+constexpr uint32_t RenderQueue::MATERIAL_SHIFT;
+constexpr uint32_t RenderQueue::SHADER_SHIFT;
+constexpr uint32_t RenderQueue::PASS_SHIFT;
+
+uint64_t RenderQueue::makeKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t texture, uint32_t mesh, float depth)
+{
+	uint32_t quantizedDepth = static_cast<uint32_t>(std::min(std::max(depth, 0.f), 1.f) * DEPTH_MAX);
+
+	return static_cast<uint64_t>(std::min(pass, PASS_MAX)) << PASS_SHIFT
+		| static_cast<uint64_t>(std::min(shader, SHADER_MAX)) << SHADER_SHIFT
+		| static_cast<uint64_t>(std::min(material, MATERIAL_MAX)) << MATERIAL_SHIFT
+		| static_cast<uint64_t>(std::min(texture, TEXTURE_MAX)) << TEXTURE_SHIFT
+		| static_cast<uint64_t>(std::min(mesh, MESH_MAX)) << MESH_SHIFT
+		| static_cast<uint64_t>(quantizedDepth) << DEPTH_SHIFT;
+}
+
+void RenderQueue::sort()
+{
+	static constexpr uint32_t DIGIT_COUNT = 8;
+	static constexpr uint32_t BUCKET_COUNT = 256;
+
+	size_t count = _items.size();
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	// Count all digits in one go
+	std::vector<uint32_t> histograms(DIGIT_COUNT * BUCKET_COUNT, 0);
+
+	for (const RenderItem& item : _items)
+	{
+		for (uint32_t digit = 0; digit < DIGIT_COUNT; ++digit)
+		{
+			++histograms[digit * BUCKET_COUNT + ((item.key >> (digit * 8)) & 0xFF)];
+		}
+	}
+
+	_scratch.resize(count);
+
+	// Least significant digit first, every pass is stable
+	for (uint32_t digit = 0; digit < DIGIT_COUNT; ++digit)
+	{
+		uint32_t* histogram = &histograms[digit * BUCKET_COUNT];
+
+		// All keys share this digit, the pass would not move anything
+		if (histogram[(_items[0].key >> (digit * 8)) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32_t offset = 0;
+
+		for (uint32_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+		{
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (const RenderItem& item : _items)
+		{
+			_scratch[histogram[(item.key >> (digit * 8)) & 0xFF]++] = item;
+		}
+
+		_items.swap(_scratch);
+	}
+}
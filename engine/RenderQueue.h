@@ -0,0 +1,306 @@
+/**
+ * @file	RenderQueue.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Queue of draws sorted to minimize state changes
+ */
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Passes, drawn in this order.
+ */
+enum RenderPass : uint8_t
+{
+	/**
+	 * @brief Opaque models.
+	 */
+	RENDER_PASS_OPAQUE,
+
+	/**
+	 * @brief Terrain, drawn after the models so they occlude it.
+	 */
+	RENDER_PASS_TERRAIN
+};
+
+/**
+ * @brief A draw in the queue.
+ */
+struct RenderItem
+{
+	/**
+	 * @brief Sort key, see RenderQueue::makeKey.
+	 */
+	uint64_t key;
+
+	/**
+	 * @brief Index of the draw data owned by the caller.
+	 */
+	uint32_t payload;
+};
+
+/**
+ * @brief Queue of draws sorted by a 64 bit key.
+ *
+ * From the highest bit the key holds the pass, shader, material, texture
+ * set, mesh and depth. Sorting the queue groups draws sharing state, so
+ * state only has to be changed when a field of the key differs from the
+ * previous draw. Within the same state draws are front to back.
+ *
+ * The resources are given small ids by RenderIdTable.
+ */
+class RenderQueue
+{
+public:
+	/**
+	 * @brief Builds a sort key.
+	 * @param pass Pass, see RenderPass.
+	 * @param shader Shader id.
+	 * @param material Material id.
+	 * @param texture Texture set id.
+	 * @param mesh Mesh id.
+	 * @param depth View depth, 0 at the near plane and 1 at the far plane.
+	 * @return The key.
+	 */
+	static uint64_t makeKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t texture, uint32_t mesh, float depth);
+
+	/**
+	 * @brief Gets the pass of a key.
+	 * @param key The key.
+	 * @return Pass.
+	 */
+	static uint32_t getPass(uint64_t key) { return static_cast<uint32_t>(key >> PASS_SHIFT) & PASS_MAX; }
+
+	/**
+	 * @brief Gets the shader id of a key.
+	 * @param key The key.
+	 * @return Shader id.
+	 */
+	static uint32_t getShader(uint64_t key) { return static_cast<uint32_t>(key >> SHADER_SHIFT) & SHADER_MAX; }
+
+	/**
+	 * @brief Gets the material id of a key.
+	 * @param key The key.
+	 * @return Material id.
+	 */
+	static uint32_t getMaterial(uint64_t key) { return static_cast<uint32_t>(key >> MATERIAL_SHIFT) & MATERIAL_MAX; }
+
+	/**
+	 * @brief Gets the texture set id of a key.
+	 * @param key The key.
+	 * @return Texture set id.
+	 */
+	static uint32_t getTexture(uint64_t key) { return static_cast<uint32_t>(key >> TEXTURE_SHIFT) & TEXTURE_MAX; }
+
+	/**
+	 * @brief Gets the mesh id of a key.
+	 * @param key The key.
+	 * @return Mesh id.
+	 */
+	static uint32_t getMesh(uint64_t key) { return static_cast<uint32_t>(key >> MESH_SHIFT) & MESH_MAX; }
+
+	/**
+	 * @brief Gets a key without its depth, equal for draws that share all state.
+	 * @param key The key.
+	 * @return State part of the key.
+	 */
+	static uint64_t getState(uint64_t key) { return key >> MESH_SHIFT; }
+
+	/**
+	 * @brief Clears the queue.
+	 */
+	void clear() { _items.clear(); }
+
+	/**
+	 * @brief Adds a draw.
+	 * @param key Sort key.
+	 * @param payload Index of the draw data.
+	 */
+	void push(uint64_t key, uint32_t payload) { _items.push_back(RenderItem{ key, payload }); }
+
+	/**
+	 * @brief Sorts the draws by key with a radix sort. Draws with equal keys
+	 * keep the order they were added in.
+	 */
+	void sort();
+
+	/**
+	 * @brief Gets the draws.
+	 * @return Ref to draws.
+	 */
+	const std::vector<RenderItem>& getItems() const { return _items; }
+
+	/**
+	 * @brief Gets the number of draws.
+	 * @return Number of draws.
+	 */
+	size_t size() const { return _items.size(); }
+
+	/**
+	 * @brief Largest pass.
+	 */
+	static constexpr uint32_t PASS_MAX{ (1 << 4) - 1 };
+
+	/**
+	 * @brief Largest shader id.
+	 */
+	static constexpr uint32_t SHADER_MAX{ (1 << 8) - 1 };
+
+	/**
+	 * @brief Largest material id.
+	 */
+	static constexpr uint32_t MATERIAL_MAX{ (1 << 12) - 1 };
+
+	/**
+	 * @brief Largest texture set id.
+	 */
+	static constexpr uint32_t TEXTURE_MAX{ (1 << 12) - 1 };
+
+	/**
+	 * @brief Largest mesh id.
+	 */
+	static constexpr uint32_t MESH_MAX{ (1 << 12) - 1 };
+
+	/**
+	 * @brief Largest depth.
+	 */
+	static constexpr uint32_t DEPTH_MAX{ (1 << 16) - 1 };
+
+private:
+	/**
+	 * @brief Position of the depth in the key.
+	 */
+	static constexpr uint32_t DEPTH_SHIFT{ 0 };
+
+	/**
+	 * @brief Position of the mesh id in the key.
+	 */
+	static constexpr uint32_t MESH_SHIFT{ 16 };
+
+	/**
+	 * @brief Position of the texture set id in the key.
+	 */
+	static constexpr uint32_t TEXTURE_SHIFT{ 28 };
+
+	/**
+	 * @brief Position of the material id in the key.
+	 */
+	static constexpr uint32_t MATERIAL_SHIFT{ 40 };
+
+	/**
+	 * @brief Position of the shader id in the key.
+	 */
+	static constexpr uint32_t SHADER_SHIFT{ 52 };
+
+	/**
+	 * @brief Position of the pass in the key.
+	 */
+	static constexpr uint32_t PASS_SHIFT{ 60 };
+
+	/**
+	 * @brief Draws.
+	 */
+	std::vector<RenderItem> _items{};
+
+	/**
+	 * @brief Scratch buffer for the sort.
+	 */
+	std::vector<RenderItem> _scratch{};
+};
+
+/**
+ * @brief Gives resources small ids for the sort keys.
+ *
+ * Ids are kept between frames, so the same resource always sorts to the
+ * same place. The largest id is shared by every resource that does not fit,
+ * so it can not be trusted to mean the same resource as the previous draw.
+ *
+ * @tparam T Resource type.
+ */
+template <typename T>
+class RenderIdTable
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param maxID Largest id, shared by every resource that does not fit.
+	 */
+	explicit RenderIdTable(uint32_t maxID) : _maxID{ maxID } {}
+
+	/**
+	 * @brief Gets the id of a resource, giving it one if it has none.
+	 * @param resource The resource.
+	 * @return Id.
+	 */
+	uint32_t getID(const T& resource)
+	{
+		auto it = _ids.find(resource);
+
+		if (it != _ids.end())
+		{
+			return it->second;
+		}
+
+		if (_ids.size() >= _maxID)
+		{
+			return _maxID;
+		}
+
+		uint32_t id = static_cast<uint32_t>(_ids.size());
+
+		_ids.emplace(resource, id);
+
+		return id;
+	}
+
+	/**
+	 * @brief Gets the id of a resource without giving it one. Only reads
+	 * the table, so it may be called from several threads as long as no
+	 * thread calls getID at the same time.
+	 * @param resource The resource.
+	 * @param id Set to the id if the resource has one.
+	 * @return True if the resource has an id.
+	 */
+	bool find(const T& resource, uint32_t& id) const
+	{
+		auto it = _ids.find(resource);
+
+		if (it != _ids.end())
+		{
+			id = it->second;
+			return true;
+		}
+
+		// A full table gives every new resource the shared id
+		if (_ids.size() >= _maxID)
+		{
+			id = _maxID;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Checks if an id may belong to several resources.
+	 * @param id The id.
+	 * @return True if the id is shared.
+	 */
+	bool isShared(uint32_t id) const { return id == _maxID; }
+
+private:
+	/**
+	 * @brief Largest id.
+	 */
+	uint32_t _maxID;
+
+	/**
+	 * @brief Id of every resource.
+	 */
+	std::map<T, uint32_t> _ids{};
+};
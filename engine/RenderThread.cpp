@@ -0,0 +1,151 @@
+/**
+ * @file	RenderThread.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Thread owning the OpenGL context and rendering submitted frames
+ */
+
+#include "RenderThread.h"
+
+RenderThread::RenderThread(Window* window)
+	: _window{ window } {}
+
+RenderThread::~RenderThread()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		// The thread is stopped, a failed last frame has nobody left to tell
+	}
+}
+
+void RenderThread::start()
+{
+	if (isRunning())
+	{
+		throw RenderThread_error("Render thread is already running");
+	}
+
+	_quit = false;
+
+	// A context can only be current on one thread at a time
+	_window->releaseContext();
+
+	_thread = std::thread{ &RenderThread::threadLoop, this };
+}
+
+void RenderThread::stop()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ _mutex };
+		_quit = true;
+	}
+
+	_frameSubmitted.notify_all();
+
+	_thread.join();
+
+	_window->setContextCurrent();
+
+	std::lock_guard<std::mutex> lock{ _mutex };
+	rethrow();
+}
+
+void RenderThread::submit(FrameJob job)
+{
+	if (!isRunning())
+	{
+		throw RenderThread_error("Render thread is not running");
+	}
+
+	{
+		std::unique_lock<std::mutex> lock{ _mutex };
+
+		_frameFinished.wait(lock, [this]() { return !_job && !_busy; });
+
+		rethrow();
+
+		_job = std::move(job);
+	}
+
+	_frameSubmitted.notify_all();
+}
+
+void RenderThread::finish()
+{
+	std::unique_lock<std::mutex> lock{ _mutex };
+
+	_frameFinished.wait(lock, [this]() { return !_job && !_busy; });
+
+	rethrow();
+}
+
+void RenderThread::threadLoop()
+{
+	_window->setContextCurrent();
+
+	std::unique_lock<std::mutex> lock{ _mutex };
+
+	while (true)
+	{
+		_frameSubmitted.wait(lock, [this]() { return _job || _quit; });
+
+		// A frame submitted before stopping is still rendered
+		if (!_job)
+		{
+			break;
+		}
+
+		FrameJob job;
+		job.swap(_job);
+
+		_busy = true;
+
+		lock.unlock();
+
+		std::exception_ptr error{};
+
+		try
+		{
+			job();
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		lock.lock();
+
+		if (error)
+		{
+			_error = error;
+		}
+
+		_busy = false;
+
+		_frameFinished.notify_all();
+	}
+
+	lock.unlock();
+
+	_window->releaseContext();
+}
+
+void RenderThread::rethrow()
+{
+	if (_error)
+	{
+		std::exception_ptr error = _error;
+		_error = nullptr;
+
+		std::rethrow_exception(error);
+	}
+}
@@ -0,0 +1,154 @@
+/**
+ * @file	RenderThread.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Thread owning the OpenGL context and rendering submitted frames
+ */
+
+#pragma once
+
+#include "Window.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+
+/**
+ * @brief RenderThread error class
+ */
+class RenderThread_error : public std::logic_error {
+	using std::logic_error::logic_error;
+};
+
+/**
+ * @brief Thread that owns the OpenGL context of a window and runs one
+ * frame at a time.
+ *
+ * A frame is submitted while the previous one may still be rendering, and
+ * submitting waits for the previous frame to finish. Frame N + 1 can then be
+ * simulated while frame N renders, as long as every frame renders from its
+ * own copy of the render data: with two copies the simulation never writes
+ * the copy being rendered.
+ *
+ * An exception thrown by a frame is rethrown by the next call to submit(),
+ * finish() or stop().
+ */
+class RenderThread
+{
+public:
+	/**
+	 * @brief Function rendering a frame.
+	 */
+	typedef std::function<void()> FrameJob;
+
+	/**
+	 * @brief Constructor.
+	 * @param window Window whose context the thread owns.
+	 */
+	explicit RenderThread(Window* window);
+
+	/**
+	 * @brief Destructor. Stops the thread.
+	 */
+	~RenderThread();
+
+	/**
+	 * @brief Constructor
+	 */
+	RenderThread(const RenderThread&) = delete;
+
+	/**
+	 * @brief Assignment operator
+	 * @return Ref. to self.
+	 */
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	/**
+	 * @brief Starts the thread. The context must be current on the calling
+	 * thread, and is moved to the render thread.
+	 */
+	void start();
+
+	/**
+	 * @brief Waits for the last frame and stops the thread. The context is
+	 * made current on the calling thread again.
+	 */
+	void stop();
+
+	/**
+	 * @brief Waits for the previous frame to finish and hands over the next.
+	 * @param job Renders the frame.
+	 */
+	void submit(FrameJob job);
+
+	/**
+	 * @brief Waits for the submitted frames to finish.
+	 */
+	void finish();
+
+	/**
+	 * @brief Checks if the thread is running.
+	 * @return True if running.
+	 */
+	bool isRunning() const { return _thread.joinable(); }
+
+private:
+	/**
+	 * @brief Main loop of the thread.
+	 */
+	void threadLoop();
+
+	/**
+	 * @brief Rethrows the exception of a frame, if any. Must be called with
+	 * the mutex held.
+	 */
+	void rethrow();
+
+	/**
+	 * @brief Window whose context the thread owns.
+	 */
+	Window* _window;
+
+	/**
+	 * @brief The thread.
+	 */
+	std::thread _thread{};
+
+	/**
+	 * @brief Mutex guarding the members below.
+	 */
+	std::mutex _mutex{};
+
+	/**
+	 * @brief Signalled when a frame is submitted or the thread should stop.
+	 */
+	std::condition_variable _frameSubmitted{};
+
+	/**
+	 * @brief Signalled when a frame has finished.
+	 */
+	std::condition_variable _frameFinished{};
+
+	/**
+	 * @brief Frame waiting to be rendered, empty if none.
+	 */
+	FrameJob _job{};
+
+	/**
+	 * @brief Whether a frame is being rendered.
+	 */
+	bool _busy{ false };
+
+	/**
+	 * @brief Whether the thread should stop.
+	 */
+	bool _quit{ false };
+
+	/**
+	 * @brief Exception thrown by a frame, not yet rethrown.
+	 */
+	std::exception_ptr _error{};
+};
@@ -12,6 +12,7 @@
 #include "ShaderProgram.h"
 
 #include <iostream>
+#include <algorithm>
 
 #include "EntityManager.h"
 
@@ -22,10 +23,84 @@
 #include "PointLight.h"
 #include "PointLightComponent.h"
 #include "MaterialComponent.h"
+#include "TerrainModel.h"
+#include "CollisionComponent.h"
+#include "GLState.h"
+#include "GraphicsDevice.h"
+#include "RecordingDevice.h"
+#include "JobSystem.h"
+
+namespace
+{
+	/**
+	 * @brief Uniforms uploaded for every draw or light, hashed at compile time.
+	 */
+	constexpr UniformName UNIFORM_TRANSFORM{ "transform" };
+	constexpr UniformName UNIFORM_MODEL{ "model" };
+	constexpr UniformName UNIFORM_INSTANCED{ "instanced" };
+	constexpr UniformName UNIFORM_FACE_MASK{ "faceMask" };
+	constexpr UniformName UNIFORM_DEPTH_MAPS{ "depthMaps" };
+
+	/**
+	 * @brief File the commands of a captured frame are written to.
+	 */
+	constexpr const char* CAPTURE_FILE{ "frame_capture.txt" };
+
+	/**
+	 * @brief Texture set of draws without a TextureComponent.
+	 */
+	const std::map<GLuint, std::string> NO_TEXTURES{};
+
+	/**
+	 * @brief Screen size below which a model is drawn with the next level
+	 * of detail, as the part of the screen height covered by its bounding
+	 * sphere.
+	 */
+	constexpr float LOD_SCREEN_SIZES[]{ 0.25f, 0.12f, 0.06f };
+
+	static_assert(
+		sizeof(LOD_SCREEN_SIZES) / sizeof(LOD_SCREEN_SIZES[0]) == RawModel::MAX_LODS - 1,
+		"Every level but the last needs a screen size");
+
+	/**
+	 * @brief Gets the values of a material identifying it in the sort keys.
+	 * @param material The material.
+	 * @return Ambient, diffuse, specular and shininess.
+	 */
+	std::array<float, 10> materialValues(const Material& material)
+	{
+		glm::vec3 ambient = material.getAmbient();
+		glm::vec3 diffuse = material.getDiffuse();
+		glm::vec3 specular = material.getSpecular();
+
+		return std::array<float, 10>{ {
+			ambient.x, ambient.y, ambient.z,
+			diffuse.x, diffuse.y, diffuse.z,
+			specular.x, specular.y, specular.z,
+			material.getShininess() } };
+	}
+
+	/**
+	 * @brief Checks if two materials have the same values.
+	 * @param lhs First material.
+	 * @param rhs Second material.
+	 * @return True if equal.
+	 */
+	bool equalMaterials(const Material& lhs, const Material& rhs)
+	{
+		return lhs.getAmbient() == rhs.getAmbient() &&
+			lhs.getDiffuse() == rhs.getDiffuse() &&
+			lhs.getSpecular() == rhs.getSpecular() &&
+			lhs.getShininess() == rhs.getShininess();
+	}
+}
 
 RenderingSystem::RenderingSystem(Window* window)
 	: window{ window } {}
 
+RenderingSystem::RenderingSystem(GLuint width, GLuint height)
+	: window{ nullptr }, frameWidth{ width }, frameHeight{ height } {}
+
 void RenderingSystem::handleEvent(const KeyEvent& ev)
 {
 	if (ev.key == GLFW_KEY_H && ev.action == 0)
@@ -58,10 +133,18 @@ void RenderingSystem::handleEvent(const KeyEvent& ev)
 		gamma -= 0.1f;
 	}
 
+	if (ev.key == GLFW_KEY_P && ev.action == 0)
+	{
+		captureFrame = true;
+	}
+
 	std::cout << "HDR: " << hdr << std::endl;
 	std::cout << "Bloom: " << bloom << std::endl;
 	std::cout << "Exposure: " << exposure << std::endl;
 	std::cout << "Gamma: " << gamma << std::endl;
+
+	// The statistics belong to the render thread, which prints them
+	reportRequested = true;
 }
 
 void RenderingSystem::startUp()
@@ -70,14 +153,16 @@ void RenderingSystem::startUp()
 
 	ev->addSubscriber<KeyEvent>(this);
 
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	GLState& state = GLState::get();
 
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
+	state.setEnabled(GL_DEPTH_TEST, true);
+	state.depthFunc(GL_LESS);
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	state.setEnabled(GL_CULL_FACE, true);
+	state.cullFace(GL_BACK);
+
+	state.setEnabled(GL_BLEND, true);
+	state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	ShaderProgram* program = new ShaderProgram{
 		"../res/shaders/simpleVert.shader",
@@ -106,7 +191,10 @@ void RenderingSystem::startUp()
 		program->bindAttribLocation(0, "vertex_position");
 		program->bindAttribLocation(1, "vertex_normal");
 		program->bindAttribLocation(2, "vertex_texture_coordinates");
+		program->bindAttribLocation(RawModel::INSTANCE_MODEL_LOCATION, "instance_model");
 		program->link();
+		program->bindUniformBlock("FrameBlock", FRAME_BLOCK_BINDING);
+		program->bindUniformBlock("MaterialBlock", MATERIAL_BLOCK_BINDING);
 	}
 	catch (const ShaderProgramException& ex)
 	{
@@ -117,7 +205,10 @@ void RenderingSystem::startUp()
 	{
 		depthShader->compile();
 		depthShader->bindAttribLocation(0, "vertex_position");
+		depthShader->bindAttribLocation(RawModel::INSTANCE_MODEL_LOCATION, "instance_model");
 		depthShader->link();
+		depthShader->bindUniformBlock("FrameBlock", FRAME_BLOCK_BINDING);
+		depthShader->bindUniformBlock("ShadowBlock", SHADOW_BLOCK_BINDING);
 	}
 	catch (const ShaderProgramException& ex)
 	{
@@ -172,147 +263,94 @@ void RenderingSystem::startUp()
 	am->load<Texture2D>("skybox", "../res/textures/skybox512.tga");
 	am->load<RawModel>("skybox", "../res/models/skybox.obj");
 
+	instanceBuffer = new VertexBufferObject{ GL_ARRAY_BUFFER };
+
+	uniformRing = new UniformRing{ UNIFORM_RING_SIZE };
+
+	// Lights and clusters are read by the shader through a buffer texture
+	lightBuffer = new VertexBufferObject{ GL_TEXTURE_BUFFER };
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	lightTexture = device.createTexture();
+	state.bindTexture(0, GL_TEXTURE_BUFFER, lightTexture);
+	device.texBuffer(GL_RGBA32F, lightBuffer->getHandle());
+	state.bindTexture(0, GL_TEXTURE_BUFFER, 0);
+
 	//=========================================================================
 	// Setup Depth Rendering
 	//=========================================================================
 
 	// Generate Framebuffer to render depth data
-	glGenFramebuffers(MAX_LIGHTS, depthMapFBOs);
+	for (GLuint& framebuffer : depthMapFBOs)
+	{
+		framebuffer = device.createFramebuffer();
+	}
 
 	// Generate our depth map slots
-	glGenTextures(MAX_LIGHTS, depthMaps);
+	for (GLuint& depthMap : depthMaps)
+	{
+		depthMap = device.createTexture();
+	}
 
-	GLfloat borderColor[] = { 1.f, 1.f, 1.f, 1.f };
+	glm::vec4 borderColor{ 1.f, 1.f, 1.f, 1.f };
 
 	// Initialize all textures
 	for (size_t i = 0; i < MAX_LIGHTS; ++i)
 	{
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, depthMaps[i]);
+		state.bindTexture(1, GL_TEXTURE_CUBE_MAP, depthMaps[i]);
 
 		// Initialize all 6 faces of the cubemap
-		for (size_t face = 0; face < 6; ++face)
+		for (GLenum face = 0; face < 6; ++face)
 		{
-			glTexImage2D(
+			device.texImage2D(
 				GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
-				0,
 				GL_DEPTH_COMPONENT32,
 				SHADOW_WIDTH,
 				SHADOW_HEIGHT,
-				0,
 				GL_DEPTH_COMPONENT,
 				GL_FLOAT,
-				NULL);
+				nullptr);
 		}
 
 		// Setup sampling behaviour
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
 		// Setup wrapping behaviour
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
 
 		// Setup border color
-		glTexParameterfv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BORDER_COLOR, borderColor);
+		device.texBorderColor(GL_TEXTURE_CUBE_MAP, borderColor);
 
 		// Setup framebuffer
-		glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBOs[i]);
+		state.bindFramebuffer(depthMapFBOs[i]);
 
-		glFramebufferTexture(
-			GL_FRAMEBUFFER, 
-			GL_DEPTH_ATTACHMENT, 
-			depthMaps[i], 
-			0);
+		device.framebufferTexture(GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP, depthMaps[i]);
 
-		glDrawBuffer(GL_NONE);
-		glReadBuffer(GL_NONE);
+		device.drawBuffers(0, nullptr);
 
 		// Check if setup is complete
-		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		if (!device.isFramebufferComplete())
 		{
 			std::cerr << "Framebuffer " << i << " not complete" << std::endl;
 		}
 
+		// Maps are sampled before their first render, so they start out without shadow
+		device.clear(GL_DEPTH_BUFFER_BIT);
+
 		// Unbind buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		state.bindFramebuffer(0);
 	}
 
 	//=========================================================================
 	// Setup Post-processing
 	//=========================================================================
 
-	//=========================================================================
-	// HDR
-	//=========================================================================
-
-	// Generate HDR Framebuffer
-	glGenFramebuffers(1, &hdrFBO);
-
-	// Generate Colorbuffers for color and bright color.
-	glGenTextures(2, colorBuffers);
-	glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-
-	// Initiate textures and attach to frame buffer
-	for (int i = 0; i < 2; ++i)
-	{
-		glBindTexture(GL_TEXTURE_2D, colorBuffers[i]);
-
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0,
-			GL_RGBA16F,
-			window->getWidth(),
-			window->getHeight(),
-			0,
-			GL_RGBA,
-			GL_FLOAT,
-			NULL);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-		glFramebufferTexture2D(
-			GL_FRAMEBUFFER, 
-			GL_COLOR_ATTACHMENT0 + i, 
-			GL_TEXTURE_2D, 
-			colorBuffers[i], 
-			0);
-	}
-
-	glGenRenderbuffers(1, &rboDepth);
-	glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-
-	glRenderbufferStorage(
-		GL_RENDERBUFFER, 
-		GL_DEPTH_COMPONENT, 
-		window->getWidth(), 
-		window->getHeight());
-
-	glFramebufferRenderbuffer(
-		GL_FRAMEBUFFER, 
-		GL_DEPTH_ATTACHMENT, 
-		GL_RENDERBUFFER, 
-		rboDepth);
-
-	GLuint attachments[2] = 
-	{ 
-		GL_COLOR_ATTACHMENT0, 
-		GL_COLOR_ATTACHMENT1 
-	};
-
-	glDrawBuffers(2, attachments);
-
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-	{
-		std::cout << "HDR framebuffer not complete!" << std::endl;
-	}
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	// Render targets are allocated by the frame graph as the passes need them
+	frameGraph = new FrameGraph{};
 
 	// Setup rendering quad
 
@@ -324,77 +362,30 @@ void RenderingSystem::startUp()
 		1.0f, -1.0f, 0.0f,		1.0f, 0.0f,
 	};
 
-	glGenVertexArrays(1, &quadVAO);
-	glGenBuffers(1, &quadVBO);
+	quadVAO = device.createVertexArray();
+	quadVBO = device.createBuffer();
 
-	glBindVertexArray(quadVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+	state.bindVertexArray(quadVAO);
+	state.bindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	device.bufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
-	glEnableVertexAttribArray(0);
+	device.setAttribArrayEnabled(0, true);
 
-	glVertexAttribPointer(
+	device.vertexAttribPointer(
 		0, 
 		3, 
-		GL_FLOAT,
-		GL_FALSE, 
-		5 * sizeof(GL_FLOAT), 
-		(GLvoid*)0);
+		5 * sizeof(GLfloat), 
+		0);
 
-	glEnableVertexAttribArray(1);
+	device.setAttribArrayEnabled(1, true);
 
-	glVertexAttribPointer(
+	device.vertexAttribPointer(
 		1, 
 		2, 
-		GL_FLOAT,
-		GL_FALSE, 
 		5 * sizeof(GLfloat), 
-		(GLvoid*)(3 * sizeof(GLfloat)));
+		3 * sizeof(GLfloat));
 
-	glBindVertexArray(0);
-
-	//=========================================================================
-	// Bloom
-	//=========================================================================
-
-	glGenFramebuffers(2, pingpongFBO);
-	glGenTextures(2, pingpongColorbuffers);
-	for (int i = 0; i < 2; ++i)
-	{
-		glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i]);
-		glBindTexture(GL_TEXTURE_2D, pingpongColorbuffers[i]);
-
-		glTexImage2D(
-			GL_TEXTURE_2D, 
-			0, 
-			GL_RGB16F, 
-			window->getWidth(), 
-			window->getHeight(), 
-			0, 
-			GL_RGB, 
-			GL_FLOAT, 
-			NULL);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-		glFramebufferTexture2D(
-			GL_FRAMEBUFFER, 
-			GL_COLOR_ATTACHMENT0, 
-			GL_TEXTURE_2D, 
-			pingpongColorbuffers[i], 
-			0);
-
-		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-		{
-			std::cout << "PingPong FBO " << i << " not complete!" << std::endl;
-		}
-	}
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	state.bindVertexArray(0);
 }
 
 void RenderingSystem::shutDown()
@@ -403,30 +394,62 @@ void RenderingSystem::shutDown()
 	ev->removeSubscriber<KeyEvent>(this);
 	am->dispose<ShaderProgram>("simpleShader");
 	am->dispose<ShaderProgram>("depthShader");
+
+	delete instanceBuffer;
+	instanceBuffer = nullptr;
+
+	delete uniformRing;
+	uniformRing = nullptr;
+
+	delete frameGraph;
+	frameGraph = nullptr;
+
+	GraphicsDevice::get().deleteTexture(lightTexture);
+
+	delete lightBuffer;
+	lightBuffer = nullptr;
 }
 
 void RenderingSystem::update(float dt)
 {
-	glm::mat4 proj = glm::perspective(FOV, window->getAspectRatio(), NEAR_PLANE, FAR_PLANE);
+	// The other frame may still be rendering from its own copy
+	preparedFrame = 1 - preparedFrame;
+
+	RenderFrame& frame = frames[preparedFrame];
+
+	if (window)
+	{
+		frame.width = window->getWidth();
+		frame.height = window->getHeight();
+	}
+	else
+	{
+		frame.width = frameWidth;
+		frame.height = frameHeight;
+	}
 
-	glm::mat4 view;
-	glm::vec3 view_pos;
+	frame.proj = glm::perspective(FOV, static_cast<GLfloat>(frame.width) / static_cast<GLfloat>(frame.height), NEAR_PLANE, FAR_PLANE);
 
 	// This is hax
 	auto updateCamera = [&](EntityHandle entHandle, TransformComponent* tr, CameraComponent* ca)
 	{
-		view = ca->camera.getViewMatrix();
-		view_pos = tr->position;
+		frame.view = ca->camera.getViewMatrix();
+		frame.viewPos = tr->position;
 	};
 
 	em->each<TransformComponent, CameraComponent>(updateCamera);
 
-	ShaderProgram* shader = am->fetch<ShaderProgram>("simpleShader");
-	ShaderProgram* depthShader = am->fetch<ShaderProgram>("depthShader");
+	frame.shader = am->fetch<ShaderProgram>("simpleShader");
+	frame.depthShader = am->fetch<ShaderProgram>("depthShader");
+	frame.skyboxShader = am->fetch<ShaderProgram>("skyboxShader");
+	frame.bloomBlurShader = am->fetch<ShaderProgram>("bloomBlurShader");
+	frame.hdrShader = am->fetch<ShaderProgram>("hdrShader");
+	frame.skyboxTexture = am->fetch<Texture2D>("skybox");
+	frame.skyboxModel = am->fetch<RawModel>("skybox");
 
-	shader->uploadUniform("viewPos", view_pos);
+	frame.lights.clear();
 
-	std::vector<PointLight> lights;
+	std::vector<EntityHandle> lightEntities;
 
 	auto getLights = [&](EntityHandle entHandle, TransformComponent* tr, PointLightComponent* pl)
 	{
@@ -439,56 +462,683 @@ void RenderingSystem::update(float dt)
 		pl->linear,
 		pl->quadratic };
 
-		lights.push_back(pointLight);
+		frame.lights.push_back(pointLight);
+		lightEntities.push_back(entHandle);
 	};
 
 	em->each<TransformComponent, PointLightComponent>(getLights);
 
+	selectLights(frame.lights, lightEntities, frame.viewPos, frame.shadowLights);
+
+	// Only the most important lights have room for a shadow map
+	frame.shadowCount = std::min(frame.lights.size(), static_cast<size_t>(MAX_LIGHTS));
+
+	frame.shadowEntities.assign(lightEntities.begin(), lightEntities.begin() + frame.shadowCount);
+
+	//=========================================================================
+	// Draw lists
+	//=========================================================================
+
+	buildQueue(frame);
+
+	buildShadowTransforms(frame);
+
+	buildShadowLists(frame);
+
+	frame.hdr = hdr;
+	frame.bloom = bloom;
+	frame.exposure = exposure;
+	frame.gamma = gamma;
+
+	ui->record(frame.ui);
+}
+
+void RenderingSystem::render(size_t index)
+{
+	RenderFrame& frame = frames[index];
+
+	// Records the frame on its way to the device in use, when asked to
+	GraphicsDevice& device = GraphicsDevice::get();
+	RecordingDevice recorder{ &device };
+
+	bool capturing = captureFrame.exchange(false);
+
+	if (capturing)
+	{
+		GraphicsDevice::set(&recorder);
+	}
+
+	GLState& state = GLState::get();
+
+	// Anything may have changed the state since the last frame
+	state.beginFrame();
+
+	stats = RenderStats{};
+	stats.visible = frame.visible;
+	stats.culled = frame.culled;
+
+	ShaderProgram* shader = frame.shader;
+	size_t shadowCount = frame.shadowCount;
+
 	shader->use();
 
-	for (int i = 0; i < lights.size(); ++i)
+	uploadLights(frame);
+
+	std::vector<uint32_t> slots;
+
+	shadowScheduler.assign(frame.shadowEntities, slots);
+
+	for (size_t i = 0; i < shadowCount; ++i)
+	{
+		shadowScheduler.request(slots[i], frame.shadowLists[i].signature, frame.shadowLights[i].resolution, frame.shadowLights[i].priority);
+	}
+
+	std::vector<uint32_t> updates;
+
+	shadowScheduler.schedule(updates);
+
+	std::vector<bool> rerender(shadowCount, false);
+
+	for (size_t i = 0; i < shadowCount; ++i)
 	{
-		std::string name{ "lights[" };
-		name += std::to_string(i);
-		name += "]";
-		shader->uploadUniform(name, lights[i]);
+		if (std::find(updates.begin(), updates.end(), slots[i]) != updates.end())
+		{
+			rerender[i] = true;
+
+			buildBatches(frame, frame.shadowLists[i]);
+		}
 	}
 
-	shader->uploadUniform("numLights", static_cast<int>(lights.size()));
+	uploadInstances(frame);
+
+	writeUniforms(frame);
+
+	GLsizei width = frame.width;
+	GLsizei height = frame.height;
 
 	//=========================================================================
 	// Depth render pass
 	//=========================================================================
 
-	static constexpr GLfloat SHADOW_ASPECT = static_cast<GLfloat>(SHADOW_WIDTH) / static_cast<GLfloat>(SHADOW_HEIGHT);
+	auto shadowPass = [&]()
+	{
+		for (size_t i = 0; i < shadowCount; ++i)
+		{
+			uint32_t slot = slots[i];
 
-	glm::mat4 shadowProj = glm::perspective(glm::radians(90.f), SHADOW_ASPECT, SHADOW_NEAR_PLANE, SHADOW_FAR_PLANE);
+			// The cached map is still what this light would render
+			if (!rerender[i])
+			{
+				if (shadowScheduler.isRendered(slot))
+				{
+					++stats.shadowCached;
+				}
+
+				// Bind texture for next render pass
+				state.bindTexture(static_cast<GLuint>(i + 1), GL_TEXTURE_CUBE_MAP, depthMaps[slot]);
+
+				shader->uploadUniform(UNIFORM_DEPTH_MAPS[static_cast<uint32_t>(i)], static_cast<int>(i + 1));
+				continue;
+			}
+
+			GLuint resolution = shadowScheduler.getResolution(slot);
+
+			if (shadowScheduler.needsResize(slot))
+			{
+				// Unit of this light, so no other light's map is unbound
+				resizeShadowMap(slot, static_cast<GLuint>(i + 1), resolution);
+			}
+
+			state.bindFramebuffer(depthMapFBOs[slot]);
+			state.viewport(0, 0, resolution, resolution);
+			GraphicsDevice::get().clear(GL_DEPTH_BUFFER_BIT);
+			state.cullFace(GL_FRONT);
+
+			++stats.shadowUpdates;
+			stats.shadowCasters += static_cast<uint32_t>(frame.shadowLists[i].items.size());
+
+			for (int face = 0; face < 6; ++face)
+			{
+				if (frame.shadowLists[i].usedFaces & (1 << face))
+				{
+					++stats.shadowFaces;
+				}
+			}
+
+			// Nothing casts a shadow, the cleared map is all that is needed
+			if (!frame.shadowLists[i].items.empty())
+			{
+				// Shadow transforms and light position
+				uniformRing->bind(SHADOW_BLOCK_BINDING, shadowRanges[i]);
+
+				drawQueueDepth(frame, frame.shadowLists[i]);
+			}
+
+			shadowScheduler.markRendered(slot);
+
+			// Bind texture for next render pass
+			state.bindTexture(static_cast<GLuint>(i + 1), GL_TEXTURE_CUBE_MAP, depthMaps[slot]);
+
+			// Depth map for light i will be in texture unit i + 1
+			shader->uploadUniform(UNIFORM_DEPTH_MAPS[static_cast<uint32_t>(i)], static_cast<int>(i + 1));
+		}
+	};
 
-	auto renderTerrainDepth = [&](EntityHandle entHandle, TransformComponent* tr, TerrainComponent* te)
+	//=========================================================================
+	// Color render pass
+	//=========================================================================
+
+	auto colorPass = [&]()
 	{
-		//glm::mat4 model = glm::translate(glm::mat4{ 1.f }, tr->position);
+		shader->uploadUniform("textureUnit", 0);
+
+		GraphicsDevice::get().clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Draw Skybox
+
+		glm::mat4 skyboxModel = glm::translate(glm::mat4{ 1.f }, frame.viewPos);
+		glm::mat4 skyboxView = frame.view;
 
-		glm::mat4 model = tr->getPipeline().getModelTransform();
-		depthShader->uploadUniform("model", model);
+		skyboxView[0][3] = 0;
+		skyboxView[1][3] = 0;
+		skyboxView[2][3] = 0;
 
-		am->fetch<TerrainModel>(te->getID())->draw(*depthShader);
+		glm::mat4 skyboxTransform = frame.proj*skyboxView*skyboxModel;
+
+		ShaderProgram* skyboxShader = frame.skyboxShader;
+
+		skyboxShader->use();
+		skyboxShader->uploadUniform(UNIFORM_TRANSFORM, skyboxTransform);
+		skyboxShader->uploadUniform(UNIFORM_MODEL, skyboxModel);
+		skyboxShader->uploadUniform("texUnit", 0);
+
+		frame.skyboxTexture->bind(0);
+
+		state.setEnabled(GL_DEPTH_TEST, false);
+		state.cullFace(GL_FRONT);
+		frame.skyboxModel->draw();
+		state.cullFace(GL_BACK);
+		state.setEnabled(GL_DEPTH_TEST, true);
+
+		state.polygonMode(GL_FILL);
+
+		drawQueue(frame);
 	};
 
-	auto renderModelsDepth = [&](EntityHandle entHandle, TransformComponent* tr, ModelComponent* mc)
+	//=========================================================================
+	// Frame graph
+	//=========================================================================
+
+	frameGraph->reset();
+
+	FrameResource shadowMaps = frameGraph->importResource("shadow maps");
+	FrameResource screen = frameGraph->importResource("screen", 0, width, height);
+
+	FrameTextureDesc colorDesc{ width, height, GL_RGBA16F };
+
+	FrameResource sceneColor = frameGraph->createTexture("scene color", colorDesc);
+	FrameResource brightColor = frameGraph->createTexture("bright color", colorDesc);
+	FrameResource sceneDepth = frameGraph->createTexture("scene depth", FrameTextureDesc{ width, height, GL_DEPTH_COMPONENT24 });
+
+	// Same format as the bright color, so a blur target can take its memory
+	FrameResource blurTargets[2] = {
+		frameGraph->createTexture("blur 0", colorDesc),
+		frameGraph->createTexture("blur 1", colorDesc) };
+
+	frameGraph->addPass("shadow", shadowPass)
+		.write(shadowMaps);
+
+	frameGraph->addPass("color", colorPass)
+		.read(shadowMaps)
+		.write(sceneColor)
+		.write(brightColor)
+		.write(sceneDepth);
+
+	//=========================================================================
+	// Bloom render pass
+	//=========================================================================
+
+	ShaderProgram* bloomBlurShader = frame.bloomBlurShader;
+
+	// Blurs the bright color back and forth between the two targets,
+	// alternating horizontal and vertical
+	FrameResource blurred = brightColor;
+
+	for (GLuint i = 0; i < BLOOM_BLUR_PASSES; ++i)
 	{
-		//glm::mat4 model = glm::translate(glm::mat4{ 1.f }, tr->position);
+		bool horizontal = i % 2 == 0;
+
+		FrameResource source = blurred;
+		FrameResource target = blurTargets[horizontal];
+
+		auto blurPass = [this, bloomBlurShader, horizontal, source, &state]()
+		{
+			bloomBlurShader->use();
+			bloomBlurShader->uploadUniform("horizontal", horizontal);
+			bloomBlurShader->uploadUniform("image", 0);
+
+			state.bindTexture(0, GL_TEXTURE_2D, frameGraph->getTexture(source));
+
+			// Render Quad
+			state.bindVertexArray(quadVAO);
+			GraphicsDevice::get().drawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		};
+
+		frameGraph->addPass("bloom blur", blurPass)
+			.read(source)
+			.write(target);
 
-		glm::mat4 model = tr->getPipeline().getModelTransform();
-		depthShader->uploadUniform("model", model);
+		blurred = target;
+	}
 
-		am->fetch<RawModel>(mc->getID())->draw();
+	//=========================================================================
+	// Screen render pass
+	//=========================================================================
+
+	auto screenPass = [&]()
+	{
+		GraphicsDevice::get().clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		ShaderProgram* hdrShader = frame.hdrShader;
+
+		hdrShader->use();
+
+		// Bind Normal light buffer
+		state.bindTexture(0, GL_TEXTURE_2D, frameGraph->getTexture(sceneColor));
+		hdrShader->uploadUniform("hdrBuffer", 0);
+
+		// Bind the last blur target, which will contain the blurred bright image.
+		if (frame.bloom)
+		{
+			state.bindTexture(1, GL_TEXTURE_2D, frameGraph->getTexture(blurred));
+		}
+
+		hdrShader->uploadUniform("bloomBuffer", 1);
+
+		hdrShader->uploadUniform("hdr", frame.hdr);
+		hdrShader->uploadUniform("bloom", frame.bloom);
+		hdrShader->uploadUniform("exposure", frame.exposure);
+		hdrShader->uploadUniform("gamma", frame.gamma);
+
+		// Render the image on screen.
+		state.bindVertexArray(quadVAO);
+		GraphicsDevice::get().drawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	};
 
-	for (size_t i = 0; i < lights.size(); ++i)
+	FramePassBuilder screenBuilder = frameGraph->addPass("screen", screenPass);
+
+	screenBuilder
+		.read(sceneColor)
+		.write(screen);
+
+	// Without bloom nothing reads the blur, and its passes are culled
+	if (frame.bloom)
+	{
+		screenBuilder.read(blurred);
+	}
+
+	frameGraph->compile();
+	frameGraph->execute();
+
+	//=========================================================================
+	// User interface
+	//=========================================================================
+
+	state.setEnabled(GL_DEPTH_TEST, false);
+
+	ui->submit(frame.ui);
+
+	state.setEnabled(GL_DEPTH_TEST, true);
+
+	if (capturing)
+	{
+		GraphicsDevice::set(&device);
+
+		const RecordingStats& recorded = recorder.getStats();
+
+		std::cout << "Captured frame: " << recorded.commands << " commands, "
+			<< recorded.draws << " draws (" << recorded.instances << " instances), "
+			<< recorded.binds << " binds, "
+			<< recorded.stateChanges << " state changes, "
+			<< recorded.uniformUploads << " uniforms, "
+			<< recorded.bytesUploaded << " bytes uploaded, "
+			<< recorded.resourcesCreated << " resources created" << std::endl;
+
+		try
+		{
+			recorder.dump(CAPTURE_FILE);
+		}
+		catch (const RecordingDevice_error& ex)
+		{
+			std::cerr << ex.what() << std::endl;
+		}
+	}
+
+	if (reportRequested.exchange(false))
+	{
+		reportStats();
+	}
+}
+
+void RenderingSystem::reportStats()
+{
+	std::cout << "Draw calls: " << stats.drawCalls
+		<< " (" << stats.instancedDraws << " instanced, drawing " << stats.instances << " entities)" << std::endl;
+	std::cout << "State changes: " << stats.stateChanges
+		<< " (shader " << stats.shaderChanges
+		<< ", material " << stats.materialChanges
+		<< ", texture " << stats.textureChanges
+		<< ", mesh " << stats.meshChanges << ")" << std::endl;
+	std::cout << "Visible: " << stats.visible << " (" << stats.culled << " culled)" << std::endl;
+	std::cout << "Lights: " << stats.lights << " (" << stats.lightAssignments
+		<< " cluster assignments, at most " << stats.maxClusterLights << " per cluster)" << std::endl;
+	std::cout << "Shadow maps: " << stats.shadowUpdates << " rendered, " << stats.shadowCached << " cached" << std::endl;
+	std::cout << "Shadow casters: " << stats.shadowCasters
+		<< " (" << stats.shadowFaces << " cube faces)" << std::endl;
+	std::cout << "Triangles: " << stats.triangles
+		<< " (" << stats.shadowTriangles << " in shadow maps)" << std::endl;
+	std::cout << "GL state calls: " << GLState::get().getStats().issued << " issued, "
+		<< GLState::get().getStats().filtered << " filtered" << std::endl;
+
+	if (frameGraph)
 	{
-		std::vector<glm::mat4> shadowTransforms;
+		const FrameGraphStats& graphStats = frameGraph->getStats();
 
-		PointLight& light = lights[i];
+		std::cout << "Render passes: " << graphStats.passes - graphStats.culledPasses
+			<< " (" << graphStats.culledPasses << " culled)" << std::endl;
+
+		for (const FramePassReport& report : frameGraph->getPassReports())
+		{
+			if (report.culled)
+			{
+				std::cout << "  " << report.name << ": culled" << std::endl;
+			}
+			else
+			{
+				std::cout << "  " << report.name << ": " << report.time << " ms" << std::endl;
+			}
+		}
+
+		std::cout << "Render targets: " << graphStats.textures << " in " << graphStats.physicalTextures
+			<< " textures, " << graphStats.allocatedBytes / 1024 << " KB of "
+			<< graphStats.textureBytes / 1024 << " KB" << std::endl;
+	}
+}
+
+void RenderingSystem::buildQueue(RenderFrame& frame)
+{
+	RenderQueue& queue = frame.queue;
+	std::vector<DrawCall>& drawCalls = frame.drawCalls;
+
+	ShaderProgram* shader = frame.shader;
+	const glm::mat4& proj = frame.proj;
+	const glm::mat4& view = frame.view;
+
+	queue.clear();
+	drawCalls.clear();
+	frame.textures.clear();
+	textureSets.clear();
+	culler.clear();
+
+	uint32_t shaderID = shaderIDs.getID(shader);
+
+	// Looking up components and assets may change the entity and asset
+	// managers, so that is done here before the jobs start
+	drawSources.clear();
+
+	auto addSource = [&](EntityHandle entHandle, const TransformComponent* tr, RenderPass pass, RawModel* rawModel, TerrainModel* terrain)
+	{
+		// Static colliders never move, so the culler can keep them in its hierarchy
+		CollisionComponent* collision = em->getComponent<CollisionComponent>(entHandle);
+
+		auto lod = lodLevels.find(entHandle);
+
+		drawSources.push_back(DrawSource{
+			entHandle,
+			tr,
+			em->getComponent<TextureComponent>(entHandle),
+			em->getComponent<MaterialComponent>(entHandle),
+			rawModel,
+			terrain,
+			pass,
+			collision && collision->isStatic(),
+			lod != lodLevels.end() ? lod->second : 0 });
+	};
+
+	em->each<TransformComponent, TerrainComponent>([&](EntityHandle entHandle, TransformComponent* tr, TerrainComponent* te)
+	{
+		addSource(entHandle, tr, RENDER_PASS_TERRAIN, nullptr, am->fetch<TerrainModel>(te->getID()));
+	});
+
+	em->each<TransformComponent, ModelComponent>([&](EntityHandle entHandle, TransformComponent* tr, ModelComponent* mc)
+	{
+		addSource(entHandle, tr, RENDER_PASS_OPAQUE, am->fetch<RawModel>(mc->getID()), nullptr);
+	});
+
+	// Every chunk of sources is extracted into its own packets
+	size_t count = drawSources.size();
+
+	drawPackets.resize(JobSystem::getChunkCount(count, DRAW_GRAIN_SIZE));
+
+	JobSystem::get().parallelFor(count, DRAW_GRAIN_SIZE, [&](size_t begin, size_t end)
+	{
+		std::vector<DrawPacket>& packets = drawPackets[begin / DRAW_GRAIN_SIZE];
+
+		packets.resize(end - begin);
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			extractDraw(drawSources[i], shader, shaderID, proj, view, packets[i - begin]);
+		}
+	});
+
+	// Only entities drawn this frame are remembered
+	lodLevels.clear();
+
+	// Merging in chunk order gives the same queue as extracting on one thread
+	for (const std::vector<DrawPacket>& packets : drawPackets)
+	{
+		for (const DrawPacket& packet : packets)
+		{
+			uint32_t index = static_cast<uint32_t>(drawCalls.size());
+
+			uint64_t key = packet.resolved ? packet.key : resolveKey(packet, shaderID);
+
+			culler.add(index, packet.draw.center, packet.draw.radius, packet.isStatic);
+			queue.push(key, index);
+			drawCalls.push_back(packet.draw);
+
+			addTextures(frame, packet.textures, RenderQueue::getTexture(key), drawCalls.back());
+
+			if (packet.draw.rawModel)
+			{
+				lodLevels[packet.entity] = packet.draw.lod;
+			}
+		}
+	}
+
+	queue.sort();
+
+	visibleDraws.clear();
+
+	culler.cull(Frustum::fromMatrix(proj * view), visibleDraws);
+
+	for (uint32_t index : visibleDraws)
+	{
+		drawCalls[index].visible = true;
+	}
+
+	frame.visible = culler.getStats().visible;
+	frame.culled = culler.getStats().culled;
+
+	// Filtering keeps the key order, so the color list stays sorted
+	frame.colorList.items.clear();
+
+	for (const RenderItem& item : queue.getItems())
+	{
+		if (drawCalls[item.payload].visible)
+		{
+			frame.colorList.items.push_back(item);
+		}
+	}
+
+	frame.instanceModels.clear();
+
+	buildBatches(frame, frame.colorList);
+}
+
+void RenderingSystem::extractDraw(const DrawSource& source, ShaderProgram* shader, uint32_t shaderID, const glm::mat4& proj, const glm::mat4& view, DrawPacket& packet) const
+{
+	TransformPipeline3D pipe = source.transform->getPipeline();
+
+	pipe.setProj(proj);
+	pipe.setView(view);
+
+	DrawCall& draw = packet.draw;
+
+	draw.transform = pipe.getMVP();
+	draw.model = pipe.getModelTransform();
+	draw.shader = shader;
+	draw.material = source.material ? source.material->material : defaultMaterial;
+	draw.firstTexture = 0;
+	draw.textureCount = 0;
+	draw.rawModel = source.rawModel;
+	draw.terrain = source.terrain;
+	draw.lod = 0;
+	draw.shadowLod = 0;
+	draw.visible = false;
+
+	// Bounding sphere in world space, scaled by the largest axis scale
+	glm::vec3 localCenter;
+	float localRadius;
+
+	if (source.rawModel)
+	{
+		localCenter = source.rawModel->getBoundsCenter();
+		localRadius = source.rawModel->getBoundsRadius();
+	}
+	else
+	{
+		localCenter = source.terrain->getBounds().getCenter();
+		localRadius = glm::length(source.terrain->getBounds().max - source.terrain->getBounds().min) * 0.5f;
+	}
+
+	float scale = glm::max(
+		glm::length(glm::vec3{ draw.model[0] }),
+		glm::max(glm::length(glm::vec3{ draw.model[1] }), glm::length(glm::vec3{ draw.model[2] })));
+
+	draw.center = glm::vec3{ draw.model * glm::vec4{ localCenter, 1.f } };
+	draw.radius = localRadius * scale;
+
+	if (source.rawModel)
+	{
+		float distance = glm::length(glm::vec3{ view * glm::vec4{ draw.center, 1.f } });
+
+		// Inside the bounding sphere the model covers the whole screen
+		float screenSize = distance > draw.radius ? draw.radius * proj[1][1] / distance : 1.f;
+
+		uint32_t lodCount = source.rawModel->getLodCount();
+
+		draw.lod = selectLod(screenSize, source.lod, lodCount);
+		draw.shadowLod = glm::min(draw.lod + SHADOW_LOD_BIAS, lodCount - 1);
+	}
+
+	// Front to back within the same state
+	packet.depth = -(view * glm::vec4{ source.transform->position, 1.f }).z / FAR_PLANE;
+	packet.pass = source.pass;
+	packet.isStatic = source.isStatic;
+	packet.textures = source.textures;
+	packet.entity = source.entity;
+
+	// Resources seen for the first time get their ids after the merge
+	uint32_t material;
+	uint32_t texture;
+	uint32_t mesh;
+
+	packet.resolved =
+		materialIDs.find(materialValues(draw.material), material) &&
+		textureIDs.find(source.textures ? source.textures->textureMap : NO_TEXTURES, texture) &&
+		meshIDs.find(draw.getMesh(), mesh);
+
+	packet.key = packet.resolved ? RenderQueue::makeKey(source.pass, shaderID, material, texture, mesh, packet.depth) : 0;
+}
+
+uint32_t RenderingSystem::selectLod(float screenSize, uint32_t current, uint32_t lodCount) const
+{
+	uint32_t lod = glm::min(current, lodCount - 1);
+
+	while (lod > 0 && screenSize > LOD_SCREEN_SIZES[lod - 1] * (1.f + LOD_HYSTERESIS))
+	{
+		--lod;
+	}
+
+	while (lod + 1 < lodCount && screenSize < LOD_SCREEN_SIZES[lod] * (1.f - LOD_HYSTERESIS))
+	{
+		++lod;
+	}
+
+	return lod;
+}
+
+uint64_t RenderingSystem::resolveKey(const DrawPacket& packet, uint32_t shaderID)
+{
+	return RenderQueue::makeKey(
+		packet.pass,
+		shaderID,
+		materialIDs.getID(materialValues(packet.draw.material)),
+		textureIDs.getID(packet.textures ? packet.textures->textureMap : NO_TEXTURES),
+		meshIDs.getID(packet.draw.getMesh()),
+		packet.depth);
+}
+
+void RenderingSystem::addTextures(RenderFrame& frame, const TextureComponent* textures, uint32_t textureID, DrawCall& draw)
+{
+	// A shared id may stand for several sets, so those are never reused
+	bool shared = textureIDs.isShared(textureID);
+
+	if (!shared)
+	{
+		auto it = textureSets.find(textureID);
+
+		if (it != textureSets.end())
+		{
+			draw.firstTexture = it->second.first;
+			draw.textureCount = it->second.second;
+			return;
+		}
+	}
+
+	draw.firstTexture = static_cast<uint32_t>(frame.textures.size());
+	draw.textureCount = 0;
+
+	if (textures)
+	{
+		for (auto it : textures->textureMap)
+		{
+			frame.textures.push_back(TextureBinding{ it.first, am->fetch<Texture2D>(it.second) });
+			++draw.textureCount;
+		}
+	}
+
+	if (!shared)
+	{
+		textureSets.emplace(textureID, std::make_pair(draw.firstTexture, draw.textureCount));
+	}
+}
+
+void RenderingSystem::buildShadowTransforms(RenderFrame& frame)
+{
+	static constexpr GLfloat SHADOW_ASPECT = static_cast<GLfloat>(SHADOW_WIDTH) / static_cast<GLfloat>(SHADOW_HEIGHT);
+
+	glm::mat4 shadowProj = glm::perspective(glm::radians(90.f), SHADOW_ASPECT, SHADOW_NEAR_PLANE, SHADOW_FAR_PLANE);
+
+	std::vector<glm::mat4>& shadowTransforms = frame.shadowTransforms;
+
+	shadowTransforms.clear();
+
+	for (size_t i = 0; i < frame.shadowCount; ++i)
+	{
+		const PointLight& light = frame.lights[i];
 
 		// Positive x Direction
 		shadowTransforms.push_back(
@@ -537,222 +1187,499 @@ void RenderingSystem::update(float dt)
 				light.getPosition() + glm::vec3(0.0, 0.0, -1.0), // Center
 				glm::vec3(0.0, -1.0, 0.0) // Up
 			));
+	}
+}
+
+void RenderingSystem::buildShadowLists(RenderFrame& frame)
+{
+	// Every light only writes its own list, so the lights are culled in parallel
+	JobSystem::get().parallelFor(frame.shadowCount, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			buildShadowList(frame, frame.shadowLists[i], frame.lights[i], &frame.shadowTransforms[i * 6]);
+		}
+	});
+}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBOs[i]);
-		glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-		glClear(GL_DEPTH_BUFFER_BIT);
-		glCullFace(GL_FRONT);
+void RenderingSystem::buildShadowList(const RenderFrame& frame, DrawList& list, const PointLight& light, const glm::mat4* shadowTransforms) const
+{
+	list.items.clear();
+	list.faceMasks.clear();
+	list.usedFaces = 0;
+
+	glm::vec3 lightPosition = light.getPosition();
+
+	// Shadows further away than the light reaches are never seen
+	float range = glm::min(light.calculateRange(SHADOW_ATTENUATION_CUTOFF), SHADOW_FAR_PLANE);
+
+	// The map only has to be rendered again if anything in here changes
+	list.signature = ShadowScheduler::hash(ShadowScheduler::HASH_SEED, &lightPosition, sizeof(lightPosition));
+	list.signature = ShadowScheduler::hash(list.signature, &range, sizeof(range));
+
+	Frustum faces[6];
+
+	for (int face = 0; face < 6; ++face)
+	{
+		faces[face] = Frustum::fromMatrix(shadowTransforms[face]);
+	}
 
-		// Upload shadow transforms
-		for (int j = 0; j < 6; ++j)
+	// Filtering keeps the key order, so every list stays sorted
+	for (const RenderItem& item : frame.queue.getItems())
+	{
+		const DrawCall& draw = frame.drawCalls[item.payload];
+
+		if (glm::length(draw.center - lightPosition) - draw.radius > range)
+		{
+			continue;
+		}
+
+		uint32_t faceMask = 0;
+
+		for (int face = 0; face < 6; ++face)
+		{
+			if (faces[face].intersectsSphere(draw.center, draw.radius))
+			{
+				faceMask |= 1 << face;
+			}
+		}
+
+		if (faceMask == 0)
 		{
-			depthShader->uploadUniform(std::string("shadowMatrices[") + std::to_string(j) + std::string("]"), shadowTransforms[j]);
+			continue;
 		}
 
-		depthShader->uploadUniform("far_plane", SHADOW_FAR_PLANE);
-		shader->uploadUniform("far_plane", SHADOW_FAR_PLANE);
-		depthShader->uploadUniform("lightPos", light.getPosition());
+		list.items.push_back(item);
+		list.faceMasks.push_back(faceMask);
 
-		em->each<TransformComponent, TerrainComponent>(renderTerrainDepth);
-		em->each<TransformComponent, ModelComponent>(renderModelsDepth);
+		list.usedFaces |= faceMask;
 
-		// Bind texture for next render pass
-		glActiveTexture(GL_TEXTURE1 + i);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, depthMaps[i]);
+		const void* mesh = draw.getMesh().first;
 
-		// Depth map for light i will be in texture unit i + 1
-		shader->uploadUniform(std::string("depthMaps[") + std::to_string(i) + std::string("]"), static_cast<int>(i + 1));
-		shader->uploadUniform("textureUnit", 0);
+		list.signature = ShadowScheduler::hash(list.signature, &draw.model, sizeof(draw.model));
+		list.signature = ShadowScheduler::hash(list.signature, &mesh, sizeof(mesh));
+		list.signature = ShadowScheduler::hash(list.signature, &draw.shadowLod, sizeof(draw.shadowLod));
+		list.signature = ShadowScheduler::hash(list.signature, &faceMask, sizeof(faceMask));
 	}
+}
 
-	//=========================================================================
-	// Color render pass
-	//=========================================================================
-	
-	// Set Framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+void RenderingSystem::selectLights(std::vector<PointLight>& lights, std::vector<EntityHandle>& entities, glm::vec3 cameraPosition, std::vector<ShadowLight>& shadowLights)
+{
+	std::vector<size_t> order(lights.size());
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	shadowLights.resize(lights.size());
 
-	glViewport(0, 0, window->getWidth(), window->getHeight());
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		const PointLight& light = lights[i];
 
-	// Draw Skybox
+		float range = glm::min(light.calculateRange(SHADOW_ATTENUATION_CUTOFF), SHADOW_FAR_PLANE);
+		float distance = glm::length(light.getPosition() - cameraPosition);
 
-	glm::mat4 skyboxModel = glm::translate(glm::mat4{ 1.f }, view_pos);
-	glm::mat4 skyboxView = view;
+		// Rough fraction of the screen covered by the lit area
+		float size = glm::min(range / glm::max(distance, NEAR_PLANE), 1.f);
 
-	skyboxView[0][3] = 0;
-	skyboxView[1][3] = 0;
-	skyboxView[2][3] = 0;
+		glm::vec3 diffuse = light.getDiffuse();
 
-	glm::mat4 skyboxTransform = proj*skyboxView*skyboxModel;
+		float intensity = glm::max(diffuse.x, glm::max(diffuse.y, diffuse.z));
 
-	ShaderProgram* skyboxShader = am->fetch<ShaderProgram>("skyboxShader");
-	Texture2D* skyboxTexture = am->fetch<Texture2D>("skybox");
-	RawModel* skyboxRawModel = am->fetch<RawModel>("skybox");
+		// Lights covering less of the screen get smaller maps
+		GLuint resolution = SHADOW_WIDTH;
 
-	skyboxShader->use();
-	skyboxShader->uploadUniform("transform", skyboxTransform);
-	skyboxShader->uploadUniform("model", skyboxModel);
-	skyboxShader->uploadUniform("texUnit", 0);
-	
-	skyboxTexture->bind(0);
+		for (float threshold = 0.5f; resolution > SHADOW_MIN_RESOLUTION && size < threshold; threshold *= 0.5f)
+		{
+			resolution /= 2;
+		}
 
-	glDisable(GL_DEPTH_TEST);
-	glCullFace(GL_FRONT);
-	skyboxRawModel->draw();
-	glCullFace(GL_BACK);
-	glEnable(GL_DEPTH_TEST);
+		shadowLights[i] = ShadowLight{ intensity * size, resolution };
+		order[i] = i;
+	}
 
-	auto renderTerrain = [&](EntityHandle entHandle, TransformComponent* tr, TerrainComponent* te)
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
 	{
-		shader->use();
-		TransformPipeline3D pipe = tr->getPipeline();
+		return shadowLights[a].priority > shadowLights[b].priority;
+	});
+
+	std::vector<PointLight> selectedLights;
+	std::vector<EntityHandle> selectedEntities;
+	std::vector<ShadowLight> selectedShadowLights;
+
+	for (size_t index : order)
+	{
+		selectedLights.push_back(lights[index]);
+		selectedEntities.push_back(entities[index]);
+		selectedShadowLights.push_back(shadowLights[index]);
+	}
+
+	lights.swap(selectedLights);
+	entities.swap(selectedEntities);
+	shadowLights.swap(selectedShadowLights);
+}
+
+void RenderingSystem::uploadLights(const RenderFrame& frame)
+{
+	clusters.build(frame.lights, static_cast<uint32_t>(frame.shadowCount), frame.view, frame.proj, NEAR_PLANE, FAR_PLANE, LIGHT_ATTENUATION_CUTOFF);
+
+	const std::vector<glm::vec4>& data = clusters.getData();
 
-		pipe.setProj(proj);
-		pipe.setView(view);
+	// One upload for all lights, the texture buffer follows the new storage
+	lightBuffer->storeData(static_cast<GLuint>(data.size() * sizeof(glm::vec4)), data.data(), GL_STREAM_DRAW);
 
-		shader->uploadUniform("transform", pipe.getMVP());
-		shader->uploadUniform("model", pipe.getModelTransform());
+	GLState::get().bindTexture(LIGHT_DATA_UNIT, GL_TEXTURE_BUFFER, lightTexture);
 
-		TextureComponent* tex = em->getComponent<TextureComponent>(entHandle);
+	frame.shader->uploadUniform("lightData", static_cast<int>(LIGHT_DATA_UNIT));
 
-		if (tex)
+	stats.lights = clusters.getStats().lights;
+	stats.lightAssignments = clusters.getStats().assignments;
+	stats.maxClusterLights = clusters.getStats().maxPerCluster;
+}
+
+void RenderingSystem::writeUniforms(RenderFrame& frame)
+{
+	size_t shadowCount = frame.shadowCount;
+
+	writeFrameBlock(frame);
+
+	for (size_t i = 0; i < shadowCount; ++i)
+	{
+		writeShadowBlock(shadowBlocks[i], frame.lights[i], &frame.shadowTransforms[i * 6]);
+	}
+
+	writeMaterialBlocks(frame);
+
+	GLuint size = uniformRing->getAlignedSize(frameBlock.getSize());
+
+	for (size_t i = 0; i < shadowCount; ++i)
+	{
+		size += uniformRing->getAlignedSize(shadowBlocks[i].getSize());
+	}
+
+	for (const Std140Block& block : materialBlocks)
+	{
+		size += uniformRing->getAlignedSize(block.getSize());
+	}
+
+	// Everything is copied at once, draws only bind offsets into the ring
+	uniformRing->begin(size);
+
+	frameRange = uniformRing->write(frameBlock);
+
+	for (size_t i = 0; i < shadowCount; ++i)
+	{
+		shadowRanges[i] = uniformRing->write(shadowBlocks[i]);
+	}
+
+	materialRanges.clear();
+
+	for (const Std140Block& block : materialBlocks)
+	{
+		materialRanges.push_back(uniformRing->write(block));
+	}
+
+	uniformRing->end();
+
+	uniformRing->bind(FRAME_BLOCK_BINDING, frameRange);
+}
+
+void RenderingSystem::writeFrameBlock(const RenderFrame& frame)
+{
+	// Same order as the FrameBlock declaration in the shaders
+	frameBlock.clear();
+	frameBlock.push(frame.view);
+	frameBlock.push(frame.proj * frame.view);
+	frameBlock.push(frame.viewPos);
+	frameBlock.push(NEAR_PLANE);
+	frameBlock.push(glm::vec2{ frame.width, frame.height });
+	frameBlock.push(FAR_PLANE);
+	frameBlock.push(SHADOW_FAR_PLANE);
+	frameBlock.push(static_cast<int>(clusters.getClusterOffset()));
+	frameBlock.push(static_cast<int>(clusters.getIndexOffset()));
+}
+
+void RenderingSystem::writeShadowBlock(Std140Block& block, const PointLight& light, const glm::mat4* shadowTransforms)
+{
+	// Same order as the ShadowBlock declaration in the depth shader
+	block.clear();
+	block.push(shadowTransforms, 6);
+	block.push(light);
+}
+
+void RenderingSystem::writeMaterialBlocks(RenderFrame& frame)
+{
+	size_t count = 0;
+
+	const Material* last = nullptr;
+
+	for (DrawBatch& batch : frame.colorList.batches)
+	{
+		const Material* material = &frame.drawCalls[frame.colorList.items[batch.first].payload].material;
+
+		// Batches are sorted by material, so equal ones follow each other
+		if (!last || !equalMaterials(*last, *material))
 		{
-			for (auto it : tex->textureMap)
+			if (materialBlocks.size() <= count)
 			{
-				//am->fetch<Texture2D>(it.second)->bind(it.first);
-				am->fetch<Texture2D>(it.second)->bind(0);
+				materialBlocks.emplace_back();
 			}
-		}
 
-		MaterialComponent* mat = em->getComponent<MaterialComponent>(entHandle);
+			materialBlocks[count].clear();
+			materialBlocks[count].push(*material);
 
-		if (mat)
-		{
-			shader->uploadUniform("material", mat->material);
-		}
-		else
-		{
-			shader->uploadUniform("material", defaultMaterial);
+			++count;
 		}
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		batch.materialBlock = static_cast<uint32_t>(count - 1);
 
-		am->fetch<TerrainModel>(te->getID())->draw(*shader);
-	};
+		last = material;
+	}
+
+	materialBlocks.resize(count);
+}
 
-	auto renderModels = [&](EntityHandle entHandle, TransformComponent* tr, ModelComponent* mc)
+void RenderingSystem::resizeShadowMap(uint32_t slot, GLuint unit, GLuint resolution)
+{
+	GLState::get().bindTexture(unit, GL_TEXTURE_CUBE_MAP, depthMaps[slot]);
+
+	for (GLenum face = 0; face < 6; ++face)
 	{
-		shader->use();
-		TransformPipeline3D pipe = tr->getPipeline();
+		GraphicsDevice::get().texImage2D(
+			GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+			GL_DEPTH_COMPONENT32,
+			resolution,
+			resolution,
+			GL_DEPTH_COMPONENT,
+			GL_FLOAT,
+			nullptr);
+	}
+}
 
-		pipe.setProj(proj);
-		pipe.setView(view);
+void RenderingSystem::uploadInstances(const RenderFrame& frame)
+{
+	// Uploaded once and used by both the shadow and the color passes
+	if (!frame.instanceModels.empty())
+	{
+		instanceBuffer->storeData(
+			static_cast<GLuint>(frame.instanceModels.size() * sizeof(glm::mat4)),
+			frame.instanceModels.data(),
+			GL_STREAM_DRAW);
+	}
+}
+
+void RenderingSystem::buildBatches(RenderFrame& frame, DrawList& list)
+{
+	const std::vector<DrawCall>& drawCalls = frame.drawCalls;
+	std::vector<glm::mat4>& instanceModels = frame.instanceModels;
+
+	list.batches.clear();
 
-		shader->uploadUniform("transform", pipe.getMVP());
-		shader->uploadUniform("model", pipe.getModelTransform());
+	const std::vector<RenderItem>& items = list.items;
+
+	uint32_t count = static_cast<uint32_t>(items.size());
+
+	for (uint32_t i = 0; i < count;)
+	{
+		uint64_t key = items[i].key;
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		const DrawCall& draw = drawCalls[items[i].payload];
 
-		TextureComponent* tex = em->getComponent<TextureComponent>(entHandle);
+		// Shared ids can not tell if two draws really use the same resources
+		bool batchable = draw.rawModel &&
+			!shaderIDs.isShared(RenderQueue::getShader(key)) &&
+			!materialIDs.isShared(RenderQueue::getMaterial(key)) &&
+			!textureIDs.isShared(RenderQueue::getTexture(key)) &&
+			!meshIDs.isShared(RenderQueue::getMesh(key));
 
-		if (tex)
+		uint32_t end = i + 1;
+
+		if (batchable)
 		{
-			for (auto it : tex->textureMap)
+			while (end < count && RenderQueue::getState(items[end].key) == RenderQueue::getState(key))
 			{
-				am->fetch<Texture2D>(it.second)->bind(it.first);
+				++end;
 			}
 		}
 
-		MaterialComponent* mat = em->getComponent<MaterialComponent>(entHandle);
+		DrawBatch batch{ i, end - i, 0, end - i >= MIN_INSTANCES, ALL_FACES, 0 };
 
-		if (mat)
+		if (!list.faceMasks.empty())
 		{
-			shader->uploadUniform("material", mat->material);
+			batch.faceMask = 0;
+
+			for (uint32_t j = i; j < end; ++j)
+			{
+				batch.faceMask |= list.faceMasks[j];
+			}
 		}
-		else
+
+		if (batch.instanced)
 		{
-			shader->uploadUniform("material", defaultMaterial);
+			batch.instanceOffset = static_cast<uint32_t>(instanceModels.size());
+
+			for (uint32_t j = i; j < end; ++j)
+			{
+				instanceModels.push_back(drawCalls[items[j].payload].model);
+			}
 		}
 
-		am->fetch<RawModel>(mc->getID())->draw();
-	};
+		list.batches.push_back(batch);
 
-	em->each<TransformComponent, TerrainComponent>(renderTerrain);
-	em->each<TransformComponent, ModelComponent>(renderModels);
+		i = end;
+	}
+}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void RenderingSystem::drawQueue(const RenderFrame& frame)
+{
+	const std::vector<DrawCall>& drawCalls = frame.drawCalls;
+	const DrawList& colorList = frame.colorList;
+	const std::vector<RenderItem>& items = colorList.items;
 
-	//=========================================================================
-	// Bloom render pass
-	//=========================================================================
+	uint64_t lastKey{ 0 };
+	bool first{ true };
+	bool instanced{ false };
 
-	ShaderProgram* bloomBlurShader = am->fetch<ShaderProgram>("bloomBlurShader");
+	for (const DrawBatch& batch : colorList.batches)
+	{
+		uint64_t key = items[batch.first].key;
 
-	bloomBlurShader->use();
+		const DrawCall& draw = drawCalls[items[batch.first].payload];
 
-	GLboolean horizontal = true;
-	GLboolean first_iteration = true;
+		uint32_t shaderID = RenderQueue::getShader(key);
+		uint32_t materialID = RenderQueue::getMaterial(key);
+		uint32_t textureID = RenderQueue::getTexture(key);
+		uint32_t meshID = RenderQueue::getMesh(key);
 
-	GLuint amount = 10;
+		// Shared ids may stand for another resource than the previous draw
+		bool shaderChanged = first || shaderID != RenderQueue::getShader(lastKey) || shaderIDs.isShared(shaderID);
+		bool materialChanged = shaderChanged || materialID != RenderQueue::getMaterial(lastKey) || materialIDs.isShared(materialID);
+		bool textureChanged = first || textureID != RenderQueue::getTexture(lastKey) || textureIDs.isShared(textureID);
+		bool meshChanged = first || meshID != RenderQueue::getMesh(lastKey) || meshIDs.isShared(meshID);
 
-	for (GLuint i = 0; i < amount; ++i)
-	{
-		// Bind the pingpong framebuffer.
-		glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[horizontal]);
-		bloomBlurShader->uploadUniform("horizontal", horizontal);
-		bloomBlurShader->uploadUniform("image", 0);
-		glActiveTexture(GL_TEXTURE0);
+		if (shaderChanged)
+		{
+			draw.shader->use();
+			draw.shader->uploadUniform(UNIFORM_INSTANCED, batch.instanced);
+			instanced = batch.instanced;
+			++stats.shaderChanges;
+		}
+
+		if (materialChanged)
+		{
+			uniformRing->bind(MATERIAL_BLOCK_BINDING, materialRanges[batch.materialBlock]);
+			++stats.materialChanges;
+		}
+
+		if (textureChanged && draw.textureCount > 0)
+		{
+			for (uint32_t i = draw.firstTexture; i < draw.firstTexture + draw.textureCount; ++i)
+			{
+				// Terrain samples everything from unit 0
+				frame.textures[i].texture->bind(draw.terrain ? 0 : frame.textures[i].unit);
+			}
+
+			++stats.textureChanges;
+		}
+
+		if (meshChanged)
+		{
+			++stats.meshChanges;
+		}
 
-		// Bind the Colorbuffer the first time, and the other pingpong buffer
-		// all subsequent times.
-		glBindTexture(
-			GL_TEXTURE_2D, 
-			first_iteration ? colorBuffers[1] : pingpongColorbuffers[!horizontal]);
+		if (batch.instanced != instanced)
+		{
+			draw.shader->uploadUniform(UNIFORM_INSTANCED, batch.instanced);
+			instanced = batch.instanced;
+		}
 
-		// Render Quad
-		glBindVertexArray(quadVAO);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-		glBindVertexArray(0);
+		if (batch.instanced)
+		{
+			draw.rawModel->drawInstanced(*instanceBuffer, batch.instanceOffset, batch.count, draw.lod);
 
-		// Switch direction of Blur pass
-		horizontal = !horizontal;
+			++stats.drawCalls;
+			++stats.instancedDraws;
+			stats.instances += batch.count;
+			stats.triangles += draw.rawModel->getTriangleCount(draw.lod) * batch.count;
+		}
+		else
+		{
+			for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+			{
+				const DrawCall& single = drawCalls[items[i].payload];
+
+				single.shader->uploadUniform(UNIFORM_TRANSFORM, single.transform);
+				single.shader->uploadUniform(UNIFORM_MODEL, single.model);
+
+				if (single.rawModel)
+				{
+					single.rawModel->draw(single.lod);
+					stats.triangles += single.rawModel->getTriangleCount(single.lod);
+				}
+				else
+				{
+					single.terrain->draw(*single.shader);
+				}
+
+				++stats.drawCalls;
+			}
+		}
 
-		// Indicate that we want to use pingpong buffer as source instead of source image.
-		if (first_iteration)
-			first_iteration = false;
+		lastKey = key;
+		first = false;
 	}
 
-	//=========================================================================
-	// Screen render pass
-	//=========================================================================
+	stats.stateChanges = stats.shaderChanges + stats.materialChanges + stats.textureChanges + stats.meshChanges;
+}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void RenderingSystem::drawQueueDepth(const RenderFrame& frame, const DrawList& list)
+{
+	const std::vector<DrawCall>& drawCalls = frame.drawCalls;
+	const std::vector<RenderItem>& items = list.items;
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	ShaderProgram* depthShader = frame.depthShader;
 
-	ShaderProgram* hdrShader = am->fetch<ShaderProgram>("hdrShader");
+	// Uploads of unchanged uniforms no longer bind the program
+	depthShader->use();
 
-	hdrShader->use();
+	bool instanced{ false };
 
-	// Bind Normal light buffer
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, colorBuffers[0]);
-	hdrShader->uploadUniform("hdrBuffer", 0);
+	depthShader->uploadUniform(UNIFORM_INSTANCED, instanced);
 
-	// Bind the last pingpong buffer, which will contain the blurred bright image.
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, pingpongColorbuffers[!horizontal]);
-	hdrShader->uploadUniform("bloomBuffer", 1);
+	for (const DrawBatch& batch : list.batches)
+	{
+		if (batch.instanced != instanced)
+		{
+			instanced = batch.instanced;
+			depthShader->uploadUniform(UNIFORM_INSTANCED, instanced);
+		}
+
+		if (batch.instanced)
+		{
+			// Every instance goes to the faces any of them touches
+			depthShader->uploadUniform(UNIFORM_FACE_MASK, static_cast<int>(batch.faceMask));
 
-	hdrShader->uploadUniform("hdr", hdr);
-	hdrShader->uploadUniform("bloom", bloom);
-	hdrShader->uploadUniform("exposure", exposure);
-	hdrShader->uploadUniform("gamma", gamma);
+			// Draws of one batch share the color level, and with it the shadow level
+			const DrawCall& draw = drawCalls[items[batch.first].payload];
+
+			draw.rawModel->drawInstanced(*instanceBuffer, batch.instanceOffset, batch.count, draw.shadowLod);
+			stats.shadowTriangles += draw.rawModel->getTriangleCount(draw.shadowLod) * batch.count;
+			continue;
+		}
+
+		for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+		{
+			const DrawCall& draw = drawCalls[items[i].payload];
 
-	// Render the image on screen.
-	glBindVertexArray(quadVAO);
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-	glBindVertexArray(0);
+			depthShader->uploadUniform(UNIFORM_MODEL, draw.model);
+			depthShader->uploadUniform(UNIFORM_FACE_MASK, static_cast<int>(list.faceMasks[i]));
+
+			if (draw.rawModel)
+			{
+				draw.rawModel->draw(draw.shadowLod);
+				stats.shadowTriangles += draw.rawModel->getTriangleCount(draw.shadowLod);
+			}
+			else
+			{
+				draw.terrain->draw(*depthShader);
+			}
+		}
+	}
 }
@@ -12,9 +12,133 @@
 #include "KeyEvent.h"
 #include "Camera.h"
 #include "Window.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "ShadowScheduler.h"
+#include "LightClusters.h"
+#include "UniformRing.h"
+#include "FrameGraph.h"
+#include "TextureComponent.h"
+#include "PointLight.h"
+
+#include <vector>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <string>
+#include <atomic>
+#include <cstdint>
 
 #define MAX_LIGHTS 8
 
+class TerrainModel;
+class Texture2D;
+class TransformComponent;
+class MaterialComponent;
+
+/**
+ * @brief Statistics from the last rendered frame.
+ */
+struct RenderStats
+{
+	/**
+	 * @brief Number of draw calls in the color pass.
+	 */
+	uint32_t drawCalls{ 0 };
+
+	/**
+	 * @brief Number of those draw calls that were instanced.
+	 */
+	uint32_t instancedDraws{ 0 };
+
+	/**
+	 * @brief Number of entities drawn by instanced draw calls.
+	 */
+	uint32_t instances{ 0 };
+
+	/**
+	 * @brief Number of times the shader was changed.
+	 */
+	uint32_t shaderChanges{ 0 };
+
+	/**
+	 * @brief Number of times the material was uploaded.
+	 */
+	uint32_t materialChanges{ 0 };
+
+	/**
+	 * @brief Number of times the textures were bound.
+	 */
+	uint32_t textureChanges{ 0 };
+
+	/**
+	 * @brief Number of times the mesh was changed.
+	 */
+	uint32_t meshChanges{ 0 };
+
+	/**
+	 * @brief Total number of state changes.
+	 */
+	uint32_t stateChanges{ 0 };
+
+	/**
+	 * @brief Number of entities inside the view frustum.
+	 */
+	uint32_t visible{ 0 };
+
+	/**
+	 * @brief Number of entities outside the view frustum.
+	 */
+	uint32_t culled{ 0 };
+
+	/**
+	 * @brief Number of lights in the scene.
+	 */
+	uint32_t lights{ 0 };
+
+	/**
+	 * @brief Number of light indices over all clusters.
+	 */
+	uint32_t lightAssignments{ 0 };
+
+	/**
+	 * @brief Largest number of lights shading one cluster.
+	 */
+	uint32_t maxClusterLights{ 0 };
+
+	/**
+	 * @brief Number of shadow maps rendered.
+	 */
+	uint32_t shadowUpdates{ 0 };
+
+	/**
+	 * @brief Number of shadow maps reused from an earlier frame.
+	 */
+	uint32_t shadowCached{ 0 };
+
+	/**
+	 * @brief Number of shadow casters drawn, summed over all rendered maps.
+	 */
+	uint32_t shadowCasters{ 0 };
+
+	/**
+	 * @brief Number of shadow cube faces with any caster, summed over all rendered maps.
+	 */
+	uint32_t shadowFaces{ 0 };
+
+	/**
+	 * @brief Number of model triangles drawn in the color pass.
+	 */
+	uint32_t triangles{ 0 };
+
+	/**
+	 * @brief Number of model triangles drawn into shadow maps, summed over
+	 * all rendered maps.
+	 */
+	uint32_t shadowTriangles{ 0 };
+};
+
 /**
  * @brief System for rendering stuff to screen
  */
@@ -28,6 +152,14 @@ public:
 	 */
 	explicit RenderingSystem(Window* window);
 
+	/**
+	 * @brief Constructor for rendering without a window, like into a
+	 * RecordingDevice.
+	 * @param width Width of the frames.
+	 * @param height Height of the frames.
+	 */
+	RenderingSystem(GLuint width, GLuint height);
+
 	/**
 	 * @brief Key Event Handler
 	 * @param ev Key Event
@@ -45,13 +177,34 @@ public:
 	virtual void shutDown() override;
 
 	/**
-	 * @brief Update the system, accounting for time dt
+	 * @brief Update the system, accounting for time dt. Prepares the next
+	 * frame from the entities without using OpenGL.
 	 * @param dt Time delta
 	 */
 	virtual void update(float dt) override;
 
 	/**
-	 * @brief Pointer to window.
+	 * @brief Gets the frame prepared by the last update.
+	 * @return Index of the frame.
+	 */
+	size_t getPreparedFrame() const { return preparedFrame; }
+
+	/**
+	 * @brief Renders a prepared frame and its UI, on the thread the context
+	 * is current on. Only the frame is read, not the entities, so the next
+	 * frame may be prepared at the same time.
+	 * @param frame Index of the frame.
+	 */
+	void render(size_t frame);
+
+	/**
+	 * @brief Gets the statistics of the last frame.
+	 * @return Statistics.
+	 */
+	const RenderStats& getStats() const { return stats; }
+
+	/**
+	 * @brief Pointer to window, nullptr when rendering without one.
 	 */
 	Window* window;
 
@@ -72,6 +225,801 @@ public:
 
 private:
 
+	/**
+	 * @brief A mesh and its level of detail.
+	 */
+	typedef std::pair<const void*, uint32_t> MeshLevel;
+
+	/**
+	 * @brief Data of a draw in the render queue.
+	 */
+	struct DrawCall
+	{
+		/**
+		 * @brief Model view projection matrix.
+		 */
+		glm::mat4 transform;
+
+		/**
+		 * @brief Model matrix.
+		 */
+		glm::mat4 model;
+
+		/**
+		 * @brief Shader to draw with.
+		 */
+		ShaderProgram* shader;
+
+		/**
+		 * @brief Material to draw with, copied so the component may change
+		 * while the frame renders.
+		 */
+		Material material{ glm::vec3{}, glm::vec3{}, glm::vec3{}, 0.f };
+
+		/**
+		 * @brief Index of the first texture to bind in the textures of the frame.
+		 */
+		uint32_t firstTexture;
+
+		/**
+		 * @brief Number of textures to bind.
+		 */
+		uint32_t textureCount;
+
+		/**
+		 * @brief Model to draw, nullptr for terrain.
+		 */
+		RawModel* rawModel;
+
+		/**
+		 * @brief Terrain to draw, nullptr for models.
+		 */
+		TerrainModel* terrain;
+
+		/**
+		 * @brief Level of detail of the model in the color pass.
+		 */
+		uint32_t lod;
+
+		/**
+		 * @brief Level of detail of the model in the shadow maps.
+		 */
+		uint32_t shadowLod;
+
+		/**
+		 * @brief Center of the bounding sphere in world space.
+		 */
+		glm::vec3 center;
+
+		/**
+		 * @brief Radius of the bounding sphere in world space.
+		 */
+		float radius;
+
+		/**
+		 * @brief Whether the draw is inside the view frustum.
+		 */
+		bool visible;
+
+		/**
+		 * @brief Gets the mesh drawn, identifying it in the sort keys.
+		 * @return The model or the terrain, and the level of detail.
+		 */
+		MeshLevel getMesh() const
+		{
+			return rawModel ? MeshLevel{ rawModel, lod } : MeshLevel{ terrain, 0 };
+		}
+	};
+
+	/**
+	 * @brief Components of an entity to draw, gathered before the draws are
+	 * extracted in parallel.
+	 */
+	struct DrawSource
+	{
+		/**
+		 * @brief The entity.
+		 */
+		EntityHandle entity;
+
+		/**
+		 * @brief Transform of the entity.
+		 */
+		const TransformComponent* transform;
+
+		/**
+		 * @brief Textures, nullptr for none.
+		 */
+		const TextureComponent* textures;
+
+		/**
+		 * @brief Material, nullptr for the default material.
+		 */
+		const MaterialComponent* material;
+
+		/**
+		 * @brief Model to draw, nullptr for terrain.
+		 */
+		RawModel* rawModel;
+
+		/**
+		 * @brief Terrain to draw, nullptr for models.
+		 */
+		TerrainModel* terrain;
+
+		/**
+		 * @brief Pass the draw belongs to.
+		 */
+		RenderPass pass;
+
+		/**
+		 * @brief Whether the entity is a static collider that never moves.
+		 */
+		bool isStatic;
+
+		/**
+		 * @brief Level of detail the model was drawn with last frame.
+		 */
+		uint32_t lod;
+	};
+
+	/**
+	 * @brief A draw extracted by a job, merged into the render queue on the
+	 * render thread.
+	 */
+	struct DrawPacket
+	{
+		/**
+		 * @brief Data of the draw.
+		 */
+		DrawCall draw;
+
+		/**
+		 * @brief Entity drawn.
+		 */
+		EntityHandle entity;
+
+		/**
+		 * @brief Textures of the entity, nullptr for none.
+		 */
+		const TextureComponent* textures;
+
+		/**
+		 * @brief Sort key, only valid if resolved.
+		 */
+		uint64_t key;
+
+		/**
+		 * @brief View depth, kept for keys built after the merge.
+		 */
+		float depth;
+
+		/**
+		 * @brief Pass the draw belongs to.
+		 */
+		RenderPass pass;
+
+		/**
+		 * @brief Whether the draw goes into the static part of the culler.
+		 */
+		bool isStatic;
+
+		/**
+		 * @brief Whether all resources of the draw had ids, so the key could
+		 * be built by the job.
+		 */
+		bool resolved;
+	};
+
+	/**
+	 * @brief Draws next to each other in the sorted queue that share all state.
+	 */
+	struct DrawBatch
+	{
+		/**
+		 * @brief Index of the first draw in the queue.
+		 */
+		uint32_t first;
+
+		/**
+		 * @brief Number of draws.
+		 */
+		uint32_t count;
+
+		/**
+		 * @brief Index of the first model matrix in the instance buffer.
+		 */
+		uint32_t instanceOffset;
+
+		/**
+		 * @brief Whether the batch is drawn with one instanced draw call.
+		 */
+		bool instanced;
+
+		/**
+		 * @brief Shadow cube faces touched by any draw of the batch, one bit per face.
+		 */
+		uint32_t faceMask;
+
+		/**
+		 * @brief Index of the material block in materialRanges, only set in
+		 * the color pass.
+		 */
+		uint32_t materialBlock;
+	};
+
+	/**
+	 * @brief Sorted draws of one pass and their batches.
+	 */
+	struct DrawList
+	{
+		/**
+		 * @brief Draws in key order.
+		 */
+		std::vector<RenderItem> items;
+
+		/**
+		 * @brief Batches of items.
+		 */
+		std::vector<DrawBatch> batches;
+
+		/**
+		 * @brief Shadow cube faces touched by every item, empty outside the
+		 * shadow pass.
+		 */
+		std::vector<uint32_t> faceMasks;
+
+		/**
+		 * @brief Shadow cube faces touched by any item.
+		 */
+		uint32_t usedFaces;
+
+		/**
+		 * @brief Hash of the light and everything drawn into its shadow map.
+		 */
+		uint64_t signature;
+	};
+
+	/**
+	 * @brief How a light's shadow is scheduled.
+	 */
+	struct ShadowLight
+	{
+		/**
+		 * @brief Importance, from the intensity and the screen area lit.
+		 */
+		float priority;
+
+		/**
+		 * @brief Shadow map resolution.
+		 */
+		GLuint resolution;
+	};
+
+	/**
+	 * @brief A texture bound by a draw.
+	 */
+	struct TextureBinding
+	{
+		/**
+		 * @brief Texture unit.
+		 */
+		GLuint unit;
+
+		/**
+		 * @brief The texture.
+		 */
+		Texture2D* texture;
+	};
+
+	/**
+	 * @brief Everything needed to render a frame, prepared from the entities.
+	 *
+	 * A frame is written by update() and then only read by render(), apart
+	 * from the batches and instances of the shadow lists it decides to draw.
+	 * There are two frames, so one can be prepared while the other renders.
+	 */
+	struct RenderFrame
+	{
+		/**
+		 * @brief Projection matrix.
+		 */
+		glm::mat4 proj;
+
+		/**
+		 * @brief View matrix.
+		 */
+		glm::mat4 view;
+
+		/**
+		 * @brief Position of the camera.
+		 */
+		glm::vec3 viewPos;
+
+		/**
+		 * @brief Width of the window.
+		 */
+		GLsizei width;
+
+		/**
+		 * @brief Height of the window.
+		 */
+		GLsizei height;
+
+		/**
+		 * @brief Shader of the color pass.
+		 */
+		ShaderProgram* shader;
+
+		/**
+		 * @brief Shader of the shadow pass.
+		 */
+		ShaderProgram* depthShader;
+
+		/**
+		 * @brief Shader of the skybox.
+		 */
+		ShaderProgram* skyboxShader;
+
+		/**
+		 * @brief Shader of the bloom blur.
+		 */
+		ShaderProgram* bloomBlurShader;
+
+		/**
+		 * @brief Shader of the screen pass.
+		 */
+		ShaderProgram* hdrShader;
+
+		/**
+		 * @brief Texture of the skybox.
+		 */
+		Texture2D* skyboxTexture;
+
+		/**
+		 * @brief Model of the skybox.
+		 */
+		RawModel* skyboxModel;
+
+		/**
+		 * @brief The lights, sorted in priority order.
+		 */
+		std::vector<PointLight> lights;
+
+		/**
+		 * @brief Number of lights, from the first, with a shadow map.
+		 */
+		size_t shadowCount;
+
+		/**
+		 * @brief Entity of every light with a shadow map.
+		 */
+		std::vector<EntityHandle> shadowEntities;
+
+		/**
+		 * @brief Shadow schedule of every light.
+		 */
+		std::vector<ShadowLight> shadowLights;
+
+		/**
+		 * @brief Projection times view matrix of every cube face, six per
+		 * light with a shadow map.
+		 */
+		std::vector<glm::mat4> shadowTransforms;
+
+		/**
+		 * @brief Draws sorted by state.
+		 */
+		RenderQueue queue;
+
+		/**
+		 * @brief Data of every draw in the queue.
+		 */
+		std::vector<DrawCall> drawCalls;
+
+		/**
+		 * @brief Textures bound by the draws.
+		 */
+		std::vector<TextureBinding> textures;
+
+		/**
+		 * @brief Draws inside the view frustum, for the color pass.
+		 */
+		DrawList colorList;
+
+		/**
+		 * @brief Shadow casters of every light, which may be outside the view.
+		 */
+		DrawList shadowLists[MAX_LIGHTS];
+
+		/**
+		 * @brief Model matrices of the instanced batches of the draw lists.
+		 */
+		std::vector<glm::mat4> instanceModels;
+
+		/**
+		 * @brief Number of entities inside the view frustum.
+		 */
+		uint32_t visible;
+
+		/**
+		 * @brief Number of entities outside the view frustum.
+		 */
+		uint32_t culled;
+
+		/**
+		 * @brief Whether to use HDR.
+		 */
+		bool hdr;
+
+		/**
+		 * @brief Whether to use bloom.
+		 */
+		bool bloom;
+
+		/**
+		 * @brief HDR exposure parameter.
+		 */
+		float exposure;
+
+		/**
+		 * @brief HDR gamma parameter.
+		 */
+		float gamma;
+
+		/**
+		 * @brief The UI drawn on top.
+		 */
+		userinterface::UIDrawList ui;
+	};
+
+	/**
+	 * @brief Fills the render queue of a frame with all entities and culls
+	 * them against the view frustum.
+	 * @param frame The frame, with the shader and matrices set.
+	 */
+	void buildQueue(RenderFrame& frame);
+
+	/**
+	 * @brief Computes the matrices, bounds and sort key of a draw. Only
+	 * reads the system, so it is run by several jobs at once.
+	 * @param source Components of the entity.
+	 * @param shader Shader used for the color pass.
+	 * @param shaderID Id of the shader.
+	 * @param proj Projection matrix.
+	 * @param view View matrix.
+	 * @param packet Packet to fill.
+	 */
+	void extractDraw(const DrawSource& source, ShaderProgram* shader, uint32_t shaderID, const glm::mat4& proj, const glm::mat4& view, DrawPacket& packet) const;
+
+	/**
+	 * @brief Picks the level of detail of a model from its size on screen.
+	 * A level only changes once the size is past the threshold by the
+	 * hysteresis, so a model at a threshold does not switch every frame.
+	 * @param screenSize Part of the screen height covered by the bounding sphere.
+	 * @param current Level drawn last frame.
+	 * @param lodCount Number of levels of the model.
+	 * @return The level.
+	 */
+	uint32_t selectLod(float screenSize, uint32_t current, uint32_t lodCount) const;
+
+	/**
+	 * @brief Builds the sort key of a draw, giving new resources ids.
+	 * @param packet The draw.
+	 * @param shaderID Id of the shader.
+	 * @return The key.
+	 */
+	uint64_t resolveKey(const DrawPacket& packet, uint32_t shaderID);
+
+	/**
+	 * @brief Adds the textures of a draw to a frame. Draws with the same
+	 * texture set share their bindings.
+	 * @param frame The frame.
+	 * @param textures Textures of the entity, nullptr for none.
+	 * @param textureID Id of the texture set.
+	 * @param draw The draw, pointed to its bindings.
+	 */
+	void addTextures(RenderFrame& frame, const TextureComponent* textures, uint32_t textureID, DrawCall& draw);
+
+	/**
+	 * @brief Ranks the lights. Lights that are close to the camera, bright
+	 * and light a large part of the screen come first and get the largest
+	 * shadow maps. Only the first MAX_LIGHTS get a shadow map at all.
+	 * @param lights The lights, sorted in priority order.
+	 * @param entities Entity of every light, kept in step with lights.
+	 * @param cameraPosition Position of the camera.
+	 * @param shadowLights Shadow schedule of every light.
+	 */
+	void selectLights(std::vector<PointLight>& lights, std::vector<EntityHandle>& entities, glm::vec3 cameraPosition, std::vector<ShadowLight>& shadowLights);
+
+	/**
+	 * @brief Computes the cube face matrices of every light with a shadow map.
+	 * @param frame The frame, with the lights set.
+	 */
+	void buildShadowTransforms(RenderFrame& frame);
+
+	/**
+	 * @brief Bins the lights into clusters and uploads them with one buffer.
+	 * @param frame The frame.
+	 */
+	void uploadLights(const RenderFrame& frame);
+
+	/**
+	 * @brief Lays out all uniform blocks of the frame and writes them to the
+	 * uniform ring in one go. Needs the light clusters and the color batches.
+	 * @param frame The frame.
+	 */
+	void writeUniforms(RenderFrame& frame);
+
+	/**
+	 * @brief Lays out the FrameBlock of the shaders.
+	 * @param frame The frame.
+	 */
+	void writeFrameBlock(const RenderFrame& frame);
+
+	/**
+	 * @brief Lays out the ShadowBlock of the depth shader for a light.
+	 * @param block Block to fill.
+	 * @param light The light.
+	 * @param shadowTransforms Projection times view matrix of the six cube faces.
+	 */
+	void writeShadowBlock(Std140Block& block, const PointLight& light, const glm::mat4* shadowTransforms);
+
+	/**
+	 * @brief Lays out one MaterialBlock per run of color batches with the
+	 * same material and points the batches to them.
+	 * @param frame The frame.
+	 */
+	void writeMaterialBlocks(RenderFrame& frame);
+
+	/**
+	 * @brief Reallocates a shadow map, binding it to the given unit.
+	 * @param slot Slot of the map.
+	 * @param unit Texture unit to bind the map to.
+	 * @param resolution New resolution of every face.
+	 */
+	void resizeShadowMap(uint32_t slot, GLuint unit, GLuint resolution);
+
+	/**
+	 * @brief Selects the shadow casters of every light. A caster must be
+	 * within range of the light, and is only sent to the cube faces it
+	 * touches.
+	 * @param frame The frame, with the queue and shadow transforms built.
+	 */
+	void buildShadowLists(RenderFrame& frame);
+
+	/**
+	 * @brief Selects the shadow casters of one light. Only reads the render
+	 * queue, so the lights are done by several jobs at once.
+	 * @param frame The frame.
+	 * @param list Draw list of the light.
+	 * @param light The light.
+	 * @param shadowTransforms Projection times view matrix of the six cube faces.
+	 */
+	void buildShadowList(const RenderFrame& frame, DrawList& list, const PointLight& light, const glm::mat4* shadowTransforms) const;
+
+	/**
+	 * @brief Uploads the model matrices of all instanced batches.
+	 * @param frame The frame.
+	 */
+	void uploadInstances(const RenderFrame& frame);
+
+	/**
+	 * @brief Groups a sorted draw list into batches and adds the model
+	 * matrices of the instanced ones to the instances of the frame.
+	 * @param frame The frame.
+	 * @param list The draw list.
+	 */
+	void buildBatches(RenderFrame& frame, DrawList& list);
+
+	/**
+	 * @brief Draws the visible part of the render queue, only changing state
+	 * when the key of a batch differs from the previous one.
+	 * @param frame The frame.
+	 */
+	void drawQueue(const RenderFrame& frame);
+
+	/**
+	 * @brief Draws the shadow casters of a light with the depth shader.
+	 * @param frame The frame.
+	 * @param list Shadow casters of the light.
+	 */
+	void drawQueueDepth(const RenderFrame& frame, const DrawList& list);
+
+	/**
+	 * @brief Prints the statistics of the last rendered frame.
+	 */
+	void reportStats();
+
+	/**
+	 * @brief Frames prepared by update and rendered by render.
+	 */
+	RenderFrame frames[2];
+
+	/**
+	 * @brief Index of the frame prepared last.
+	 */
+	size_t preparedFrame{ 0 };
+
+	/**
+	 * @brief Entities to draw this frame, in the order they were gathered.
+	 */
+	std::vector<DrawSource> drawSources{};
+
+	/**
+	 * @brief Draws extracted by every job, one vector per chunk of
+	 * drawSources so they can be merged in a fixed order.
+	 */
+	std::vector<std::vector<DrawPacket>> drawPackets{};
+
+	/**
+	 * @brief First binding and number of bindings of every texture set
+	 * added to the frame being prepared, by id.
+	 */
+	std::map<uint32_t, std::pair<uint32_t, uint32_t>> textureSets{};
+
+	/**
+	 * @brief Level of detail every model was drawn with in the frame
+	 * prepared last.
+	 */
+	std::unordered_map<EntityHandle, uint32_t> lodLevels{};
+
+	/**
+	 * @brief Decides which shadow maps are rendered again.
+	 */
+	ShadowScheduler shadowScheduler{ MAX_LIGHTS, SHADOW_UPDATE_BUDGET };
+
+	/**
+	 * @brief Culls the draws against the view frustum.
+	 */
+	FrustumCuller culler{};
+
+	/**
+	 * @brief Indices of the draws found visible by the culler.
+	 */
+	std::vector<uint32_t> visibleDraws{};
+
+	/**
+	 * @brief Buffer holding the instances of the frame on the GPU.
+	 */
+	VertexBufferObject* instanceBuffer{ nullptr };
+
+	/**
+	 * @brief Lights of the current frame binned into view clusters.
+	 */
+	LightClusters clusters{};
+
+	/**
+	 * @brief Buffer holding the packed lights and clusters.
+	 */
+	VertexBufferObject* lightBuffer{ nullptr };
+
+	/**
+	 * @brief Buffer texture reading lightBuffer.
+	 */
+	GLuint lightTexture{};
+
+	/**
+	 * @brief Uniform blocks of the frames in flight.
+	 */
+	UniformRing* uniformRing{ nullptr };
+
+	/**
+	 * @brief Per frame constants shared by all shaders.
+	 */
+	Std140Block frameBlock{};
+
+	/**
+	 * @brief Shadow matrices and light of every light with a shadow map.
+	 */
+	Std140Block shadowBlocks[MAX_LIGHTS];
+
+	/**
+	 * @brief Materials of the color pass.
+	 */
+	std::vector<Std140Block> materialBlocks{};
+
+	/**
+	 * @brief Where frameBlock is in the uniform ring this frame.
+	 */
+	UniformRange frameRange{};
+
+	/**
+	 * @brief Where shadowBlocks are in the uniform ring this frame.
+	 */
+	UniformRange shadowRanges[MAX_LIGHTS];
+
+	/**
+	 * @brief Where materialBlocks are in the uniform ring this frame.
+	 */
+	std::vector<UniformRange> materialRanges{};
+
+	/**
+	 * @brief Binding of the FrameBlock uniform block.
+	 */
+	static constexpr GLuint FRAME_BLOCK_BINDING{ 0 };
+
+	/**
+	 * @brief Binding of the ShadowBlock uniform block.
+	 */
+	static constexpr GLuint SHADOW_BLOCK_BINDING{ 1 };
+
+	/**
+	 * @brief Binding of the MaterialBlock uniform block.
+	 */
+	static constexpr GLuint MATERIAL_BLOCK_BINDING{ 2 };
+
+	/**
+	 * @brief Initial size of every region of the uniform ring, grown when
+	 * a frame needs more.
+	 */
+	static constexpr GLuint UNIFORM_RING_SIZE{ 64 * 1024 };
+
+	/**
+	 * @brief Texture unit of the light buffer, after the shadow maps.
+	 */
+	static constexpr GLuint LIGHT_DATA_UNIT{ MAX_LIGHTS + 1 };
+
+	/**
+	 * @brief Attenuation below which a light does not shade a cluster.
+	 */
+	static constexpr GLfloat LIGHT_ATTENUATION_CUTOFF{ 1.f / 256.f };
+
+	/**
+	 * @brief Entities extracted by one job.
+	 */
+	static constexpr size_t DRAW_GRAIN_SIZE{ 64 };
+
+	/**
+	 * @brief Smallest batch drawn with instancing.
+	 */
+	static constexpr uint32_t MIN_INSTANCES{ 2 };
+
+	/**
+	 * @brief Number of gaussian blur passes of the bloom, alternating
+	 * horizontal and vertical.
+	 */
+	static constexpr GLuint BLOOM_BLUR_PASSES{ 10 };
+
+	/**
+	 * @brief Part of a level of detail threshold the screen size has to
+	 * pass it by before the level changes.
+	 */
+	static constexpr float LOD_HYSTERESIS{ 0.15f };
+
+	/**
+	 * @brief Levels coarser than the color pass that models are drawn with
+	 * in the shadow maps.
+	 */
+	static constexpr uint32_t SHADOW_LOD_BIAS{ 1 };
+
+	/**
+	 * @brief Ids of the shaders in the sort keys.
+	 */
+	RenderIdTable<const ShaderProgram*> shaderIDs{ RenderQueue::SHADER_MAX };
+
+	/**
+	 * @brief Ids of the materials in the sort keys, by value so that equal
+	 * materials of different entities can be instanced together.
+	 */
+	RenderIdTable<std::array<float, 10>> materialIDs{ RenderQueue::MATERIAL_MAX };
+
+	/**
+	 * @brief Ids of the texture sets in the sort keys.
+	 */
+	RenderIdTable<std::map<GLuint, std::string>> textureIDs{ RenderQueue::TEXTURE_MAX };
+
+	/**
+	 * @brief Ids of the meshes in the sort keys. Every level of detail of a
+	 * model is a mesh of its own, so only draws of the same level batch.
+	 */
+	RenderIdTable<MeshLevel> meshIDs{ RenderQueue::MESH_MAX };
+
+	/**
+	 * @brief Statistics of the last frame.
+	 */
+	RenderStats stats{};
+
 	/**
 	 * @brief Default material, which will be used if MaterialComponent not is present.
 	 */
@@ -83,7 +1031,7 @@ private:
 	};
 
 	/**
-	 * @brief Width of shadow texture
+	 * @brief Width of shadow texture, the resolution of the most important lights
 	 */
 	static constexpr GLuint SHADOW_WIDTH{ 512 };
 
@@ -92,6 +1040,16 @@ private:
 	 */
 	static constexpr GLuint SHADOW_HEIGHT{ 512 };
 
+	/**
+	 * @brief Smallest shadow map resolution
+	 */
+	static constexpr GLuint SHADOW_MIN_RESOLUTION{ 128 };
+
+	/**
+	 * @brief Largest number of shadow maps rendered per frame
+	 */
+	static constexpr uint32_t SHADOW_UPDATE_BUDGET{ 2 };
+
 	/**
 	 * @brief Shadow projection near plane
 	 */
@@ -102,6 +1060,17 @@ private:
 	 */
 	static constexpr GLfloat SHADOW_FAR_PLANE{ 250.f };
 
+	/**
+	 * @brief Attenuation below which a light is too weak for its shadows
+	 * to be seen.
+	 */
+	static constexpr GLfloat SHADOW_ATTENUATION_CUTOFF{ 1.f / 256.f };
+
+	/**
+	 * @brief Face mask with all six cube faces.
+	 */
+	static constexpr uint32_t ALL_FACES{ (1 << 6) - 1 };
+
 	/**
 	 * @brief Light depth frame buffer objects
 	 */
@@ -113,19 +1082,19 @@ private:
 	GLuint depthMaps[MAX_LIGHTS];
 
 	/**
-	 * @brief HDR framebuffer object
+	 * @brief Passes of the frame and the render targets between them.
 	 */
-	GLuint hdrFBO{};
+	FrameGraph* frameGraph{ nullptr };
 
 	/**
-	 * @brief Renderbuffer for depth
+	 * @brief Size of the frames without a window.
 	 */
-	GLuint rboDepth{};
+	GLuint frameWidth{ 0 };
 
 	/**
-	 * @brief HDR color buffers
+	 * @brief Size of the frames without a window.
 	 */
-	GLuint colorBuffers[2];
+	GLuint frameHeight{ 0 };
 
 	/**
 	 * @brief Vertex array object for screen rendering quad.
@@ -137,16 +1106,6 @@ private:
 	 */
 	GLuint quadVBO{};
 
-	/**
-	 * @brief PingPong framebuffer for multipass gaussian blur.
-	 */
-	GLuint pingpongFBO[2];
-
-	/**
-	 * @brief PingPong color buffer for multipass gaussian blur.
-	 */
-	GLuint pingpongColorbuffers[2];
-
 	/**
 	 * @brief Whether to use HDR
 	 */
@@ -166,4 +1125,15 @@ private:
 	 * @brief HDR gamma parameter
 	 */
 	float gamma{ 2.2f };
+
+	/**
+	 * @brief Whether the commands of the next frame are recorded and written
+	 * to a file. Set by key events, cleared by the render thread.
+	 */
+	std::atomic<bool> captureFrame{ false };
+
+	/**
+	 * @brief Whether the statistics are printed after the next frame.
+	 */
+	std::atomic<bool> reportRequested{ false };
 };
@@ -0,0 +1,49 @@
+/**
+ * @file	RigidBodyComponent.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Rigid body component
+ */
+
+#include "RigidBodyComponent.h"
+#include "Utils.h"
+
+#include <sstream>
+#include <string>
+
+RigidBodyComponent::RigidBodyComponent(rapidxml::xml_node<>* node)
+{
+	if (rapidxml::xml_node<>* massNode = node->first_node("mass"))
+	{
+		mass = std::stof(massNode->value());
+	}
+
+	if (rapidxml::xml_node<>* velocityNode = node->first_node("velocity"))
+	{
+		std::stringstream ss{ velocityNode->value() };
+
+		ss >> velocity;
+	}
+
+	if (rapidxml::xml_node<>* restitutionNode = node->first_node("restitution"))
+	{
+		restitution = std::stof(restitutionNode->value());
+	}
+
+	if (rapidxml::xml_node<>* frictionNode = node->first_node("friction"))
+	{
+		friction = std::stof(frictionNode->value());
+	}
+
+	if (rapidxml::xml_node<>* dampingNode = node->first_node("damping"))
+	{
+		damping = std::stof(dampingNode->value());
+	}
+
+	if (rapidxml::xml_node<>* gravityNode = node->first_node("gravity"))
+	{
+		std::string value{ gravityNode->value() };
+
+		useGravity = value == "true" || value == "1";
+	}
+}
@@ -0,0 +1,81 @@
+/**
+ * @file	RigidBodyComponent.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Rigid body component
+ */
+
+#pragma once
+
+#include "Component.h"
+
+#include <rapidxml/rapidxml.hpp>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Makes an entity with a transform and a collider move under the
+ * PhysicsSystem.
+ *
+ * Bodies are simulated without rotation, the collider shape only decides
+ * where they touch.
+ */
+class RigidBodyComponent : public Component
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param mass Mass of the body, 0 for a body only moved by its velocity.
+	 * @param velocity Initial velocity.
+	 * @param restitution Bounciness, 0 to 1.
+	 * @param friction Friction coefficient.
+	 * @param useGravity Whether gravity pulls the body.
+	 */
+	explicit RigidBodyComponent(float mass = 1.f, glm::vec3 velocity = glm::vec3{}, float restitution = 0.f, float friction = 0.5f, bool useGravity = true)
+		: mass(mass), velocity(velocity), restitution(restitution), friction(friction), useGravity(useGravity) {}
+
+	/**
+	 * @brief Constructor from xml.
+	 *
+	 * Reads the optional nodes <mass>, <velocity>, <restitution>,
+	 * <friction>, <damping> and <gravity>.
+	 *
+	 * @param node The xml node.
+	 */
+	explicit RigidBodyComponent(rapidxml::xml_node<>* node);
+
+	/**
+	 * @brief Mass of the body, 0 for a body only moved by its velocity.
+	 */
+	float mass{ 1.f };
+
+	/**
+	 * @brief Velocity in units per second.
+	 */
+	glm::vec3 velocity{};
+
+	/**
+	 * @brief Bounciness, 0 to 1.
+	 */
+	float restitution{ 0.f };
+
+	/**
+	 * @brief Friction coefficient.
+	 */
+	float friction{ 0.5f };
+
+	/**
+	 * @brief Fraction of the velocity lost per second.
+	 */
+	float damping{ 0.05f };
+
+	/**
+	 * @brief Whether gravity pulls the body.
+	 */
+	bool useGravity{ true };
+
+	/**
+	 * @brief Whether the body is simulated. Set by the PhysicsSystem, clear
+	 * it to put the body to sleep or set it to wake the body up.
+	 */
+	bool awake{ true };
+};
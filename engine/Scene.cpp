@@ -6,10 +6,18 @@
 #include "MaterialComponent.h"
 #include "ProjectileMovement.h"
 #include "ProjectileComponent.h"
+#include "RigidBodyComponent.h"
+#include "PhysicsSystem.h"
 #include <ctime>
+#include <iostream>
 
 
 Scene::Scene(AssetManager* AM, Window* window) :
+	broadphase{ nullptr },
+	broadphaseType{ BroadphaseType::AABB_TREE },
+	nextBroadphaseType{ BroadphaseType::AABB_TREE },
+	broadphaseTotals{},
+	broadphaseFrames{ 0 },
 	asM{ AM },
 	enM{ nullptr },
 	evM{ nullptr },
@@ -18,9 +26,9 @@ Scene::Scene(AssetManager* AM, Window* window) :
 	evM = new EventManager{};
 	uiM = new userinterface::UIManager(window->getWidth(), window->getHeight());
 	enM = new EntityManager{ evM, asM, uiM };
-	quadtree = new Quadtree{enM, evM, glm::vec2{100, 100}, 300, 300};
+	broadphase = createBroadphase(broadphaseType);
 
-	evM->addSubscriber<CollisionEvent>(this);
+	evM->addSubscriber<CollisionBeginEvent>(this);
 	evM->addSubscriber<KeyEvent>(this);
 
 	enM->registerComponent<CollisionComponent>("CollisionComponent");
@@ -33,29 +41,51 @@ Scene::Scene(AssetManager* AM, Window* window) :
 	enM->registerComponent<PointLightComponent>("PointLightComponent");
 	enM->registerComponent<MaterialComponent>("MaterialComponent");
 	enM->registerComponent<ProjectileComponent>("ProjectileComponent");
+	enM->registerComponent<RigidBodyComponent>("RigidBodyComponent");
 
-	// Detta tar hand om instansiering och snt.
+	// Detta tar hand om instansiering och sånt.
 	enM->registerSystem<CameraController>();
 	enM->registerSystem<RenderingSystem>(window);
 	enM->registerSystem<ProjectileMovement>();
+	enM->registerSystem<PhysicsSystem>();
 }
 
 Scene::~Scene()
 {
+	// The broadphase unsubscribes and detaches its components on destruction
+	delete broadphase;
 	delete enM;
-	delete quadtree;
 	delete evM;
 	delete uiM;
 }
 
-void Scene::handleEvent(const CollisionEvent& ev)
+void Scene::handleEvent(const CollisionBeginEvent& ev)
 {
 
 }
 
 void Scene::handleEvent(const KeyEvent & ev)
 {
-	if (!(ev.action == 2 && ev.key == GLFW_KEY_F)) return;
+	if (ev.action != 2) return;
+
+	if (ev.key == GLFW_KEY_G)
+	{
+		switch (broadphaseType)
+		{
+		case BroadphaseType::QUADTREE:
+			setBroadphase(BroadphaseType::SPATIAL_HASH_GRID);
+			break;
+		case BroadphaseType::SPATIAL_HASH_GRID:
+			setBroadphase(BroadphaseType::AABB_TREE);
+			break;
+		case BroadphaseType::AABB_TREE:
+			setBroadphase(BroadphaseType::QUADTREE);
+			break;
+		}
+		return;
+	}
+
+	if (ev.key != GLFW_KEY_F) return;
 
 	int max1 = 130; int min1 = 80; int range1 = max1 - min1 + 1;
 	int max2 = 180; int min2 = 120; int range2 = max2 - min2 + 1;
@@ -67,7 +97,7 @@ void Scene::handleEvent(const KeyEvent & ev)
 	//enM->assignComponent<ModelComponent>(tree1, std::string("tree").append(std::to_string(rand() % range3 + min3)));
 	enM->assignComponent<ModelComponent>(tree1, "lowpolytree");
 	enM->assignComponent<TextureComponent>(tree1);
-	enM->assignComponent<CollisionComponent>(tree1, 1.f);
+	enM->assignComponent<CollisionComponent>(tree1, 1.f, true, LAYER_SCENERY, LAYER_ALL & ~LAYER_SCENERY);
 	TextureComponent* texComp2 = enM->getComponent<TextureComponent>(tree1);
 	texComp2->attach(0, "grass");
 }
@@ -94,5 +124,78 @@ userinterface::UIManager * Scene::getUIManager() const
 
 void Scene::update()
 {
-	quadtree->update();
+	if (nextBroadphaseType != broadphaseType)
+	{
+		reportBroadphase();
+
+		delete broadphase;
+		broadphaseType = nextBroadphaseType;
+		broadphase = createBroadphase(broadphaseType);
+	}
+
+	broadphase->update();
+
+	const BroadphaseStats& stats = broadphase->getStats();
+
+	broadphaseTotals.updateTime += stats.updateTime;
+	broadphaseTotals.entityCount += stats.entityCount;
+	broadphaseTotals.pairTests += stats.pairTests;
+	broadphaseTotals.groupsSkipped += stats.groupsSkipped;
+	broadphaseTotals.sweptPairs += stats.sweptPairs;
+	broadphaseTotals.narrowRejected += stats.narrowRejected;
+	broadphaseTotals.pairsFound += stats.pairsFound;
+	broadphaseTotals.pairsBegun += stats.pairsBegun;
+	broadphaseTotals.pairsEnded += stats.pairsEnded;
+	++broadphaseFrames;
+}
+
+void Scene::setBroadphase(BroadphaseType type)
+{
+	nextBroadphaseType = type;
+}
+
+Broadphase* Scene::createBroadphase(BroadphaseType type)
+{
+	Broadphase* result{ nullptr };
+
+	switch (type)
+	{
+	case BroadphaseType::QUADTREE:
+		result = new Quadtree{ enM, evM, glm::vec2{ 100, 100 }, 300, 300 };
+		break;
+	case BroadphaseType::SPATIAL_HASH_GRID:
+		result = new SpatialHashGrid{ enM, evM };
+		break;
+	case BroadphaseType::AABB_TREE:
+		result = new AABBTreeBroadphase{ enM, evM };
+		break;
+	}
+
+	enM->each<TransformComponent>([result](EntityHandle ent, TransformComponent*)
+	{
+		result->pushEntity(ent);
+	});
+
+	broadphaseTotals = BroadphaseStats{};
+	broadphaseFrames = 0;
+
+	return result;
+}
+
+void Scene::reportBroadphase() const
+{
+	if (broadphaseFrames == 0) return;
+
+	float frames = static_cast<float>(broadphaseFrames);
+
+	std::cout << broadphase->getName() << " over " << broadphaseFrames << " frames:" << std::endl
+		<< "  entities:   " << broadphaseTotals.entityCount / frames << std::endl
+		<< "  pair tests: " << broadphaseTotals.pairTests / frames << std::endl
+		<< "  skipped:    " << broadphaseTotals.groupsSkipped / frames << std::endl
+		<< "  swept:      " << broadphaseTotals.sweptPairs / frames << std::endl
+		<< "  rejected:   " << broadphaseTotals.narrowRejected / frames << std::endl
+		<< "  pairs:      " << broadphaseTotals.pairsFound / frames << std::endl
+		<< "  begun:      " << broadphaseTotals.pairsBegun / frames << std::endl
+		<< "  ended:      " << broadphaseTotals.pairsEnded / frames << std::endl
+		<< "  time:       " << broadphaseTotals.updateTime / frames * 1000.f << " ms" << std::endl;
 }
@@ -3,6 +3,8 @@
 #include "AssetManager.h"
 #include "EntityManager.h"
 #include "Quadtree.h"
+#include "SpatialHashGrid.h"
+#include "AABBTreeBroadphase.h"
 
 #include "TransformComponent.h"
 #include "CollisionComponent.h"
@@ -18,12 +20,22 @@
 #include "KeyEvent.h"
 #include "MouseEvent.h"
 #include "CameraController.h"
-#include "CollisionEvent.h"
+#include "CollisionBeginEvent.h"
+
+/**
+ * \brief The available collision broadphases
+ */
+enum class BroadphaseType
+{
+	QUADTREE,
+	SPATIAL_HASH_GRID,
+	AABB_TREE
+};
 
 /**
  * \brief Scene class, to be held by the engine
  */
-class Scene : public Subscriber<CollisionEvent>, public Subscriber<KeyEvent>
+class Scene : public Subscriber<CollisionBeginEvent>, public Subscriber<KeyEvent>
 {
 public:
 	Scene() = delete;
@@ -36,10 +48,10 @@ public:
 	~Scene();
 
 	/**
-	 * \brief Event handler for collision events
+	 * \brief Event handler for collision begin events
 	 * \param ev Event to be handled
 	 */
-	void handleEvent(const CollisionEvent& ev) override;
+	void handleEvent(const CollisionBeginEvent& ev) override;
 
 	/**
 	 * \brief Event handler for keyboard events 
@@ -75,12 +87,50 @@ public:
 	 * \brief Updates the scene
 	 */
 	void update();
+
+	/**
+	 * \brief Switches broadphase at the start of the next update
+	 * \param type The broadphase to switch to
+	 */
+	void setBroadphase(BroadphaseType type);
 private:
 
 	/**
-	 * \brief Pointer to the quadtree of the scene
+	 * \brief Creates a broadphase of the given type, tracking all current entities
+	 * \param type The broadphase to create
+	 * \return Pointer to the new broadphase
+	 */
+	Broadphase* createBroadphase(BroadphaseType type);
+
+	/**
+	 * \brief Prints the average statistics of the current broadphase
+	 */
+	void reportBroadphase() const;
+
+	/**
+	 * \brief Pointer to the collision broadphase of the scene
+	 */
+	Broadphase* broadphase;
+
+	/**
+	 * \brief Type of the current broadphase
+	 */
+	BroadphaseType broadphaseType;
+
+	/**
+	 * \brief Type of broadphase to switch to on the next update
+	 */
+	BroadphaseType nextBroadphaseType;
+
+	/**
+	 * \brief Accumulated statistics since the broadphase was created
+	 */
+	BroadphaseStats broadphaseTotals;
+
+	/**
+	 * \brief Number of updates since the broadphase was created
 	 */
-	Quadtree* quadtree;
+	uint32_t broadphaseFrames;
 
 	/**
 	 * \brief pointer to the global asset manager
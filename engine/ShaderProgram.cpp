@@ -8,6 +8,63 @@
 #include "ShaderProgram.h"
 
 #include "Utils.h"
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
+#include <cstring>
+
+namespace
+{
+	/**
+	 * @brief Creates and compiles a shader.
+	 * @param type Shader type.
+	 * @param path Path to the source.
+	 * @param stage Name of the stage in the error message.
+	 * @return Shader handle.
+	 */
+	GLuint compileShader(GLenum type, const std::string& path, const char* stage)
+	{
+		GraphicsDevice& device = GraphicsDevice::get();
+
+		GLuint shader = device.createShader(type);
+
+		std::string log;
+
+		if (!device.compileShader(shader, getStringFromFile(path), log))
+		{
+			device.deleteShader(shader);
+
+			throw ShaderProgramException("Error compiling " + std::string{ stage } + " shader (" + path + ")\n" + log);
+		}
+
+		return shader;
+	}
+}
+
+constexpr uint32_t UniformName::HASH_SEED;
+constexpr uint32_t UniformName::HASH_PRIME;
+
+UniformName UniformName::operator[](uint32_t index) const
+{
+	char digits[16];
+
+	int length = 0;
+
+	do
+	{
+		digits[length++] = static_cast<char>('0' + index % 10);
+		index /= 10;
+	} while (index > 0);
+
+	uint32_t result = hashString("[", hash);
+
+	while (length > 0)
+	{
+		result = (result ^ static_cast<uint8_t>(digits[--length])) * HASH_PRIME;
+	}
+
+	return UniformName{ hashString("]", result) };
+}
 
 ShaderProgram::ShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::string& geometryShaderPath)
 	:vertexShaderPath(vertexShaderPath), fragmentShaderPath(fragmentShaderPath), geometryShaderPath(geometryShaderPath)
@@ -15,146 +72,186 @@ ShaderProgram::ShaderProgram(const std::string& vertexShaderPath, const std::str
 
 ShaderProgram::~ShaderProgram()
 {
-	if (glIsProgram(shaderProgramHandle))
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	if (shaderProgramHandle != 0)
 	{
-		glDeleteProgram(shaderProgramHandle);
+		device.deleteProgram(shaderProgramHandle);
 	}
 
-	if (glIsShader(vertexShaderHandle))
+	if (vertexShaderHandle != 0)
 	{
-		glDeleteShader(vertexShaderHandle);
+		device.deleteShader(vertexShaderHandle);
 	}
 
-	if (glIsShader(fragmentShaderHandle))
+	if (fragmentShaderHandle != 0)
 	{
-		glDeleteShader(fragmentShaderHandle);
+		device.deleteShader(fragmentShaderHandle);
 	}
 
-	if (glIsShader(geometryShaderHandle))
+	if (geometryShaderHandle != 0)
 	{
-		glDeleteShader(geometryShaderHandle);
+		device.deleteShader(geometryShaderHandle);
 	}
 }
 
 void ShaderProgram::compile()
 {
-	if (glIsShader(vertexShaderHandle))
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	GLuint* shaderHandles[] = { &vertexShaderHandle, &fragmentShaderHandle, &geometryShaderHandle };
+
+	for (GLuint* handle : shaderHandles)
 	{
-		glDeleteShader(vertexShaderHandle);
+		if (*handle != 0)
+		{
+			device.deleteShader(*handle);
+			*handle = 0;
+		}
 	}
 
-	if (glIsShader(fragmentShaderHandle))
+	vertexShaderHandle = compileShader(GL_VERTEX_SHADER, vertexShaderPath, "vertex");
+	fragmentShaderHandle = compileShader(GL_FRAGMENT_SHADER, fragmentShaderPath, "fragment");
+
+	if (geometryShaderPath != "")
 	{
-		glDeleteShader(fragmentShaderHandle);
+		geometryShaderHandle = compileShader(GL_GEOMETRY_SHADER, geometryShaderPath, "geometry");
 	}
 
-	if (glIsShader(geometryShaderHandle))
+	// If the prorgram is already existing, delete it before creating a new one.
+	if (shaderProgramHandle != 0)
 	{
-		glDeleteShader(geometryShaderHandle);
+		device.deleteProgram(shaderProgramHandle);
 	}
 
-	// Create a new vertex shader
-	vertexShaderHandle = glCreateShader(GL_VERTEX_SHADER);
+	shaderProgramHandle = device.createProgram();
 
-	std::string vertexShaderString = getStringFromFile(vertexShaderPath);
-	const char* vertexShaderSource = vertexShaderString.c_str();
-	glShaderSource(vertexShaderHandle, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShaderHandle);
+	device.attachShader(shaderProgramHandle, vertexShaderHandle);
+	device.attachShader(shaderProgramHandle, fragmentShaderHandle);
 
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShaderHandle, GL_COMPILE_STATUS, &success);
-	if (!success)
+	if (geometryShaderHandle != 0)
 	{
-		glGetShaderInfoLog(vertexShaderHandle, 512, NULL, infoLog);
-		std::string errorMessage;
-		errorMessage = "Error compiling vertex shader (" + vertexShaderPath + ")\n" + infoLog;
-		throw ShaderProgramException(errorMessage);
+		device.attachShader(shaderProgramHandle, geometryShaderHandle);
 	}
 
-	fragmentShaderHandle = glCreateShader(GL_FRAGMENT_SHADER);
+}
 
-	std::string fragmentShaderString = getStringFromFile(fragmentShaderPath);
-	const char* fragmentShaderSource = fragmentShaderString.c_str();
-	glShaderSource(fragmentShaderHandle, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShaderHandle);
+void ShaderProgram::link()
+{
+	std::string log;
 
-	glGetShaderiv(fragmentShaderHandle, GL_COMPILE_STATUS, &success);
-	if (!success)
+	if (!GraphicsDevice::get().linkProgram(shaderProgramHandle, log))
 	{
-		glGetShaderInfoLog(fragmentShaderHandle, 512, NULL, infoLog);
 		std::string errorMessage;
-		errorMessage = "Error compiling fragment shader (" + fragmentShaderPath + ")\n" + infoLog;
+		errorMessage = std::string{ "Error linking shader program " } + vertexShaderPath + "\n" + log;
 		throw ShaderProgramException(errorMessage);
 	}
 
-	if (geometryShaderPath != "")
+	buildUniformTable();
+}
+
+void ShaderProgram::buildUniformTable()
+{
+	uniformIndices.clear();
+	uniforms.clear();
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	std::vector<ActiveUniform> active;
+
+	device.getActiveUniforms(shaderProgramHandle, active);
+
+	auto addUniform = [&](const std::string& name)
+	{
+		GLint location = device.getUniformLocation(shaderProgramHandle, name.c_str());
+
+		if (location < 0)
+		{
+			return;
+		}
+
+		uint32_t hash = UniformName{ name }.hash;
+
+		if (uniformIndices.count(hash))
+		{
+			throw ShaderProgramException("Uniform name hash collision in " + vertexShaderPath + ": " + name);
+		}
+
+		uniformIndices.emplace(hash, static_cast<uint32_t>(uniforms.size()));
+		uniforms.push_back(Uniform{ location, false, {} });
+	};
+
+	for (const ActiveUniform& uniform : active)
 	{
-		geometryShaderHandle = glCreateShader(GL_GEOMETRY_SHADER);
+		const std::string& name = uniform.name;
 
-		std::string geometryShaderString = getStringFromFile(geometryShaderPath);
-		const char* geometryShaderSource = geometryShaderString.c_str();
+		// Arrays are reported by their first element, as "name[0]"
+		size_t bracket = name.rfind("[0]");
+
+		if (bracket == std::string::npos || bracket + 3 != name.size())
+		{
+			addUniform(name);
+			continue;
+		}
 
-		glShaderSource(geometryShaderHandle, 1, &geometryShaderSource, NULL);
-		glCompileShader(geometryShaderHandle);
+		std::string base = name.substr(0, bracket);
 
-		glGetShaderiv(geometryShaderHandle, GL_COMPILE_STATUS, &success);
-		if (!success)
+		addUniform(base);
+
+		for (GLint element = 0; element < uniform.size; ++element)
 		{
-			glGetShaderInfoLog(geometryShaderHandle, 512, NULL, infoLog);
-			std::string errorMessage;
-			errorMessage = "Error compiling geometry shader (" + geometryShaderPath + ")\n" + infoLog;
-			throw ShaderProgramException(errorMessage);
+			addUniform(base + "[" + std::to_string(element) + "]");
 		}
 	}
+}
 
-	// If the prorgram is already existing, delete it before creating a new one.
-	if (glIsProgram(shaderProgramHandle))
+GLint ShaderProgram::updateUniform(UniformName name, const void* data, size_t size)
+{
+	auto it = uniformIndices.find(name.hash);
+
+	if (it == uniformIndices.end())
 	{
-		glDeleteProgram(shaderProgramHandle);
+		return -1;
 	}
 
-	shaderProgramHandle = glCreateProgram();
-
-	glAttachShader(shaderProgramHandle, vertexShaderHandle);
-	glAttachShader(shaderProgramHandle, fragmentShaderHandle);
+	Uniform& uniform = uniforms[it->second];
 
-	if (glIsShader(geometryShaderHandle))
+	if (uniform.valid && std::memcmp(uniform.value.data(), data, size) == 0)
 	{
-		glAttachShader(shaderProgramHandle, geometryShaderHandle);
+		return -1;
 	}
 
-}
+	std::memcpy(uniform.value.data(), data, size);
+	uniform.valid = true;
 
-void ShaderProgram::link() const
-{
-	GLint success;
-	GLchar infoLog[512];
+	bind();
 
-	glLinkProgram(shaderProgramHandle);
+	return uniform.location;
+}
 
-	glGetProgramiv(shaderProgramHandle, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgramHandle, 512, NULL, infoLog);
-		std::string errorMessage;
-		errorMessage = std::string{ "Error linking shader program " } + vertexShaderPath + "\n" + std::string{ infoLog };
-		throw ShaderProgramException(errorMessage);
-	}
+void ShaderProgram::bind()
+{
+	GLState::get().useProgram(shaderProgramHandle);
 }
 
 void ShaderProgram::bindAttribLocation(GLuint index, const GLchar* name) const
 {
-	glBindAttribLocation(shaderProgramHandle, index, name);
+	GraphicsDevice::get().bindAttribLocation(shaderProgramHandle, index, name);
+}
+
+void ShaderProgram::bindUniformBlock(const GLchar* name, GLuint binding) const
+{
+	GraphicsDevice::get().bindUniformBlock(shaderProgramHandle, name, binding);
 }
 
 void ShaderProgram::use() const
 {
-	glUseProgram(shaderProgramHandle);
+	GLState::get().useProgram(shaderProgramHandle);
 }
 
 void ShaderProgram::disable() const
 {
-	glUseProgram(0);
+	GLState::get().useProgram(0);
 }
 
 GLuint ShaderProgram::getShaderProgramHandle() const
@@ -162,61 +259,85 @@ GLuint ShaderProgram::getShaderProgramHandle() const
 	return shaderProgramHandle;
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, float value)
+void ShaderProgram::uploadUniform(UniformName name, float value)
 {
-	use();
-	glUniform1f(glGetUniformLocation(shaderProgramHandle, name.c_str()), value);
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, int value)
+void ShaderProgram::uploadUniform(UniformName name, int value)
 {
-	use();
-	glUniform1i(glGetUniformLocation(shaderProgramHandle, name.c_str()), value);
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, glm::vec2 value)
+void ShaderProgram::uploadUniform(UniformName name, glm::vec2 value)
 {
-	use();
-	glUniform2f(glGetUniformLocation(shaderProgramHandle, name.c_str()), value.x, value.y);
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, glm::vec3 value)
+void ShaderProgram::uploadUniform(UniformName name, glm::vec3 value)
 {
-	use();
-	glUniform3f(glGetUniformLocation(shaderProgramHandle, name.c_str()), value.x, value.y, value.z);
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, glm::vec4 value)
+void ShaderProgram::uploadUniform(UniformName name, glm::vec4 value)
 {
-	use();
-	glUniform4f(glGetUniformLocation(shaderProgramHandle, name.c_str()), value.x, value.y, value.z, value.w);
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, glm::mat4 value)
+void ShaderProgram::uploadUniform(UniformName name, glm::mat4 value)
 {
-	use();
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgramHandle, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	GLint location = updateUniform(name, &value, sizeof(value));
+
+	if (location >= 0)
+	{
+		GraphicsDevice::get().uniform(location, value);
+	}
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, const PointLight& pointLight)
+void ShaderProgram::uploadUniform(UniformName name, const PointLight& pointLight)
 {
-	uploadUniform(name + ".position", pointLight.getPosition());
+	uploadUniform(name.member(".position"), pointLight.getPosition());
 
-	uploadUniform(name + ".ambient", pointLight.getAmbient());
-	uploadUniform(name + ".diffuse", pointLight.getDiffuse());
-	uploadUniform(name + ".specular", pointLight.getSpecular());
+	uploadUniform(name.member(".ambient"), pointLight.getAmbient());
+	uploadUniform(name.member(".diffuse"), pointLight.getDiffuse());
+	uploadUniform(name.member(".specular"), pointLight.getSpecular());
 
-	uploadUniform(name + ".constant", pointLight.getConstant());
-	uploadUniform(name + ".linear", pointLight.getLinear());
-	uploadUniform(name + ".quadratic", pointLight.getQuadratic());
+	uploadUniform(name.member(".constant"), pointLight.getConstant());
+	uploadUniform(name.member(".linear"), pointLight.getLinear());
+	uploadUniform(name.member(".quadratic"), pointLight.getQuadratic());
 }
 
-void ShaderProgram::uploadUniform(const std::string& name, const Material& material)
+void ShaderProgram::uploadUniform(UniformName name, const Material& material)
 {
-	uploadUniform(name + ".ambient", material.getAmbient());
-	uploadUniform(name + ".diffuse", material.getDiffuse());
-	uploadUniform(name + ".specular", material.getSpecular());
-	uploadUniform(name + ".shininess", material.getShininess());
+	uploadUniform(name.member(".ambient"), material.getAmbient());
+	uploadUniform(name.member(".diffuse"), material.getDiffuse());
+	uploadUniform(name.member(".specular"), material.getSpecular());
+	uploadUniform(name.member(".shininess"), material.getShininess());
 }
 
 void swap(ShaderProgram& lhs, ShaderProgram& rhs) noexcept
@@ -230,5 +351,7 @@ void swap(ShaderProgram& lhs, ShaderProgram& rhs) noexcept
 	swap(lhs.vertexShaderHandle, rhs.vertexShaderHandle);
 	swap(lhs.fragmentShaderHandle, rhs.fragmentShaderHandle);
 	swap(lhs.geometryShaderHandle, rhs.geometryShaderHandle);
+	swap(lhs.uniformIndices, rhs.uniformIndices);
+	swap(lhs.uniforms, rhs.uniforms);
 
 }
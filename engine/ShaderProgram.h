@@ -9,6 +9,10 @@
 
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -27,8 +31,84 @@ public:
 	using std::runtime_error::runtime_error;
 };
 
+/**
+ * @brief Name of a uniform, identified by its hash.
+ *
+ * The hash of a string literal is computed at compile time when the name
+ * is constexpr. Members and array elements are hashed by continuing the
+ * hash of their parent, so "lights" then [2] then ".position" has the same
+ * hash as "lights[2].position" without building any string.
+ */
+class UniformName
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param name Name of the uniform.
+	 */
+	constexpr UniformName(const char* name) : hash{ hashString(name, HASH_SEED) } {}
+
+	/**
+	 * @brief Constructor.
+	 * @param name Name of the uniform.
+	 */
+	UniformName(const std::string& name) : hash{ hashString(name.c_str(), HASH_SEED) } {}
+
+	/**
+	 * @brief Gets the name of a member.
+	 * @param member Member name, including the leading dot.
+	 * @return Member name.
+	 */
+	constexpr UniformName member(const char* member) const { return UniformName{ hashString(member, hash) }; }
+
+	/**
+	 * @brief Gets the name of an array element.
+	 * @param index Index of the element.
+	 * @return Element name.
+	 */
+	UniformName operator[](uint32_t index) const;
+
+	/**
+	 * @brief Hash of the name.
+	 */
+	uint32_t hash;
+
+	/**
+	 * @brief Continues a FNV-1a hash with a string.
+	 * @param string The string.
+	 * @param hash Hash so far.
+	 * @return Hash.
+	 */
+	static constexpr uint32_t hashString(const char* string, uint32_t hash)
+	{
+		return *string ? hashString(string + 1, (hash ^ static_cast<uint8_t>(*string)) * HASH_PRIME) : hash;
+	}
+
+	/**
+	 * @brief Hash of the empty name.
+	 */
+	static constexpr uint32_t HASH_SEED{ 2166136261u };
+
+	/**
+	 * @brief FNV prime.
+	 */
+	static constexpr uint32_t HASH_PRIME{ 16777619u };
+
+private:
+	/**
+	 * @brief Constructor from a hash.
+	 * @param hash The hash.
+	 */
+	explicit constexpr UniformName(uint32_t hash) : hash{ hash } {}
+};
+
 /**
  * @brief Representation of a complete shader program.
+ *
+ * The locations of all active uniforms, and of every element of uniform
+ * arrays, are looked up once when the program is linked. The last value
+ * uploaded to each uniform is kept, and uploads of an unchanged value are
+ * skipped without calling OpenGL.
  */
 class ShaderProgram
 {
@@ -66,8 +146,9 @@ public:
 	 * @brief Link Shader
 	 * 
 	 * Links the shader. Expects the vertex and fragment shaders to be loaded and compiled beforehand.
+	 * Builds the uniform table.
 	 */
-	void link() const;
+	void link();
 
 	/**
 	 * @brief Binds an attribute location for the shader.
@@ -76,6 +157,14 @@ public:
 	 */
 	void bindAttribLocation(GLuint index, const GLchar* name) const;
 
+	/**
+	 * @brief Binds a uniform block to a binding index. Blocks the shader
+	 * does not use are ignored.
+	 * @param name Name of the block.
+	 * @param binding Binding index.
+	 */
+	void bindUniformBlock(const GLchar* name, GLuint binding) const;
+
 	/**
 	 * @brief Sets the openGL pipeline to use the shader for subsequent draws.
 	 */
@@ -97,56 +186,56 @@ public:
 	 * @param name Name of the uniform.
 	 * @param value Value to be upload.
 	 */
-	void uploadUniform(const std::string& name, float value);
+	void uploadUniform(UniformName name, float value);
 
 	/**
 	* @brief Uploads a value as an uniform to the shader.
 	* @param name Name of the uniform.
 	* @param value Value to be upload.
 	*/
-	void uploadUniform(const std::string& name, int value);
+	void uploadUniform(UniformName name, int value);
 
 	/**
 	* @brief Uploads a value as an uniform to the shader.
 	* @param name Name of the uniform.
 	* @param value Value to be upload.
 	*/
-	void uploadUniform(const std::string& name, glm::vec2 value);
+	void uploadUniform(UniformName name, glm::vec2 value);
 
 	/**
 	* @brief Uploads a value as an uniform to the shader.
 	* @param name Name of the uniform.
 	* @param value Value to be upload.
 	*/
-	void uploadUniform(const std::string& name, glm::vec3 value);
+	void uploadUniform(UniformName name, glm::vec3 value);
 
 	/**
 	* @brief Uploads a value as an uniform to the shader.
 	* @param name Name of the uniform.
 	* @param value Value to be upload.
 	*/
-	void uploadUniform(const std::string& name, glm::vec4 value);
+	void uploadUniform(UniformName name, glm::vec4 value);
 
 	/**
 	* @brief Uploads a value as an uniform to the shader.
 	* @param name Name of the uniform.
 	* @param value Value to be upload.
 	*/
-	void uploadUniform(const std::string& name, glm::mat4 value);
+	void uploadUniform(UniformName name, glm::mat4 value);
 
 	/**
 	 * @brief Uploads a value as an uniform to the shader
 	 * @param name Name of the uniform
 	 * @param pointLight PointLight object
 	 */
-	void uploadUniform(const std::string& name, const PointLight& pointLight);
+	void uploadUniform(UniformName name, const PointLight& pointLight);
 
 	/**
 	 * @brief Uploads a value as an uniform to the shader
 	 * @param name Name of the uniform
 	 * @param material Material object
 	 */
-	void uploadUniform(const std::string& name, const Material& material);
+	void uploadUniform(UniformName name, const Material& material);
 
 	/**
 	 * @brief Swaps two shaders
@@ -156,6 +245,57 @@ public:
 	friend void swap(ShaderProgram& lhs, ShaderProgram& rhs) noexcept;
 private:
 
+	/**
+	 * @brief A uniform in the table.
+	 */
+	struct Uniform
+	{
+		/**
+		 * @brief Location in the program.
+		 */
+		GLint location;
+
+		/**
+		 * @brief Whether value holds what was last uploaded.
+		 */
+		bool valid;
+
+		/**
+		 * @brief Last uploaded value, as raw words.
+		 */
+		std::array<uint32_t, 16> value;
+	};
+
+	/**
+	 * @brief Looks up all active uniforms of the linked program.
+	 */
+	void buildUniformTable();
+
+	/**
+	 * @brief Finds a uniform and records a new value for it.
+	 * @param name Name of the uniform.
+	 * @param data The value.
+	 * @param size Size of the value in bytes, at most 64.
+	 * @return Location to upload to, -1 if the uniform is missing or
+	 * already holds the value.
+	 */
+	GLint updateUniform(UniformName name, const void* data, size_t size);
+
+	/**
+	 * @brief Makes the program current unless it already is.
+	 */
+	void bind();
+
+	/**
+	 * @brief Index into uniforms by name hash.
+	 */
+	std::unordered_map<uint32_t, uint32_t> uniformIndices;
+
+	/**
+	 * @brief All active uniforms, array elements one by one.
+	 */
+	std::vector<Uniform> uniforms;
+
 	/**
 	 * @brief Path to the vertex shader source.
 	 */
@@ -174,20 +314,20 @@ private:
 	/**
 	 * @brief OpenGL shader program handle.
 	 */
-	GLuint shaderProgramHandle;
+	GLuint shaderProgramHandle{ 0 };
 
 	/**
 	 * @brief OpenGL vertex shader handle.
 	 */
-	GLuint vertexShaderHandle;
+	GLuint vertexShaderHandle{ 0 };
 
 	/**
 	 * @brief OpenGL fragment shader handle.
 	 */
-	GLuint fragmentShaderHandle;
+	GLuint fragmentShaderHandle{ 0 };
 
 	/**
 	* @brief OpenGL geometry shader handle.
 	*/
-	GLuint geometryShaderHandle;
+	GLuint geometryShaderHandle{ 0 };
 };
\ No newline at end of file
@@ -0,0 +1,179 @@
+/**
+ * @file	ShadowScheduler.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Decides which cached shadow maps to re-render each frame
+ */
+
+#include "ShadowScheduler.h"
+
+#include <algorithm>
+
+constexpr uint64_t ShadowScheduler::HASH_SEED;
+
+ShadowScheduler::ShadowScheduler(uint32_t slotCount, uint32_t budget)
+	: _slots(slotCount, Slot{ 0, false, false, 0, 0, 0, 0, 0.f, 0, false }), _budget{ budget } {}
+
+void ShadowScheduler::assign(const std::vector<EntityHandle>& lights, std::vector<uint32_t>& slots)
+{
+	static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+	slots.assign(lights.size(), NO_SLOT);
+
+	std::vector<bool> taken(_slots.size(), false);
+
+	// Lights that had a slot keep it, and with it their cached map
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		for (uint32_t slot = 0; slot < _slots.size(); ++slot)
+		{
+			if (_slots[slot].used && _slots[slot].owner == lights[i])
+			{
+				slots[i] = slot;
+				taken[slot] = true;
+				break;
+			}
+		}
+	}
+
+	// New lights take the slots of lights that are gone
+	uint32_t next = 0;
+
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		if (slots[i] != NO_SLOT)
+		{
+			continue;
+		}
+
+		while (next < _slots.size() && taken[next])
+		{
+			++next;
+		}
+
+		if (next == _slots.size())
+		{
+			break;
+		}
+
+		Slot& slot = _slots[next];
+
+		slot.owner = lights[i];
+		slot.rendered = false;
+		slot.staleFrames = 0;
+
+		slots[i] = next;
+		taken[next] = true;
+	}
+
+	for (uint32_t slot = 0; slot < _slots.size(); ++slot)
+	{
+		_slots[slot].used = taken[slot];
+		_slots[slot].requested = false;
+	}
+}
+
+void ShadowScheduler::request(uint32_t slot, uint64_t signature, uint32_t resolution, float priority)
+{
+	Slot& s = _slots[slot];
+
+	s.signature = signature;
+	s.resolution = resolution;
+	s.priority = priority;
+	s.requested = true;
+}
+
+void ShadowScheduler::schedule(std::vector<uint32_t>& update)
+{
+	update.clear();
+
+	for (uint32_t slot = 0; slot < _slots.size(); ++slot)
+	{
+		Slot& s = _slots[slot];
+
+		if (!s.used || !s.requested)
+		{
+			continue;
+		}
+
+		bool stale = !s.rendered || s.signature != s.renderedSignature || s.resolution != s.allocatedResolution;
+
+		if (stale)
+		{
+			++s.staleFrames;
+			update.push_back(slot);
+		}
+		else
+		{
+			s.staleFrames = 0;
+		}
+	}
+
+	std::sort(update.begin(), update.end(), [&](uint32_t a, uint32_t b)
+	{
+		const Slot& sa = _slots[a];
+		const Slot& sb = _slots[b];
+
+		// A map that was never rendered holds garbage, unlike an old one
+		if (sa.rendered != sb.rendered)
+		{
+			return !sa.rendered;
+		}
+
+		float scoreA = sa.priority * sa.staleFrames;
+		float scoreB = sb.priority * sb.staleFrames;
+
+		if (scoreA != scoreB)
+		{
+			return scoreA > scoreB;
+		}
+
+		return a < b;
+	});
+
+	if (update.size() > _budget)
+	{
+		update.resize(_budget);
+	}
+}
+
+void ShadowScheduler::markRendered(uint32_t slot)
+{
+	Slot& s = _slots[slot];
+
+	s.rendered = true;
+	s.renderedSignature = s.signature;
+	s.allocatedResolution = s.resolution;
+	s.staleFrames = 0;
+}
+
+bool ShadowScheduler::needsResize(uint32_t slot) const
+{
+	return _slots[slot].resolution != _slots[slot].allocatedResolution;
+}
+
+uint32_t ShadowScheduler::getResolution(uint32_t slot) const
+{
+	return _slots[slot].resolution;
+}
+
+bool ShadowScheduler::isRendered(uint32_t slot) const
+{
+	return _slots[slot].rendered;
+}
+
+uint64_t ShadowScheduler::hash(uint64_t seed, const void* data, size_t size)
+{
+	static constexpr uint64_t PRIME = 1099511628211ull;
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	// FNV-1a
+	for (size_t i = 0; i < size; ++i)
+	{
+		seed ^= bytes[i];
+		seed *= PRIME;
+	}
+
+	return seed;
+}
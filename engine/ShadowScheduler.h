@@ -0,0 +1,171 @@
+/**
+ * @file	ShadowScheduler.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Decides which cached shadow maps to re-render each frame
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Handle of the light entity owning a shadow map.
+ */
+typedef uint32_t EntityHandle;
+
+/**
+ * @brief Keeps track of a fixed number of cached shadow maps.
+ *
+ * Every light with a shadow gets a slot that it keeps for as long as it
+ * is shadowed. Each frame the caller describes what the light would render
+ * with a signature. A slot is stale when the signature or the resolution
+ * differs from what its map was rendered with. At most a budget of stale
+ * slots are re-rendered per frame, the most important first.
+ */
+class ShadowScheduler
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param slotCount Number of shadow maps.
+	 * @param budget Largest number of maps re-rendered per frame.
+	 */
+	ShadowScheduler(uint32_t slotCount, uint32_t budget);
+
+	/**
+	 * @brief Gives every light a slot. Lights keep the slot they had last
+	 * frame, slots of lights that are gone are reused.
+	 * @param lights The lights, at most as many as there are slots.
+	 * @param slots Slot of every light.
+	 */
+	void assign(const std::vector<EntityHandle>& lights, std::vector<uint32_t>& slots);
+
+	/**
+	 * @brief Describes what a slot would render this frame.
+	 * @param slot The slot.
+	 * @param signature Hash of the light and its casters.
+	 * @param resolution Wanted resolution of the map.
+	 * @param priority Importance of the light, higher is updated first.
+	 */
+	void request(uint32_t slot, uint64_t signature, uint32_t resolution, float priority);
+
+	/**
+	 * @brief Picks the stale slots to re-render this frame. Maps that were
+	 * never rendered come first, then the highest priority weighted by the
+	 * number of frames the map has been stale, so that no light starves.
+	 * @param update Slots to re-render.
+	 */
+	void schedule(std::vector<uint32_t>& update);
+
+	/**
+	 * @brief Marks a slot as rendered with the requested signature.
+	 * @param slot The slot.
+	 */
+	void markRendered(uint32_t slot);
+
+	/**
+	 * @brief Checks if the map of a slot has to be reallocated before it
+	 * is rendered.
+	 * @param slot The slot.
+	 * @return True if the requested resolution differs from the allocated one.
+	 */
+	bool needsResize(uint32_t slot) const;
+
+	/**
+	 * @brief Gets the requested resolution of a slot.
+	 * @param slot The slot.
+	 * @return Resolution.
+	 */
+	uint32_t getResolution(uint32_t slot) const;
+
+	/**
+	 * @brief Checks if a slot has ever been rendered.
+	 * @param slot The slot.
+	 * @return True if the slot holds a map.
+	 */
+	bool isRendered(uint32_t slot) const;
+
+	/**
+	 * @brief Hashes bytes into a signature.
+	 * @param seed Signature so far.
+	 * @param data Bytes to add.
+	 * @param size Number of bytes.
+	 * @return New signature.
+	 */
+	static uint64_t hash(uint64_t seed, const void* data, size_t size);
+
+	/**
+	 * @brief Start value of a signature.
+	 */
+	static constexpr uint64_t HASH_SEED{ 14695981039346656037ull };
+
+private:
+	/**
+	 * @brief A cached shadow map.
+	 */
+	struct Slot
+	{
+		/**
+		 * @brief Light owning the slot.
+		 */
+		EntityHandle owner;
+
+		/**
+		 * @brief Whether the slot has an owner.
+		 */
+		bool used;
+
+		/**
+		 * @brief Whether the map has been rendered since it was allocated.
+		 */
+		bool rendered;
+
+		/**
+		 * @brief Signature the map was rendered with.
+		 */
+		uint64_t renderedSignature;
+
+		/**
+		 * @brief Resolution the map is allocated with.
+		 */
+		uint32_t allocatedResolution;
+
+		/**
+		 * @brief Signature wanted this frame.
+		 */
+		uint64_t signature;
+
+		/**
+		 * @brief Resolution wanted this frame.
+		 */
+		uint32_t resolution;
+
+		/**
+		 * @brief Priority this frame.
+		 */
+		float priority;
+
+		/**
+		 * @brief Number of frames the map has been stale.
+		 */
+		uint32_t staleFrames;
+
+		/**
+		 * @brief Whether the slot was requested this frame.
+		 */
+		bool requested;
+	};
+
+	/**
+	 * @brief All slots.
+	 */
+	std::vector<Slot> _slots;
+
+	/**
+	 * @brief Largest number of maps re-rendered per frame.
+	 */
+	uint32_t _budget;
+};
@@ -0,0 +1,546 @@
+/**
+ * @file	SpatialHashGrid.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Uniform spatial hash grid broadphase
+ */
+
+#include "SpatialHashGrid.h"
+#include "CollisionComponent.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+constexpr float SpatialHashGrid::DEFAULT_CELL_SIZE;
+constexpr size_t SpatialHashGrid::GRAIN_SIZE;
+constexpr uint32_t SpatialHashGrid::NO_BUCKET;
+
+SpatialHashGrid::SpatialHashGrid(EntityManager* entMan, EventManager* evMan, float cellSize) :
+	Broadphase(entMan, evMan),
+	_cellSize{ DEFAULT_CELL_SIZE }
+{
+	setCellSize(cellSize);
+
+	_evM->addSubscriber<EntityDestroyedEvent>(this);
+	_evM->addSubscriber<ComponentAssignedEvent<TransformComponent>>(this);
+}
+
+SpatialHashGrid::~SpatialHashGrid()
+{
+	_evM->removeSubscriber<EntityDestroyedEvent>(this);
+	_evM->removeSubscriber<ComponentAssignedEvent<TransformComponent>>(this);
+}
+
+void SpatialHashGrid::findPairs(std::vector<CollisionPair>& pairs)
+{
+	gather();
+	sortIntoCells();
+	generatePairs(pairs);
+}
+
+void SpatialHashGrid::pushEntity(EntityHandle ent)
+{
+	if (std::find(_entities.begin(), _entities.end(), ent) != _entities.end())
+	{
+		throw Broadphase_error(std::string("Duplicate entity '").append(std::to_string(ent)).append("' in spatial hash grid"));
+	}
+
+	_entities.push_back(ent);
+}
+
+void SpatialHashGrid::handleEvent(const EntityDestroyedEvent& ev)
+{
+	_entToRemove.push_back(ev.entHandle);
+}
+
+void SpatialHashGrid::handleEvent(const ComponentAssignedEvent<TransformComponent>& ev)
+{
+	pushEntity(ev.entHandle);
+}
+
+void SpatialHashGrid::setCellSize(float value)
+{
+	if (!(value > 0.f))
+	{
+		throw Broadphase_error(std::string("Invalid cell size '").append(std::to_string(value)).append("' for spatial hash grid"));
+	}
+
+	_cellSize = value;
+}
+
+void SpatialHashGrid::gather()
+{
+	if (!_entToRemove.empty())
+	{
+		std::sort(_entToRemove.begin(), _entToRemove.end());
+
+		_entities.erase(std::remove_if(_entities.begin(), _entities.end(), [this](EntityHandle ent)
+		{
+			return std::binary_search(_entToRemove.begin(), _entToRemove.end(), ent);
+		}), _entities.end());
+
+		_entToRemove.clear();
+	}
+
+	size_t count = _entities.size();
+
+	_posX.resize(count);
+	_posY.resize(count);
+	_posZ.resize(count);
+	_extentX.resize(count);
+	_extentY.resize(count);
+	_extentZ.resize(count);
+	_layer.resize(count);
+	_mask.resize(count);
+	_group.resize(count);
+	_fast.resize(count);
+	_cellX.resize(count);
+	_cellZ.resize(count);
+	_bucket.resize(count);
+
+	// Only reads from the entity manager, safe to do from several threads.
+	JobSystem::get().parallelFor(count, GRAIN_SIZE, [this](size_t begin, size_t end)
+	{
+		float halfCell = _cellSize / 2;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			EntityHandle ent = _entities[i];
+
+			if (!_enM->hasComponent<CollisionComponent>(ent))
+			{
+				_extentX[i] = -1.f;
+				_bucket[i] = NO_BUCKET;
+				continue;
+			}
+
+			glm::vec3 pos = _enM->getComponent<TransformComponent>(ent)->position;
+			CollisionComponent* collider = _enM->getComponent<CollisionComponent>(ent);
+			glm::vec3 extent = collider->getExtent();
+
+			_posX[i] = pos.x;
+			_posY[i] = pos.y;
+			_posZ[i] = pos.z;
+			_extentX[i] = extent.x;
+			_extentY[i] = extent.y;
+			_extentZ[i] = extent.z;
+			_layer[i] = collider->getLayer();
+			_mask[i] = collider->getMask();
+			_fast[i] = collider->isFast();
+			_cellX[i] = static_cast<int32_t>(std::floor(pos.x / _cellSize));
+			_cellZ[i] = static_cast<int32_t>(std::floor(pos.z / _cellSize));
+
+			// Bucket is filled in once the table size is known
+			_bucket[i] = extent.x > halfCell || extent.z > halfCell ? NO_BUCKET : 0;
+		}
+	});
+
+	_oversized.clear();
+	_groupLayer.clear();
+	_groupMask.clear();
+
+	size_t gridded = 0;
+	uint32_t group = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (_bucket[i] != NO_BUCKET)
+		{
+			++gridded;
+		}
+		else if (_extentX[i] >= 0.f)
+		{
+			_oversized.push_back(static_cast<uint32_t>(i));
+		}
+		else
+		{
+			continue;
+		}
+
+		// There are only a handful of groups and neighbours often share one
+		if (group >= _groupLayer.size() || _groupLayer[group] != _layer[i] || _groupMask[group] != _mask[i])
+		{
+			group = 0;
+
+			while (group < _groupLayer.size() && (_groupLayer[group] != _layer[i] || _groupMask[group] != _mask[i]))
+			{
+				++group;
+			}
+
+			if (group == _groupLayer.size())
+			{
+				_groupLayer.push_back(_layer[i]);
+				_groupMask.push_back(_mask[i]);
+			}
+		}
+
+		_group[i] = group;
+
+		if (_fast[i])
+		{
+			_fastEntities.push_back(_entities[i]);
+		}
+	}
+
+	// Counting sort of the gridded colliders by group, keeps their order within a group
+	_groupStart.assign(_groupLayer.size() + 1, 0);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (_bucket[i] != NO_BUCKET)
+		{
+			++_groupStart[_group[i] + 1];
+		}
+	}
+
+	for (size_t g = 1; g < _groupStart.size(); ++g)
+	{
+		_groupStart[g] += _groupStart[g - 1];
+	}
+
+	_byGroup.resize(gridded);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (_bucket[i] != NO_BUCKET)
+		{
+			_byGroup[_groupStart[_group[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	std::sort(_oversized.begin(), _oversized.end(), [this](uint32_t a, uint32_t b)
+	{
+		return _group[a] != _group[b] ? _group[a] < _group[b] : a < b;
+	});
+
+	_oversizedRunEnd.resize(_oversized.size());
+
+	for (size_t k = _oversized.size(); k-- > 0;)
+	{
+		bool sameRun = k + 1 < _oversized.size() && _group[_oversized[k + 1]] == _group[_oversized[k]];
+
+		_oversizedRunEnd[k] = sameRun ? _oversizedRunEnd[k + 1] : static_cast<uint32_t>(k + 1);
+	}
+
+	_tableSize = 1;
+
+	while (_tableSize < gridded)
+	{
+		_tableSize <<= 1;
+	}
+
+	_stats.entityCount = static_cast<uint32_t>(gridded + _oversized.size());
+}
+
+void SpatialHashGrid::sortIntoCells()
+{
+	JobSystem& jobs = JobSystem::get();
+
+	// Going through the colliders by group leaves every bucket sorted by group
+	size_t count = _byGroup.size();
+
+	// Keep the number of jobs down to the number of threads, every job needs
+	// its own histogram over the whole table.
+	size_t grain = std::max(GRAIN_SIZE, (count + jobs.getThreadCount() - 1) / jobs.getThreadCount());
+	size_t jobCount = JobSystem::getChunkCount(count, grain);
+
+	_histograms.assign(jobCount * _tableSize, 0);
+
+	jobs.parallelFor(count, grain, [this, grain](size_t begin, size_t end)
+	{
+		uint32_t* histogram = &_histograms[(begin / grain) * _tableSize];
+
+		for (size_t k = begin; k < end; ++k)
+		{
+			uint32_t i = _byGroup[k];
+
+			_bucket[i] = hashCell(_cellX[i], _cellZ[i]);
+
+			++histogram[_bucket[i]];
+		}
+	});
+
+	// Bucket major prefix sum, turns the histograms into the first slot of
+	// every job within every bucket. Keeps the sort stable.
+	_bucketStart.resize(_tableSize + 1);
+
+	uint32_t offset = 0;
+
+	for (uint32_t bucket = 0; bucket < _tableSize; ++bucket)
+	{
+		_bucketStart[bucket] = offset;
+
+		for (size_t job = 0; job < jobCount; ++job)
+		{
+			uint32_t& slot = _histograms[job * _tableSize + bucket];
+			uint32_t bucketCount = slot;
+
+			slot = offset;
+			offset += bucketCount;
+		}
+	}
+
+	_bucketStart[_tableSize] = offset;
+
+	_sorted.resize(offset);
+
+	jobs.parallelFor(count, grain, [this, grain](size_t begin, size_t end)
+	{
+		uint32_t* next = &_histograms[(begin / grain) * _tableSize];
+
+		for (size_t k = begin; k < end; ++k)
+		{
+			uint32_t i = _byGroup[k];
+
+			_sorted[next[_bucket[i]]++] = i;
+		}
+	});
+
+	_runEnd.resize(offset);
+
+	for (size_t k = offset; k-- > 0;)
+	{
+		uint32_t i = _sorted[k];
+		bool sameRun = k + 1 < offset && _bucket[_sorted[k + 1]] == _bucket[i] && _group[_sorted[k + 1]] == _group[i];
+
+		_runEnd[k] = sameRun ? _runEnd[k + 1] : static_cast<uint32_t>(k + 1);
+	}
+}
+
+void SpatialHashGrid::generatePairs(std::vector<CollisionPair>& pairs)
+{
+	// Half of the neighbourhood, the other half is covered from the neighbours.
+	static const int32_t neighbours[4][2]{ { 1, 0 },{ 1, 1 },{ 0, 1 },{ -1, 1 } };
+
+	size_t gridded = _sorted.size();
+	size_t count = gridded + _oversized.size();
+	size_t jobCount = JobSystem::getChunkCount(count, GRAIN_SIZE);
+
+	if (_jobPairs.size() < jobCount)
+	{
+		_jobPairs.resize(jobCount);
+	}
+
+	_jobTests.assign(jobCount, 0);
+	_jobSkipped.assign(jobCount, 0);
+
+	// Items below gridded are positions in _sorted, the rest index _oversized.
+	JobSystem::get().parallelFor(count, GRAIN_SIZE, [this, gridded](size_t begin, size_t end)
+	{
+		size_t job = begin / GRAIN_SIZE;
+
+		std::vector<CollisionPair>& jobPairs = _jobPairs[job];
+		uint32_t tests = 0;
+		uint32_t skipped = 0;
+
+		jobPairs.clear();
+
+		for (size_t item = begin; item < end; ++item)
+		{
+			if (item < gridded)
+			{
+				uint32_t i = _sorted[item];
+				uint32_t bucket = _bucket[i];
+
+				// Same cell, only colliders sorted after this one
+				for (uint32_t k = static_cast<uint32_t>(item) + 1; k < _bucketStart[bucket + 1];)
+				{
+					uint32_t j = _sorted[k];
+
+					// A run of colliders in a group that can not collide is skipped at once
+					if (!groupsCollide(_group[i], _group[j]))
+					{
+						++skipped;
+						k = _runEnd[k];
+						continue;
+					}
+
+					++k;
+
+					// Another cell hashing to the same bucket
+					if (_cellX[j] != _cellX[i] || _cellZ[j] != _cellZ[i])
+						continue;
+
+					++tests;
+
+					if (overlaps(i, j))
+					{
+						jobPairs.push_back(CollisionPair(_entities[i], _entities[j]));
+					}
+				}
+
+				for (auto& offset : neighbours)
+				{
+					int32_t x = _cellX[i] + offset[0];
+					int32_t z = _cellZ[i] + offset[1];
+
+					uint32_t other = hashCell(x, z);
+
+					for (uint32_t k = _bucketStart[other]; k < _bucketStart[other + 1];)
+					{
+						uint32_t j = _sorted[k];
+
+						if (!groupsCollide(_group[i], _group[j]))
+						{
+							++skipped;
+							k = _runEnd[k];
+							continue;
+						}
+
+						++k;
+
+						if (_cellX[j] != x || _cellZ[j] != z)
+							continue;
+
+						++tests;
+
+						if (overlaps(i, j))
+						{
+							jobPairs.push_back(CollisionPair(_entities[i], _entities[j]));
+						}
+					}
+				}
+			}
+			else
+			{
+				// Oversized colliders are tested against everything
+				size_t index = item - gridded;
+				uint32_t i = _oversized[index];
+
+				for (uint32_t k = 0; k < gridded;)
+				{
+					uint32_t j = _sorted[k];
+
+					if (!groupsCollide(_group[i], _group[j]))
+					{
+						++skipped;
+						k = _runEnd[k];
+						continue;
+					}
+
+					++k;
+					++tests;
+
+					if (overlaps(i, j))
+					{
+						jobPairs.push_back(CollisionPair(_entities[i], _entities[j]));
+					}
+				}
+
+				for (size_t k = index + 1; k < _oversized.size();)
+				{
+					uint32_t j = _oversized[k];
+
+					if (!groupsCollide(_group[i], _group[j]))
+					{
+						++skipped;
+						k = _oversizedRunEnd[k];
+						continue;
+					}
+
+					++k;
+					++tests;
+
+					if (overlaps(i, j))
+					{
+						jobPairs.push_back(CollisionPair(_entities[i], _entities[j]));
+					}
+				}
+			}
+		}
+
+		_jobTests[job] = tests;
+		_jobSkipped[job] = skipped;
+	});
+
+	// Merge in job order so the result does not depend on the scheduling
+	_stats.pairTests = 0;
+	_stats.groupsSkipped = 0;
+
+	for (size_t job = 0; job < jobCount; ++job)
+	{
+		pairs.insert(pairs.end(), _jobPairs[job].begin(), _jobPairs[job].end());
+		_stats.pairTests += _jobTests[job];
+		_stats.groupsSkipped += _jobSkipped[job];
+	}
+}
+
+void SpatialHashGrid::queryColliders(const AABB& box, const ColliderCallback& callback) const
+{
+	auto visit = [&](uint32_t i)
+	{
+		glm::vec3 position{ _posX[i], _posY[i], _posZ[i] };
+		glm::vec3 extent{ _extentX[i], _extentY[i], _extentZ[i] };
+
+		return callback(_entities[i], AABB::fromCenter(position, extent), _layer[i]);
+	};
+
+	for (auto i : _oversized)
+	{
+		if (!visit(i))
+			return;
+	}
+
+	if (_sorted.empty())
+		return;
+
+	// Gridded colliders reach at most half a cell outside their cell
+	float halfCell = _cellSize / 2;
+
+	double minX = std::floor((box.min.x - halfCell) / _cellSize);
+	double minZ = std::floor((box.min.z - halfCell) / _cellSize);
+	double maxX = std::floor((box.max.x + halfCell) / _cellSize);
+	double maxZ = std::floor((box.max.z + halfCell) / _cellSize);
+
+	// Boxes covering more cells than there are colliders are cheaper to scan
+	if ((maxX - minX + 1) * (maxZ - minZ + 1) > static_cast<double>(_sorted.size()))
+	{
+		for (auto i : _sorted)
+		{
+			if (!visit(i))
+				return;
+		}
+
+		return;
+	}
+
+	for (int32_t x = static_cast<int32_t>(minX); x <= static_cast<int32_t>(maxX); ++x)
+	{
+		for (int32_t z = static_cast<int32_t>(minZ); z <= static_cast<int32_t>(maxZ); ++z)
+		{
+			uint32_t bucket = hashCell(x, z);
+
+			for (uint32_t k = _bucketStart[bucket]; k < _bucketStart[bucket + 1]; ++k)
+			{
+				uint32_t i = _sorted[k];
+
+				if (_cellX[i] != x || _cellZ[i] != z)
+					continue;
+
+				if (!visit(i))
+					return;
+			}
+		}
+	}
+}
+
+bool SpatialHashGrid::groupsCollide(uint32_t a, uint32_t b) const
+{
+	return CollisionComponent::canCollide(_groupLayer[a], _groupMask[a], _groupLayer[b], _groupMask[b]);
+}
+
+bool SpatialHashGrid::overlaps(uint32_t a, uint32_t b) const
+{
+	return std::abs(_posX[a] - _posX[b]) < _extentX[a] + _extentX[b] &&
+		std::abs(_posY[a] - _posY[b]) < _extentY[a] + _extentY[b] &&
+		std::abs(_posZ[a] - _posZ[b]) < _extentZ[a] + _extentZ[b];
+}
+
+uint32_t SpatialHashGrid::hashCell(int32_t x, int32_t z) const
+{
+	uint32_t hash = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(z) * 19349663u);
+
+	return hash & (_tableSize - 1);
+}
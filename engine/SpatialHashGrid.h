@@ -0,0 +1,313 @@
+/**
+ * @file	SpatialHashGrid.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Uniform spatial hash grid broadphase
+ */
+
+#pragma once
+
+#include "Broadphase.h"
+#include "EntityManager.h"
+#include "TransformComponent.h"
+#include "EntityDestroyedEvent.h"
+#include "ComponentAssignedEvent.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Broadphase hashing all colliders into a uniform grid in the XZ plane.
+ *
+ * The grid is rebuilt from scratch every frame. Each collider is placed in the
+ * cell containing its center, the cells are laid out with a counting sort and
+ * every cell is then tested against itself and half of its neighbours. This
+ * only works as long as no collider reaches further than half a cell, larger
+ * colliders are kept in a separate list and tested against everything. The
+ * final overlap test is done in 3D.
+ *
+ * Colliders are grouped by layer and mask, and sorted by group within every
+ * bucket. A run of colliders that can not collide with the one being tested
+ * is skipped with a single test, no pair is ever tested by layer.
+ *
+ * Well suited for many colliders of roughly the same size, like trees and
+ * projectiles.
+ */
+class SpatialHashGrid : public Broadphase, public Subscriber<EntityDestroyedEvent>, public Subscriber<ComponentAssignedEvent<TransformComponent>>
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param entMan Pointer to the entity manager.
+	 * @param evMan Pointer to the event manager.
+	 * @param cellSize Side of a grid cell.
+	 */
+	SpatialHashGrid(EntityManager* entMan, EventManager* evMan, float cellSize = DEFAULT_CELL_SIZE);
+
+	/**
+	 * @brief Destructor
+	 */
+	~SpatialHashGrid();
+
+	/**
+	 * @brief Rebuilds the grid and collects the colliding pairs.
+	 * @param pairs Vector to append the colliding pairs to.
+	 */
+	void findPairs(std::vector<CollisionPair>& pairs) override;
+
+	/**
+	 * @brief Starts tracking an entity.
+	 * @param ent Handle to entity.
+	 */
+	void pushEntity(EntityHandle ent) override;
+
+	/**
+	 * @brief Gets the name of the broadphase
+	 * @return "Spatial hash grid"
+	 */
+	const char* getName() const override { return "Spatial hash grid"; }
+
+	/**
+	 * @brief Destroyed entity handler
+	 * @param ev The recieved event to be handled
+	 */
+	void handleEvent(const EntityDestroyedEvent& ev) override;
+
+	/**
+	 * @brief TransformComponent assignment handler
+	 * @param ev The recieved event to be handled
+	 */
+	void handleEvent(const ComponentAssignedEvent<TransformComponent>& ev) override;
+
+	/**
+	 * @brief Cell size getter
+	 * @return Side of a grid cell.
+	 */
+	float getCellSize() const { return _cellSize; }
+
+	/**
+	 * @brief Cell size setter. Takes effect on the next update.
+	 * @param value Side of a grid cell.
+	 */
+	void setCellSize(float value);
+
+	/**
+	 * @brief Cell size that fits colliders with a reach of 1.
+	 */
+	static constexpr float DEFAULT_CELL_SIZE{ 2.f };
+
+protected:
+	/**
+	 * @brief Calls callback with the colliders in the cells around box and
+	 * with all oversized colliders.
+	 * @param box The box.
+	 * @param callback Callback.
+	 */
+	void queryColliders(const AABB& box, const ColliderCallback& callback) const override;
+
+private:
+
+	/**
+	 * @brief Removes destroyed entities and gathers the colliders of the frame.
+	 */
+	void gather();
+
+	/**
+	 * @brief Sorts the colliders into their buckets with a counting sort.
+	 */
+	void sortIntoCells();
+
+	/**
+	 * @brief Tests all cells against themselves and their neighbours.
+	 * @param pairs Vector to append the colliding pairs to.
+	 */
+	void generatePairs(std::vector<CollisionPair>& pairs);
+
+	/**
+	 * @brief Checks whether the layers of the groups a and b allow them to collide.
+	 * @param a Index of first group.
+	 * @param b Index of second group.
+	 * @return True if the colliders of the groups can collide.
+	 */
+	bool groupsCollide(uint32_t a, uint32_t b) const;
+
+	/**
+	 * @brief Checks whether the colliders with index a and b overlap.
+	 * @param a Index of first collider.
+	 * @param b Index of second collider.
+	 * @return True if the colliders overlap.
+	 */
+	bool overlaps(uint32_t a, uint32_t b) const;
+
+	/**
+	 * @brief Gets the bucket a cell hashes to.
+	 * @param x Cell x coordinate.
+	 * @param z Cell z coordinate.
+	 * @return Bucket index.
+	 */
+	uint32_t hashCell(int32_t x, int32_t z) const;
+
+	/**
+	 * @brief Number of colliders per job.
+	 */
+	static constexpr size_t GRAIN_SIZE{ 256 };
+
+	/**
+	 * @brief Marks a collider that is not in any bucket.
+	 */
+	static constexpr uint32_t NO_BUCKET{ 0xFFFFFFFF };
+
+	/**
+	 * @brief Side of a grid cell.
+	 */
+	float _cellSize;
+
+	/**
+	 * @brief All tracked entities.
+	 */
+	std::vector<EntityHandle> _entities{};
+
+	/**
+	 * @brief Entities destroyed since the last update.
+	 */
+	std::vector<EntityHandle> _entToRemove{};
+
+	/**
+	 * @brief Number of buckets in the hash table. Always a power of two.
+	 */
+	uint32_t _tableSize{ 0 };
+
+	/**
+	 * @brief Collider x positions. Indexed like _entities.
+	 */
+	std::vector<float> _posX{};
+
+	/**
+	 * @brief Collider y positions. Indexed like _entities.
+	 */
+	std::vector<float> _posY{};
+
+	/**
+	 * @brief Collider z positions. Indexed like _entities.
+	 */
+	std::vector<float> _posZ{};
+
+	/**
+	 * @brief Collider x extents, negative for entities without collider. Indexed like _entities.
+	 */
+	std::vector<float> _extentX{};
+
+	/**
+	 * @brief Collider y extents. Indexed like _entities.
+	 */
+	std::vector<float> _extentY{};
+
+	/**
+	 * @brief Collider z extents. Indexed like _entities.
+	 */
+	std::vector<float> _extentZ{};
+
+	/**
+	 * @brief Collider layers. Indexed like _entities.
+	 */
+	std::vector<uint32_t> _layer{};
+
+	/**
+	 * @brief Collider masks. Indexed like _entities.
+	 */
+	std::vector<uint32_t> _mask{};
+
+	/**
+	 * @brief Layer and mask group of every collider. Indexed like _entities.
+	 */
+	std::vector<uint32_t> _group{};
+
+	/**
+	 * @brief Collision layers of every group.
+	 */
+	std::vector<uint32_t> _groupLayer{};
+
+	/**
+	 * @brief Collision mask of every group.
+	 */
+	std::vector<uint32_t> _groupMask{};
+
+	/**
+	 * @brief Index into _byGroup where every group starts, then the next
+	 * free slot of every group while sorting.
+	 */
+	std::vector<uint32_t> _groupStart{};
+
+	/**
+	 * @brief Gridded collider indices ordered by group, the order the
+	 * counting sort goes through them in.
+	 */
+	std::vector<uint32_t> _byGroup{};
+
+	/**
+	 * @brief Whether the colliders are fast. Indexed like _entities.
+	 */
+	std::vector<uint8_t> _fast{};
+
+	/**
+	 * @brief Cell x coordinates. Indexed like _entities.
+	 */
+	std::vector<int32_t> _cellX{};
+
+	/**
+	 * @brief Cell z coordinates. Indexed like _entities.
+	 */
+	std::vector<int32_t> _cellZ{};
+
+	/**
+	 * @brief Bucket of every collider, NO_BUCKET if not in the grid. Indexed like _entities.
+	 */
+	std::vector<uint32_t> _bucket{};
+
+	/**
+	 * @brief Per job bucket histograms, laid out job by job.
+	 */
+	std::vector<uint32_t> _histograms{};
+
+	/**
+	 * @brief Index into _sorted where every bucket starts. Has _tableSize + 1 entries.
+	 */
+	std::vector<uint32_t> _bucketStart{};
+
+	/**
+	 * @brief Collider indices ordered by bucket, and by group within a bucket.
+	 */
+	std::vector<uint32_t> _sorted{};
+
+	/**
+	 * @brief Index into _sorted past the run of colliders with the same
+	 * bucket and group. Indexed like _sorted.
+	 */
+	std::vector<uint32_t> _runEnd{};
+
+	/**
+	 * @brief Colliders reaching too far to be placed in a single cell, ordered by group.
+	 */
+	std::vector<uint32_t> _oversized{};
+
+	/**
+	 * @brief Index into _oversized past the run of colliders with the same
+	 * group. Indexed like _oversized.
+	 */
+	std::vector<uint32_t> _oversizedRunEnd{};
+
+	/**
+	 * @brief Pair buffers of every job, merged in order once all jobs are done.
+	 */
+	std::vector<std::vector<CollisionPair>> _jobPairs{};
+
+	/**
+	 * @brief Overlap test counters of every job.
+	 */
+	std::vector<uint32_t> _jobTests{};
+
+	/**
+	 * @brief Counters of every job for the runs skipped by layer.
+	 */
+	std::vector<uint32_t> _jobSkipped{};
+};
@@ -0,0 +1,123 @@
+/**
+ * @file	SpatialQuery.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Types used when querying the broadphase
+ */
+
+#pragma once
+
+#include "EntityManager.h"
+#include "AABB.h"
+
+#include <glm/glm.hpp>
+#include <type_traits>
+#include <cstdint>
+
+/**
+ * @brief A ray for ray casts against the broadphase.
+ */
+struct Ray
+{
+	/**
+	 * @brief Origin of the ray.
+	 */
+	glm::vec3 origin{};
+
+	/**
+	 * @brief Direction of the ray, normalized.
+	 */
+	glm::vec3 direction{ 0.f, 0.f, -1.f };
+
+	/**
+	 * @brief Max distance along the ray.
+	 */
+	float maxDistance{ 1000.f };
+};
+
+/**
+ * @brief A collider found by a ray cast or a nearest neighbour query.
+ */
+struct SpatialHit
+{
+	/**
+	 * @brief Handle to entity, INVALID_ENTITY if nothing was hit.
+	 */
+	EntityHandle ent{ INVALID_ENTITY };
+
+	/**
+	 * @brief Distance along the ray, or from the query point to the collider.
+	 */
+	float distance{ 0.f };
+};
+
+/**
+ * @brief Reference to a callable taking the entity, box and layer of a
+ * collider, passed to the virtual query functions of the structures.
+ *
+ * Only holds a pointer to the callable and a function calling it, so unlike
+ * std::function it never allocates. The callable must outlive the
+ * reference, which holds for a lambda passed straight to a query.
+ *
+ * @tparam Result Return type of the callable.
+ */
+template <typename Result>
+class QueryCallback
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @tparam Func Type of the callable.
+	 * @param func The callable.
+	 */
+	template <typename Func, typename = typename std::enable_if<!std::is_same<typename std::decay<Func>::type, QueryCallback>::value>::type>
+	QueryCallback(const Func& func) : _callable{ &func }, _invoke{ &invoke<Func> } {}
+
+	/**
+	 * @brief Calls the callable.
+	 * @param ent Handle to entity.
+	 * @param box Box of the collider.
+	 * @param layer Layers of the collider.
+	 * @return Result of the callable.
+	 */
+	Result operator()(EntityHandle ent, const AABB& box, uint32_t layer) const { return _invoke(_callable, ent, box, layer); }
+
+private:
+	/**
+	 * @brief Calls a callable of a given type.
+	 * @tparam Func Type of the callable.
+	 * @param callable Pointer to the callable.
+	 * @param ent Handle to entity.
+	 * @param box Box of the collider.
+	 * @param layer Layers of the collider.
+	 * @return Result of the callable.
+	 */
+	template <typename Func>
+	static Result invoke(const void* callable, EntityHandle ent, const AABB& box, uint32_t layer)
+	{
+		return (*static_cast<const Func*>(callable))(ent, box, layer);
+	}
+
+	/**
+	 * @brief Pointer to the callable.
+	 */
+	const void* _callable;
+
+	/**
+	 * @brief Function calling the callable.
+	 */
+	Result (*_invoke)(const void*, EntityHandle, const AABB&, uint32_t);
+};
+
+/**
+ * @brief Callback for the colliders a structure finds for a query. Gets the
+ * entity, its box and its layer, returns false to stop the query.
+ */
+typedef QueryCallback<bool> ColliderCallback;
+
+/**
+ * @brief Callback for the colliders a structure finds along a ray. Gets the
+ * entity, its box and its layer, returns the max distance for the rest of
+ * the cast or a negative value to stop it.
+ */
+typedef QueryCallback<float> RayCallback;
@@ -0,0 +1,86 @@
+/**
+ * @file	StaticBVH.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Read-only bounding volume hierarchy for immovable colliders
+ */
+
+#include "StaticBVH.h"
+
+#include <algorithm>
+
+constexpr uint32_t StaticBVH::MAX_LEAF_SIZE;
+constexpr uint32_t StaticBVH::QUERY_STACK_SIZE;
+
+void StaticBVH::build(std::vector<Item> items)
+{
+	_items = std::move(items);
+	_nodes.clear();
+
+	if (_items.empty())
+		return;
+
+	// A binary tree with leaves of at least one item never needs more
+	_nodes.reserve(2 * _items.size());
+
+	buildNode(0, static_cast<uint32_t>(_items.size()));
+}
+
+void StaticBVH::clear()
+{
+	_items.clear();
+	_nodes.clear();
+}
+
+void StaticBVH::buildNode(uint32_t begin, uint32_t end)
+{
+	uint32_t index = static_cast<uint32_t>(_nodes.size());
+
+	_nodes.push_back(Node{});
+
+	AABB bounds = _items[begin].aabb;
+	AABB centers{ _items[begin].aabb.getCenter(), _items[begin].aabb.getCenter() };
+
+	for (uint32_t i = begin + 1; i < end; ++i)
+	{
+		glm::vec3 center = _items[i].aabb.getCenter();
+
+		bounds = bounds.merge(_items[i].aabb);
+		centers = centers.merge(AABB{ center, center });
+	}
+
+	_nodes[index].aabb = bounds;
+
+	if (end - begin <= MAX_LEAF_SIZE)
+	{
+		_nodes[index].offset = begin;
+		_nodes[index].count = end - begin;
+
+		return;
+	}
+
+	// Split at the median of the axis along which the centers spread the most
+	glm::vec3 spread = centers.max - centers.min;
+
+	int axis = 0;
+
+	if (spread.y > spread[axis]) axis = 1;
+	if (spread.z > spread[axis]) axis = 2;
+
+	uint32_t middle = begin + (end - begin) / 2;
+
+	std::nth_element(_items.begin() + begin, _items.begin() + middle, _items.begin() + end, [axis](const Item& a, const Item& b)
+	{
+		return a.aabb.min[axis] + a.aabb.max[axis] < b.aabb.min[axis] + b.aabb.max[axis];
+	});
+
+	buildNode(begin, middle);
+
+	// The right child goes after the whole left subtree
+	uint32_t right = static_cast<uint32_t>(_nodes.size());
+
+	buildNode(middle, end);
+
+	_nodes[index].offset = right;
+	_nodes[index].count = 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * @file	StaticBVH.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Read-only bounding volume hierarchy for immovable colliders
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "EntityManager.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Bounding volume hierarchy built once from a fixed set of boxes.
+ *
+ * The tree is built top down by splitting at the median of the longest axis
+ * and stored depth first in a flat array, so the left child of a node always
+ * directly follows it. It can not be changed after the build, only rebuilt.
+ *
+ * Queries only read the tree and can run from several threads at once.
+ */
+class StaticBVH
+{
+public:
+	/**
+	 * @brief A box in the tree.
+	 */
+	struct Item
+	{
+		/**
+		 * @brief The box.
+		 */
+		AABB aabb;
+
+		/**
+		 * @brief Entity owning the box.
+		 */
+		EntityHandle ent;
+	};
+
+	/**
+	 * @brief Rebuilds the tree from a set of boxes.
+	 * @param items The boxes. Taken over by the tree.
+	 */
+	void build(std::vector<Item> items);
+
+	/**
+	 * @brief Removes all boxes.
+	 */
+	void clear();
+
+	/**
+	 * @brief Gets the number of boxes in the tree.
+	 * @return Number of boxes.
+	 */
+	size_t getItemCount() const { return _items.size(); }
+
+	/**
+	 * @brief Gets the number of nodes in the tree.
+	 * @return Number of nodes.
+	 */
+	size_t getNodeCount() const { return _nodes.size(); }
+
+	/**
+	 * @brief Calls callback with every item whose box overlaps aabb.
+	 * @tparam Func Callable as bool(const Item& item). Returning false stops the query.
+	 * @param aabb Box to query.
+	 * @param callback Callback.
+	 */
+	template <typename Func>
+	void query(const AABB& aabb, Func&& callback) const;
+
+	/**
+	 * @brief Calls callback with every item whose box is hit by a ray.
+	 * @tparam Func Callable as float(const Item& item, float distance), where
+	 * distance is where the ray enters the box. Returns the max distance for
+	 * the rest of the cast, a negative value stops the cast.
+	 * @param origin Origin of the ray.
+	 * @param direction Direction of the ray.
+	 * @param maxDistance Max distance along the ray.
+	 * @param callback Callback.
+	 */
+	template <typename Func>
+	void rayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, Func&& callback) const;
+
+	/**
+	 * @brief Walks the tree against a volume. Subtrees outside it are
+	 * skipped, and nothing below a subtree fully inside it is tested again.
+	 * @tparam Classify Callable as Containment(const AABB& aabb).
+	 * @tparam Func Callable as void(const Item& item, bool inside). Called
+	 * for every item below a node inside the volume, with inside set, and for
+	 * every item in a leaf partly inside the volume.
+	 * @param classify Tests a box against the volume.
+	 * @param callback Callback.
+	 */
+	template <typename Classify, typename Func>
+	void traverse(Classify&& classify, Func&& callback) const;
+
+private:
+
+	/**
+	 * @brief Node in the flattened tree.
+	 */
+	struct Node
+	{
+		/**
+		 * @brief Box of everything below the node.
+		 */
+		AABB aabb;
+
+		/**
+		 * @brief First item of a leaf, or the right child of an inner node.
+		 */
+		uint32_t offset;
+
+		/**
+		 * @brief Number of items in a leaf, 0 for inner nodes.
+		 */
+		uint32_t count;
+	};
+
+	/**
+	 * @brief Builds the subtree of the items in [begin, end).
+	 * @param begin First item.
+	 * @param end One past the last item.
+	 */
+	void buildNode(uint32_t begin, uint32_t end);
+
+	/**
+	 * @brief Max number of items in a leaf.
+	 */
+	static constexpr uint32_t MAX_LEAF_SIZE{ 4 };
+
+	/**
+	 * @brief Max depth of the query stack. Median splits keep the depth
+	 * logarithmic in the number of items.
+	 */
+	static constexpr uint32_t QUERY_STACK_SIZE{ 64 };
+
+	/**
+	 * @brief Nodes, depth first.
+	 */
+	std::vector<Node> _nodes{};
+
+	/**
+	 * @brief Items, ordered so every leaf covers a contiguous range.
+	 */
+	std::vector<Item> _items{};
+};
+
+template <typename Func>
+void StaticBVH::query(const AABB& aabb, Func&& callback) const
+{
+	if (_nodes.empty())
+		return;
+
+	uint32_t stack[QUERY_STACK_SIZE];
+	uint32_t top = 0;
+
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t index = stack[--top];
+		const Node& node = _nodes[index];
+
+		if (!node.aabb.overlaps(aabb))
+			continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if (_items[i].aabb.overlaps(aabb) && !callback(_items[i]))
+					return;
+			}
+		}
+		else
+		{
+			stack[top++] = node.offset;
+			stack[top++] = index + 1;
+		}
+	}
+}
+
+template <typename Func>
+void StaticBVH::rayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, Func&& callback) const
+{
+	if (_nodes.empty())
+		return;
+
+	glm::vec3 invDirection = 1.f / direction;
+
+	uint32_t stack[QUERY_STACK_SIZE];
+	uint32_t top = 0;
+
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t index = stack[--top];
+		const Node& node = _nodes[index];
+
+		float distance;
+
+		if (!node.aabb.intersectRay(origin, invDirection, maxDistance, distance))
+			continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if (!_items[i].aabb.intersectRay(origin, invDirection, maxDistance, distance))
+					continue;
+
+				float value = callback(_items[i], distance);
+
+				if (value < 0.f)
+					return;
+
+				maxDistance = std::min(maxDistance, value);
+			}
+		}
+		else
+		{
+			stack[top++] = node.offset;
+			stack[top++] = index + 1;
+		}
+	}
+}
+
+template <typename Classify, typename Func>
+void StaticBVH::traverse(Classify&& classify, Func&& callback) const
+{
+	if (_nodes.empty())
+		return;
+
+	// The top bit of a stack entry marks subtrees known to be inside
+	const uint32_t insideBit = 0x80000000;
+
+	uint32_t stack[QUERY_STACK_SIZE];
+	uint32_t top = 0;
+
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t entry = stack[--top];
+		uint32_t index = entry & ~insideBit;
+
+		bool inside = (entry & insideBit) != 0;
+
+		const Node& node = _nodes[index];
+
+		if (!inside)
+		{
+			Containment containment = classify(node.aabb);
+
+			if (containment == CONTAINMENT_OUTSIDE)
+				continue;
+
+			inside = containment == CONTAINMENT_INSIDE;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				callback(_items[i], inside);
+			}
+		}
+		else
+		{
+			uint32_t flag = inside ? insideBit : 0;
+
+			stack[top++] = node.offset | flag;
+			stack[top++] = (index + 1) | flag;
+		}
+	}
+}
@@ -0,0 +1,135 @@
+/**
+ * @file	Std140Block.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Lays out uniform block data by the std140 rules
+ */
+
+#include "Std140Block.h"
+
+#include <cstring>
+#include <cstdint>
+
+constexpr size_t Std140Block::VEC4_ALIGNMENT;
+
+void Std140Block::clear()
+{
+	_data.clear();
+}
+
+void Std140Block::push(float value)
+{
+	write(&value, sizeof(value), sizeof(float));
+}
+
+void Std140Block::push(int value)
+{
+	int32_t converted = static_cast<int32_t>(value);
+
+	write(&converted, sizeof(converted), sizeof(int32_t));
+}
+
+void Std140Block::push(bool value)
+{
+	// GLSL bools are four bytes wide in a block
+	uint32_t converted = value ? 1 : 0;
+
+	write(&converted, sizeof(converted), sizeof(uint32_t));
+}
+
+void Std140Block::push(glm::vec2 value)
+{
+	write(&value[0], sizeof(float) * 2, sizeof(float) * 2);
+}
+
+void Std140Block::push(glm::vec3 value)
+{
+	write(&value[0], sizeof(float) * 3, VEC4_ALIGNMENT);
+}
+
+void Std140Block::push(glm::vec4 value)
+{
+	write(&value[0], sizeof(float) * 4, VEC4_ALIGNMENT);
+}
+
+void Std140Block::push(const glm::mat4& value)
+{
+	// Stored as four vec4 columns
+	for (int column = 0; column < 4; ++column)
+	{
+		push(value[column]);
+	}
+}
+
+void Std140Block::push(const glm::mat4* values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		push(values[i]);
+	}
+
+	align(VEC4_ALIGNMENT);
+}
+
+void Std140Block::push(const PointLight& pointLight)
+{
+	beginStruct();
+
+	push(pointLight.getPosition());
+	push(pointLight.getConstant());
+	push(pointLight.getLinear());
+	push(pointLight.getQuadratic());
+	push(pointLight.getAmbient());
+	push(pointLight.getDiffuse());
+	push(pointLight.getSpecular());
+
+	endStruct();
+}
+
+void Std140Block::push(const Material& material)
+{
+	beginStruct();
+
+	push(material.getAmbient());
+	push(material.getDiffuse());
+	push(material.getSpecular());
+	push(material.getShininess());
+
+	endStruct();
+}
+
+void Std140Block::beginStruct()
+{
+	align(VEC4_ALIGNMENT);
+}
+
+void Std140Block::endStruct()
+{
+	align(VEC4_ALIGNMENT);
+}
+
+const void* Std140Block::getData() const
+{
+	return _data.data();
+}
+
+size_t Std140Block::getSize() const
+{
+	return _data.size();
+}
+
+void Std140Block::write(const void* data, size_t size, size_t alignment)
+{
+	align(alignment);
+
+	size_t offset = _data.size();
+
+	_data.resize(offset + size);
+
+	std::memcpy(&_data[offset], data, size);
+}
+
+void Std140Block::align(size_t alignment)
+{
+	_data.resize((_data.size() + alignment - 1) / alignment * alignment, 0);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file	Std140Block.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Lays out uniform block data by the std140 rules
+ */
+
+#pragma once
+
+#include "PointLight.h"
+#include "Material.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Contents of a std140 uniform block.
+ *
+ * Members are pushed in the order they are declared in the shader, and
+ * every push pads to the alignment std140 gives the type: 4 bytes for
+ * scalars, 8 for vec2 and 16 for vec3, vec4, matrix columns, array
+ * elements and structs. The result can be copied straight into a uniform
+ * buffer.
+ */
+class Std140Block
+{
+public:
+	/**
+	 * @brief Removes all members.
+	 */
+	void clear();
+
+	/**
+	 * @brief Adds a float member.
+	 * @param value Value.
+	 */
+	void push(float value);
+
+	/**
+	 * @brief Adds an int member.
+	 * @param value Value.
+	 */
+	void push(int value);
+
+	/**
+	 * @brief Adds a bool member, which takes four bytes.
+	 * @param value Value.
+	 */
+	void push(bool value);
+
+	/**
+	 * @brief Adds a vec2 member.
+	 * @param value Value.
+	 */
+	void push(glm::vec2 value);
+
+	/**
+	 * @brief Adds a vec3 member. A scalar pushed next fills the fourth component.
+	 * @param value Value.
+	 */
+	void push(glm::vec3 value);
+
+	/**
+	 * @brief Adds a vec4 member.
+	 * @param value Value.
+	 */
+	void push(glm::vec4 value);
+
+	/**
+	 * @brief Adds a mat4 member.
+	 * @param value Value.
+	 */
+	void push(const glm::mat4& value);
+
+	/**
+	 * @brief Adds a mat4 array member.
+	 * @param values First element.
+	 * @param count Number of elements.
+	 */
+	void push(const glm::mat4* values, size_t count);
+
+	/**
+	 * @brief Adds a Light struct member, as declared in the shaders.
+	 * @param pointLight PointLight object.
+	 */
+	void push(const PointLight& pointLight);
+
+	/**
+	 * @brief Adds a Material struct member, as declared in the shaders.
+	 * @param material Material object.
+	 */
+	void push(const Material& material);
+
+	/**
+	 * @brief Starts a struct member.
+	 */
+	void beginStruct();
+
+	/**
+	 * @brief Ends a struct member, padding it to a whole number of vec4.
+	 */
+	void endStruct();
+
+	/**
+	 * @brief Gets the data.
+	 * @return Pointer to the first byte.
+	 */
+	const void* getData() const;
+
+	/**
+	 * @brief Gets the size of the data, excluding padding after the last member.
+	 * @return Size in bytes.
+	 */
+	size_t getSize() const;
+
+	/**
+	 * @brief Alignment of vec3, vec4, matrix columns, array elements and structs.
+	 */
+	static constexpr size_t VEC4_ALIGNMENT{ 16 };
+
+private:
+	/**
+	 * @brief Pads to an alignment and appends bytes.
+	 * @param data Bytes to append.
+	 * @param size Number of bytes.
+	 * @param alignment Alignment of the member.
+	 */
+	void write(const void* data, size_t size, size_t alignment);
+
+	/**
+	 * @brief Pads the data to an alignment.
+	 * @param alignment The alignment.
+	 */
+	void align(size_t alignment);
+
+	/**
+	 * @brief The data.
+	 */
+	std::vector<unsigned char> _data{};
+};
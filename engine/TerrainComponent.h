@@ -27,7 +27,7 @@ public:
 	 * @brief XML Constructor
 	 * @param node XML node.
 	 */
-	explicit TerrainComponent(rapidxml::xml_node<>* node) {} // TODO: Lgg till
+	explicit TerrainComponent(rapidxml::xml_node<>* node) {} // TODO: Lägg till
 
 	/**
 	 * @brief ID getter
@@ -10,6 +10,7 @@
 #include <list>
 #include <iostream>
 #include "Utils.h"
+#include "GLState.h"
 
 TerrainModel::TerrainModel(const char* filePath)
 {
@@ -23,7 +24,12 @@ TerrainModel::~TerrainModel()
 
 void TerrainModel::draw(ShaderProgram& shader) const
 {
+	// DrawModel binds the vertex array and buffers itself
+	GLState::get().bindVertexArray(model->vao);
+
 	DrawModel(model, shader.getShaderProgramHandle(), "vertex_position", "vertex_normal", "vertex_texture_coordinates");
+
+	GLState::get().invalidateBuffers();
 }
 
 float TerrainModel::getHeight(float x, float z) const
@@ -200,6 +206,11 @@ void TerrainModel::generate(const char* filePath)
 		indexArray,
 		vertexCount,
 		triangleCount * 3);
+
+	// The loader binds its vertex array and buffers directly
+	GLState::get().invalidate();
+
+	bounds = AABB::fromPoints(model->vertexArray, model->numVertices);
 }
 
 float TerrainModel::getGridHeight(int x, int z) const
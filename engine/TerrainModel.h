@@ -11,6 +11,7 @@
 #include <glm/glm.hpp>
 
 #include "ShaderProgram.h"
+#include "AABB.h"
 
 class TGA;
 
@@ -45,6 +46,12 @@ public:
 	 * @return Height at (x,z)
 	 */
 	float getHeight(float x, float z) const;
+
+	/**
+	 * @brief Gets the box around the terrain in model space.
+	 * @return Bounding box.
+	 */
+	const AABB& getBounds() const { return bounds; }
 private:
 
 	/**
@@ -86,4 +93,9 @@ private:
 	 * @brief Terrain Model
 	 */
 	Model* model;
+
+	/**
+	 * @brief Box around the terrain in model space.
+	 */
+	AABB bounds{};
 };
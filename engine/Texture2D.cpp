@@ -9,6 +9,8 @@
 
 #include "TGA.h"
 #include "BMP.h"
+#include "GLState.h"
+#include "GraphicsDevice.h"
 
 #include <string>
 #include <iostream>
@@ -47,17 +49,17 @@ Texture2D::Texture2D(
 		throw std::invalid_argument(std::string("Invalid file. (") + filePath + ")");
 	}
 
-	glGenTextures(1, &textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	textureID = device.createTexture();
+
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glTexImage2D(
+	device.texImage2D(
 		GL_TEXTURE_2D,							// Target
-		0,										// Level
 		file->hasAlpha() ? GL_RGBA : GL_RGB,	// Internal Format
 		file->getWidth(),						// Width
 		file->getHeight(),						// Height
-		0,										// Border
 		file->hasAlpha() ? GL_RGBA : GL_RGB,	// Format
 		GL_UNSIGNED_BYTE,						// Type
 		file->getPixels().data());				// Pixels
@@ -66,16 +68,16 @@ Texture2D::Texture2D(
 	switch (sWrap)
 	{
 	case TEXTURE_2D_WRAP::REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::MIRRORED_REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_EDGE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_BORDER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
 		break;
 	}
 
@@ -83,26 +85,26 @@ Texture2D::Texture2D(
 	switch (tWrap)
 	{
 	case TEXTURE_2D_WRAP::REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::MIRRORED_REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_EDGE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_BORDER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 	}
 
 
 	switch (magFilter)
 	{
 	case TEXTURE_2D_FILTERING::NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		break;
 	default:
 		std::cerr << "Invalid GL_TEXTURE_MAG_FILTER parameter to texture " << filePath << std::endl;
@@ -112,26 +114,26 @@ Texture2D::Texture2D(
 	switch (minFilter)
 	{
 	case TEXTURE_2D_FILTERING::NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		break;
 	case TEXTURE_2D_FILTERING::NEAREST_MIPMAP_NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR_MIPMAP_NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::NEAREST_MIPMAP_LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR_MIPMAP_LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		break;
 	}
 
-	glGenerateMipmap(GL_TEXTURE_2D);
+	device.generateMipmap(GL_TEXTURE_2D);
 
 	width = file->getWidth();
 	height = file->getHeight();
@@ -143,8 +145,12 @@ Texture2D::Texture2D(
 Texture2D::Texture2D(GLuint width, GLuint height, TEXTURE_2D_FORMAT format, TEXTURE_2D_DATATYPE type, GLvoid* data)
 	: width(width), height(height)
 {
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	textureID = device.createTexture();
+
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
+
 	GLenum f;
 	GLenum t;
 
@@ -175,13 +181,11 @@ Texture2D::Texture2D(GLuint width, GLuint height, TEXTURE_2D_FORMAT format, TEXT
 		throw std::invalid_argument(std::string("Invalid type."));
 	}
 
-	glTexImage2D(
+	device.texImage2D(
 		GL_TEXTURE_2D,	// Target
-		0,				// Level
 		f,				// Internal format
 		width,			// Width
 		height,			// Height
-		0,				// Border
 		f,				// Format
 		t,				// Type
 		data			// Data
@@ -191,7 +195,12 @@ Texture2D::Texture2D(GLuint width, GLuint height, TEXTURE_2D_FORMAT format, TEXT
 Texture2D::~Texture2D()
 {
 	if (textureID != 0)
-		glDeleteTextures(1, &textureID);
+	{
+		GraphicsDevice::get().deleteTexture(textureID);
+
+		// Deleting unbinds the texture behind the back of the cache
+		GLState::get().invalidate();
+	}
 }
 
 Texture2D::Texture2D(Texture2D&& other) noexcept
@@ -216,420 +225,356 @@ GLuint Texture2D::getHandle() const
 
 void Texture2D::setDepthStencilTextureMode(TEXTURE_2D_TEXTURE_MODE mode)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (mode)
 	{
 	case TEXTURE_2D_TEXTURE_MODE::DEPTH_COMPONENT:
-		glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT);
+		device.texParameter(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT);
 		break;
 	case TEXTURE_2D_TEXTURE_MODE::STENCIL_INDEX:
-		// OBS Fel i OpenGL-manualen. Detta r rtt, inte GL_STENCIL_COMPONENT. 
+		// OBS Fel i OpenGL-manualen. Detta är rätt, inte GL_STENCIL_COMPONENT. 
 		// Ref: http://stackoverflow.com/questions/31449740/how-to-utilize-gl-arb-stencil-texturing
-		glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_STENCIL_INDEX);
+		device.texParameter(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_STENCIL_INDEX);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureBorderColor(Color color)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	// Detta r hax men fungerar p.g.a att frgerna ligger i rgba-ordning i color.
-	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &color.r);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texBorderColor(GL_TEXTURE_2D, glm::vec4{ color.r, color.g, color.b, color.a });
 }
 
 void Texture2D::setTextureBaseLevel(GLint baseLevel)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
 }
 
 void Texture2D::setTextureMaxLevel(GLint maxLevel)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
 }
 
 void Texture2D::setTextureCompareFunc(TEXTURE_2D_COMPARE_FUNC func)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (func)
 	{
 	case TEXTURE_2D_COMPARE_FUNC::LESS_EQUAL:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::GREATER_EQUAL:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_GEQUAL);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_GEQUAL);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::LESS:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::GREATER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_GREATER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_GREATER);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::EQUAL:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_EQUAL);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_EQUAL);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::NOT_EQUAL:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_NOTEQUAL);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_NOTEQUAL);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::ALWAYS:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_ALWAYS);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_ALWAYS);
 		break;
 	case TEXTURE_2D_COMPARE_FUNC::NEVER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_NEVER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_NEVER);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureCompareMode(TEXTURE_2D_COMPARE_MODE mode)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (mode)
 	{
 	case TEXTURE_2D_COMPARE_MODE::COMPARE_REF_TO_TEXTURE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
 		break;
 	case TEXTURE_2D_COMPARE_MODE::NONE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureLODBias(GLint LODBias)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, LODBias);
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, LODBias);
 }
 
 void Texture2D::setTextureMinLOD(GLint minLOD)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, minLOD);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, minLOD);
 }
 
 void Texture2D::setTextureMaxLOD(GLint maxLOD)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, maxLOD);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
+	device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, maxLOD);
 }
 
 void Texture2D::setTextureWrapS(TEXTURE_2D_WRAP sWrap)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (sWrap)
 	{
 	case TEXTURE_2D_WRAP::REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::MIRRORED_REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_EDGE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_BORDER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureWrapT(TEXTURE_2D_WRAP tWrap)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (tWrap)
 	{
 	case TEXTURE_2D_WRAP::REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::MIRRORED_REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_EDGE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_BORDER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureWrapR(TEXTURE_2D_WRAP rWrap)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (rWrap)
 	{
 	case TEXTURE_2D_WRAP::REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::MIRRORED_REPEAT:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_EDGE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		break;
 	case TEXTURE_2D_WRAP::CLAMP_TO_BORDER:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureMagFilter(TEXTURE_2D_FILTERING magFilter)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (magFilter)
 	{
 	case TEXTURE_2D_FILTERING::NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureMinFilter(TEXTURE_2D_FILTERING minFilter)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (minFilter)
 	{
 	case TEXTURE_2D_FILTERING::NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		break;
 	case TEXTURE_2D_FILTERING::NEAREST_MIPMAP_NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR_MIPMAP_NEAREST:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
 		break;
 	case TEXTURE_2D_FILTERING::NEAREST_MIPMAP_LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
 		break;
 	case TEXTURE_2D_FILTERING::LINEAR_MIPMAP_LINEAR:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureSwizzleR(TEXTURE_2D_SWIZZLE_COMPONENT comp)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (comp)
 	{
 	case TEXTURE_2D_SWIZZLE_COMPONENT::RED:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_RED);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_RED);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::GREEN:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_GREEN);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_GREEN);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::BLUE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_BLUE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_BLUE);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ALPHA:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ALPHA);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ALPHA);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ZERO:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ONE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ONE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ONE);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureSwizzleG(TEXTURE_2D_SWIZZLE_COMPONENT comp)
 {
-	GLint currentTexture;
-
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (comp)
 	{
 	case TEXTURE_2D_SWIZZLE_COMPONENT::RED:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::GREEN:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_GREEN);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_GREEN);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::BLUE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_BLUE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_BLUE);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ALPHA:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ALPHA);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ALPHA);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ZERO:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ONE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ONE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ONE);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureSwizzleB(TEXTURE_2D_SWIZZLE_COMPONENT comp)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (comp)
 	{
 	case TEXTURE_2D_SWIZZLE_COMPONENT::RED:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::GREEN:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_GREEN);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_GREEN);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::BLUE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_BLUE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_BLUE);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ALPHA:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ALPHA);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ALPHA);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ZERO:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ONE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ONE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ONE);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 void Texture2D::setTextureSwizzleA(TEXTURE_2D_SWIZZLE_COMPONENT comp)
 {
-	GLint currentTexture;
+	GraphicsDevice& device = GraphicsDevice::get();
 
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(0, GL_TEXTURE_2D, textureID);
 
 	switch (comp)
 	{
 	case TEXTURE_2D_SWIZZLE_COMPONENT::RED:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::GREEN:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::BLUE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_BLUE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_BLUE);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ALPHA:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ZERO:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ZERO);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ZERO);
 		break;
 	case TEXTURE_2D_SWIZZLE_COMPONENT::ONE:
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ONE);
+		device.texParameter(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ONE);
 		break;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, currentTexture);
 }
 
 TEXTURE_2D_TEXTURE_MODE Texture2D::getDepthStencilTextureMode() const
@@ -1174,17 +1119,15 @@ void Texture2D::bind() const
 
 void Texture2D::bind(GLuint texUnit) const
 {
-	GLint numTextureUnits;
-
-	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &numTextureUnits);
+	// Fixed for the context, so it is only queried once
+	static const GLint numTextureUnits = GraphicsDevice::get().getInteger(GL_MAX_TEXTURE_IMAGE_UNITS);
 
-	if (texUnit >= numTextureUnits)
+	if (texUnit >= static_cast<GLuint>(numTextureUnits))
 	{
 		throw std::invalid_argument("Requested texture unit larger than supported");
 	}
 
-	glActiveTexture(GL_TEXTURE0 + texUnit);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::get().bindTexture(texUnit, GL_TEXTURE_2D, textureID);
 }
 
 void swap(Texture2D& first, Texture2D& second) noexcept
@@ -303,7 +303,7 @@ enum class TEXTURE_2D_FILTERING
 	INVALID_VALUE
 };
 
-// Fyll p efter behov.
+// Fyll på efter behov.
 enum class TEXTURE_2D_FORMAT
 {
 	DEPTH_COMPONENT,
@@ -312,7 +312,7 @@ enum class TEXTURE_2D_FORMAT
 	INVALID_VALUE
 };
 
-// Fyll p efter behov.
+// Fyll på efter behov.
 enum class TEXTURE_2D_DATATYPE
 {
 	FLOAT,
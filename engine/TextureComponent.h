@@ -28,7 +28,7 @@ public:
 	 * @brief XML constructor.
 	 * @param node XML node.
 	 */
-	explicit TextureComponent(rapidxml::xml_node<>* node) {} // TODO: Lgg till
+	explicit TextureComponent(rapidxml::xml_node<>* node) {} // TODO: Lägg till
 
 	/**
 	 * @brief Attach a texture to the component.
@@ -41,7 +41,7 @@ public:
 	 */
 	explicit TransformComponent(rapidxml::xml_node<>* node)
 	{
-		// Flummigt. Finns nog bttre stt.
+		// Flummigt. Finns nog bättre sätt.
 
 		std::stringstream ss1{ node->first_node("position")->value() };
 
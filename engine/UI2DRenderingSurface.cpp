@@ -7,6 +7,9 @@
 
 #include "UI2DRenderingSurface.h"
 
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
 #include <iostream>
 
 namespace userinterface
@@ -20,16 +23,19 @@ namespace userinterface
 		_projection{ glm::ortho(0.f, static_cast<GLfloat>(width), 0.f, static_cast<GLfloat>(height)) },
 		_textRenderer{ width, height }
 	{
+		GraphicsDevice& device = GraphicsDevice::get();
+		GLState& state = GLState::get();
+
 		// Setup Quad
-		glGenVertexArrays(1, &_quadVAO);
-		glGenBuffers(1, &_quadVBO);
-		glBindVertexArray(_quadVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, _quadVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_STATIC_DRAW);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		_quadVAO = device.createVertexArray();
+		_quadVBO = device.createBuffer();
+		state.bindVertexArray(_quadVAO);
+		state.bindBuffer(GL_ARRAY_BUFFER, _quadVBO);
+		device.bufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr, GL_STATIC_DRAW);
+		device.setAttribArrayEnabled(0, true);
+		device.vertexAttribPointer(0, 4, 4 * sizeof(GLfloat), 0);
+		state.bindBuffer(GL_ARRAY_BUFFER, 0);
+		state.bindVertexArray(0);
 
 		// Setup Shader
 		try
@@ -53,11 +59,25 @@ namespace userinterface
 
 	UI2DRenderingSurface::~UI2DRenderingSurface()
 	{
-		glDeleteBuffers(1, &_quadVBO);
-		glDeleteVertexArrays(1, &_quadVAO);
+		GraphicsDevice::get().deleteBuffer(_quadVBO);
+		GraphicsDevice::get().deleteVertexArray(_quadVAO);
+
+		// Deleting unbinds the objects behind the back of the cache
+		GLState::get().invalidate();
 	}
 
 	void UI2DRenderingSurface::renderQuad(int posX, int posY, int width, int height, Color color)
+	{
+		if (_recording)
+		{
+			_recording->push_back(UIDrawCommand{ false, posX, posY, width, height, 0.f, color, std::string{} });
+			return;
+		}
+
+		drawQuad(posX, posY, width, height, color);
+	}
+
+	void UI2DRenderingSurface::drawQuad(int posX, int posY, int width, int height, Color color)
 	{
 		GLfloat vertices[6][4] = {
 			{ posX, posY + height, 0.0, 0.0 },
@@ -69,23 +89,55 @@ namespace userinterface
 			{ posX + width, posY + height, 1.0, 0.0 }
 		};
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		GLState& state = GLState::get();
 
-		glBindVertexArray(_quadVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, _quadVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
+		state.polygonMode(GL_FILL);
+
+		state.bindVertexArray(_quadVAO);
+		state.bindBuffer(GL_ARRAY_BUFFER, _quadVBO);
+		GraphicsDevice::get().bufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
 
 		_shader.use();
 
 		_shader.uploadUniform("color", glm::vec4(color.r, color.g, color.b, color.a));
 		_shader.uploadUniform("projection", _projection);
 
-		glDrawArrays(GL_TRIANGLES, 0, 6);
-		glBindVertexArray(0);
+		GraphicsDevice::get().drawArrays(GL_TRIANGLES, 0, 6);
 	}
 
 	void UI2DRenderingSurface::renderText(const std::string& str, int x, int y, float scale, Color color)
 	{
+		if (_recording)
+		{
+			_recording->push_back(UIDrawCommand{ true, x, y, 0, 0, scale, color, str });
+			return;
+		}
+
 		_textRenderer.render(str, x, y, scale, color, &_font);
 	}
+
+	void UI2DRenderingSurface::beginRecording(UIDrawList* list)
+	{
+		_recording = list;
+	}
+
+	void UI2DRenderingSurface::endRecording()
+	{
+		_recording = nullptr;
+	}
+
+	void UI2DRenderingSurface::replay(const UIDrawList& list)
+	{
+		for (const UIDrawCommand& command : list)
+		{
+			if (command.text)
+			{
+				_textRenderer.render(command.str, command.posX, command.posY, command.scale, command.color, &_font);
+			}
+			else
+			{
+				drawQuad(command.posX, command.posY, command.width, command.height, command.color);
+			}
+		}
+	}
 }
\ No newline at end of file
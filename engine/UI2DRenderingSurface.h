@@ -8,6 +8,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "ShaderProgram.h"
 #include "Color.h"
@@ -17,6 +18,57 @@ namespace userinterface
 {
 	class UIManager;
 
+	/**
+	 * @brief A primitive drawn by the UI, recorded to be drawn later.
+	 */
+	struct UIDrawCommand
+	{
+		/**
+		 * @brief Whether the command draws text or a quad.
+		 */
+		bool text;
+
+		/**
+		 * @brief x-position
+		 */
+		int posX;
+
+		/**
+		 * @brief y-position
+		 */
+		int posY;
+
+		/**
+		 * @brief Width of a quad
+		 */
+		int width;
+
+		/**
+		 * @brief Height of a quad
+		 */
+		int height;
+
+		/**
+		 * @brief Scale of a text
+		 */
+		float scale;
+
+		/**
+		 * @brief Color
+		 */
+		Color color;
+
+		/**
+		 * @brief String of a text
+		 */
+		std::string str;
+	};
+
+	/**
+	 * @brief Primitives of the UI in the order they are drawn.
+	 */
+	typedef std::vector<UIDrawCommand> UIDrawList;
+
 	/**
 	 * @brief 2D Rendering surface.
 	 */
@@ -56,7 +108,35 @@ namespace userinterface
 		 * @param color Color
 		 */
 		void renderText(const std::string& str, int x, int y, float scale, Color color);
+
+		/**
+		 * @brief Records the primitives rendered from now on to a list
+		 * instead of drawing them.
+		 * @param list List to add the primitives to.
+		 */
+		void beginRecording(UIDrawList* list);
+
+		/**
+		 * @brief Draws the primitives rendered from now on again.
+		 */
+		void endRecording();
+
+		/**
+		 * @brief Draws recorded primitives.
+		 * @param list The primitives.
+		 */
+		void replay(const UIDrawList& list);
 	private:
+
+		/**
+		 * @brief Draws a quad primitive, whether recording or not.
+		 * @param posX x-position
+		 * @param posY y-position
+		 * @param width width
+		 * @param height height
+		 * @param color color
+		 */
+		void drawQuad(int posX, int posY, int width, int height, Color color);
 		
 		/**
 		 * @brief Pointer to UI manager
@@ -102,5 +182,10 @@ namespace userinterface
 		 * @brief Font to be used for text rendering.
 		 */
 		Font _font;
+
+		/**
+		 * @brief List being recorded to, nullptr when drawing.
+		 */
+		UIDrawList* _recording{ nullptr };
 	};
 }
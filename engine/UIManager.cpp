@@ -41,4 +41,18 @@ namespace userinterface
 			it->second->draw(&_surface);
 		}
 	}
+
+	void UIManager::record(UIDrawList& list)
+	{
+		list.clear();
+
+		_surface.beginRecording(&list);
+		draw();
+		_surface.endRecording();
+	}
+
+	void UIManager::submit(const UIDrawList& list)
+	{
+		_surface.replay(list);
+	}
 }
\ No newline at end of file
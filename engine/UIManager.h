@@ -65,6 +65,19 @@ namespace userinterface
 		 * @brief Draw the elements to the surface.
 		 */
 		void draw();
+
+		/**
+		 * @brief Records what draw() would draw, without using OpenGL, so
+		 * it can be drawn on another thread.
+		 * @param list List to fill.
+		 */
+		void record(UIDrawList& list);
+
+		/**
+		 * @brief Draws a recorded list to the surface.
+		 * @param list The list.
+		 */
+		void submit(const UIDrawList& list);
 	private:
 
 		/**
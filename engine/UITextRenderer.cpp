@@ -7,6 +7,9 @@
 
 #include "UITextRenderer.h"
 
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
 #include <iostream>
 
 // https://learnopengl.com/#!In-Practice/Text-Rendering
@@ -22,16 +25,19 @@ namespace userinterface
 		if (FT_Init_FreeType(&_ft))
 			std::cerr << "Could not initialize FT" << std::endl;
 
+		GraphicsDevice& device = GraphicsDevice::get();
+		GLState& state = GLState::get();
+
 		// Setup rendering quad
-		glGenVertexArrays(1, &_VAO);
-		glGenBuffers(1, &_VBO);
-		glBindVertexArray(_VAO);
-		glBindBuffer(GL_ARRAY_BUFFER, _VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		_VAO = device.createVertexArray();
+		_VBO = device.createBuffer();
+		state.bindVertexArray(_VAO);
+		state.bindBuffer(GL_ARRAY_BUFFER, _VBO);
+		device.bufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+		device.setAttribArrayEnabled(0, true);
+		device.vertexAttribPointer(0, 4, 4 * sizeof(GLfloat), 0);
+		state.bindBuffer(GL_ARRAY_BUFFER, 0);
+		state.bindVertexArray(0);
 
 		// Setup screen projection.
 		_projection = glm::ortho(0.f, static_cast<GLfloat>(_screenWidth), 0.f, static_cast<GLfloat>(_screenHeight));
@@ -65,7 +71,7 @@ namespace userinterface
 
 		FT_Set_Pixel_Sizes(face, 0, size);
 
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		GraphicsDevice::get().pixelStore(GL_UNPACK_ALIGNMENT, 1);
 
 		for (GLubyte c = 0;c < 128; ++c)
 		{
@@ -103,10 +109,12 @@ namespace userinterface
 
 	void UITextRenderer::render(const std::string& text, GLfloat x, GLfloat y, GLfloat scale, Color color, Font* font)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		GLState& state = GLState::get();
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		state.setEnabled(GL_BLEND, true);
+		state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		state.polygonMode(GL_FILL);
 
 		_textShader.use();
 
@@ -114,7 +122,7 @@ namespace userinterface
 		_textShader.uploadUniform("projection", _projection);
 		_textShader.uploadUniform("text", 0);
 
-		glBindVertexArray(_VAO);
+		state.bindVertexArray(_VAO);
 
 		std::string::const_iterator ci;
 
@@ -139,17 +147,14 @@ namespace userinterface
 			};
 
 			ch.texture->bind(0);
-			glBindBuffer(GL_ARRAY_BUFFER, _VBO);
+			state.bindBuffer(GL_ARRAY_BUFFER, _VBO);
 
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			GraphicsDevice::get().bufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			GraphicsDevice::get().drawArrays(GL_TRIANGLES, 0, 6);
 
 			x += (ch.advance >> 6) * scale;
 		}
-
-		glBindVertexArray(0);
 	}
 
 	void UITextRenderer::setScreenDimensions(unsigned int width, unsigned int height)
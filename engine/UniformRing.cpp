@@ -0,0 +1,197 @@
+/**
+ * @file	UniformRing.cpp
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Ring buffer of uniform block data, written once per frame
+ */
+
+#include "UniformRing.h"
+
+#include "GraphicsDevice.h"
+
+#include <cstring>
+#include <string>
+
+constexpr GLuint UniformRing::FRAME_COUNT;
+
+UniformRing::UniformRing(GLuint frameSize)
+{
+	GLint alignment = GraphicsDevice::get().getInteger(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+
+	_alignment = alignment > 0 ? static_cast<GLuint>(alignment) : 256;
+
+	allocate(getAlignedSize(frameSize));
+}
+
+UniformRing::~UniformRing()
+{
+	release();
+}
+
+void UniformRing::begin(GLuint size)
+{
+	// Everything submitted so far may read the region used until now
+	if (_started)
+	{
+		_fences[_frame] = GraphicsDevice::get().fence();
+	}
+
+	if (size > _frameSize)
+	{
+		GLuint frameSize = _frameSize;
+
+		while (frameSize < size)
+		{
+			frameSize *= 2;
+		}
+
+		release();
+		allocate(frameSize);
+	}
+
+	_started = true;
+	_frame = (_frame + 1) % FRAME_COUNT;
+	_used = 0;
+
+	wait(_frame);
+
+	if (!_persistent)
+	{
+		GraphicsDevice& device = GraphicsDevice::get();
+
+		device.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+
+		// The fence already guarantees the GPU is done with the region
+		_memory = static_cast<unsigned char*>(device.mapBufferRange(
+			GL_UNIFORM_BUFFER,
+			_frame * _frameSize,
+			_frameSize,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+		device.bindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		if (!_memory)
+		{
+			throw UniformRing_error("Could not map uniform buffer");
+		}
+	}
+}
+
+UniformRange UniformRing::write(const Std140Block& block)
+{
+	GLuint size = getAlignedSize(block.getSize());
+
+	if (_used + size > _frameSize)
+	{
+		throw UniformRing_error(std::string("Uniform ring overflow, ").append(std::to_string(_frameSize)).append(" bytes per frame"));
+	}
+
+	unsigned char* region = _persistent ? _memory + _frame * _frameSize : _memory;
+
+	std::memcpy(region + _used, block.getData(), block.getSize());
+
+	UniformRange range{ _frame * _frameSize + _used, static_cast<GLuint>(block.getSize()) };
+
+	_used += size;
+
+	return range;
+}
+
+void UniformRing::end()
+{
+	// Coherent persistent writes are seen by later commands without a flush
+	if (!_persistent)
+	{
+		GraphicsDevice& device = GraphicsDevice::get();
+
+		device.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+		device.unmapBuffer(GL_UNIFORM_BUFFER);
+		device.bindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		_memory = nullptr;
+	}
+}
+
+void UniformRing::bind(GLuint binding, UniformRange range) const
+{
+	GraphicsDevice::get().bindBufferRange(GL_UNIFORM_BUFFER, binding, _buffer, range.offset, range.size);
+}
+
+GLuint UniformRing::getAlignedSize(size_t size) const
+{
+	// Blocks are read in whole vec4, then offsets have to be aligned
+	size_t padded = (size + Std140Block::VEC4_ALIGNMENT - 1) / Std140Block::VEC4_ALIGNMENT * Std140Block::VEC4_ALIGNMENT;
+
+	return static_cast<GLuint>((padded + _alignment - 1) / _alignment * _alignment);
+}
+
+void UniformRing::allocate(GLuint frameSize)
+{
+	_frameSize = frameSize;
+	_frame = 0;
+	_started = false;
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	_buffer = device.createBuffer();
+	device.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+
+	GLsizeiptr size = static_cast<GLsizeiptr>(_frameSize) * FRAME_COUNT;
+
+	_persistent = device.hasBufferStorage();
+
+	if (_persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		device.bufferStorage(GL_UNIFORM_BUFFER, size, flags);
+
+		_memory = static_cast<unsigned char*>(device.mapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+
+		if (!_memory)
+		{
+			throw UniformRing_error("Could not map uniform buffer");
+		}
+	}
+	else
+	{
+		device.bufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	}
+
+	device.bindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformRing::release()
+{
+	for (GLuint frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		wait(frame);
+	}
+
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	if (_persistent && _memory)
+	{
+		device.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+		device.unmapBuffer(GL_UNIFORM_BUFFER);
+		device.bindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	_memory = nullptr;
+
+	device.deleteBuffer(_buffer);
+	_buffer = 0;
+}
+
+void UniformRing::wait(GLuint frame)
+{
+	GLsync& fence = _fences[frame];
+
+	if (!fence)
+	{
+		return;
+	}
+
+	GraphicsDevice::get().waitFence(fence);
+	fence = nullptr;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file	UniformRing.h
+ * @Author	Joakim Bertils
+ * @date	2026-10-18
+ * @brief	Ring buffer of uniform block data, written once per frame
+ */
+
+#pragma once
+
+#include "Std140Block.h"
+
+#include <GL/glew.h>
+
+#include <stdexcept>
+
+/**
+ * @brief UniformRing error class
+ */
+class UniformRing_error : public std::logic_error {
+	using std::logic_error::logic_error;
+};
+
+/**
+ * @brief Part of the ring holding one block.
+ */
+struct UniformRange
+{
+	/**
+	 * @brief Offset in the buffer, in bytes.
+	 */
+	GLuint offset;
+
+	/**
+	 * @brief Size in bytes.
+	 */
+	GLuint size;
+};
+
+/**
+ * @brief Uniform buffer split into one region per frame in flight.
+ *
+ * All blocks of a frame are written between begin() and end() and then
+ * bound by index with bind(), which is the only call left per draw. A
+ * region is only written again once the GPU is done with the frame that
+ * last used it, which is tracked with a fence per region.
+ *
+ * The buffer is mapped once for its whole lifetime where the device
+ * supports buffer storage. Otherwise the region of the frame is mapped
+ * unsynchronized in begin() and unmapped in end().
+ */
+class UniformRing
+{
+public:
+	/**
+	 * @brief Constructor.
+	 * @param frameSize Initial size of every region in bytes.
+	 */
+	explicit UniformRing(GLuint frameSize);
+
+	/**
+	 * @brief Destructor.
+	 */
+	~UniformRing();
+
+	/**
+	 * @brief Constructor
+	 */
+	UniformRing(const UniformRing&) = delete;
+
+	/**
+	 * @brief Assignment operator
+	 * @return Ref. to self.
+	 */
+	UniformRing& operator=(const UniformRing&) = delete;
+
+	/**
+	 * @brief Starts writing the blocks of a frame into the next region.
+	 * Waits for the GPU if it still reads the region.
+	 * @param size Bytes needed by the frame, from getAlignedSize(). The
+	 * regions grow if they are too small.
+	 */
+	void begin(GLuint size);
+
+	/**
+	 * @brief Writes a block.
+	 * @param block The block.
+	 * @return Where the block was written.
+	 */
+	UniformRange write(const Std140Block& block);
+
+	/**
+	 * @brief Ends writing, the blocks may be bound after this.
+	 */
+	void end();
+
+	/**
+	 * @brief Binds a block to a uniform block binding.
+	 * @param binding Binding index.
+	 * @param range The block.
+	 */
+	void bind(GLuint binding, UniformRange range) const;
+
+	/**
+	 * @brief Gets the space a block takes in the ring.
+	 * @param size Size of the block in bytes.
+	 * @return Size rounded up to the offset alignment.
+	 */
+	GLuint getAlignedSize(size_t size) const;
+
+	/**
+	 * @brief Number of regions, the frames the GPU may lag behind plus one.
+	 */
+	static constexpr GLuint FRAME_COUNT{ 3 };
+
+private:
+	/**
+	 * @brief Creates and maps the buffer.
+	 * @param frameSize Size of every region in bytes.
+	 */
+	void allocate(GLuint frameSize);
+
+	/**
+	 * @brief Waits for every region and deletes the buffer.
+	 */
+	void release();
+
+	/**
+	 * @brief Waits for the GPU to finish with a region.
+	 * @param frame The region.
+	 */
+	void wait(GLuint frame);
+
+	/**
+	 * @brief OpenGL handle.
+	 */
+	GLuint _buffer{ 0 };
+
+	/**
+	 * @brief Size of every region in bytes.
+	 */
+	GLuint _frameSize{ 0 };
+
+	/**
+	 * @brief Alignment of offsets bound with glBindBufferRange.
+	 */
+	GLuint _alignment{ 0 };
+
+	/**
+	 * @brief Region of the current frame.
+	 */
+	GLuint _frame{ 0 };
+
+	/**
+	 * @brief Bytes written to the current region.
+	 */
+	GLuint _used{ 0 };
+
+	/**
+	 * @brief Whether the buffer stays mapped.
+	 */
+	bool _persistent{ false };
+
+	/**
+	 * @brief Whether a frame has been started since the buffer was allocated.
+	 */
+	bool _started{ false };
+
+	/**
+	 * @brief Start of the whole buffer when persistent, else of the mapped region.
+	 */
+	unsigned char* _memory{ nullptr };
+
+	/**
+	 * @brief Fence after the last commands reading every region.
+	 */
+	GLsync _fences[FRAME_COUNT]{};
+};
@@ -7,24 +7,45 @@
 
 #include "VertexArrayObject.h"
 
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
 VertexArrayObject::VertexArrayObject()
 {
-	glGenVertexArrays(1, &vao);
+	vao = GraphicsDevice::get().createVertexArray();
 }
 
 VertexArrayObject::~VertexArrayObject()
 {
-	glDeleteVertexArrays(1, &vao);
+	GraphicsDevice::get().deleteVertexArray(vao);
+
+	// Deleting unbinds the vertex array behind the back of the cache
+	GLState::get().invalidate();
 }
 
 void VertexArrayObject::bind()
 {
-	glBindVertexArray(vao);
+	GLState::get().bindVertexArray(vao);
 }
 
 void VertexArrayObject::unbind()
 {
-	glBindVertexArray(0);
+	GLState::get().bindVertexArray(0);
+}
+
+void VertexArrayObject::setupInstanceAttribPointer(VertexBufferObject& buffer, GLuint location, GLuint elementSize, GLsizei stride, GLsizeiptr offset)
+{
+	GraphicsDevice& device = GraphicsDevice::get();
+
+	buffer.bind();
+	device.vertexAttribPointer(location, elementSize, stride, offset);
+	device.vertexAttribDivisor(location, 1);
+	device.setAttribArrayEnabled(location, true);
+}
+
+void VertexArrayObject::disableAttribArray(GLuint location)
+{
+	GraphicsDevice::get().setAttribArrayEnabled(location, false);
 }
 
 GLuint VertexArrayObject::getHandle() const
@@ -14,6 +14,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "VertexBufferObject.h"
+
 /**
  * @brief Vertex Array Object abstraction
  */
@@ -63,6 +65,23 @@ public:
 	*/
 	void unbind();
 
+	/**
+	 * @brief Sets up an attribute that advances once per instance instead of
+	 * once per vertex. The VAO must be bound.
+	 * @param buffer Buffer to read the attribute from.
+	 * @param location Attribute location.
+	 * @param elementSize Number of floats in the attribute.
+	 * @param stride Bytes between two instances.
+	 * @param offset Byte offset of the first instance in the buffer.
+	 */
+	void setupInstanceAttribPointer(VertexBufferObject& buffer, GLuint location, GLuint elementSize, GLsizei stride, GLsizeiptr offset);
+
+	/**
+	 * @brief Disables an attribute array. The VAO must be bound.
+	 * @param location Attribute location.
+	 */
+	void disableAttribArray(GLuint location);
+
 	/**
 	 * @brief Handle getter.
 	 * @return OpenGL handle.
@@ -7,31 +7,37 @@
 
 #include "VertexBufferObject.h"
 
+#include "GLState.h"
+#include "GraphicsDevice.h"
+
 VertexBufferObject::VertexBufferObject(GLenum target)
 	: target{ target }
 {
-	glGenBuffers(1, &vbo);
+	vbo = GraphicsDevice::get().createBuffer();
 }
 
 VertexBufferObject::~VertexBufferObject()
 {
-	glDeleteBuffers(1, &vbo);
+	GraphicsDevice::get().deleteBuffer(vbo);
+
+	// Deleting unbinds the buffer behind the back of the cache
+	GLState::get().invalidate();
 }
 
 void VertexBufferObject::bind()
 {
-	glBindBuffer(target, vbo);
+	GLState::get().bindBuffer(target, vbo);
 }
 
 void VertexBufferObject::unbind()
 {
-	glBindBuffer(target, 0);
+	GLState::get().bindBuffer(target, 0);
 }
 
 void VertexBufferObject::storeData(GLuint size, const void* data, GLenum usage)
 {
 	bind();
-	glBufferData(target, size, data, usage);
+	GraphicsDevice::get().bufferData(target, size, data, usage);
 	this->size = size;
 	unbind();
 }
@@ -39,8 +45,8 @@ void VertexBufferObject::storeData(GLuint size, const void* data, GLenum usage)
 void VertexBufferObject::setupVertexAttribPointer(GLuint location, GLuint elementSize)
 {
 	bind();
-	glVertexAttribPointer(location, elementSize, GL_FLOAT, GL_FALSE, 0, 0);
-	glEnableVertexAttribArray(location);
+	GraphicsDevice::get().vertexAttribPointer(location, elementSize, 0, 0);
+	GraphicsDevice::get().setAttribArrayEnabled(location, true);
 	unbind();
 }
 
@@ -329,8 +329,12 @@ void Window::framebuffer_size_callback(int width, int height)
 {
 	this->width = width;
 	this->height = height;
-	setContextCurrent();
-	glViewport(0, 0, width, height);
+
+	// The context may be owned by the render thread, which sets its own viewport
+	if (glfwGetCurrentContext() == windowHandle)
+	{
+		glViewport(0, 0, width, height);
+	}
 
 	WindowEvent ev;
 	ev.type = EventType::RESIZED;
@@ -501,8 +505,18 @@ void Window::mouse_scroll_callback(double xOffset, double yOffset)
 }
 
 void Window::display() const
+{
+	swapBuffers();
+	processEvents();
+}
+
+void Window::swapBuffers() const
 {
 	glfwSwapBuffers(windowHandle);
+}
+
+void Window::processEvents() const
+{
 	glfwPollEvents();
 }
 
@@ -511,6 +525,14 @@ void Window::setContextCurrent() const
 	glfwMakeContextCurrent(windowHandle);
 }
 
+void Window::releaseContext() const
+{
+	if (glfwGetCurrentContext() == windowHandle)
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+}
+
 bool Window::pollEvent(WindowEvent& ev)
 {
 	if (eventQueue.empty())
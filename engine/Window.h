@@ -625,11 +625,27 @@ public:
 	 */
 	void display() const;
 
+	/**
+	 * @brief Swaps the buffers, from the thread the context is current on.
+	 */
+	void swapBuffers() const;
+
+	/**
+	 * @brief Polls for events of all windows, from the main thread.
+	 */
+	void processEvents() const;
+
 	/**
 	 * @brief Sets this window as the current context.
 	 */
 	void setContextCurrent() const;
 
+	/**
+	 * @brief Makes the context of this window not current on the calling
+	 * thread, so another thread can make it current.
+	 */
+	void releaseContext() const;
+
 	/**
 	 * @brief Polls for any window events
 	 * @param ev Reference to struct where data will be stored.
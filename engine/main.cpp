@@ -13,12 +13,40 @@
 #include "TextureComponent.h"
 #include "MaterialComponent.h"
 #include "TerrainComponent.h"
+#include "PhysicsBenchmark.h"
+#include "BroadphaseBenchmark.h"
+#include "RenderBenchmark.h"
 #include <filesystem>
+#include <cstring>
 
 void createSomeTrees(EntityManager* entityManager);
 
-int main()
+int main(int argc, char** argv)
 {
+	// Runs the physics without a window and exits
+	if (argc > 1 && std::strcmp(argv[1], "--physics-benchmark") == 0)
+	{
+		runPhysicsBenchmark();
+
+		return 0;
+	}
+
+	// Compares the broadphases over the same scene without a window and exits
+	if (argc > 1 && std::strcmp(argv[1], "--broadphase-benchmark") == 0)
+	{
+		runBroadphaseBenchmark();
+
+		return 0;
+	}
+
+	// Renders into a recording device without a window and exits
+	if (argc > 1 && std::strcmp(argv[1], "--render-benchmark") == 0)
+	{
+		runRenderBenchmark();
+
+		return 0;
+	}
+
 	engine::Engine engine;
 
 	engine.init();
@@ -97,7 +125,7 @@ int main()
 		// EntityManager setup
 		//=====================================================================
 
-		// Grs i scene's konstruktor, registrerar alla saker dr
+		// Görs i scene's konstruktor, registrerar alla saker där
 
 		//=====================================================================
 		// Load entities
@@ -176,7 +204,7 @@ void createSomeTrees(EntityManager* entityManager)
 		//entityManager->assignComponent<ModelComponent>(tree1, std::string("tree").append(std::to_string(rand()  % range3 + min3)));
 		entityManager->assignComponent<ModelComponent>(tree1, "lowpolytree");
 		entityManager->assignComponent<TextureComponent>(tree1);
-		entityManager->assignComponent<CollisionComponent>(tree1, 1.f);
+		entityManager->assignComponent<CollisionComponent>(tree1, 1.f, true, LAYER_SCENERY, LAYER_ALL & ~LAYER_SCENERY);
 		TextureComponent* texComp2 = entityManager->getComponent<TextureComponent>(tree1);
 		texComp2->attach(0, "grass");
 	}
@@ -8,7 +8,7 @@
 
 int main()
 {
-	// OBS! Denna fil anvnds inte fr tillfllet d vi inte ftt till DLL-lnkning ordentligt. 
+	// OBS! Denna fil används inte för tillfället då vi inte fått till DLL-länkning ordentligt. 
 	// Se main.cpp i engine
 
 	/*
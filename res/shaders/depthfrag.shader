@@ -2,14 +2,45 @@
 
 in vec4 FragPos;
 
-uniform vec3 lightPos;
-uniform float far_plane;
+struct Light
+{
+	vec3 position;
+
+	float constant;
+	float linear;
+	float quadratic;
+
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+// Per frame constants, must match RenderingSystem::writeFrameBlock
+layout(std140) uniform FrameBlock
+{
+	mat4 view;
+	mat4 viewProj;
+	vec3 viewPos;
+	float nearPlane;
+	vec2 screenSize;
+	float farPlane;
+	float shadowFarPlane;
+	int clusterOffset;
+	int indexOffset;
+};
+
+// The light being rendered, must match RenderingSystem::writeShadowBlock
+layout(std140) uniform ShadowBlock
+{
+	mat4 shadowMatrices[6];
+	Light light;
+};
 
 void main()
 {
-	float lightDistance = length(FragPos.xyz - lightPos);
+	float lightDistance = length(FragPos.xyz - light.position);
 
-	lightDistance = lightDistance / far_plane;
+	lightDistance = lightDistance / shadowFarPlane;
 
 	gl_FragDepth = lightDistance;
 }
\ No newline at end of file
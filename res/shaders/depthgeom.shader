@@ -3,7 +3,28 @@
 layout(triangles) in;
 layout(triangle_strip, max_vertices = 18) out;
 
-uniform mat4 shadowMatrices[6];
+struct Light
+{
+	vec3 position;
+
+	float constant;
+	float linear;
+	float quadratic;
+
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+// The light being rendered, must match RenderingSystem::writeShadowBlock
+layout(std140) uniform ShadowBlock
+{
+	mat4 shadowMatrices[6];
+	Light light;
+};
+
+// Cube faces the draw touches, one bit per face
+uniform int faceMask;
 
 out vec4 FragPos;
 
@@ -11,6 +32,11 @@ void main()
 {
 	for (int face = 0; face < 6; ++face)
 	{
+		if ((faceMask & (1 << face)) == 0)
+		{
+			continue;
+		}
+
 		gl_Layer = face;
 		for (int i = 0; i < 3; ++i)
 		{
@@ -1,10 +1,12 @@
 #version 330 core
 
 layout(location = 0) in vec3 vertex_position;
+layout(location = 3) in mat4 instance_model;
 
 uniform mat4 model;
+uniform bool instanced;
 
 void main()
 {
-	gl_Position = model*vec4(vertex_position, 1.0);
+	gl_Position = (instanced ? instance_model : model)*vec4(vertex_position, 1.0);
 }
\ No newline at end of file
@@ -1,5 +1,15 @@
 #version 330 core
 
+//=============================================================================
+// Constants
+//=============================================================================
+
+// Must match MAX_LIGHTS in RenderingSystem.h
+const int MAX_SHADOWS = 8;
+
+// Must match the grid of LightClusters
+const ivec3 CLUSTER_GRID = ivec3(16, 9, 24);
+
 //=============================================================================
 // Structs
 //=============================================================================
@@ -47,31 +57,99 @@ layout (location = 1) out vec4 brightColor;
 // Texture to sample main texture from.
 uniform sampler2D 	textureUnit;
 
-// Position of the camera during the render pass.
-uniform vec3 		viewPos;
-
-// Number of lights in scene
-uniform int numLights;
-
-// Light data. TODO: Variable length buffer with SSBO
-uniform Light lights[32];
-
-// Shadow depth cube maps
-uniform samplerCube depthMaps[32];
+// Per frame constants, must match RenderingSystem::writeFrameBlock.
+// The view matrix and the planes locate the depth slice, clusterOffset and
+// indexOffset are the texels of the first cluster header and light index.
+layout(std140) uniform FrameBlock
+{
+	mat4 view;
+	mat4 viewProj;
+	vec3 viewPos;
+	float nearPlane;
+	vec2 screenSize;
+	float farPlane;
+	float shadowFarPlane;
+	int clusterOffset;
+	int indexOffset;
+};
 
 // Material Properties
-uniform Material material;
+layout(std140) uniform MaterialBlock
+{
+	Material material;
+};
+
+// Lights, cluster headers and cluster light indices, see LightClusters
+uniform samplerBuffer lightData;
 
-// Far plane used by shadows
-uniform float far_plane;
+// Shadow depth cube maps, one per light with a shadow
+uniform samplerCube depthMaps[MAX_SHADOWS];
 
 //=============================================================================
 // Functions
 //=============================================================================
 
-float calculateShadow(int i)
+Light fetchLight(int i)
+{
+	vec4 t0 = texelFetch(lightData, i * 4 + 0);
+	vec4 t1 = texelFetch(lightData, i * 4 + 1);
+	vec4 t2 = texelFetch(lightData, i * 4 + 2);
+	vec4 t3 = texelFetch(lightData, i * 4 + 3);
+
+	Light light;
+
+	light.position = t0.xyz;
+	light.ambient = t1.xyz;
+	light.constant = t1.w;
+	light.diffuse = t2.xyz;
+	light.linear = t2.w;
+	light.specular = t3.xyz;
+	light.quadratic = t3.w;
+
+	return light;
+}
+
+int fetchShadowIndex(int i)
+{
+	return int(texelFetch(lightData, i * 4).w);
+}
+
+int findCluster()
 {
-	vec3 fragToLight = FragPos - lights[i].position;
+	float depth = -(view * vec4(FragPos, 1.0)).z;
+
+	int slice = int(floor(log(max(depth, nearPlane) / nearPlane) / log(farPlane / nearPlane) * float(CLUSTER_GRID.z)));
+
+	ivec2 tile = ivec2(gl_FragCoord.xy / screenSize * vec2(CLUSTER_GRID.xy));
+
+	tile = clamp(tile, ivec2(0), CLUSTER_GRID.xy - 1);
+	slice = clamp(slice, 0, CLUSTER_GRID.z - 1);
+
+	return (slice * CLUSTER_GRID.y + tile.y) * CLUSTER_GRID.x + tile.x;
+}
+
+float sampleShadow(int shadowIndex, vec3 direction)
+{
+	// Sampler arrays may only be indexed by constants in this version
+	for (int s = 0; s < MAX_SHADOWS; ++s)
+	{
+		if (s == shadowIndex)
+		{
+			return texture(depthMaps[s], direction).r;
+		}
+	}
+
+	return 1.0;
+}
+
+float calculateShadow(Light light, int shadowIndex)
+{
+	if (shadowIndex < 0)
+	{
+		return 0.0;
+	}
+
+	vec3 fragToLight = FragPos - light.position;
 		
 	float currentDepth = length(fragToLight);
 	
@@ -90,8 +168,8 @@ float calculateShadow(int i)
 		{
 			for(float z = -offset; z < offset; z+= offset/(samples*0.5))
 			{
-				float closestDepth = texture(depthMaps[i], fragToLight + vec3(x,y,z)).r;
-				closestDepth *= far_plane;
+				float closestDepth = sampleShadow(shadowIndex, fragToLight + vec3(x,y,z));
+				closestDepth *= shadowFarPlane;
 				if(currentDepth - bias > closestDepth)
 				{
 					shadow += 1.0;
@@ -120,32 +198,43 @@ void main()
 	vec3 norm = normalize(normal);
 	vec3 viewDir = normalize(viewPos - FragPos);
 	
+	// Only the lights reaching this fragment's cluster
+	vec4 cluster = texelFetch(lightData, clusterOffset + findCluster());
+
+	int first = int(cluster.x);
+	int count = int(cluster.y);
+
 	// Variable to store light result.
 	vec3 resColor = vec3(0,0,0);
-	for(int i = 0; i < numLights; ++i)
+	for(int n = 0; n < count; ++n)
 	{
-		vec3 lightDirection = normalize(lights[i].position - FragPos);
+		int index = first + n;
+		int i = int(texelFetch(lightData, indexOffset + index / 4)[index % 4]);
+
+		Light light = fetchLight(i);
+
+		vec3 lightDirection = normalize(light.position - FragPos);
 
 		// Ambient light calculation
-		vec3 ambientColor = lights[i].ambient*material.ambient;
+		vec3 ambientColor = light.ambient*material.ambient;
 	
 		// Diffuse light calculation
 		float diff = max(dot(norm, lightDirection), 0.0);
-		vec3 diffuseColor = lights[i].diffuse * diff * material.diffuse;
+		vec3 diffuseColor = light.diffuse * diff * material.diffuse;
 	
 		// Specular light calculation
 		vec3 reflectDir = reflect(-lightDirection, norm);
-		float lightDistance = length(lights[i].position - FragPos);
+		float lightDistance = length(light.position - FragPos);
 		float spec = pow(max(dot(viewDir, reflectDir), 0.0f), material.shininess);
-		vec3 specularColor = lights[i].specular * spec * material.specular;
+		vec3 specularColor = light.specular * spec * material.specular;
 	
 		// Calculate Shadow factor.
-		float shadow = calculateShadow(i);
+		float shadow = calculateShadow(light, fetchShadowIndex(i));
 		
 		shadow = clamp(shadow, 0.0, 1.0);
 		
 		// Calulate Attenuatuon factor.
-		float attenuation = calculateAttenuation(lightDistance, lights[i]);
+		float attenuation = calculateAttenuation(lightDistance, light);
 	
 		// Add the results to the resulting light color
 		resColor += (ambientColor + (1.0 - shadow)*(diffuseColor + specularColor))*attenuation;
@@ -8,6 +8,9 @@ layout(location = 0) in vec3 vertex_position;
 layout(location = 1) in vec3 vertex_normal;
 layout(location = 2) in vec2 vertex_texture_coordinates;
 
+// Model matrix per instance, only read when instanced is set
+layout(location = 3) in mat4 instance_model;
+
 //=============================================================================
 // Output
 //=============================================================================
@@ -20,8 +23,23 @@ out vec2 texCoords;
 // Uniforms
 //=============================================================================
 
+// Per frame constants, must match RenderingSystem::writeFrameBlock
+layout(std140) uniform FrameBlock
+{
+	mat4 view;
+	mat4 viewProj;
+	vec3 viewPos;
+	float nearPlane;
+	vec2 screenSize;
+	float farPlane;
+	float shadowFarPlane;
+	int clusterOffset;
+	int indexOffset;
+};
+
 uniform mat4 transform;
 uniform mat4 model;
+uniform bool instanced;
 
 //=============================================================================
 // Functions
@@ -33,14 +51,16 @@ uniform mat4 model;
 
 void main()
 {
+	mat4 modelMatrix = instanced ? instance_model : model;
+
 	// Invert-transpose model to find normal transformations
-	normal = mat3(transpose(inverse(model)))*vertex_normal;
+	normal = mat3(transpose(inverse(modelMatrix)))*vertex_normal;
 	
 	// Output Vertex position
-	gl_Position = transform*vec4(vertex_position, 1.0);
+	gl_Position = instanced ? viewProj*modelMatrix*vec4(vertex_position, 1.0) : transform*vec4(vertex_position, 1.0);
 	
 	// Pass Fragment position
-	FragPos = vec3(model*vec4(vertex_position, 1.0));
+	FragPos = vec3(modelMatrix*vec4(vertex_position, 1.0));
 	
 	// Pass Texture Coordinates
 	texCoords = vertex_texture_coordinates;